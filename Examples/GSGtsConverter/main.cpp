@@ -0,0 +1,201 @@
+// Converts a 3DGS .ply to the quantized .gts runtime format (GSCompressedScene.h) and reports
+// what the conversion costs. Needs no GPU.
+//
+//   GSGtsConverter input.ply [output.gts] [--sh-degree N] [--chunk N] [--threads N] [--repeats N]
+//
+// Splats are sorted spatially before chunking. Reported are bytes per splat, best-of load times of
+// both files through GSSceneLoader (page cache warm), the time to stream the .gts through a single
+// chunk of staging memory, and the error of the decoded scene against the float reference. The
+// PSNR is over SH colours evaluated for 32 view directions per splat and clamped like
+// gs_preprocess.comp, and over opacity: attribute space, not rendered images.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GaussianSplat/GSCompressedScene.h"
+#include "GaussianSplat/GSSceneLoader.h"
+
+namespace
+{
+    constexpr int kViewDirections = 32;
+
+    // gs_preprocess.comp compute_sh, for one direction
+    glm::vec3 ShColor(const GSVertex& v, const glm::vec3& d)
+    {
+        const auto sh = [&](int i) { return glm::vec3(v.sh[i * 3], v.sh[i * 3 + 1], v.sh[i * 3 + 2]); };
+        const float x = d.x, y = d.y, z = d.z;
+        glm::vec3 c = 0.28209479177387814f * sh(0);
+        c += 0.4886025119029199f * (-sh(1) * y + sh(2) * z - sh(3) * x);
+        c += 1.0925484305920792f * sh(4) * x * y;
+        c += -1.0925484305920792f * sh(5) * y * z;
+        c += 0.31539156525252005f * sh(6) * (2.0f * z * z - x * x - y * y);
+        c += -1.0925484305920792f * sh(7) * z * x;
+        c += 0.5462742152960396f * sh(8) * (x * x - y * y);
+        c += -0.5900435899266435f * sh(9) * (3.0f * x * x - y * y) * y;
+        c += 2.890611442640554f * sh(10) * x * y * z;
+        c += -0.4570457994644658f * sh(11) * (4.0f * z * z - x * x - y * y) * y;
+        c += 0.3731763325901154f * sh(12) * z * (2.0f * z * z - 3.0f * x * x - 3.0f * y * y);
+        c += -0.4570457994644658f * sh(13) * x * (4.0f * z * z - x * x - y * y);
+        c += 1.445305721320277f * sh(14) * (x * x - y * y) * z;
+        c += -0.5900435899266435f * sh(15) * x * (x * x - 3.0f * y * y);
+        return glm::clamp(c + 0.5f, 0.0f, 1.0f);
+    }
+
+    // evenly spread over the sphere (Fibonacci lattice)
+    std::vector<glm::vec3> ViewDirections()
+    {
+        std::vector<glm::vec3> directions;
+        for (int i = 0; i < kViewDirections; ++i)
+        {
+            const float z = 1.0f - 2.0f * (float(i) + 0.5f) / float(kViewDirections);
+            const float r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+            const float phi = 2.39996323f * float(i);
+            directions.emplace_back(r * std::cos(phi), r * std::sin(phi), z);
+        }
+        return directions;
+    }
+
+    double Psnr(double squaredError, double samples)
+    {
+        const double mse = squaredError / std::max(1.0, samples);
+        return mse > 0.0 ? 10.0 * std::log10(1.0 / mse) : 99.0;
+    }
+
+    void ReportError(const std::vector<GSVertex>& reference, const std::vector<GSVertex>& decoded)
+    {
+        glm::vec3 minP(1e30f), maxP(-1e30f);
+        for (const GSVertex& v : reference)
+        {
+            minP = glm::min(minP, glm::vec3(v.position));
+            maxP = glm::max(maxP, glm::vec3(v.position));
+        }
+        const double diagonal = std::max(1e-30f, glm::length(maxP - minP));
+
+        const std::vector<glm::vec3> directions = ViewDirections();
+        double colorError = 0.0, opacityError = 0.0, positionError = 0.0, maxPositionError = 0.0;
+        double scaleError = 0.0, rotationError = 0.0;
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            const GSVertex& a = reference[i];
+            const GSVertex& b = decoded[i];
+            for (const glm::vec3& d : directions)
+            {
+                const glm::vec3 e = ShColor(a, d) - ShColor(b, d);
+                colorError += glm::dot(e, e);
+            }
+            opacityError += double(a.scale_opacity.w - b.scale_opacity.w) * (a.scale_opacity.w - b.scale_opacity.w);
+            const double p = glm::length(glm::vec3(a.position - b.position));
+            positionError += p * p;
+            maxPositionError = std::max(maxPositionError, p);
+            for (int k = 0; k < 3; ++k)
+                scaleError += std::abs(a.scale_opacity[k] - b.scale_opacity[k]) / std::max(1e-30f, a.scale_opacity[k]);
+            rotationError += 2.0 * std::acos(std::min(1.0f, std::abs(glm::dot(a.rotation, b.rotation))));
+        }
+        const double n = double(reference.size());
+        std::cout << "  colour PSNR          " << std::setw(8) << Psnr(colorError, n * kViewDirections * 3) << " dB ("
+                  << kViewDirections << " view directions)\n"
+                  << "  opacity PSNR         " << std::setw(8) << Psnr(opacityError, n) << " dB\n"
+                  << std::scientific << std::setprecision(2)
+                  << "  position RMSE        " << std::setw(8) << std::sqrt(positionError / n) / diagonal
+                  << " of the scene diagonal (max " << maxPositionError / diagonal << ")\n"
+                  << "  scale error          " << std::setw(8) << scaleError / (3.0 * n) << " relative, mean\n"
+                  << std::fixed << std::setprecision(3)
+                  << "  rotation error       " << std::setw(8) << glm::degrees(rotationError / n) << " degrees, mean\n"
+                  << std::setprecision(1);
+    }
+
+    template <typename Function>
+    double BestOf(int repeats, Function&& function)
+    {
+        double best = 1e30;
+        for (int i = 0; i < repeats; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path input, output;
+    GtsEncodeOptions options;
+    unsigned threads = 0;
+    int repeats = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--sh-degree" && i + 1 < argc) options.shDegree = uint32_t(std::clamp(std::atoi(argv[++i]), 0, 3));
+        else if (arg == "--chunk" && i + 1 < argc) options.chunkSplats = uint32_t(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--threads" && i + 1 < argc) threads = unsigned(std::max(0, std::atoi(argv[++i])));
+        else if (arg == "--repeats" && i + 1 < argc) repeats = std::max(1, std::atoi(argv[++i]));
+        else if (input.empty()) input = arg;
+        else output = arg;
+    }
+    if (input.empty())
+    {
+        std::cout << "usage: GSGtsConverter input.ply [output.gts] [--sh-degree N] [--chunk N] [--threads N] [--repeats N]"
+                  << std::endl;
+        return 1;
+    }
+    if (output.empty())
+        output = std::filesystem::path(input).replace_extension(".gts");
+
+    GSSceneLoader loader;
+    std::vector<GSVertex> reference;
+    std::vector<GSVertex> decoded;
+    double encodeSeconds = 0.0;
+    try
+    {
+        reference = loader.load(input.string(), threads);
+        const auto start = std::chrono::steady_clock::now();
+        sortSplatsSpatially(reference);
+        writeGtsScene(output.string(), reference, options);
+        encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        decoded = loader.load(output.string(), threads);
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    if (decoded.size() != reference.size())
+    {
+        std::cout << "decoded " << decoded.size() << " of " << reference.size() << " splats" << std::endl;
+        return 1;
+    }
+
+    const double splats = double(reference.size());
+    const double plyBytes = double(std::filesystem::file_size(input));
+    const double gtsBytes = double(std::filesystem::file_size(output));
+    const double plySeconds = BestOf(repeats, [&]() { loader.load(input.string(), threads); });
+    const double gtsSeconds = BestOf(repeats, [&]() { loader.load(output.string(), threads); });
+    // the upload path: chunk by chunk through one chunk-sized buffer standing in for staging memory
+    const double streamSeconds = BestOf(repeats, [&]() {
+        const GtsSceneReader reader(output.string());
+        std::vector<GSVertex> staging(options.chunkSplats);
+        for (size_t c = 0; c < reader.chunkCount(); ++c)
+            reader.decodeChunk(c, staging.data());
+    });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << reference.size() << " splats, SH degree " << options.shDegree << ", " << options.chunkSplats
+              << " splats per chunk -> " << output.string() << "\n"
+              << "  bytes per splat      " << std::setw(8) << plyBytes / splats << " .ply, " << sizeof(GSVertex)
+              << " GSVertex, " << gtsBytes / splats << " .gts (" << plyBytes / gtsBytes << "x smaller)\n"
+              << "  encode               " << std::setw(8) << encodeSeconds * 1000.0 << " ms (sort + write)\n"
+              << "  load .ply            " << std::setw(8) << plySeconds * 1000.0 << " ms\n"
+              << "  load .gts            " << std::setw(8) << gtsSeconds * 1000.0 << " ms\n"
+              << "  stream .gts          " << std::setw(8) << streamSeconds * 1000.0 << " ms (one chunk of staging, 1 thread)\n";
+    ReportError(reference, decoded);
+    std::cout << std::flush;
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Load throughput of GSSceneLoader on synthetic Gaussian splat scenes. Needs no GPU.
+//
+//   GSPlyLoadBenchmark [splatsInMillions ...] [--threads N] [--repeats N] [--dir path] [--keep]
+//
+// Every scene is written as a binary little-endian .ply with the full 3DGS layout (62 floats,
+// 248 bytes per splat: position, normal, SH degree 3, opacity, scale, rotation), then loaded
+// with 1, 2, 4, .. N decode threads. The file stays in the page cache after writing, so the
+// numbers are decode throughput, next to a plain ifstream read of the same file as the
+// memory-bandwidth reference. A few splats are checked against the generator.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GaussianSplat/GSSceneLoader.h"
+
+namespace
+{
+    constexpr int kFloatsPerSplat = 62;
+
+    // deterministic attribute k of splat i, in ranges like a trained scene
+    float SplatValue(size_t i, int k)
+    {
+        uint32_t h = uint32_t(i) * 2654435761u ^ uint32_t(k) * 40503u;
+        h ^= h >> 15;
+        h *= 2246822519u;
+        h ^= h >> 13;
+        return float(h & 0xFFFF) / 65535.0f * 2.0f - 1.0f;
+    }
+
+    bool WriteSyntheticPly(const std::filesystem::path& path, size_t splats)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        file << "ply\nformat binary_little_endian 1.0\ncomment synthetic GSPlyLoadBenchmark scene\n";
+        file << "element vertex " << splats << "\n";
+        for (const char* name : { "x", "y", "z", "nx", "ny", "nz", "f_dc_0", "f_dc_1", "f_dc_2" })
+            file << "property float " << name << "\n";
+        for (int i = 0; i < 45; ++i)
+            file << "property float f_rest_" << i << "\n";
+        for (const char* name : { "opacity", "scale_0", "scale_1", "scale_2", "rot_0", "rot_1", "rot_2", "rot_3" })
+            file << "property float " << name << "\n";
+        file << "end_header\n";
+
+        // written in blocks, one float at a time would dominate for multi-GB scenes
+        constexpr size_t kBlockSplats = 65536;
+        std::vector<float> block(kBlockSplats * kFloatsPerSplat);
+        for (size_t first = 0; first < splats; first += kBlockSplats)
+        {
+            const size_t count = std::min(kBlockSplats, splats - first);
+            for (size_t i = 0; i < count; ++i)
+            {
+                for (int k = 0; k < kFloatsPerSplat; ++k)
+                    block[i * kFloatsPerSplat + k] = SplatValue(first + i, k);
+            }
+            file.write(reinterpret_cast<const char*>(block.data()), std::streamsize(count * kFloatsPerSplat * sizeof(float)));
+        }
+        return bool(file);
+    }
+
+    // position, dc color and the first f_rest of each channel land where the loader promises
+    bool CheckSplat(const std::vector<GSVertex>& vertices, size_t i)
+    {
+        const GSVertex& v = vertices[i];
+        const float expected[] = {
+            SplatValue(i, 0), v.position.x, SplatValue(i, 1), v.position.y, SplatValue(i, 2), v.position.z,
+            SplatValue(i, 6), v.sh[0], SplatValue(i, 7), v.sh[1], SplatValue(i, 8), v.sh[2],
+            SplatValue(i, 9), v.sh[3], SplatValue(i, 24), v.sh[4], SplatValue(i, 39), v.sh[5],
+            1.0f / (1.0f + std::exp(-SplatValue(i, 54))), v.scale_opacity.w,
+            std::exp(SplatValue(i, 55)), v.scale_opacity.x,
+        };
+        for (size_t k = 0; k < std::size(expected); k += 2)
+        {
+            if (std::abs(expected[k] - expected[k + 1]) > 1e-5f * std::max(1.0f, std::abs(expected[k])))
+                return false;
+        }
+        return true;
+    }
+
+    template <typename Function>
+    double BestOf(int repeats, Function&& function)
+    {
+        double best = 1e30;
+        for (int i = 0; i < repeats; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<double> sceneMillions;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    int repeats = 3;
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    bool keep = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) maxThreads = unsigned(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--repeats" && i + 1 < argc) repeats = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--dir" && i + 1 < argc) directory = argv[++i];
+        else if (arg == "--keep") keep = true;
+        else sceneMillions.push_back(std::atof(arg.c_str()));
+    }
+    if (sceneMillions.empty())
+        sceneMillions = { 1.0, 3.0 };
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::cout << std::fixed << std::setprecision(1);
+    bool ok = true;
+    GSSceneLoader loader;
+    for (double millions : sceneMillions)
+    {
+        const size_t splats = size_t(millions * 1e6);
+        if (splats == 0)
+            continue;
+        const std::filesystem::path path = directory / ("gs_load_benchmark_" + std::to_string(splats) + ".ply");
+        if (!WriteSyntheticPly(path, splats))
+        {
+            std::cout << "failed to write " << path << std::endl;
+            return 1;
+        }
+        const double megabytes = double(std::filesystem::file_size(path)) / (1024.0 * 1024.0);
+        std::cout << "\n" << splats << " splats, " << megabytes << " MB (" << path.string() << ")" << std::endl;
+
+        std::vector<char> bytes(size_t(std::filesystem::file_size(path)));
+        const double readSeconds = BestOf(repeats, [&]() {
+            std::ifstream file(path, std::ios::binary);
+            file.read(bytes.data(), std::streamsize(bytes.size()));
+        });
+        std::cout << "  ifstream read        " << std::setw(8) << megabytes / readSeconds << " MB/s" << std::endl;
+        bytes = {};
+
+        for (unsigned threads : threadCounts)
+        {
+            std::vector<GSVertex> vertices;
+            const double seconds = BestOf(repeats, [&]() { vertices = loader.load(path.string(), threads); });
+            const bool valid = vertices.size() == splats && CheckSplat(vertices, 0) && CheckSplat(vertices, splats / 2)
+                && CheckSplat(vertices, splats - 1);
+            ok = ok && valid;
+            std::cout << "  load, " << std::setw(2) << threads << " thread(s)   " << std::setw(8) << megabytes / seconds
+                      << " MB/s  " << std::setw(7) << double(splats) / seconds * 1e-6 << " M splats/s  "
+                      << std::setw(7) << seconds * 1000.0 << " ms" << (valid ? "" : "  MISMATCH") << std::endl;
+        }
+
+        if (!keep)
+            std::filesystem::remove(path);
+    }
+    return ok ? 0 : 1;
+}
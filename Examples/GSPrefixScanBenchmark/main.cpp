@@ -0,0 +1,647 @@
+// Correctness and throughput of the two tile-overlap prefix sums of GSComputeRenderer
+// (GSPrefixScan): gs_prefix_sum.comp (Hillis-Steele, ceil(log2 n) + 1 dispatches) and
+// gs_prefix_sum_lookback.comp (decoupled look-back, one dispatch). Headless: a compute queue is
+// all it needs, so it runs on a software driver, e.g. Mesa lavapipe:
+//
+//   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json GSPrefixScanBenchmark
+//
+//   GSPrefixScanBenchmark [--sizes n,n,...] [--repeats N] [--shaders dir] [--device name]
+//                         [--threads N] [--cpu-only]
+//
+// Inputs look like tile overlap counts (many culled splats, small counts otherwise). Every GPU
+// result is compared against std::inclusive_scan. A CPU model of the look-back scan, with one
+// partition per task and the same state encoding, runs first and is checked the same way. A last
+// input sums past 2^30 and must raise the look-back overflow flag. The exit code is non-zero on any
+// mismatch.
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // must match gs_prefix_sum_lookback.comp
+    constexpr uint32_t kWorkgroupSize = 256;
+    constexpr uint32_t kPartitionSize = kWorkgroupSize * 8;
+    constexpr uint32_t kFlagAggregate = 1u << 30;
+    constexpr uint32_t kFlagPrefix = 2u << 30;
+    constexpr uint32_t kValueMask = (1u << 30) - 1;
+
+    struct Options
+    {
+        std::vector<uint32_t> sizes{ 1, 255, 2048, 2049, 65537, 1000003, 6000000 };
+        int repeats = 5;
+        std::string shaderDir = "resources/compiled_shaders";
+        std::string device;
+        unsigned threads = 0;
+        bool cpuOnly = false;
+    };
+
+    struct LookbackResult
+    {
+        std::vector<uint32_t> values;
+        bool overflow = false;
+    };
+
+    struct Timing
+    {
+        double bestMs = 0.0;
+        double medianMs = 0.0;
+    };
+
+    std::vector<uint32_t> TileOverlaps(uint32_t n, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> culled(0.0f, 1.0f);
+        std::geometric_distribution<uint32_t> overlap(0.35);
+        std::vector<uint32_t> values(n);
+        for (uint32_t& v : values)
+            v = culled(rng) < 0.4f ? 0u : std::min(1u + overlap(rng), 64u);
+        return values;
+    }
+
+    std::vector<uint32_t> ReferenceScan(const std::vector<uint32_t>& input)
+    {
+        std::vector<uint32_t> output(input.size());
+        std::inclusive_scan(input.begin(), input.end(), output.begin());
+        return output;
+    }
+
+    // 3 full partitions of 2^29: the Hillis-Steele total still fits, the look-back one does not
+    std::vector<uint32_t> OverflowingOverlaps()
+    {
+        return std::vector<uint32_t>(3 * kPartitionSize, 1u << 18);
+    }
+
+    // gs_prefix_sum_lookback.comp on CPU threads: partitions are taken from a counter in order,
+    // each publishes its aggregate, then walks back until it meets an inclusive prefix.
+    LookbackResult LookbackScanModel(const std::vector<uint32_t>& input, unsigned threadCount)
+    {
+        const uint32_t n = uint32_t(input.size());
+        const uint32_t partitions = (n + kPartitionSize - 1) / kPartitionSize;
+        std::vector<uint32_t> output(n);
+        std::vector<std::atomic<uint32_t>> state(partitions);
+        for (auto& s : state)
+            s.store(0, std::memory_order_relaxed);
+        std::atomic<uint32_t> nextPartition{ 0 };
+        std::atomic<bool> overflow{ false };
+
+        const auto worker = [&]()
+        {
+            for (uint32_t p = nextPartition.fetch_add(1); p < partitions; p = nextPartition.fetch_add(1))
+            {
+                const uint32_t begin = p * kPartitionSize;
+                const uint32_t end = std::min(n, begin + kPartitionSize);
+                uint32_t aggregate = 0;
+                for (uint32_t i = begin; i < end; ++i)
+                    output[i] = aggregate += input[i];
+                bool overflowed = aggregate > kValueMask;
+                aggregate &= kValueMask;
+
+                uint32_t prefix = 0;
+                if (p == 0)
+                {
+                    state[0].store(kFlagPrefix | aggregate);
+                }
+                else
+                {
+                    state[p].store(kFlagAggregate | aggregate);
+                    for (uint32_t lookback = p - 1;; --lookback)
+                    {
+                        uint32_t s = state[lookback].load();
+                        while (s == 0)
+                        {
+                            std::this_thread::yield();
+                            s = state[lookback].load();
+                        }
+                        prefix += s & kValueMask;
+                        overflowed = overflowed || prefix > kValueMask;
+                        prefix &= kValueMask;
+                        if ((s & ~kValueMask) == kFlagPrefix)
+                            break;
+                    }
+                    overflowed = overflowed || prefix + aggregate > kValueMask;
+                    state[p].store(kFlagPrefix | ((prefix + aggregate) & kValueMask));
+                }
+                if (overflowed)
+                    overflow = true;
+                for (uint32_t i = begin; i < end; ++i)
+                    output[i] += prefix;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < threadCount; ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (std::thread& t : threads)
+            t.join();
+        return { std::move(output), overflow.load() };
+    }
+
+    // index of the first difference, or -1
+    int64_t FirstMismatch(const std::vector<uint32_t>& expected, const std::vector<uint32_t>& actual)
+    {
+        const auto it = std::mismatch(expected.begin(), expected.end(), actual.begin());
+        return it.first == expected.end() ? -1 : int64_t(it.first - expected.begin());
+    }
+
+    Timing Summarize(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return { samples.front(), samples[samples.size() / 2] };
+    }
+
+    void Check(VkResult result, const char* what)
+    {
+        if (result != VK_SUCCESS)
+            throw std::runtime_error(std::string(what) + " failed, VkResult " + std::to_string(int(result)));
+    }
+
+    struct Buffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+    };
+
+    class ComputeContext
+    {
+    public:
+        explicit ComputeContext(const std::string& deviceFilter)
+        {
+            VkApplicationInfo app{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
+            app.pApplicationName = "GSPrefixScanBenchmark";
+            app.apiVersion = VK_API_VERSION_1_1;
+            VkInstanceCreateInfo instanceInfo{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+            instanceInfo.pApplicationInfo = &app;
+            Check(vkCreateInstance(&instanceInfo, nullptr, &instance), "vkCreateInstance");
+
+            uint32_t count = 0;
+            vkEnumeratePhysicalDevices(instance, &count, nullptr);
+            std::vector<VkPhysicalDevice> devices(count);
+            vkEnumeratePhysicalDevices(instance, &count, devices.data());
+            for (VkPhysicalDevice candidate : devices)
+            {
+                vkGetPhysicalDeviceProperties(candidate, &properties);
+                if (deviceFilter.empty() || std::string(properties.deviceName).find(deviceFilter) != std::string::npos)
+                {
+                    physicalDevice = candidate;
+                    break;
+                }
+            }
+            if (physicalDevice == VK_NULL_HANDLE)
+                throw std::runtime_error("no Vulkan device" + (deviceFilter.empty() ? "" : " matching " + deviceFilter));
+
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, nullptr);
+            std::vector<VkQueueFamilyProperties> families(count);
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, families.data());
+            family = UINT32_MAX;
+            for (uint32_t i = 0; i < count && family == UINT32_MAX; ++i)
+            {
+                if (families[i].queueFlags & VK_QUEUE_COMPUTE_BIT)
+                    family = i;
+            }
+            if (family == UINT32_MAX)
+                throw std::runtime_error("device has no compute queue");
+            timestampBits = families[family].timestampValidBits;
+
+            const float priority = 1.0f;
+            VkDeviceQueueCreateInfo queueInfo{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            queueInfo.queueFamilyIndex = family;
+            queueInfo.queueCount = 1;
+            queueInfo.pQueuePriorities = &priority;
+            VkDeviceCreateInfo deviceInfo{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+            deviceInfo.queueCreateInfoCount = 1;
+            deviceInfo.pQueueCreateInfos = &queueInfo;
+            Check(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device), "vkCreateDevice");
+            vkGetDeviceQueue(device, family, 0, &queue);
+
+            VkCommandPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+            poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            poolInfo.queueFamilyIndex = family;
+            Check(vkCreateCommandPool(device, &poolInfo, nullptr, &commandPool), "vkCreateCommandPool");
+            VkCommandBufferAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+            allocInfo.commandPool = commandPool;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandBufferCount = 1;
+            Check(vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer), "vkAllocateCommandBuffers");
+            VkFenceCreateInfo fenceInfo{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+            Check(vkCreateFence(device, &fenceInfo, nullptr, &fence), "vkCreateFence");
+            VkQueryPoolCreateInfo queryInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+            queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            queryInfo.queryCount = 2;
+            Check(vkCreateQueryPool(device, &queryInfo, nullptr, &queryPool), "vkCreateQueryPool");
+        }
+
+        ~ComputeContext()
+        {
+            if (device != VK_NULL_HANDLE)
+            {
+                vkDeviceWaitIdle(device);
+                vkDestroyQueryPool(device, queryPool, nullptr);
+                vkDestroyFence(device, fence, nullptr);
+                vkDestroyCommandPool(device, commandPool, nullptr);
+                vkDestroyDevice(device, nullptr);
+            }
+            if (instance != VK_NULL_HANDLE)
+                vkDestroyInstance(instance, nullptr);
+        }
+
+        ComputeContext(const ComputeContext&) = delete;
+        ComputeContext& operator=(const ComputeContext&) = delete;
+
+        Buffer CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) const
+        {
+            Buffer b;
+            b.size = size;
+            VkBufferCreateInfo info{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+            info.size = size;
+            info.usage = usage;
+            Check(vkCreateBuffer(device, &info, nullptr, &b.buffer), "vkCreateBuffer");
+            VkMemoryRequirements requirements;
+            vkGetBufferMemoryRequirements(device, b.buffer, &requirements);
+            VkPhysicalDeviceMemoryProperties memory;
+            vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memory);
+            VkMemoryAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+            allocInfo.allocationSize = requirements.size;
+            allocInfo.memoryTypeIndex = UINT32_MAX;
+            for (uint32_t i = 0; i < memory.memoryTypeCount && allocInfo.memoryTypeIndex == UINT32_MAX; ++i)
+            {
+                if ((requirements.memoryTypeBits & (1u << i)) && (memory.memoryTypes[i].propertyFlags & properties) == properties)
+                    allocInfo.memoryTypeIndex = i;
+            }
+            if (allocInfo.memoryTypeIndex == UINT32_MAX)
+                throw std::runtime_error("no suitable memory type");
+            Check(vkAllocateMemory(device, &allocInfo, nullptr, &b.memory), "vkAllocateMemory");
+            Check(vkBindBufferMemory(device, b.buffer, b.memory, 0), "vkBindBufferMemory");
+            return b;
+        }
+
+        void DestroyBuffer(Buffer& b) const
+        {
+            vkDestroyBuffer(device, b.buffer, nullptr);
+            vkFreeMemory(device, b.memory, nullptr);
+            b = {};
+        }
+
+        VkShaderModule LoadShader(const std::string& path) const
+        {
+            std::ifstream file(path, std::ios::binary);
+            if (!file)
+                throw std::runtime_error("could not open " + path);
+            std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::vector<uint32_t> code((bytes.size() + 3) / 4);
+            std::memcpy(code.data(), bytes.data(), bytes.size());
+            VkShaderModuleCreateInfo info{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+            info.codeSize = bytes.size();
+            info.pCode = code.data();
+            VkShaderModule module = VK_NULL_HANDLE;
+            Check(vkCreateShaderModule(device, &info, nullptr, &module), "vkCreateShaderModule");
+            return module;
+        }
+
+        // records with the function, submits, waits; returns the GPU time between the two timestamps
+        // the function writes (or the CPU time around the submit if the queue has no timestamps)
+        template <typename Record>
+        double Submit(Record&& record) const
+        {
+            VkCommandBufferBeginInfo begin{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+            begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            Check(vkBeginCommandBuffer(commandBuffer, &begin), "vkBeginCommandBuffer");
+            vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
+            record(commandBuffer);
+            Check(vkEndCommandBuffer(commandBuffer), "vkEndCommandBuffer");
+            VkSubmitInfo submit{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+            submit.commandBufferCount = 1;
+            submit.pCommandBuffers = &commandBuffer;
+            const auto start = std::chrono::steady_clock::now();
+            Check(vkQueueSubmit(queue, 1, &submit, fence), "vkQueueSubmit");
+            Check(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX), "vkWaitForFences");
+            const double cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            vkResetFences(device, 1, &fence);
+            uint64_t timestamps[2]{};
+            if (timestampBits == 0
+                || vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(timestamps), timestamps, sizeof(uint64_t),
+                                         VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+                return cpuMs;
+            const uint64_t mask = timestampBits >= 64 ? ~0ull : (1ull << timestampBits) - 1;
+            return double((timestamps[1] - timestamps[0]) & mask) * properties.limits.timestampPeriod * 1e-6;
+        }
+
+        VkInstance instance = VK_NULL_HANDLE;
+        VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties properties{};
+        VkDevice device = VK_NULL_HANDLE;
+        VkQueue queue = VK_NULL_HANDLE;
+        uint32_t family = 0;
+        uint32_t timestampBits = 0;
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        VkQueryPool queryPool = VK_NULL_HANDLE;
+    };
+
+    struct ScanPipeline
+    {
+        VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+    };
+
+    ScanPipeline CreateScanPipeline(const ComputeContext& vk, const std::string& spvPath, uint32_t bindings, uint32_t pushBytes)
+    {
+        ScanPipeline p;
+        std::vector<VkDescriptorSetLayoutBinding> layoutBindings;
+        for (uint32_t i = 0; i < bindings; ++i)
+            layoutBindings.push_back({ i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr });
+        VkDescriptorSetLayoutCreateInfo setInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO };
+        setInfo.bindingCount = bindings;
+        setInfo.pBindings = layoutBindings.data();
+        Check(vkCreateDescriptorSetLayout(vk.device, &setInfo, nullptr, &p.setLayout), "vkCreateDescriptorSetLayout");
+        VkPushConstantRange push{ VK_SHADER_STAGE_COMPUTE_BIT, 0, pushBytes };
+        VkPipelineLayoutCreateInfo layoutInfo{ VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &p.setLayout;
+        layoutInfo.pushConstantRangeCount = pushBytes > 0 ? 1 : 0;
+        layoutInfo.pPushConstantRanges = &push;
+        Check(vkCreatePipelineLayout(vk.device, &layoutInfo, nullptr, &p.layout), "vkCreatePipelineLayout");
+        VkShaderModule module = vk.LoadShader(spvPath);
+        VkComputePipelineCreateInfo info{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+        info.stage = { VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_COMPUTE_BIT, module, "main", nullptr };
+        info.layout = p.layout;
+        const VkResult result = vkCreateComputePipelines(vk.device, VK_NULL_HANDLE, 1, &info, nullptr, &p.pipeline);
+        vkDestroyShaderModule(vk.device, module, nullptr);
+        Check(result, "vkCreateComputePipelines");
+        return p;
+    }
+
+    void DestroyScanPipeline(const ComputeContext& vk, ScanPipeline& p)
+    {
+        vkDestroyPipeline(vk.device, p.pipeline, nullptr);
+        vkDestroyPipelineLayout(vk.device, p.layout, nullptr);
+        vkDestroyDescriptorSetLayout(vk.device, p.setLayout, nullptr);
+    }
+
+    VkDescriptorSet AllocateSet(const ComputeContext& vk, VkDescriptorPool pool, const ScanPipeline& p, const std::vector<VkBuffer>& buffers)
+    {
+        VkDescriptorSetAllocateInfo allocInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        allocInfo.descriptorPool = pool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &p.setLayout;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        Check(vkAllocateDescriptorSets(vk.device, &allocInfo, &set), "vkAllocateDescriptorSets");
+        std::vector<VkDescriptorBufferInfo> infos;
+        for (VkBuffer b : buffers)
+            infos.push_back({ b, 0, VK_WHOLE_SIZE });
+        std::vector<VkWriteDescriptorSet> writes;
+        for (uint32_t i = 0; i < uint32_t(infos.size()); ++i)
+        {
+            VkWriteDescriptorSet write{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+            write.dstSet = set;
+            write.dstBinding = i;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = &infos[i];
+            writes.push_back(write);
+        }
+        vkUpdateDescriptorSets(vk.device, uint32_t(writes.size()), writes.data(), 0, nullptr);
+        return set;
+    }
+
+    void Barrier(VkCommandBuffer cmd, VkPipelineStageFlags src, VkAccessFlags srcAccess, VkPipelineStageFlags dst, VkAccessFlags dstAccess)
+    {
+        VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, srcAccess, dstAccess };
+        vkCmdPipelineBarrier(cmd, src, dst, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+
+    std::vector<uint32_t> Download(const ComputeContext& vk, const Buffer& source, const Buffer& staging)
+    {
+        vk.Submit([&](VkCommandBuffer cmd)
+        {
+            VkBufferCopy region{ 0, 0, source.size };
+            vkCmdCopyBuffer(cmd, source.buffer, staging.buffer, 1, &region);
+            Barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+        });
+        std::vector<uint32_t> values(source.size / sizeof(uint32_t));
+        void* mapped = nullptr;
+        Check(vkMapMemory(vk.device, staging.memory, 0, source.size, 0, &mapped), "vkMapMemory");
+        std::memcpy(values.data(), mapped, source.size);
+        vkUnmapMemory(vk.device, staging.memory);
+        return values;
+    }
+
+    void Report(const char* name, uint32_t n, uint32_t dispatches, const Timing& timing, int64_t mismatch)
+    {
+        const double gbPerSecond = double(n) * 2.0 * sizeof(uint32_t) / (timing.bestMs * 1e6);
+        std::cout << "  " << std::left << std::setw(20) << name << std::right << std::setw(6) << dispatches << " dispatches "
+                  << std::setw(10) << timing.bestMs << " ms best " << std::setw(10) << timing.medianMs << " ms median "
+                  << std::setw(8) << gbPerSecond << " GB/s  " << (mismatch < 0 ? "ok" : "MISMATCH at " + std::to_string(mismatch))
+                  << "\n";
+    }
+
+    // the look-back values are only meaningful without overflow, the flag must match either way
+    bool ReportLookback(const char* name, uint32_t n, uint32_t dispatches, const Timing& timing,
+                        const std::vector<uint32_t>& expected, const LookbackResult& result, bool expectOverflow)
+    {
+        const int64_t mismatch = expectOverflow ? -1 : FirstMismatch(expected, result.values);
+        Report(name, n, dispatches, timing, mismatch);
+        const bool flagOk = result.overflow == expectOverflow;
+        if (expectOverflow || !flagOk)
+        {
+            std::cout << "  " << std::left << std::setw(20) << "" << std::right << " overflow flag "
+                      << (result.overflow ? "set" : "clear") << (flagOk ? "" : ", MISMATCH") << "\n";
+        }
+        return mismatch < 0 && flagOk;
+    }
+
+    // runs both GPU scans on one input; returns false on a mismatch
+    bool RunGpu(const ComputeContext& vk, const ScanPipeline& hillis, const ScanPipeline& lookback, const Options& options,
+                const std::vector<uint32_t>& input, const std::vector<uint32_t>& expected, bool expectOverflow)
+    {
+        const uint32_t n = uint32_t(input.size());
+        const VkDeviceSize bytes = VkDeviceSize(n) * sizeof(uint32_t);
+        const uint32_t partitions = (n + kPartitionSize - 1) / kPartitionSize;
+        const VkBufferUsageFlags usage =
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        Buffer overlaps = vk.CreateBuffer(bytes, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Buffer ping = vk.CreateBuffer(bytes, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Buffer pong = vk.CreateBuffer(bytes, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        // partition counter, overflow flag, one word per partition
+        Buffer state = vk.CreateBuffer(sizeof(uint32_t) * (2 + partitions), usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        Buffer staging = vk.CreateBuffer(std::max(bytes, state.size), VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        void* mapped = nullptr;
+        Check(vkMapMemory(vk.device, staging.memory, 0, bytes, 0, &mapped), "vkMapMemory");
+        std::memcpy(mapped, input.data(), bytes);
+        vkUnmapMemory(vk.device, staging.memory);
+        vk.Submit([&](VkCommandBuffer cmd)
+        {
+            VkBufferCopy region{ 0, 0, bytes };
+            vkCmdCopyBuffer(cmd, staging.buffer, overlaps.buffer, 1, &region);
+        });
+
+        VkDescriptorPoolSize poolSize{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 8 };
+        VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+        poolInfo.maxSets = 2;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        Check(vkCreateDescriptorPool(vk.device, &poolInfo, nullptr, &pool), "vkCreateDescriptorPool");
+        // the same bindings GSComputeRenderer uses: ping/pong for Hillis-Steele, overlaps -> pong for look-back
+        const VkDescriptorSet hillisSet = AllocateSet(vk, pool, hillis, { ping.buffer, pong.buffer });
+        const VkDescriptorSet lookbackSet = AllocateSet(vk, pool, lookback, { overlaps.buffer, pong.buffer, state.buffer });
+
+        const uint32_t iters = uint32_t(std::ceil(std::log2(float(n))));
+        const uint32_t groups = (n + kWorkgroupSize - 1) / kWorkgroupSize;
+        std::vector<double> hillisMs, lookbackMs;
+        for (int r = 0; r < options.repeats; ++r)
+        {
+            hillisMs.push_back(vk.Submit([&](VkCommandBuffer cmd)
+            {
+                vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, vk.queryPool, 0);
+                VkBufferCopy region{ 0, 0, bytes };
+                vkCmdCopyBuffer(cmd, overlaps.buffer, ping.buffer, 1, &region);
+                Barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, hillis.pipeline);
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, hillis.layout, 0, 1, &hillisSet, 0, nullptr);
+                for (uint32_t t = 0; t <= iters; ++t)
+                {
+                    vkCmdPushConstants(cmd, hillis.layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &t);
+                    vkCmdDispatch(cmd, groups, 1, 1);
+                    Barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+                }
+                vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, vk.queryPool, 1);
+            }));
+        }
+        const int64_t hillisMismatch = FirstMismatch(expected, Download(vk, ping, staging));
+        Report("hillis-steele", n, iters + 1, Summarize(hillisMs), hillisMismatch);
+
+        vk.Submit([&](VkCommandBuffer cmd) { vkCmdFillBuffer(cmd, pong.buffer, 0, VK_WHOLE_SIZE, 0); });
+        for (int r = 0; r < options.repeats; ++r)
+        {
+            lookbackMs.push_back(vk.Submit([&](VkCommandBuffer cmd)
+            {
+                vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, vk.queryPool, 0);
+                vkCmdFillBuffer(cmd, state.buffer, 0, VK_WHOLE_SIZE, 0);
+                Barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lookback.pipeline);
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, lookback.layout, 0, 1, &lookbackSet, 0, nullptr);
+                vkCmdDispatch(cmd, partitions, 1, 1);
+                vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, vk.queryPool, 1);
+            }));
+        }
+        LookbackResult gpuResult{ Download(vk, pong, staging), Download(vk, state, staging)[1] != 0 };
+        const bool lookbackOk =
+            ReportLookback("decoupled look-back", n, 1, Summarize(lookbackMs), expected, gpuResult, expectOverflow);
+
+        vkDestroyDescriptorPool(vk.device, pool, nullptr);
+        for (Buffer* b : { &overlaps, &ping, &pong, &state, &staging })
+            vk.DestroyBuffer(*b);
+        return hillisMismatch < 0 && lookbackOk;
+    }
+
+    Options ParseOptions(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            if (arg == "--sizes" && i + 1 < argc)
+            {
+                options.sizes.clear();
+                std::stringstream list(argv[++i]);
+                for (std::string item; std::getline(list, item, ',');)
+                    options.sizes.push_back(uint32_t(std::max(1l, std::atol(item.c_str()))));
+            }
+            else if (arg == "--repeats" && i + 1 < argc) options.repeats = std::max(1, std::atoi(argv[++i]));
+            else if (arg == "--shaders" && i + 1 < argc) options.shaderDir = argv[++i];
+            else if (arg == "--device" && i + 1 < argc) options.device = argv[++i];
+            else if (arg == "--threads" && i + 1 < argc) options.threads = unsigned(std::max(0, std::atoi(argv[++i])));
+            else if (arg == "--cpu-only") options.cpuOnly = true;
+            else
+                std::cout << "ignoring argument " << arg << std::endl;
+        }
+        if (options.threads == 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        return options;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const Options options = ParseOptions(argc, argv);
+    bool ok = true;
+    try
+    {
+        std::unique_ptr<ComputeContext> vk;
+        ScanPipeline hillis, lookback;
+        if (!options.cpuOnly)
+        {
+            vk = std::make_unique<ComputeContext>(options.device);
+            std::cout << "device: " << vk->properties.deviceName << (vk->timestampBits ? "" : " (no timestamps, CPU timing)")
+                      << "\n";
+            hillis = CreateScanPipeline(*vk, options.shaderDir + "/gs_prefix_sum_comp.spv", 2, sizeof(uint32_t));
+            lookback = CreateScanPipeline(*vk, options.shaderDir + "/gs_prefix_sum_lookback_comp.spv", 3, 0);
+        }
+        std::cout << std::fixed << std::setprecision(3);
+        const auto runCase = [&](const std::vector<uint32_t>& input, bool expectOverflow)
+        {
+            const uint32_t n = uint32_t(input.size());
+            const auto start = std::chrono::steady_clock::now();
+            const std::vector<uint32_t> expected = ReferenceScan(input);
+            const double referenceMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << n << " elements, total " << expected.back() << "\n";
+            Report("cpu reference", n, 0, { referenceMs, referenceMs }, -1);
+
+            std::vector<double> modelMs;
+            LookbackResult model;
+            bool modelOk = true;
+            for (int r = 0; r < options.repeats; ++r)
+            {
+                const auto modelStart = std::chrono::steady_clock::now();
+                model = LookbackScanModel(input, options.threads);
+                modelMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - modelStart).count());
+                modelOk &= model.overflow == expectOverflow && (expectOverflow || FirstMismatch(expected, model.values) < 0);
+            }
+            // the report shows the last repeat, an earlier failing one still fails the run
+            ok &= ReportLookback("cpu look-back model", n, 0, Summarize(modelMs), expected, model, expectOverflow) && modelOk;
+
+            if (vk)
+                ok &= RunGpu(*vk, hillis, lookback, options, input, expected, expectOverflow);
+        };
+        for (uint32_t n : options.sizes)
+            runCase(TileOverlaps(n, n), false);
+        runCase(OverflowingOverlaps(), true);
+        if (vk)
+        {
+            DestroyScanPipeline(*vk, hillis);
+            DestroyScanPipeline(*vk, lookback);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << std::endl;
+        return 2;
+    }
+    std::cout << (ok ? "all scans match the reference" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
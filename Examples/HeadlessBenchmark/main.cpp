@@ -0,0 +1,488 @@
+// Offscreen benchmark of the OpenGL multi-pass pipeline, for machines without a display or GPU
+// (Mesa llvmpipe works). Renders a sandbox scene through OpenGLRenderer and RenderPassManager
+// on an EGL pbuffer while the camera orbits the scene once, then writes frame-time percentiles,
+// per-pass CPU / GPU timings and the last frame's RenderStats as JSON.
+//
+//   HeadlessBenchmark [--frames N] [--warmup N] [--width W] [--height H]
+//                     [--scene instancing|shadow] [--json file] [--png file] [--verbose]
+//
+// Every run renders the same frames, so the --png image of the last frame can be diffed
+// against a reference. Frame time includes glFinish, there is no swap to pace the GPU.
+#define EGL_NO_X11  // keep Xlib macros (None, Bool, ...) out of the engine headers
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "framework/Renderer.h"
+#include "framework/RenderPassManager.h"
+#include "framework/RenderPass.h"
+#include "framework/Profiler.h"
+#include "framework/RenderContext.h"
+#include "sandbox/Sandbox_InstancingDemo.h"
+#include "sandbox/Sandbox_ShadowRenderingDemo.h"
+#include "materials/BlitMaterial.h"
+#include "RenderView.h"
+#include "Camera.h"
+#include "Light.h"
+
+namespace
+{
+    struct Options
+    {
+        int frames = 300;
+        int warmup = 30;
+        int width = 1280;
+        int height = 720;
+        std::string scene = "instancing";
+        std::string jsonPath = "headless_benchmark.json";
+        std::string pngPath;
+        bool verbose = false;
+    };
+
+    // swallows the per-pass logging of the render loop
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--frames") options.frames = std::atoi(next());
+            else if (arg == "--warmup") options.warmup = std::atoi(next());
+            else if (arg == "--width") options.width = std::atoi(next());
+            else if (arg == "--height") options.height = std::atoi(next());
+            else if (arg == "--scene") options.scene = next();
+            else if (arg == "--json") options.jsonPath = next();
+            else if (arg == "--png") options.pngPath = next();
+            else if (arg == "--verbose") options.verbose = true;
+            else
+            {
+                std::cerr << "unknown option " << arg << std::endl;
+                return false;
+            }
+        }
+        return options.frames > 0 && options.warmup >= 0 && options.width > 0 && options.height > 0;
+    }
+
+    struct HeadlessContext
+    {
+        EGLDisplay display = EGL_NO_DISPLAY;
+        EGLSurface surface = EGL_NO_SURFACE;
+        EGLContext context = EGL_NO_CONTEXT;
+        const char* platform = "default";
+
+        ~HeadlessContext()
+        {
+            if (display == EGL_NO_DISPLAY)
+                return;
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (context != EGL_NO_CONTEXT)
+                eglDestroyContext(display, context);
+            if (surface != EGL_NO_SURFACE)
+                eglDestroySurface(display, surface);
+            eglTerminate(display);
+        }
+    };
+
+    EGLDisplay OpenDisplay(const char*& platform)
+    {
+        // a display server if there is one, else Mesa's surfaceless platform (no X / Wayland / DRM needed)
+        EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+        {
+            platform = "default";
+            return display;
+        }
+
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (!getPlatformDisplay)
+            return EGL_NO_DISPLAY;
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+            return EGL_NO_DISPLAY;
+        platform = "surfaceless";
+        return display;
+    }
+
+    bool CreateHeadlessContext(HeadlessContext& headless, int width, int height)
+    {
+        headless.display = OpenDisplay(headless.platform);
+        if (headless.display == EGL_NO_DISPLAY)
+        {
+            std::cerr << "no EGL display" << std::endl;
+            return false;
+        }
+
+        // a pbuffer gives the passes a default framebuffer to present into
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+            EGL_NONE
+        };
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(headless.display, configAttribs, &config, 1, &configCount) || configCount == 0)
+        {
+            std::cerr << "no EGL config with pbuffer + desktop GL" << std::endl;
+            return false;
+        }
+
+        const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+        headless.surface = eglCreatePbufferSurface(headless.display, config, surfaceAttribs);
+        if (headless.surface == EGL_NO_SURFACE)
+        {
+            std::cerr << "eglCreatePbufferSurface failed: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+            return false;
+        }
+
+        // the render graph needs glMemoryBarrier (4.2); take the newest core profile offered
+        eglBindAPI(EGL_OPENGL_API);
+        const std::array<std::array<EGLint, 2>, 3> versions = { { { 4, 6 }, { 4, 5 }, { 4, 3 } } };
+        for (const auto& version : versions)
+        {
+            const EGLint contextAttribs[] = {
+                EGL_CONTEXT_MAJOR_VERSION, version[0],
+                EGL_CONTEXT_MINOR_VERSION, version[1],
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+            };
+            headless.context = eglCreateContext(headless.display, config, EGL_NO_CONTEXT, contextAttribs);
+            if (headless.context != EGL_NO_CONTEXT)
+                break;
+        }
+        if (headless.context == EGL_NO_CONTEXT)
+        {
+            std::cerr << "no OpenGL 4.3+ core context" << std::endl;
+            return false;
+        }
+
+        if (!eglMakeCurrent(headless.display, headless.surface, headless.surface, headless.context))
+        {
+            std::cerr << "eglMakeCurrent failed" << std::endl;
+            return false;
+        }
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)))
+        {
+            std::cerr << "Failed to initialize GLAD" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // ---- minimal PNG writer: RGBA8, stored (uncompressed) deflate blocks ----
+
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+    {
+        static const auto table = [] {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                t[n] = c;
+            }
+            return t;
+        }();
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void PutBigEndian(std::vector<uint8_t>& out, uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out.push_back(uint8_t(value >> shift));
+    }
+
+    void WriteChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& data)
+    {
+        std::vector<uint8_t> chunk;
+        PutBigEndian(chunk, uint32_t(data.size()));
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        PutBigEndian(chunk, Crc32(chunk.data() + 4, chunk.size() - 4));
+        file.write(reinterpret_cast<const char*>(chunk.data()), std::streamsize(chunk.size()));
+    }
+
+    // rows are bottom-up as glReadPixels returns them
+    bool WritePng(const std::string& path, int width, int height, const std::vector<uint8_t>& rgba)
+    {
+        std::ofstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+        const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+        std::vector<uint8_t> header;
+        PutBigEndian(header, uint32_t(width));
+        PutBigEndian(header, uint32_t(height));
+        header.insert(header.end(), { 8, 6, 0, 0, 0 });  // 8 bit RGBA, no interlace
+        WriteChunk(file, "IHDR", header);
+
+        // scanlines top-down, each with filter type 0
+        const size_t rowBytes = size_t(width) * 4;
+        std::vector<uint8_t> raw;
+        raw.reserve((rowBytes + 1) * height);
+        for (int y = height - 1; y >= 0; --y)
+        {
+            raw.push_back(0);
+            raw.insert(raw.end(), rgba.begin() + y * rowBytes, rgba.begin() + (y + 1) * rowBytes);
+        }
+
+        std::vector<uint8_t> zlib = { 0x78, 0x01 };
+        for (size_t offset = 0; offset < raw.size(); offset += 65535)
+        {
+            const size_t size = std::min<size_t>(65535, raw.size() - offset);
+            zlib.push_back(offset + size >= raw.size() ? 1 : 0);
+            zlib.insert(zlib.end(), { uint8_t(size), uint8_t(size >> 8), uint8_t(~size), uint8_t(~size >> 8) });
+            zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+        }
+        uint32_t a = 1, b = 0;
+        for (uint8_t byte : raw)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        PutBigEndian(zlib, (b << 16) | a);
+        WriteChunk(file, "IDAT", zlib);
+        WriteChunk(file, "IEND", {});
+        return bool(file);
+    }
+
+    // ---- scene ----
+
+    std::unique_ptr<ISandbox> CreateScene(const std::string& name)
+    {
+        if (name == "instancing")
+            return std::make_unique<Sandbox_InstancingDemo>();
+        if (name == "shadow")
+            return std::make_unique<Sandbox_ShadowRenderingDemo>();
+        return nullptr;
+    }
+
+    // same passes as the TinyRenderer host, compiled into the render graph
+    void SetupPasses(const std::shared_ptr<RenderView>& view, const std::shared_ptr<RenderContext>& context)
+    {
+        auto shadowPass = std::make_shared<te::ShadowPass>();
+        shadowPass->Initialize(view, context);
+        auto skyboxPass = std::make_shared<te::SkyboxPass>();
+        skyboxPass->Initialize(view, context);
+        auto geometryPass = std::make_shared<te::GeometryPass>();
+        geometryPass->Initialize(view, context);
+        auto basePass = std::make_shared<te::BasePass>();
+        basePass->Initialize(view, context);
+        auto postProcessPass = std::make_shared<te::PostProcessPass>();
+        postProcessPass->Initialize(view, context);
+        postProcessPass->AddEffect("Blit", std::make_shared<BlitMaterial>());
+
+        auto& passManager = te::RenderPassManager::GetInstance();
+        passManager.AddPass(shadowPass);
+        passManager.AddPass(skyboxPass);
+        passManager.AddPass(geometryPass);
+        passManager.AddPass(basePass);
+        passManager.AddPass(postProcessPass);
+        passManager.EnableRenderGraph(true);
+    }
+
+    // one orbit over the measured frames; warmup frames continue the path backwards
+    void PlaceCamera(Camera& camera, int frame, int frames)
+    {
+        const float angle = 6.2831853f * float(frame) / float(frames);
+        camera.SetLookAt(12.0f * std::cos(angle), 6.0f, 12.0f * std::sin(angle),
+                         0.0f, 0.0f, 0.0f,
+                         0.0f, 1.0f, 0.0f);
+    }
+
+    // nearest rank
+    double Percentile(const std::vector<double>& sorted, double percent)
+    {
+        const size_t rank = size_t(std::ceil(percent / 100.0 * double(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+    bool WriteReport(const Options& options, const char* platform, const std::vector<double>& frameMs,
+                     const RenderStats& stats)
+    {
+        std::ofstream out(options.jsonPath);
+        if (!out)
+            return false;
+
+        std::vector<double> sorted = frameMs;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double ms : sorted)
+            total += ms;
+
+        auto quoted = [](const char* text) { return std::string("\"") + (text ? text : "") + "\""; };
+        out << std::fixed << std::setprecision(4);
+        out << "{\n";
+        out << "  \"config\": { \"scene\": " << quoted(options.scene.c_str())
+            << ", \"width\": " << options.width << ", \"height\": " << options.height
+            << ", \"frames\": " << options.frames << ", \"warmup\": " << options.warmup
+            << ", \"egl\": " << quoted(platform)
+            << ", \"glRenderer\": " << quoted(reinterpret_cast<const char*>(glGetString(GL_RENDERER)))
+            << ", \"glVersion\": " << quoted(reinterpret_cast<const char*>(glGetString(GL_VERSION))) << " },\n";
+        out << "  \"frameTimeMs\": { \"mean\": " << total / double(sorted.size())
+            << ", \"min\": " << sorted.front()
+            << ", \"p50\": " << Percentile(sorted, 50.0)
+            << ", \"p95\": " << Percentile(sorted, 95.0)
+            << ", \"p99\": " << Percentile(sorted, 99.0)
+            << ", \"max\": " << sorted.back() << " },\n";
+
+        out << "  \"passes\": [";
+        const std::vector<te::PassTiming> passes = te::Profiler::GetInstance().GetPassTimings();
+        for (size_t i = 0; i < passes.size(); ++i)
+        {
+            out << (i ? ",\n" : "\n") << "    { \"name\": " << quoted(passes[i].name.c_str())
+                << ", \"cpuMs\": " << passes[i].cpuMs << ", \"gpuMs\": ";
+            if (passes[i].hasGpu)
+                out << passes[i].gpuMs;
+            else
+                out << "null";
+            out << " }";
+        }
+        out << "\n  ],\n";
+
+        out << "  \"renderStats\": { \"drawCalls\": " << stats.drawCalls
+            << ", \"instances\": " << stats.instances
+            << ", \"triangles\": " << stats.triangles
+            << ", \"vertices\": " << stats.vertices
+            << ", \"stateChangesAvoided\": " << stats.stateChangesAvoided
+            << ", \"geometryBytesCopied\": " << stats.geometryBytesCopied
+            << ", \"frameAllocations\": " << stats.frameAllocations
+            << ", \"frameAllocatedBytes\": " << stats.frameAllocatedBytes
+            << ", \"frameHeapAllocations\": " << stats.frameHeapAllocations << " }\n";
+        out << "}\n";
+        return bool(out);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: HeadlessBenchmark [--frames N] [--warmup N] [--width W] [--height H]"
+                     " [--scene instancing|shadow] [--json file] [--png file] [--verbose]" << std::endl;
+        return 2;
+    }
+
+    HeadlessContext headless;
+    if (!CreateHeadlessContext(headless, options.width, options.height))
+        return 1;
+    std::cout << "EGL " << headless.platform << ": " << glGetString(GL_RENDERER)
+              << " (" << glGetString(GL_VERSION) << ")" << std::endl;
+
+    auto scene = CreateScene(options.scene);
+    if (!scene)
+    {
+        std::cerr << "unknown scene " << options.scene << std::endl;
+        return 2;
+    }
+
+    std::shared_ptr<IRenderer> renderer = RendererFactory::CreateRenderer(RendererBackend::OpenGL);
+    if (!renderer || !renderer->Initialize())
+    {
+        std::cerr << "Failed to initialize renderer" << std::endl;
+        return 1;
+    }
+
+    auto view = std::make_shared<RenderView>(options.width, options.height);
+    auto context = std::make_shared<RenderContext>();
+    renderer->SetRenderContext(context);
+
+    auto camera = std::make_shared<Camera>(glm::vec3(0.0f, 0.0f, 3.0f));
+    camera->SetAspectRatio(float(options.width) / float(options.height));
+    context->AttachCamera(camera);
+
+    auto light = std::make_shared<Light>();
+    light->SetPosition(glm::vec3(2.0f, 2.0f, 2.0f));
+    light->SetColor(glm::vec3(1.0f, 1.0f, 1.0f));
+    light->SetDirection(glm::normalize(glm::vec3(-0.5f, -1.0f, -0.3f)));
+    context->PushAttachLight(light);
+
+    scene->Init(renderer);
+    SetupPasses(view, context);
+    renderer->SetMultiPassEnabled(true);
+    te::Profiler::GetInstance().SetEnabled(true);
+
+    NullBuffer nullBuffer;
+    std::streambuf* coutBuffer = options.verbose ? nullptr : std::cout.rdbuf(&nullBuffer);
+
+    std::vector<RenderCommand> commands;
+    std::vector<double> frameMs;
+    frameMs.reserve(options.frames);
+    RenderStats lastStats;
+    for (int frame = -options.warmup; frame < options.frames; ++frame)
+    {
+        PlaceCamera(*camera, frame, options.frames);
+        scene->Update(renderer);
+        commands.clear();
+        scene->CollectRenderCommands(commands);
+
+        const auto start = std::chrono::steady_clock::now();
+        renderer->BeginFrame();
+        renderer->SetViewport(0, 0, options.width, options.height);
+        renderer->SetClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        renderer->Clear(0x3);
+        te::RenderPassManager::GetInstance().ExecuteAll(commands);
+        renderer->EndFrame();
+        glFinish();
+        const auto end = std::chrono::steady_clock::now();
+
+        if (frame >= 0)
+            frameMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        lastStats = renderer->GetRenderStats();
+    }
+
+    if (coutBuffer)
+        std::cout.rdbuf(coutBuffer);
+
+    bool ok = WriteReport(options, headless.platform, frameMs, lastStats);
+    std::cout << (ok ? "wrote " : "failed to write ") << options.jsonPath << std::endl;
+
+    if (!options.pngPath.empty())
+    {
+        std::vector<uint8_t> pixels(size_t(options.width) * options.height * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, options.width, options.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        const bool pngOk = WritePng(options.pngPath, options.width, options.height, pixels);
+        std::cout << (pngOk ? "wrote " : "failed to write ") << options.pngPath << std::endl;
+        ok = ok && pngOk;
+    }
+
+    std::sort(frameMs.begin(), frameMs.end());
+    std::cout << std::fixed << std::setprecision(3) << "frame ms  p50 " << Percentile(frameMs, 50.0)
+              << "  p95 " << Percentile(frameMs, 95.0) << "  p99 " << Percentile(frameMs, 99.0) << std::endl;
+
+    scene->Teardown(renderer);
+    te::RenderPassManager::GetInstance().Clear();
+    renderer->Shutdown();
+    return ok ? 0 : 1;
+}
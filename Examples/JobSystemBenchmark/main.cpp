@@ -0,0 +1,160 @@
+// Scaling benchmark of te::JobSystem from 1 to N cores (N - 1 workers plus the calling thread).
+// Needs no GL context.
+//
+//   JobSystemBenchmark [maxCores] [repeats]
+//
+// bounds:    toAabb over a 4M vertex mesh, the parallel path of GeometryItem::GetAABB
+// transform: ParallelFor over 2M points with a few hundred flops each, no shared state
+// graph:     256 jobs per stage, 8 stages, every stage waits for the previous one through a JobCounter
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include "framework/JobSystem.h"
+#include "mesh/AaBB.h"
+#include "mesh/Vertex.h"
+
+namespace
+{
+    struct Result
+    {
+        const char* label;
+        double ms;
+    };
+
+    template <typename Function>
+    double BestOf(int repeats, Function&& function)
+    {
+        double best = 1e30;
+        for (int i = 0; i < repeats; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    std::vector<Vertex> MakeVertices(size_t count)
+    {
+        std::vector<Vertex> vertices(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float t = float(i) * 0.001f;
+            vertices[i].position = glm::vec3(std::sin(t) * 10.0f, std::cos(t * 0.7f) * 5.0f, t * 0.01f);
+        }
+        return vertices;
+    }
+
+    void RunBounds(const std::vector<Vertex>& vertices, te::AaBB& out)
+    {
+        te::toAabb(out, vertices.data(), uint32_t(vertices.size()), sizeof(Vertex), 0);
+    }
+
+    void RunTransform(const std::vector<glm::vec4>& input, std::vector<glm::vec4>& output)
+    {
+        te::JobSystem::GetInstance().ParallelFor(input.size(), 4096, [&](size_t begin, size_t end) {
+            glm::mat4 m(1.0f);
+            m[3] = glm::vec4(0.5f, 0.25f, 0.125f, 1.0f);
+            for (size_t i = begin; i < end; ++i)
+            {
+                glm::vec4 p = input[i];
+                for (int k = 0; k < 16; ++k)
+                {
+                    p = m * p;
+                    p.w = 1.0f;
+                }
+                output[i] = p;
+            }
+        });
+    }
+
+    void RunGraph(std::vector<double>& cells)
+    {
+        constexpr int kStages = 8;
+        constexpr size_t kJobsPerStage = 256;
+        const size_t cellsPerJob = cells.size() / kJobsPerStage;
+
+        te::JobSystem& jobs = te::JobSystem::GetInstance();
+        te::JobCounter stages[kStages];
+        for (int stage = 0; stage < kStages; ++stage)
+        {
+            const te::JobCounter* dependency = stage > 0 ? &stages[stage - 1] : nullptr;
+            for (size_t job = 0; job < kJobsPerStage; ++job)
+            {
+                jobs.Run([&cells, job, cellsPerJob, stage]() {
+                    for (size_t i = job * cellsPerJob; i < (job + 1) * cellsPerJob; ++i)
+                    {
+                        cells[i] = std::sqrt(cells[i] + double(stage)) * 1.0001;
+                    }
+                }, &stages[stage], dependency);
+            }
+        }
+        // the last stage implies all the others, but every counter must be quiet before it goes away
+        for (te::JobCounter& stage : stages)
+        {
+            jobs.Wait(stage);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned maxCores = argc > 1 ? std::max(1, std::atoi(argv[1])) : hardwareThreads;
+    const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+    std::cout << "hardware threads: " << hardwareThreads << ", measuring 1.." << maxCores << " cores, best of "
+              << repeats << std::endl;
+
+    const std::vector<Vertex> vertices = MakeVertices(4u << 20);
+    std::vector<glm::vec4> points(2u << 20, glm::vec4(1.0f));
+    std::vector<glm::vec4> transformed(points.size());
+    std::vector<double> cells(256 * 4096, 1.0);
+
+    std::vector<std::vector<Result>> rows;
+    for (unsigned cores = 1; cores <= maxCores; ++cores)
+    {
+        te::JobSystem& jobs = te::JobSystem::GetInstance();
+        jobs.Stop();
+        if (cores > 1)
+        {
+            jobs.Start(cores - 1);
+        }
+
+        te::AaBB bounds;
+        std::vector<Result> row;
+        row.push_back({ "bounds", BestOf(repeats, [&]() { RunBounds(vertices, bounds); }) });
+        row.push_back({ "transform", BestOf(repeats, [&]() { RunTransform(points, transformed); }) });
+        row.push_back({ "graph", BestOf(repeats, [&]() { RunGraph(cells); }) });
+        rows.push_back(row);
+
+        // keep the results alive
+        if (bounds.max.x < bounds.min.x || transformed[0].w != 1.0f || cells[0] < 0.0)
+            std::cout << "unexpected result" << std::endl;
+    }
+    te::JobSystem::GetInstance().Stop();
+
+    std::cout << std::left << std::setw(7) << "cores";
+    for (const Result& result : rows[0])
+    {
+        std::cout << std::right << std::setw(12) << result.label << std::setw(9) << "speedup";
+    }
+    std::cout << std::endl;
+    for (size_t cores = 0; cores < rows.size(); ++cores)
+    {
+        std::cout << std::left << std::setw(7) << cores + 1 << std::right << std::fixed;
+        for (size_t i = 0; i < rows[cores].size(); ++i)
+        {
+            std::cout << std::setprecision(2) << std::setw(9) << rows[cores][i].ms << " ms"
+                      << std::setw(8) << rows[0][i].ms / rows[cores][i].ms << "x";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
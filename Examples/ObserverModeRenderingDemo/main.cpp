@@ -162,7 +162,9 @@ private:
         const auto& stats = mpGLRenderer->GetRenderStats();
         std::cout << "\rDraw Calls: " << stats.drawCalls 
                   << " | Triangles: " << stats.triangles 
-                  << " | Vertices: " << stats.vertices << std::flush;
+                  << " | Vertices: " << stats.vertices
+                  << " | Bytes Copied: " << stats.geometryBytesCopied
+                  << " | Binds Avoided: " << stats.stateChangesAvoided << std::flush;
     }
 
 private:
@@ -0,0 +1,173 @@
+// Contention benchmark of the main thread -> render thread command hand-off.
+// A producer thread publishes frames of N commands while a consumer thread takes them, both running
+// flat out so the two sides overlap the way they do when the render thread lags behind.
+// Needs no GL context.
+//
+//   RenderCommandQueueBenchmark [frames]
+//
+// frame copy: building the frame's command list only (GetSceneRenderCommands), the floor for both
+// mutex:      the previous std::queue + mutex + condition variable, PushCommands copies, one lock per pop
+// spsc ring:  RenderCommandQueue, one publish per push batch and one release per drain
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+#include "Fragment.h"
+#include "framework/RenderCommandQueue.h"
+
+namespace
+{
+    // the queue RenderCommandQueue used before, kept here as the baseline
+    class MutexCommandQueue
+    {
+    public:
+        void PushCommands(const std::vector<RenderCommand>& commands)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto& cmd : commands)
+            {
+                mCommands.push(cmd);
+            }
+            mCondition.notify_one();
+        }
+
+        std::optional<RenderCommand> PopCommand()
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mCommands.empty())
+            {
+                return std::nullopt;
+            }
+
+            RenderCommand cmd = mCommands.front();
+            mCommands.pop();
+            return cmd;
+        }
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+        std::queue<RenderCommand> mCommands;
+    };
+
+    // a scene of `count` draws over a few hundred distinct fragment sources, like instanced props
+    std::vector<RenderCommand> MakeScene(size_t count)
+    {
+        std::vector<std::shared_ptr<FragmentsSource>> sources(256);
+        for (auto& source : sources)
+        {
+            source = std::make_shared<FragmentsSource>();
+        }
+
+        std::vector<RenderCommand> commands(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            commands[i].fragmentsSource = sources[i % sources.size()];
+            commands[i].renderpassflag = RenderPassFlag::BaseColor;
+        }
+        return commands;
+    }
+
+    template <typename Producer, typename Consumer>
+    double RunFrames(int frames, Producer&& produce, Consumer&& consume)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::thread producer([&]() {
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                produce();
+            }
+        });
+        std::thread consumer([&]() {
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                consume();
+            }
+        });
+        producer.join();
+        consumer.join();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void Report(const char* label, double totalMs, int frames, size_t commandsPerFrame)
+    {
+        const double perFrameMs = totalMs / frames;
+        const double millionsPerSecond = double(commandsPerFrame) * frames / (totalMs * 1000.0);
+        std::cout << "  " << std::left << std::setw(11) << label << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << perFrameMs << " ms/frame" << std::setprecision(1)
+                  << std::setw(10) << millionsPerSecond << " Mcmd/s" << std::endl;
+    }
+
+    void RunCase(size_t commandsPerFrame, int frames)
+    {
+        const std::vector<RenderCommand> scene = MakeScene(commandsPerFrame);
+        std::cout << commandsPerFrame << " commands/frame, " << frames << " frames" << std::endl;
+
+        const double copyMs = RunFrames(frames,
+            [&]() { std::vector<RenderCommand> commands = scene; },
+            []() {});
+        Report("frame copy", copyMs, frames, commandsPerFrame);
+
+        MutexCommandQueue mutexQueue;
+        const double mutexMs = RunFrames(frames,
+            [&]() {
+                const std::vector<RenderCommand> commands = scene;
+                mutexQueue.PushCommands(commands);
+            },
+            [&]() {
+                std::vector<RenderCommand> commands;
+                commands.reserve(commandsPerFrame);
+                while (commands.size() < commandsPerFrame)
+                {
+                    if (auto cmd = mutexQueue.PopCommand())
+                        commands.push_back(*cmd);
+                    else
+                        std::this_thread::yield();
+                }
+            });
+        Report("mutex", mutexMs, frames, commandsPerFrame);
+
+        // default capacity: the 100k case wraps around the ring while the consumer drains it
+        RenderCommandQueue ring;
+        std::vector<RenderCommand> drained;
+        const double ringMs = RunFrames(frames,
+            [&]() {
+                std::vector<RenderCommand> commands = scene;
+                for (size_t pushed = 0; pushed < commands.size();)
+                {
+                    const size_t count = ring.PushCommands(commands, pushed);
+                    if (count == 0)
+                        std::this_thread::yield();  // ring full, let the consumer catch up
+                    pushed += count;
+                }
+            },
+            [&]() {
+                drained.clear();
+                while (drained.size() < commandsPerFrame)
+                {
+                    if (ring.DrainCommands(drained, commandsPerFrame - drained.size()) == 0)
+                        std::this_thread::yield();
+                }
+            });
+        Report("spsc ring", ringMs, frames, commandsPerFrame);
+
+        std::cout << "  ring speedup over mutex: " << std::setprecision(2) << mutexMs / ringMs << "x"
+                  << " (capacity " << ring.Capacity() << ")" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 100;
+    RunCase(10000, frames);
+    RunCase(100000, frames);
+    return 0;
+}
@@ -158,7 +158,9 @@ private:
         const auto& stats = mpRenderer->GetRenderStats();
         std::cout << "\rDraw Calls: " << stats.drawCalls 
                   << " | Triangles: " << stats.triangles 
-                  << " | Vertices: " << stats.vertices << std::flush;
+                  << " | Vertices: " << stats.vertices
+                  << " | Bytes Copied: " << stats.geometryBytesCopied
+                  << " | Binds Avoided: " << stats.stateChangesAvoided << std::flush;
     }
 
 private:
@@ -1,13 +1,24 @@
 #include "GaussianSplat/GSRenderDemoApp.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <string>
 
+// VK_GSRenderDemo [scene.ply|scene.gts] [--sh-degree N]
 int main(int argc, char** argv) {
     std::string plyPath;
-    if (argc > 1) {
-        plyPath = argv[1];
+    uint32_t maxShDegree = 3;
+    // the look-back scan is not exposed until GSPrefixScanBenchmark has validated it on a Vulkan driver
+    const GSPrefixScan prefixScan = GSPrefixScan::HillisSteele;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--sh-degree" && i + 1 < argc) {
+            maxShDegree = static_cast<uint32_t>(std::clamp(std::atoi(argv[++i]), 0, 3));
+        } else {
+            plyPath = arg;
+        }
     }
     if (plyPath.empty()) {
         const std::string defaultRel = "Examples/VK_GSRenderDemo/assets/cloudpoints/sample_robot.ply";
@@ -20,7 +31,7 @@ int main(int argc, char** argv) {
     }
     GSRenderDemoApp demo;
     try {
-        if (!demo.initialize(plyPath)) {
+        if (!demo.initialize(plyPath, maxShDegree, prefixScan)) {
             std::cerr << "Failed to initialize VK_GSRenderDemo." << std::endl;
             return -1;
         }
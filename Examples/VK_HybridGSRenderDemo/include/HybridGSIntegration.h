@@ -45,5 +45,4 @@ private:
 
     struct Compositor;
     std::unique_ptr<Compositor> compositor_;
-    gt::gs::GSPreprocessResult lastPre_{};
 };
@@ -373,13 +373,12 @@ void HybridGSIntegration::destroyCompositor()
 
 void HybridGSIntegration::onPreprocess()
 {
-    lastPre_ = gs_.runPreprocessSubmitWait();
+    gs_.beginFrame();
 }
 
 void HybridGSIntegration::onAfterLighting(VkCommandBuffer cmd, uint32_t swapchainImageIndex)
 {
-    gs_.updateUniforms();
-    gs_.recordSortAndRender(cmd, swapchainImageIndex, lastPre_);
+    gs_.recordFrame(cmd, swapchainImageIndex);
     if (compositor_) {
         compositor_->record(cmd, renderer_, swapchainImageIndex, gs_.gsColorView(swapchainImageIndex),
                             gs_.gsDepthView(swapchainImageIndex));
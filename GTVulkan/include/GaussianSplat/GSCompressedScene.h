@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GSRenderTypes.h"
+
+class GSMappedFile;
+
+// .gts: chunked, quantized runtime format for Gaussian splat scenes (little endian).
+//
+//   GtsFileHeader | GtsChunkHeader[chunkCount] | chunk data ...
+//   chunk data:  float shRestScale[restCount] | record[splatCount]
+//   record:      uint16 position[3]      fixed point within the chunk bounds
+//                half   logScale[3]
+//                half   rotation[4]      (w, x, y, z)
+//                half   shDc[3]
+//                uint8  opacity          after the sigmoid
+//                int8   shRest[restCount] times the chunk's shRestScale, per coefficient
+//                zero padding to 4 bytes
+//
+// restCount = 3 * ((shDegree + 1)^2 - 1): 45 floats at degree 3 make a 72 byte record.
+// Chunks are independent, so they decode in parallel or one by one into staging memory.
+constexpr char kGtsMagic[4] = { 'G', 'T', 'S', '1' };
+constexpr uint32_t kGtsVersion = 1;
+
+struct GtsFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t splatCount;
+    uint32_t chunkCount;
+    uint32_t shDegree;
+    uint32_t recordBytes;
+    uint32_t reserved;
+};
+
+struct GtsChunkHeader {
+    float positionMin[3];
+    float positionStep[3];  // world units per position step
+    uint32_t splatCount;
+    uint32_t reserved;
+    uint64_t offset;        // of the chunk data, from the start of the file
+};
+
+struct GtsEncodeOptions {
+    uint32_t chunkSplats = 16384;
+    uint32_t shDegree = 3;  // higher SH bands are dropped
+};
+
+uint32_t gtsRestCount(uint32_t shDegree);
+uint32_t gtsRecordBytes(uint32_t shDegree);
+
+// Morton order over the scene bounds, so chunk bounds are tight and 16-bit positions fine.
+// Call before writeGtsScene; splat order does not matter to the renderer.
+void sortSplatsSpatially(std::vector<GSVertex>& vertices);
+
+// Throws std::runtime_error when the file cannot be written.
+void writeGtsScene(const std::string& path, const std::vector<GSVertex>& vertices, const GtsEncodeOptions& options = {});
+
+// Maps a .gts file and validates its tables; throws std::runtime_error on malformed files.
+class GtsSceneReader {
+public:
+    explicit GtsSceneReader(const std::string& path);
+    ~GtsSceneReader();
+
+    uint64_t splatCount() const { return header.splatCount; }
+    uint32_t shDegree() const { return header.shDegree; }
+    size_t fileBytes() const;
+    size_t chunkCount() const { return chunks.size(); }
+    uint64_t chunkFirstSplat(size_t chunk) const { return firstSplats[chunk]; }
+    uint32_t chunkSplatCount(size_t chunk) const { return chunks[chunk].splatCount; }
+
+    // Writes chunkSplatCount(chunk) vertices to destination, which may be mapped staging memory.
+    // Safe to call for different chunks from several threads.
+    void decodeChunk(size_t chunk, GSVertex* destination) const;
+
+    // Every chunk, on threadCount threads (0: one per hardware thread).
+    void decodeAll(GSVertex* destination, unsigned threadCount = 0) const;
+
+private:
+    std::unique_ptr<GSMappedFile> file;
+    GtsFileHeader header{};
+    std::vector<GtsChunkHeader> chunks;
+    std::vector<uint64_t> firstSplats;
+};
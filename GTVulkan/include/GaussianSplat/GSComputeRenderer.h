@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "GSRenderTypes.h"
 
 class GSComputeRenderer {
 public:
-    bool initialize(const std::vector<GSVertex>& vertices);
+    // maxShDegree caps the SH bands uploaded and evaluated; the scene's own degree is used if lower
+    bool initialize(const std::vector<GSVertex>& vertices, uint32_t maxShDegree = 3,
+                    GSPrefixScan prefixScan = GSPrefixScan::HillisSteele);
     void run();
     void shutdown();
 };
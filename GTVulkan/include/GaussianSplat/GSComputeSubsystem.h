@@ -15,12 +15,6 @@ namespace gs {
 
 class GaussianSplatComputeEngine;
 
-/** Result of GS preprocess (prefix sum + instance count); needed before sort/render dispatch. */
-struct GSPreprocessResult {
-    uint32_t numInstances = 0;
-    bool prefixInPing = true;
-};
-
 /**
  * Embedded Gaussian splat compute path: no window creation, no swapchain color target.
  * Intended to be recorded into the host's command buffer after deferred lighting (Strategy B).
@@ -33,15 +27,24 @@ public:
     GSComputeSubsystem(const GSComputeSubsystem&) = delete;
     GSComputeSubsystem& operator=(const GSComputeSubsystem&) = delete;
 
-    bool initialize(const std::vector<GSVertex>& vertices, const std::shared_ptr<Camera>& camera);
+    /** maxShDegree caps the SH bands uploaded and evaluated; the scene's own degree is used if lower. */
+    bool initialize(const std::vector<GSVertex>& vertices, const std::shared_ptr<Camera>& camera, uint32_t maxShDegree = 3,
+                    GSPrefixScan prefixScan = GSPrefixScan::HillisSteele);
     void shutdown();
 
+    /** Uploads the camera uniforms right away; recordFrame records its own update. */
     void updateUniforms();
-    /** Submit preprocess on internal command buffer; CPU wait (reads instance count). Call once per frame before sort/render. */
-    GSPreprocessResult runPreprocessSubmitWait();
-
-    /** Record radix sort + tile render into an already-started command buffer. */
-    void recordSortAndRender(VkCommandBuffer cmd, uint32_t swapchainImageIndex, const GSPreprocessResult& prep);
+    /**
+     * CPU side of a frame, before recordFrame and after the previous frame's fence: follows window resizes and
+     * grows the sort buffers when the last frame's tile instances overflowed them. Never waits on the GPU.
+     */
+    void beginFrame();
+
+    /**
+     * Record uniforms, preprocess, prefix sum, radix sort and tile render into an already-started command buffer.
+     * The instance count stays on the GPU: sort and tile boundary passes use vkCmdDispatchIndirect.
+     */
+    void recordFrame(VkCommandBuffer cmd, uint32_t swapchainImageIndex);
 
     VkImageView gsColorView(uint32_t index) const;
     VkImageView gsDepthView(uint32_t index) const;
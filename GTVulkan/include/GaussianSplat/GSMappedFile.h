@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only mapping of a whole file: decode threads read the page cache directly,
+// with no copy into stream buffers. Throws std::runtime_error if the file cannot be mapped.
+class GSMappedFile {
+public:
+    explicit GSMappedFile(const std::string& filename);
+    ~GSMappedFile();
+
+    GSMappedFile(const GSMappedFile&) = delete;
+    GSMappedFile& operator=(const GSMappedFile&) = delete;
+
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+private:
+    void release();
+
+#ifdef _WIN32
+    void* file = nullptr;  // HANDLE
+    void* mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include "GSRenderTypes.h"
+
 class GSSceneLoader;
 class GSComputeRenderer;
 
@@ -11,7 +14,8 @@ public:
     GSRenderDemoApp();
     ~GSRenderDemoApp();
 
-    bool initialize(const std::string& plyPath);
+    bool initialize(const std::string& plyPath, uint32_t maxShDegree = 3,
+                    GSPrefixScan prefixScan = GSPrefixScan::HillisSteele);
     void run();
     void shutdown();
 
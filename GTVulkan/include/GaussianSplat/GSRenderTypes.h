@@ -11,6 +11,11 @@ struct GSVertex {
     float sh[48];
 };
 
+// Floats per splat in the GPU SH array (SH_FLOATS in gs_common.glsl).
+constexpr uint32_t gsShFloatCount(uint32_t shDegree) {
+    return 3 * (shDegree + 1) * (shDegree + 1);
+}
+
 struct alignas(16) GSVertexAttributeCPU {
     glm::vec4 conic_opacity;
     glm::vec4 color_radii;
@@ -47,3 +52,27 @@ struct GSRadixSortPushConstants {
     uint32_t g_num_blocks_per_workgroup;
 };
 
+// How the per-splat tile overlap counts are prefix summed. Both write the same buffers.
+enum class GSPrefixScan : uint32_t {
+    HillisSteele,       // gs_prefix_sum.comp: ceil(log2(n)) + 1 dispatches over ping/pong buffers
+    // gs_prefix_sum_lookback.comp: one dispatch, each element read and written once;
+    // not yet validated on a driver (GSPrefixScanBenchmark), so the demos do not offer it
+    DecoupledLookback,
+};
+
+// Written on the GPU after the prefix sum (IndirectArgs in gs_common.glsl); the sort and tile
+// boundary passes are dispatched from it with vkCmdDispatchIndirect.
+struct GSSortIndirectArgs {
+    uint32_t sortGroups[3];
+    uint32_t tileBoundaryGroups[3];
+    uint32_t numInstances;        // clamped to the sort buffer capacity
+    uint32_t requestedInstances;  // the prefix sum total, above numInstances on overflow
+};
+
+// gs_indirect_args.comp; the sort grid is ceil(numInstances / (256 * sortBlocksPerWorkgroup)),
+// which must match the histogram buffer and GSRadixSortPushConstants::g_num_blocks_per_workgroup
+struct GSIndirectArgsPushConstants {
+    uint32_t capacity;
+    uint32_t sortBlocksPerWorkgroup;
+};
+
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -7,6 +8,12 @@
 
 class GSSceneLoader {
 public:
-    std::vector<GSVertex> load(const std::string& plyPath) const;
+    // Maps a binary little-endian 3DGS .ply, or a quantized .gts (GSCompressedScene.h), and decodes
+    // it on threadCount threads (0: one per hardware thread). An empty path yields a single-splat fallback scene.
+    std::vector<GSVertex> load(const std::string& scenePath, unsigned threadCount = 0) const;
+
+    // Highest SH band with a non-zero coefficient: scenes trained at a lower degree, or .gts
+    // files written with fewer bands, still fill all 48 GSVertex::sh floats.
+    static uint32_t shDegreeInUse(const std::vector<GSVertex>& vertices);
 };
 
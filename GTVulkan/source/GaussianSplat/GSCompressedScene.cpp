@@ -0,0 +1,340 @@
+#include "GaussianSplat/GSCompressedScene.h"
+
+#include "GaussianSplat/GSMappedFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include <glm/gtc/packing.hpp>
+
+namespace {
+
+// record field offsets, see GSCompressedScene.h
+constexpr size_t kPositionOffset = 0;
+constexpr size_t kLogScaleOffset = 6;
+constexpr size_t kRotationOffset = 12;
+constexpr size_t kShDcOffset = 20;
+constexpr size_t kOpacityOffset = 26;
+constexpr size_t kShRestOffset = 27;
+
+constexpr float kPositionSteps = 65535.0f;
+
+template <typename T>
+void storeValues(uint8_t* destination, const T* values, size_t count) {
+    std::memcpy(destination, values, sizeof(T) * count);
+}
+
+void storeHalves(uint8_t* destination, const float* values, size_t count) {
+    uint16_t halves[4];
+    for (size_t i = 0; i < count; i++) {
+        halves[i] = glm::packHalf1x16(values[i]);
+    }
+    storeValues(destination, halves, count);
+}
+
+// rebias the exponent, patching up inf/NaN and the rare zero/subnormal inputs; glm's
+// unpackHalf1x16 is a branchy generic conversion that dominated decode time
+float halfToFloat(uint16_t half) {
+    constexpr uint32_t kShiftedExponent = 0x7C00u << 13;
+    uint32_t bits = (half & 0x7FFFu) << 13;
+    const uint32_t exponent = bits & kShiftedExponent;
+    bits += (127 - 15) << 23;
+    bits += exponent == kShiftedExponent ? (128 - 16) << 23 : 0;
+    if (exponent == 0) {
+        float magnitude;
+        bits += 1 << 23;
+        std::memcpy(&magnitude, &bits, sizeof(magnitude));
+        magnitude -= 6.103515625e-05f;  // 2^-14
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+    }
+    bits |= static_cast<uint32_t>(half & 0x8000u) << 16;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+template <size_t Count>
+void loadHalves(const uint8_t* source, float* values) {
+    uint16_t halves[Count];
+    std::memcpy(halves, source, sizeof(halves));
+    for (size_t i = 0; i < Count; i++) {
+        values[i] = halfToFloat(halves[i]);
+    }
+}
+
+// spreads the low 21 bits of v to every third bit
+uint64_t spreadBits(uint64_t v) {
+    v &= 0x1FFFFF;
+    v = (v | v << 32) & 0x1F00000000FFFFull;
+    v = (v | v << 16) & 0x1F0000FF0000FFull;
+    v = (v | v << 8) & 0x100F00F00F00F00Full;
+    v = (v | v << 4) & 0x10C30C30C30C30C3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+GtsChunkHeader chunkBounds(const GSVertex* vertices, uint32_t count) {
+    glm::vec3 minP(std::numeric_limits<float>::max());
+    glm::vec3 maxP(std::numeric_limits<float>::lowest());
+    for (uint32_t i = 0; i < count; i++) {
+        minP = glm::min(minP, glm::vec3(vertices[i].position));
+        maxP = glm::max(maxP, glm::vec3(vertices[i].position));
+    }
+    GtsChunkHeader chunk{};
+    for (int axis = 0; axis < 3; axis++) {
+        chunk.positionMin[axis] = minP[axis];
+        chunk.positionStep[axis] = (maxP[axis] - minP[axis]) / kPositionSteps;
+    }
+    chunk.splatCount = count;
+    return chunk;
+}
+
+void encodeChunk(const GtsChunkHeader& chunk, const GSVertex* vertices, uint32_t shDegree, std::vector<uint8_t>& data) {
+    const uint32_t restCount = gtsRestCount(shDegree);
+    const uint32_t recordBytes = gtsRecordBytes(shDegree);
+    data.assign(sizeof(float) * restCount + size_t(recordBytes) * chunk.splatCount, 0);
+
+    // one int8 scale per SH coefficient and chunk
+    std::vector<float> restScale(restCount, 0.0f);
+    for (uint32_t i = 0; i < chunk.splatCount; i++) {
+        for (uint32_t k = 0; k < restCount; k++) {
+            restScale[k] = std::max(restScale[k], std::abs(vertices[i].sh[3 + k]));
+        }
+    }
+    for (float& scale : restScale) {
+        scale /= 127.0f;
+    }
+    storeValues(data.data(), restScale.data(), restCount);
+
+    uint8_t* record = data.data() + sizeof(float) * restCount;
+    for (uint32_t i = 0; i < chunk.splatCount; i++, record += recordBytes) {
+        const GSVertex& v = vertices[i];
+
+        uint16_t position[3];
+        for (int axis = 0; axis < 3; axis++) {
+            const float step = chunk.positionStep[axis];
+            const float q = step > 0.0f ? std::round((v.position[axis] - chunk.positionMin[axis]) / step) : 0.0f;
+            position[axis] = static_cast<uint16_t>(std::clamp(q, 0.0f, kPositionSteps));
+        }
+        storeValues(record + kPositionOffset, position, 3);
+
+        // log scale keeps the relative precision of half floats across tiny and huge splats
+        const float logScale[3] = {
+            std::log(std::max(v.scale_opacity.x, std::numeric_limits<float>::min())),
+            std::log(std::max(v.scale_opacity.y, std::numeric_limits<float>::min())),
+            std::log(std::max(v.scale_opacity.z, std::numeric_limits<float>::min())),
+        };
+        storeHalves(record + kLogScaleOffset, logScale, 3);
+        storeHalves(record + kRotationOffset, &v.rotation.x, 4);
+        storeHalves(record + kShDcOffset, v.sh, 3);
+        record[kOpacityOffset] = static_cast<uint8_t>(std::round(std::clamp(v.scale_opacity.w, 0.0f, 1.0f) * 255.0f));
+
+        for (uint32_t k = 0; k < restCount; k++) {
+            const float q = restScale[k] > 0.0f ? std::round(v.sh[3 + k] / restScale[k]) : 0.0f;
+            record[kShRestOffset + k] = static_cast<uint8_t>(static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f)));
+        }
+    }
+}
+
+// a compile-time record layout per SH degree lets the SH loop vectorize
+template <uint32_t ShDegree>
+void decodeRecords(const GtsChunkHeader& chunk, const uint8_t* data, GSVertex* destination) {
+    constexpr uint32_t kRestCount = 3 * ((ShDegree + 1) * (ShDegree + 1) - 1);
+    constexpr uint32_t kRecordBytes = (static_cast<uint32_t>(kShRestOffset) + kRestCount + 3) & ~3u;
+
+    float restScale[kRestCount + 1];
+    std::memcpy(restScale, data, sizeof(float) * kRestCount);
+
+    const uint8_t* record = data + sizeof(float) * kRestCount;
+    for (uint32_t i = 0; i < chunk.splatCount; i++, record += kRecordBytes) {
+        // built on the stack and copied once: destination may be write-combined staging memory
+        GSVertex v{};
+
+        uint16_t position[3];
+        std::memcpy(position, record + kPositionOffset, sizeof(position));
+        v.position = glm::vec4(
+            chunk.positionMin[0] + chunk.positionStep[0] * position[0],
+            chunk.positionMin[1] + chunk.positionStep[1] * position[1],
+            chunk.positionMin[2] + chunk.positionStep[2] * position[2],
+            1.0f);
+
+        float logScale[3];
+        loadHalves<3>(record + kLogScaleOffset, logScale);
+        v.scale_opacity = glm::vec4(std::exp(logScale[0]), std::exp(logScale[1]), std::exp(logScale[2]),
+            record[kOpacityOffset] / 255.0f);
+
+        float rotation[4];
+        loadHalves<4>(record + kRotationOffset, rotation);
+        const glm::vec4 rotationWxyz(rotation[0], rotation[1], rotation[2], rotation[3]);
+        const float rotationNorm = glm::length(rotationWxyz);
+        v.rotation = rotationNorm > std::numeric_limits<float>::epsilon()
+            ? (rotationWxyz / rotationNorm)
+            : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+        loadHalves<3>(record + kShDcOffset, v.sh);
+        int8_t rest[kRestCount + 1];
+        std::memcpy(rest, record + kShRestOffset, kRestCount);
+        for (uint32_t k = 0; k < kRestCount; k++) {
+            v.sh[3 + k] = rest[k] * restScale[k];
+        }
+
+        std::memcpy(destination + i, &v, sizeof(GSVertex));
+    }
+}
+
+} // namespace
+
+uint32_t gtsRestCount(uint32_t shDegree) {
+    return 3 * ((shDegree + 1) * (shDegree + 1) - 1);
+}
+
+uint32_t gtsRecordBytes(uint32_t shDegree) {
+    return (static_cast<uint32_t>(kShRestOffset) + gtsRestCount(shDegree) + 3) & ~3u;
+}
+
+void sortSplatsSpatially(std::vector<GSVertex>& vertices) {
+    if (vertices.size() < 2) {
+        return;
+    }
+    glm::vec3 minP(std::numeric_limits<float>::max());
+    glm::vec3 maxP(std::numeric_limits<float>::lowest());
+    for (const GSVertex& v : vertices) {
+        minP = glm::min(minP, glm::vec3(v.position));
+        maxP = glm::max(maxP, glm::vec3(v.position));
+    }
+    const glm::vec3 extent = glm::max(maxP - minP, glm::vec3(std::numeric_limits<float>::min()));
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const glm::vec3 cell = glm::clamp((glm::vec3(vertices[i].position) - minP) / extent, 0.0f, 1.0f) * 2097151.0f;
+        const uint64_t key = spreadBits(uint64_t(cell.x)) | spreadBits(uint64_t(cell.y)) << 1 | spreadBits(uint64_t(cell.z)) << 2;
+        keys[i] = { key, static_cast<uint32_t>(i) };
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<GSVertex> sorted(vertices.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        sorted[i] = vertices[keys[i].second];
+    }
+    vertices = std::move(sorted);
+}
+
+void writeGtsScene(const std::string& path, const std::vector<GSVertex>& vertices, const GtsEncodeOptions& options) {
+    if (options.shDegree > 3 || options.chunkSplats == 0) {
+        throw std::runtime_error("Invalid GTS encode options.");
+    }
+
+    GtsFileHeader header{};
+    std::memcpy(header.magic, kGtsMagic, sizeof(header.magic));
+    header.version = kGtsVersion;
+    header.splatCount = vertices.size();
+    header.chunkCount = static_cast<uint32_t>((vertices.size() + options.chunkSplats - 1) / options.chunkSplats);
+    header.shDegree = options.shDegree;
+    header.recordBytes = gtsRecordBytes(options.shDegree);
+
+    std::vector<GtsChunkHeader> chunks(header.chunkCount);
+    uint64_t offset = sizeof(GtsFileHeader) + sizeof(GtsChunkHeader) * chunks.size();
+    for (size_t c = 0; c < chunks.size(); c++) {
+        const size_t first = c * options.chunkSplats;
+        const uint32_t count = static_cast<uint32_t>(std::min<size_t>(options.chunkSplats, vertices.size() - first));
+        chunks[c] = chunkBounds(vertices.data() + first, count);
+        chunks[c].offset = offset;
+        offset += sizeof(float) * gtsRestCount(options.shDegree) + uint64_t(header.recordBytes) * count;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Could not create GTS: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(chunks.data()), std::streamsize(sizeof(GtsChunkHeader) * chunks.size()));
+    std::vector<uint8_t> data;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        encodeChunk(chunks[c], vertices.data() + c * options.chunkSplats, options.shDegree, data);
+        out.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write GTS: " + path);
+    }
+}
+
+GtsSceneReader::GtsSceneReader(const std::string& path)
+    : file(std::make_unique<GSMappedFile>(path)) {
+    if (file->size < sizeof(GtsFileHeader)) {
+        throw std::runtime_error("Invalid GTS file: " + path);
+    }
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, kGtsMagic, sizeof(header.magic)) != 0 || header.version != kGtsVersion
+        || header.shDegree > 3 || header.recordBytes != gtsRecordBytes(header.shDegree)) {
+        throw std::runtime_error("Invalid GTS file or unsupported version: " + path);
+    }
+    const size_t tableEnd = sizeof(GtsFileHeader) + sizeof(GtsChunkHeader) * size_t(header.chunkCount);
+    if (tableEnd > file->size) {
+        throw std::runtime_error("Invalid GTS file: chunk table is truncated.");
+    }
+    chunks.resize(header.chunkCount);
+    std::memcpy(chunks.data(), file->data + sizeof(GtsFileHeader), sizeof(GtsChunkHeader) * chunks.size());
+
+    const size_t restBytes = sizeof(float) * gtsRestCount(header.shDegree);
+    firstSplats.resize(chunks.size());
+    uint64_t splats = 0;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        const GtsChunkHeader& chunk = chunks[c];
+        if (chunk.offset < tableEnd || chunk.offset > file->size
+            || file->size - chunk.offset < restBytes + uint64_t(header.recordBytes) * chunk.splatCount) {
+            throw std::runtime_error("Invalid GTS file: chunk data is truncated.");
+        }
+        firstSplats[c] = splats;
+        splats += chunk.splatCount;
+    }
+    if (splats != header.splatCount) {
+        throw std::runtime_error("Invalid GTS file: chunk sizes do not add up to the splat count.");
+    }
+}
+
+GtsSceneReader::~GtsSceneReader() = default;
+
+size_t GtsSceneReader::fileBytes() const {
+    return file->size;
+}
+
+void GtsSceneReader::decodeChunk(size_t chunkIndex, GSVertex* destination) const {
+    const GtsChunkHeader& chunk = chunks[chunkIndex];
+    const uint8_t* data = file->data + chunk.offset;
+    switch (header.shDegree) {
+    case 0: decodeRecords<0>(chunk, data, destination); break;
+    case 1: decodeRecords<1>(chunk, data, destination); break;
+    case 2: decodeRecords<2>(chunk, data, destination); break;
+    default: decodeRecords<3>(chunk, data, destination); break;
+    }
+}
+
+void GtsSceneReader::decodeAll(GSVertex* destination, unsigned threadCount) const {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t threads = std::clamp<size_t>(chunks.size(), 1, threadCount);
+
+    // chunks are handed out one at a time, the last one is usually short
+    std::atomic<size_t> nextChunk{ 0 };
+    const auto decodeChunks = [&]() {
+        for (size_t c = nextChunk++; c < chunks.size(); c = nextChunk++) {
+            decodeChunk(c, destination + firstSplats[c]);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        workers.emplace_back(decodeChunks);
+    }
+    decodeChunks();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
@@ -1,5 +1,6 @@
 #include "GaussianSplat/GSComputeRenderer.h"
 #include "GaussianSplat/GSComputeSubsystem.h"
+#include "GaussianSplat/GSSceneLoader.h"
 #include "Camera.h"
 
 #include "GTVulkan/EasyVulkan.h"
@@ -8,7 +9,9 @@
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -24,12 +27,13 @@ namespace gs {
 
 constexpr uint32_t kTileWidth = 16;
 constexpr uint32_t kTileHeight = 16;
+// blocks of 256 keys per gs_hist / gs_sort workgroup; sizes sortHistBuffer and, through
+// GSIndirectArgsPushConstants, the indirect sort grid
 constexpr uint32_t kSortBlocksPerWorkgroup = 1;
-
-struct PreprocessResult {
-    uint32_t numInstances = 0;
-    bool prefixInPing = true;
-};
+// tile instances per splat the sort buffers start with; grown a frame after an overflow
+constexpr uint32_t kInitialSortCapacityMultiplier = 4;
+// elements per workgroup of gs_prefix_sum_lookback.comp
+constexpr uint32_t kLookbackPartitionSize = 256 * 8;
 
 enum class CameraControlMode {
     FreeLook,
@@ -141,8 +145,9 @@ VkDescriptorSet allocateDescriptorSet(VkDescriptorPool pool, VkDescriptorSetLayo
 
 class GaussianSplatComputeEngine {
 public:
-    bool initialize(const std::vector<GSVertex>& inputVertices) {
+    bool initialize(const std::vector<GSVertex>& inputVertices, uint32_t maxShDegree, GSPrefixScan scan) {
         embeddedMode_ = false;
+        prefixScan = scan;
         if (!InitializeWindow({1280, 720}, false, true, false)) {
             return false;
         }
@@ -162,6 +167,7 @@ public:
         installInputCallbacks();
 
         vertices = inputVertices;
+        selectShDegree(maxShDegree);
         fitCameraToScene();
         captureResetState();
         resetCameraToInitialFocus();
@@ -177,8 +183,10 @@ public:
     }
 
     /** Use when `GraphicsBase` + GLFW window already exist (e.g. VulkanRenderer). Does not create/destroy the window. */
-    bool initializeEmbedded(const std::vector<GSVertex>& inputVertices, const std::shared_ptr<Camera>& externalCamera) {
+    bool initializeEmbedded(const std::vector<GSVertex>& inputVertices, const std::shared_ptr<Camera>& externalCamera,
+                            uint32_t maxShDegree, GSPrefixScan scan) {
         embeddedMode_ = true;
+        prefixScan = scan;
         if (!pWindow || GraphicsBase::Base().Device() == VK_NULL_HANDLE) {
             return false;
         }
@@ -187,6 +195,7 @@ public:
         lastFrameTime = glfwGetTime();
 
         vertices = inputVertices;
+        selectShDegree(maxShDegree);
         lastExtent = windowSize;
         createCommandResources();
         createSyncResources();
@@ -241,6 +250,8 @@ public:
         if (pipeline_sort != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline_sort, nullptr);
         if (pipeline_tileBoundary != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline_tileBoundary, nullptr);
         if (pipeline_render != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline_render, nullptr);
+        if (pipeline_indirectArgs != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline_indirectArgs, nullptr);
+        if (pipeline_prefixSumLookback != VK_NULL_HANDLE) vkDestroyPipeline(device, pipeline_prefixSumLookback, nullptr);
         if (layout_precomp != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_precomp, nullptr);
         if (layout_preprocess != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_preprocess, nullptr);
         if (layout_prefixSum != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_prefixSum, nullptr);
@@ -249,6 +260,10 @@ public:
         if (layout_sort != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_sort, nullptr);
         if (layout_tileBoundary != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_tileBoundary, nullptr);
         if (layout_render != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_render, nullptr);
+        if (layout_indirectArgs != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_indirectArgs, nullptr);
+        if (layout_prefixSumLookback != VK_NULL_HANDLE) vkDestroyPipelineLayout(device, layout_prefixSumLookback, nullptr);
+        if (preprocessQueryPool != VK_NULL_HANDLE) vkDestroyQueryPool(device, preprocessQueryPool, nullptr);
+        preprocessQueryPool = VK_NULL_HANDLE;
         renderFinishedSemaphores.clear();
         imageAvailableSemaphores.clear();
         fenceRender.reset();
@@ -303,6 +318,8 @@ private:
     VkPipelineLayout layout_sort = VK_NULL_HANDLE;
     VkPipelineLayout layout_tileBoundary = VK_NULL_HANDLE;
     VkPipelineLayout layout_render = VK_NULL_HANDLE;
+    VkPipelineLayout layout_indirectArgs = VK_NULL_HANDLE;
+    VkPipelineLayout layout_prefixSumLookback = VK_NULL_HANDLE;
     VkPipeline pipeline_precomp = VK_NULL_HANDLE;
     VkPipeline pipeline_preprocess = VK_NULL_HANDLE;
     VkPipeline pipeline_prefixSum = VK_NULL_HANDLE;
@@ -311,15 +328,25 @@ private:
     VkPipeline pipeline_sort = VK_NULL_HANDLE;
     VkPipeline pipeline_tileBoundary = VK_NULL_HANDLE;
     VkPipeline pipeline_render = VK_NULL_HANDLE;
+    VkPipeline pipeline_indirectArgs = VK_NULL_HANDLE;
+    VkPipeline pipeline_prefixSumLookback = VK_NULL_HANDLE;
 
-    deviceLocalBuffer vertexBuffer;
+    // splats as one array per attribute; positions and cov3Ds are the hot data culling reads
+    deviceLocalBuffer positionBuffer;
     deviceLocalBuffer cov3DBuffer;
+    deviceLocalBuffer scaleOpacityBuffer;
+    deviceLocalBuffer rotationBuffer;
+    deviceLocalBuffer shBuffer;
+    uint32_t shDegree = 3;
     deviceLocalBuffer uniformBuffer;
     deviceLocalBuffer vertexAttributeBuffer;
     deviceLocalBuffer tileOverlapBuffer;
     deviceLocalBuffer prefixSumPingBuffer;
     deviceLocalBuffer prefixSumPongBuffer;
-    bufferMemory totalSumBufferHost;
+    deviceLocalBuffer prefixSumStateBuffer;  // look-back scan: partition counter, overflow flag, per-partition state
+    GSPrefixScan prefixScan = GSPrefixScan::HillisSteele;
+    deviceLocalBuffer indirectArgsBuffer;
+    bufferMemory requestedInstancesHost;
     deviceLocalBuffer sortKBufferEven;
     deviceLocalBuffer sortKBufferOdd;
     deviceLocalBuffer sortVBufferEven;
@@ -332,7 +359,16 @@ private:
     std::vector<StorageImage> colorOutputs;
     std::vector<uint8_t> embeddedSurfacePrimed;
     bool embeddedMode_ = false;
-    uint32_t sortBufferSizeMultiplier = 1;
+    uint32_t sortBufferSizeMultiplier = kInitialSortCapacityMultiplier;
+    bool requestedInstancesPending = false;
+    bool prefixSumOverflowReported = false;
+
+    // GPU time of the preprocess dispatch, between two timestamps
+    VkQueryPool preprocessQueryPool = VK_NULL_HANDLE;
+    double timestampPeriodNs = 1.0;
+    uint64_t timestampMask = ~0ull;
+    double preprocessGpuMs = 0.0;
+    bool timestampsPending = false;
 
     VkDescriptorSet set_precomp = VK_NULL_HANDLE;
     VkDescriptorSet set_preprocess0 = VK_NULL_HANDLE;
@@ -346,6 +382,8 @@ private:
     VkDescriptorSet set_sort_odd = VK_NULL_HANDLE;
     VkDescriptorSet set_tileBoundary = VK_NULL_HANDLE;
     VkDescriptorSet set_render0 = VK_NULL_HANDLE;
+    VkDescriptorSet set_indirectArgs = VK_NULL_HANDLE;
+    VkDescriptorSet set_prefixLookback = VK_NULL_HANDLE;
     std::vector<VkDescriptorSet> set_render1;
 
     static VkBufferMemoryBarrier bufferBarrier(VkBuffer buf, VkAccessFlags src, VkAccessFlags dst) {
@@ -570,6 +608,11 @@ private:
         const char* modeName = (cameraControlMode == CameraControlMode::FreeLook) ? "FreeLook" : "Orbit";
         std::string title = std::string(windowTitle) + " [" + modeName + "]  " + std::to_string(static_cast<int>(fps + 0.5));
         title += " FPS";
+        if (preprocessQueryPool != VK_NULL_HANDLE) {
+            char preprocessText[64];
+            std::snprintf(preprocessText, sizeof(preprocessText), "  preprocess %.3f ms (SH %u)", preprocessGpuMs, shDegree);
+            title += preprocessText;
+        }
         glfwSetWindowTitle(pWindow, title.c_str());
     }
 
@@ -618,6 +661,33 @@ private:
         commandPoolGraphics.Create(GraphicsBase::Base().QueueFamilyIndex_Graphics(),
                                    VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
         commandPoolGraphics.AllocateBuffers(cmdBuffers);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(GraphicsBase::Base().PhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(GraphicsBase::Base().PhysicalDevice(), &familyCount, families.data());
+        const uint32_t family = GraphicsBase::Base().QueueFamilyIndex_Graphics();
+        const uint32_t validBits = family < familyCount ? families[family].timestampValidBits : 0;
+        if (validBits > 0) {
+            timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+            timestampPeriodNs = GraphicsBase::Base().PhysicalDeviceProperties().limits.timestampPeriod;
+            VkQueryPoolCreateInfo info{
+                .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .queryType = VK_QUERY_TYPE_TIMESTAMP,
+                .queryCount = 2
+            };
+            checkVk(vkCreateQueryPool(GraphicsBase::Base().Device(), &info, nullptr, &preprocessQueryPool),
+                    "Failed to create preprocess timestamp query pool");
+        }
+    }
+
+    // the degree the SH array and gs_preprocess.comp are built for
+    void selectShDegree(uint32_t maxShDegree) {
+        shDegree = (std::min)((std::min)(maxShDegree, 3u), GSSceneLoader::shDegreeInUse(vertices));
+        const uint32_t hotBytes = sizeof(glm::vec4) + sizeof(float) * 6;
+        const uint32_t splatBytes = hotBytes + sizeof(glm::vec4) * 2 + sizeof(float) * gsShFloatCount(shDegree);
+        std::cout << "GS splat buffers: SH degree " << shDegree << ", " << splatBytes << " bytes per splat ("
+                  << hotBytes << " hot: position + cov3D), " << vertices.size() << " splats" << std::endl;
     }
 
     void createSyncResources() {
@@ -640,20 +710,29 @@ private:
         const uint32_t tileX = ceilDiv(extent.width, kTileWidth);
         const uint32_t tileY = ceilDiv(extent.height, kTileHeight);
 
-        vertexBuffer.Create(sizeof(GSVertex) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        const uint32_t shFloats = gsShFloatCount(shDegree);
+        positionBuffer.Create(sizeof(glm::vec4) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
         cov3DBuffer.Create(sizeof(float) * 6 * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        scaleOpacityBuffer.Create(sizeof(glm::vec4) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        rotationBuffer.Create(sizeof(glm::vec4) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        shBuffer.Create(sizeof(float) * shFloats * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
         uniformBuffer.Create(sizeof(GSUniformBufferCPU), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
         vertexAttributeBuffer.Create(sizeof(GSVertexAttributeCPU) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
         tileOverlapBuffer.Create(sizeof(uint32_t) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
         prefixSumPingBuffer.Create(sizeof(uint32_t) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
         prefixSumPongBuffer.Create(sizeof(uint32_t) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        prefixSumStateBuffer.Create(sizeof(uint32_t) * (2 + ceilDiv(n, kLookbackPartitionSize)),
+                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
 
+        indirectArgsBuffer.Create(sizeof(GSSortIndirectArgs),
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        // requested instances, then the look-back scan's overflow flag
         VkBufferCreateInfo hostInfo{
-            .size = sizeof(uint32_t),
-            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+            .size = sizeof(uint32_t) * 2,
+            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT
         };
-        checkVk(totalSumBufferHost.Create(hostInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
-                "Failed to create host total-sum buffer");
+        checkVk(requestedInstancesHost.Create(hostInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+                "Failed to create host instance-count buffer");
 
         const uint32_t maxInstances = n * sortBufferSizeMultiplier;
         sortKBufferEven.Create(sizeof(uint64_t) * maxInstances, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
@@ -665,10 +744,25 @@ private:
         const uint32_t numWorkgroups = ceilDiv(globalInvocation, 256u);
         sortHistBuffer.Create(sizeof(uint32_t) * 256u * numWorkgroups, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
         tileBoundaryBuffer.Create(sizeof(uint32_t) * tileX * tileY * 2, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-        vertexBuffer.TransferData(vertices.data(), sizeof(GSVertex) * n);
+
+        // split into the per-attribute arrays, keeping the first shFloats SH floats of each splat
+        std::vector<glm::vec4> attribute(n);
+        for (uint32_t i = 0; i < n; ++i) attribute[i] = vertices[i].position;
+        positionBuffer.TransferData(attribute.data(), sizeof(glm::vec4) * n);
+        for (uint32_t i = 0; i < n; ++i) attribute[i] = vertices[i].scale_opacity;
+        scaleOpacityBuffer.TransferData(attribute.data(), sizeof(glm::vec4) * n);
+        for (uint32_t i = 0; i < n; ++i) attribute[i] = vertices[i].rotation;
+        rotationBuffer.TransferData(attribute.data(), sizeof(glm::vec4) * n);
+        attribute = {};
+        std::vector<float> sh(size_t(shFloats) * n);
+        for (uint32_t i = 0; i < n; ++i) {
+            std::copy_n(vertices[i].sh, shFloats, sh.data() + size_t(i) * shFloats);
+        }
+        shBuffer.TransferData(sh.data(), sizeof(float) * sh.size());
     }
 
-    VkPipeline createComputePipeline(const char* spvName, VkPipelineLayout layout) {
+    VkPipeline createComputePipeline(const char* spvName, VkPipelineLayout layout,
+                                     const VkSpecializationInfo* specialization = nullptr) {
         std::string shaderPath = std::string("resources/compiled_shaders/") + spvName;
         shaderModule shader(shaderPath.c_str());
         VkComputePipelineCreateInfo info{
@@ -676,6 +770,7 @@ private:
             .stage = shader.StageCreateInfo(VK_SHADER_STAGE_COMPUTE_BIT),
             .layout = layout
         };
+        info.stage.pSpecializationInfo = specialization;
         VkPipeline p = VK_NULL_HANDLE;
         checkVk(vkCreateComputePipelines(GraphicsBase::Base().Device(), VK_NULL_HANDLE, 1, &info, nullptr, &p),
                 "Failed to create compute pipeline");
@@ -686,20 +781,26 @@ private:
     void createPipelines();
     void precomputeCov3D();
     void createOutputImagesAndRenderSets();
+    GSUniformBufferCPU currentUniforms() const;
     void updateUniforms();
-    PreprocessResult runPreprocessPass();
-    void ensureSortCapacity(uint32_t numInstances);
+    bool prefixSumInPing() const;
+    void recordHillisSteeleScan(VkCommandBuffer cmd);
+    void recordLookbackScan(VkCommandBuffer cmd);
+    void readBackPreviousFrame();
+    void ensureSortCapacity(uint32_t requestedInstances);
     void rebuildResizeDependentResources();
     void drawFrame();
 
 public:
-    PreprocessResult runPreprocessPassForHybrid() { return runPreprocessPass(); }
     void pushUniformsToGpu() { updateUniforms(); }
-    void refreshForHybridPreprocess() {
+    // CPU side of a frame, before recording: resize, and grow the sort buffers if the last frame overflowed
+    void beginFrame() {
         rebuildResizeDependentResources();
-        updateUniforms();
+        readBackPreviousFrame();
     }
-    void recordSortAndRenderIntoCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex, uint32_t numInstances, bool prefixInPing);
+    void recordUniformUpdate(VkCommandBuffer cmd);
+    void recordPreprocessIntoCommandBuffer(VkCommandBuffer cmd);
+    void recordSortAndRenderIntoCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex);
     VkImageView gsColorImageView(uint32_t imageIndex) const {
         return (imageIndex < colorOutputs.size()) ? colorOutputs[imageIndex].view : VK_NULL_HANDLE;
     }
@@ -707,22 +808,23 @@ public:
         return (imageIndex < depthOutputs.size()) ? depthOutputs[imageIndex].view : VK_NULL_HANDLE;
     }
     bool isEmbedded() const { return embeddedMode_; }
-    void prepareSortedInstances(uint32_t numInstances) { ensureSortCapacity(numInstances == 0 ? 1u : numInstances); }
 };
 
 void GaussianSplatComputeEngine::createDescriptorResources() {
     descriptorPool = createDescriptorPool();
-    descriptorSetLayouts.resize(10, VK_NULL_HANDLE);
-    descriptorSetLayouts[0] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
-    descriptorSetLayouts[1] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts.resize(12, VK_NULL_HANDLE);
+    descriptorSetLayouts[0] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[1] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
     descriptorSetLayouts[2] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
     descriptorSetLayouts[3] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
     descriptorSetLayouts[4] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
-    descriptorSetLayouts[5] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
-    descriptorSetLayouts[6] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
-    descriptorSetLayouts[7] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[5] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[6] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[7] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
     descriptorSetLayouts[8] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
     descriptorSetLayouts[9] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[10] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
+    descriptorSetLayouts[11] = createDescriptorSetLayout({{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}, {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr}});
 
     set_precomp = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[0]);
     set_preprocess0 = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[1]);
@@ -736,11 +838,17 @@ void GaussianSplatComputeEngine::createDescriptorResources() {
     set_sort_odd = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[6]);
     set_tileBoundary = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[7]);
     set_render0 = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[8]);
+    set_indirectArgs = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[10]);
+    set_prefixLookback = allocateDescriptorSet(descriptorPool, descriptorSetLayouts[11]);
 
-    writeBuffer(set_precomp, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vertexBuffer, VK_WHOLE_SIZE);
-    writeBuffer(set_precomp, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, cov3DBuffer, VK_WHOLE_SIZE);
-    writeBuffer(set_preprocess0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vertexBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_precomp, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, scaleOpacityBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_precomp, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, rotationBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_precomp, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, cov3DBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_preprocess0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, positionBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_preprocess0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, cov3DBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_preprocess0, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, scaleOpacityBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_preprocess0, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, rotationBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_preprocess0, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, shBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_preprocess1, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBuffer, sizeof(GSUniformBufferCPU));
     writeBuffer(set_preprocess1, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vertexAttributeBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_preprocess1, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, tileOverlapBuffer, VK_WHOLE_SIZE);
@@ -756,23 +864,36 @@ void GaussianSplatComputeEngine::createDescriptorResources() {
     writeBuffer(set_preprocessSortPong, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_hist_even, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_hist_even, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortHistBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_hist_even, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_hist_odd, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferOdd, VK_WHOLE_SIZE);
     writeBuffer(set_hist_odd, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortHistBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_hist_odd, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_sort_even, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_sort_even, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferOdd, VK_WHOLE_SIZE);
     writeBuffer(set_sort_even, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_sort_even, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferOdd, VK_WHOLE_SIZE);
     writeBuffer(set_sort_even, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortHistBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_sort_even, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_sort_odd, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferOdd, VK_WHOLE_SIZE);
     writeBuffer(set_sort_odd, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_sort_odd, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferOdd, VK_WHOLE_SIZE);
     writeBuffer(set_sort_odd, 3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_sort_odd, 4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortHistBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_sort_odd, 5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_tileBoundary, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortKBufferEven, VK_WHOLE_SIZE);
     writeBuffer(set_tileBoundary, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, tileBoundaryBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_tileBoundary, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_render0, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vertexAttributeBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_render0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, tileBoundaryBuffer, VK_WHOLE_SIZE);
     writeBuffer(set_render0, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, sortVBufferEven, VK_WHOLE_SIZE);
+    writeBuffer(set_indirectArgs, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                prefixSumInPing() ? prefixSumPingBuffer : prefixSumPongBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_indirectArgs, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, indirectArgsBuffer, VK_WHOLE_SIZE);
+    // the look-back scan reads the overlaps directly and writes where the ping/pong result is read
+    writeBuffer(set_prefixLookback, 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, tileOverlapBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_prefixLookback, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                prefixSumInPing() ? prefixSumPingBuffer : prefixSumPongBuffer, VK_WHOLE_SIZE);
+    writeBuffer(set_prefixLookback, 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, prefixSumStateBuffer, VK_WHOLE_SIZE);
 }
 
 void GaussianSplatComputeEngine::createPipelines() {
@@ -792,17 +913,27 @@ void GaussianSplatComputeEngine::createPipelines() {
     createLayout({descriptorSetLayouts[4]}, sizeof(uint32_t), layout_preprocessSort);
     createLayout({descriptorSetLayouts[5]}, sizeof(GSRadixSortPushConstants), layout_hist);
     createLayout({descriptorSetLayouts[6]}, sizeof(GSRadixSortPushConstants), layout_sort);
-    createLayout({descriptorSetLayouts[7]}, sizeof(uint32_t), layout_tileBoundary);
+    createLayout({descriptorSetLayouts[7]}, 0, layout_tileBoundary);
     createLayout({descriptorSetLayouts[8], descriptorSetLayouts[9]}, sizeof(GSRenderPushConstants), layout_render);
+    createLayout({descriptorSetLayouts[10]}, sizeof(GSIndirectArgsPushConstants), layout_indirectArgs);
+    createLayout({descriptorSetLayouts[11]}, 0, layout_prefixSumLookback);
 
     pipeline_precomp = createComputePipeline("gs_precomp_cov3d_comp.spv", layout_precomp);
-    pipeline_preprocess = createComputePipeline("gs_preprocess_comp.spv", layout_preprocess);
-    pipeline_prefixSum = createComputePipeline("gs_prefix_sum_comp.spv", layout_prefixSum);
+    // SH_DEGREE (constant_id 0) in gs_common.glsl
+    const VkSpecializationMapEntry shDegreeEntry{0, 0, sizeof(uint32_t)};
+    const VkSpecializationInfo shDegreeSpecialization{1, &shDegreeEntry, sizeof(uint32_t), &shDegree};
+    pipeline_preprocess = createComputePipeline("gs_preprocess_comp.spv", layout_preprocess, &shDegreeSpecialization);
+    if (prefixScan == GSPrefixScan::DecoupledLookback) {
+        pipeline_prefixSumLookback = createComputePipeline("gs_prefix_sum_lookback_comp.spv", layout_prefixSumLookback);
+    } else {
+        pipeline_prefixSum = createComputePipeline("gs_prefix_sum_comp.spv", layout_prefixSum);
+    }
     pipeline_preprocessSort = createComputePipeline("gs_preprocess_sort_comp.spv", layout_preprocessSort);
     pipeline_hist = createComputePipeline("gs_hist_comp.spv", layout_hist);
     pipeline_sort = createComputePipeline("gs_sort_comp.spv", layout_sort);
     pipeline_tileBoundary = createComputePipeline("gs_tile_boundary_comp.spv", layout_tileBoundary);
     pipeline_render = createComputePipeline("gs_render_comp.spv", layout_render);
+    pipeline_indirectArgs = createComputePipeline("gs_indirect_args_comp.spv", layout_indirectArgs);
 }
 
 void GaussianSplatComputeEngine::precomputeCov3D() {
@@ -852,7 +983,7 @@ void GaussianSplatComputeEngine::createOutputImagesAndRenderSets() {
     embeddedSurfacePrimed.assign(count, 0);
 }
 
-void GaussianSplatComputeEngine::updateUniforms() {
+GSUniformBufferCPU GaussianSplatComputeEngine::currentUniforms() const {
     GSUniformBufferCPU u{};
     const auto extent = windowSize;
     u.width = extent.width;
@@ -879,19 +1010,34 @@ void GaussianSplatComputeEngine::updateUniforms() {
     u.proj_mat[0][1] *= -1.0f; u.proj_mat[1][1] *= -1.0f; u.proj_mat[2][1] *= -1.0f; u.proj_mat[3][1] *= -1.0f;
     u.tan_fovx = tanFovX;
     u.tan_fovy = tanFovY;
-    uniformBuffer.TransferData(u);
+    return u;
 }
 
-PreprocessResult GaussianSplatComputeEngine::runPreprocessPass() {
-    auto& cmd = cmdBuffers[0];
+void GaussianSplatComputeEngine::updateUniforms() {
+    uniformBuffer.TransferData(currentUniforms());
+}
+
+// in-band, so the frame needs no staging submit of its own
+void GaussianSplatComputeEngine::recordUniformUpdate(VkCommandBuffer cmd) {
+    const GSUniformBufferCPU u = currentUniforms();
+    vkCmdUpdateBuffer(cmd, uniformBuffer, 0, sizeof(GSUniformBufferCPU), &u);
+    auto b = bufferBarrier(uniformBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_UNIFORM_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &b, 0, nullptr);
+}
+
+// The scan's last step (stride >= n) only copies, so both ping and pong hold the full result;
+// ping is read when iters is even, as the CPU readback always did.
+bool GaussianSplatComputeEngine::prefixSumInPing() const {
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    const uint32_t iters = static_cast<uint32_t>(std::ceil(std::log2(static_cast<float>(n))));
+    return iters % 2 == 0;
+}
+
+// Hillis-Steele over ping/pong: ceil(log2(n)) + 1 dispatches, each a full pass over the buffers.
+void GaussianSplatComputeEngine::recordHillisSteeleScan(VkCommandBuffer cmd) {
     const uint32_t n = static_cast<uint32_t>(vertices.size());
     const uint32_t groups = ceilDiv(n, 256u);
     const uint32_t iters = static_cast<uint32_t>(std::ceil(std::log2(static_cast<float>(n))));
-    cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_preprocess);
-    std::array<VkDescriptorSet, 2> sets{set_preprocess0, set_preprocess1};
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_preprocess, 0, 2, sets.data(), 0, nullptr);
-    vkCmdDispatch(cmd, groups, 1, 1);
     auto b0 = bufferBarrier(tileOverlapBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &b0, 0, nullptr);
     VkBufferCopy copyRegion{0, 0, sizeof(uint32_t) * n};
@@ -907,24 +1053,103 @@ PreprocessResult GaussianSplatComputeEngine::runPreprocessPass() {
         auto bb = bufferBarrier(srcBuf, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
         vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &bb, 0, nullptr);
     }
-    const bool prefixInPing = (iters % 2 == 0);
-    VkBuffer srcPrefix = prefixInPing ? static_cast<VkBuffer>(prefixSumPingBuffer) : static_cast<VkBuffer>(prefixSumPongBuffer);
-    VkBufferCopy tailCopy{(n - 1) * sizeof(uint32_t), 0, sizeof(uint32_t)};
-    vkCmdCopyBuffer(cmd, srcPrefix, totalSumBufferHost.Buffer(), 1, &tailCopy);
-    cmd.End();
-    fenceCompute->Reset();
-    GraphicsBase::Base().SubmitCommandBuffer_Graphics(cmd, *fenceCompute);
-    fenceCompute->WaitAndReset();
-    uint32_t total = 0;
-    totalSumBufferHost.RetrieveData(&total, sizeof(uint32_t), 0);
-    return PreprocessResult{total, prefixInPing};
 }
 
-void GaussianSplatComputeEngine::ensureSortCapacity(uint32_t numInstances) {
+// Decoupled look-back: one dispatch from tileOverlapBuffer into the buffer prefixSumInPing() names.
+void GaussianSplatComputeEngine::recordLookbackScan(VkCommandBuffer cmd) {
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    vkCmdFillBuffer(cmd, prefixSumStateBuffer, 0, VK_WHOLE_SIZE, 0);
+    std::array<VkBufferMemoryBarrier, 2> inputs{
+        bufferBarrier(tileOverlapBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT),
+        bufferBarrier(prefixSumStateBuffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT)
+    };
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 0, nullptr, static_cast<uint32_t>(inputs.size()), inputs.data(), 0, nullptr);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_prefixSumLookback);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_prefixSumLookback, 0, 1, &set_prefixLookback, 0, nullptr);
+    vkCmdDispatch(cmd, ceilDiv(n, kLookbackPartitionSize), 1, 1);
+    VkBuffer result = prefixSumInPing() ? static_cast<VkBuffer>(prefixSumPingBuffer) : static_cast<VkBuffer>(prefixSumPongBuffer);
+    auto out = bufferBarrier(result, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &out, 0, nullptr);
+    // the overflow flag goes to the host next to the instance count (host barrier in recordPreprocess)
+    auto state = bufferBarrier(prefixSumStateBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1, &state, 0, nullptr);
+    VkBufferCopy overflowCopy{sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmd, prefixSumStateBuffer, requestedInstancesHost.Buffer(), 1, &overflowCopy);
+}
+
+// Preprocess, prefix sum and the indirect arguments for the sort. Nothing here waits on the GPU:
+// the instance count stays on the device and reaches the CPU a frame later, for capacity only.
+void GaussianSplatComputeEngine::recordPreprocessIntoCommandBuffer(VkCommandBuffer cmd) {
     const uint32_t n = static_cast<uint32_t>(vertices.size());
-    if (numInstances <= n * sortBufferSizeMultiplier) return;
-    while (numInstances > n * sortBufferSizeMultiplier) sortBufferSizeMultiplier++;
+    const uint32_t groups = ceilDiv(n, 256u);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_preprocess);
+    std::array<VkDescriptorSet, 2> sets{set_preprocess0, set_preprocess1};
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_preprocess, 0, 2, sets.data(), 0, nullptr);
+    if (preprocessQueryPool != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(cmd, preprocessQueryPool, 0, 2);
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, preprocessQueryPool, 0);
+    }
+    vkCmdDispatch(cmd, groups, 1, 1);
+    if (preprocessQueryPool != VK_NULL_HANDLE) {
+        vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, preprocessQueryPool, 1);
+        timestampsPending = true;
+    }
+    if (prefixScan == GSPrefixScan::DecoupledLookback) {
+        recordLookbackScan(cmd);
+    } else {
+        recordHillisSteeleScan(cmd);
+    }
+
+    const GSIndirectArgsPushConstants argsConstants{n * sortBufferSizeMultiplier, kSortBlocksPerWorkgroup};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_indirectArgs);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_indirectArgs, 0, 1, &set_indirectArgs, 0, nullptr);
+    vkCmdPushConstants(cmd, layout_indirectArgs, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(argsConstants), &argsConstants);
+    vkCmdDispatch(cmd, 1, 1, 1);
+    auto argsBarrier = bufferBarrier(indirectArgsBuffer, VK_ACCESS_SHADER_WRITE_BIT,
+                                     VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 1, &argsBarrier, 0, nullptr);
+    VkBufferCopy countCopy{offsetof(GSSortIndirectArgs, requestedInstances), 0, sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmd, indirectArgsBuffer, requestedInstancesHost.Buffer(), 1, &countCopy);
+    auto hostBarrier = bufferBarrier(requestedInstancesHost.Buffer(), VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+    requestedInstancesPending = true;
+}
+
+// Results of the previous frame, whose fence the caller has waited on. Nothing blocks: a query
+// that is not ready is skipped.
+void GaussianSplatComputeEngine::readBackPreviousFrame() {
+    uint64_t timestamps[2]{};
+    if (timestampsPending
+        && vkGetQueryPoolResults(GraphicsBase::Base().Device(), preprocessQueryPool, 0, 2, sizeof(timestamps), timestamps,
+                                 sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+        const double ms = double((timestamps[1] - timestamps[0]) & timestampMask) * timestampPeriodNs * 1e-6;
+        preprocessGpuMs = preprocessGpuMs > 0.0 ? preprocessGpuMs * 0.9 + ms * 0.1 : ms;
+    }
+    if (requestedInstancesPending) {
+        uint32_t readBack[2]{};
+        requestedInstancesHost.RetrieveData(readBack, sizeof(readBack), 0);
+        if (prefixScan == GSPrefixScan::DecoupledLookback && readBack[1] != 0 && !prefixSumOverflowReported) {
+            // the look-back state holds 30-bit sums; the instance offsets of this frame are wrong
+            std::cout << "GS look-back prefix sum overflowed: more than 2^30 tile instances, use GSPrefixScan::HillisSteele"
+                      << std::endl;
+            prefixSumOverflowReported = true;
+        }
+        ensureSortCapacity(readBack[0]);
+    }
+}
+
+void GaussianSplatComputeEngine::ensureSortCapacity(uint32_t requestedInstances) {
+    const uint32_t n = static_cast<uint32_t>(vertices.size());
+    if (requestedInstances <= n * sortBufferSizeMultiplier) return;
+    // a quarter of headroom, so a slowly moving camera does not overflow again the next frame
+    const uint64_t target = uint64_t(requestedInstances) + requestedInstances / 4;
+    sortBufferSizeMultiplier = static_cast<uint32_t>((target + n - 1) / n);
     const uint32_t maxInstances = n * sortBufferSizeMultiplier;
+    std::cout << "GS sort buffers overflowed (" << requestedInstances << " tile instances), growing to " << maxInstances
+              << std::endl;
     sortKBufferEven.Recreate(sizeof(uint64_t) * maxInstances, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
     sortKBufferOdd.Recreate(sizeof(uint64_t) * maxInstances, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
     sortVBufferEven.Recreate(sizeof(uint32_t) * maxInstances, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
@@ -970,13 +1195,14 @@ void GaussianSplatComputeEngine::rebuildResizeDependentResources() {
     createOutputImagesAndRenderSets();
 }
 
-void GaussianSplatComputeEngine::recordSortAndRenderIntoCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex, uint32_t numInstances,
-                                                                     bool prefixInPing) {
+void GaussianSplatComputeEngine::recordSortAndRenderIntoCommandBuffer(VkCommandBuffer cmd, uint32_t imageIndex) {
     const uint32_t n = static_cast<uint32_t>(vertices.size());
     const uint32_t groups = ceilDiv(n, 256u);
-    const uint32_t sortInvocation = ceilDiv(ceilDiv(numInstances, kSortBlocksPerWorkgroup), 256u);
+    // upper bounds only: hist, sort and tile boundary are dispatched from indirectArgsBuffer
+    const uint32_t capacity = n * sortBufferSizeMultiplier;
+    const uint32_t capacityWorkgroups = ceilDiv(ceilDiv(capacity, kSortBlocksPerWorkgroup), 256u);
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_preprocessSort);
-    VkDescriptorSet preSortSet = prefixInPing ? set_preprocessSortPing : set_preprocessSortPong;
+    VkDescriptorSet preSortSet = prefixSumInPing() ? set_preprocessSortPing : set_preprocessSortPong;
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_preprocessSort, 0, 1, &preSortSet, 0, nullptr);
     uint32_t tileX = ceilDiv(windowSize.width, kTileWidth);
     vkCmdPushConstants(cmd, layout_preprocessSort, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &tileX);
@@ -988,19 +1214,19 @@ void GaussianSplatComputeEngine::recordSortAndRenderIntoCommandBuffer(VkCommandB
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
                          static_cast<uint32_t>(preSortBarriers.size()), preSortBarriers.data(), 0, nullptr);
     for (uint32_t i = 0; i < 8; ++i) {
-        GSRadixSortPushConstants pc{numInstances, i * 8, sortInvocation, kSortBlocksPerWorkgroup};
+        GSRadixSortPushConstants pc{capacity, i * 8, capacityWorkgroups, kSortBlocksPerWorkgroup};
         VkDescriptorSet histSet = (i % 2 == 0) ? set_hist_even : set_hist_odd;
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_hist);
         vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_hist, 0, 1, &histSet, 0, nullptr);
         vkCmdPushConstants(cmd, layout_hist, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GSRadixSortPushConstants), &pc);
-        vkCmdDispatch(cmd, sortInvocation, 1, 1);
+        vkCmdDispatchIndirect(cmd, indirectArgsBuffer, offsetof(GSSortIndirectArgs, sortGroups));
         auto bh = bufferBarrier(sortHistBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
         vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &bh, 0, nullptr);
         VkDescriptorSet sortSet = (i % 2 == 0) ? set_sort_even : set_sort_odd;
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_sort);
         vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_sort, 0, 1, &sortSet, 0, nullptr);
         vkCmdPushConstants(cmd, layout_sort, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GSRadixSortPushConstants), &pc);
-        vkCmdDispatch(cmd, sortInvocation, 1, 1);
+        vkCmdDispatchIndirect(cmd, indirectArgsBuffer, offsetof(GSSortIndirectArgs, sortGroups));
         VkBuffer outKey = (i % 2 == 0) ? static_cast<VkBuffer>(sortKBufferOdd) : static_cast<VkBuffer>(sortKBufferEven);
         VkBuffer outValue = (i % 2 == 0) ? static_cast<VkBuffer>(sortVBufferOdd) : static_cast<VkBuffer>(sortVBufferEven);
         std::array<VkBufferMemoryBarrier, 2> sortOutputBarriers{
@@ -1015,8 +1241,7 @@ void GaussianSplatComputeEngine::recordSortAndRenderIntoCommandBuffer(VkCommandB
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &tbFill, 0, nullptr);
     vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_tileBoundary);
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, layout_tileBoundary, 0, 1, &set_tileBoundary, 0, nullptr);
-    vkCmdPushConstants(cmd, layout_tileBoundary, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32_t), &numInstances);
-    vkCmdDispatch(cmd, ceilDiv(numInstances, 256u), 1, 1);
+    vkCmdDispatchIndirect(cmd, indirectArgsBuffer, offsetof(GSSortIndirectArgs, tileBoundaryGroups));
     auto tbRead = bufferBarrier(tileBoundaryBuffer, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
     vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1, &tbRead, 0, nullptr);
     const bool surfacePrimed =
@@ -1097,18 +1322,16 @@ void GaussianSplatComputeEngine::recordSortAndRenderIntoCommandBuffer(VkCommandB
 }
 
 void GaussianSplatComputeEngine::drawFrame() {
-    rebuildResizeDependentResources();
-    updateUniforms();
+    beginFrame();
     VkSemaphore acquireSemaphore = imageAvailableSemaphores[frameSemaphoreIndex];
     GraphicsBase::Base().SwapImage(acquireSemaphore);
     const uint32_t imageIndex = GraphicsBase::Base().CurrentImageIndex();
     VkSemaphore renderFinishedSemaphore = renderFinishedSemaphores[imageIndex];
-    auto prep = runPreprocessPass();
-    uint32_t numInstances = prep.numInstances == 0 ? 1 : prep.numInstances;
-    ensureSortCapacity(numInstances);
     auto& cmd = cmdBuffers[1];
     cmd.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-    recordSortAndRenderIntoCommandBuffer(cmd, imageIndex, numInstances, prep.prefixInPing);
+    recordUniformUpdate(cmd);
+    recordPreprocessIntoCommandBuffer(cmd);
+    recordSortAndRenderIntoCommandBuffer(cmd, imageIndex);
     cmd.End();
     VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
     VkSubmitInfo submitInfo{
@@ -1129,11 +1352,12 @@ GSComputeSubsystem::~GSComputeSubsystem() {
     shutdown();
 }
 
-bool GSComputeSubsystem::initialize(const std::vector<GSVertex>& vertices, const std::shared_ptr<Camera>& camera) {
+bool GSComputeSubsystem::initialize(const std::vector<GSVertex>& vertices, const std::shared_ptr<Camera>& camera,
+                                    uint32_t maxShDegree, GSPrefixScan prefixScan) {
     if (!camera) {
         return false;
     }
-    return engine_->initializeEmbedded(vertices, camera);
+    return engine_->initializeEmbedded(vertices, camera, maxShDegree, prefixScan);
 }
 
 void GSComputeSubsystem::shutdown() {
@@ -1148,24 +1372,19 @@ void GSComputeSubsystem::updateUniforms() {
     }
 }
 
-GSPreprocessResult GSComputeSubsystem::runPreprocessSubmitWait() {
-    if (!engine_) {
-        return {};
+void GSComputeSubsystem::beginFrame() {
+    if (engine_) {
+        engine_->beginFrame();
     }
-    engine_->refreshForHybridPreprocess();
-    const auto prep = engine_->runPreprocessPassForHybrid();
-    GSPreprocessResult out{};
-    out.numInstances = prep.numInstances == 0 ? 1u : prep.numInstances;
-    out.prefixInPing = prep.prefixInPing;
-    return out;
 }
 
-void GSComputeSubsystem::recordSortAndRender(VkCommandBuffer cmd, uint32_t swapchainImageIndex, const GSPreprocessResult& prep) {
+void GSComputeSubsystem::recordFrame(VkCommandBuffer cmd, uint32_t swapchainImageIndex) {
     if (!engine_ || cmd == VK_NULL_HANDLE) {
         return;
     }
-    engine_->prepareSortedInstances(prep.numInstances);
-    engine_->recordSortAndRenderIntoCommandBuffer(cmd, swapchainImageIndex, prep.numInstances, prep.prefixInPing);
+    engine_->recordUniformUpdate(cmd);
+    engine_->recordPreprocessIntoCommandBuffer(cmd);
+    engine_->recordSortAndRenderIntoCommandBuffer(cmd, swapchainImageIndex);
 }
 
 VkImageView GSComputeSubsystem::gsColorView(uint32_t index) const {
@@ -1179,11 +1398,11 @@ VkImageView GSComputeSubsystem::gsDepthView(uint32_t index) const {
 } // namespace gs
 } // namespace gt
 
-bool GSComputeRenderer::initialize(const std::vector<GSVertex>& vertices) {
+bool GSComputeRenderer::initialize(const std::vector<GSVertex>& vertices, uint32_t maxShDegree, GSPrefixScan prefixScan) {
     if (!gt::gs::g_standaloneEngine) {
         gt::gs::g_standaloneEngine = new gt::gs::GaussianSplatComputeEngine();
     }
-    return gt::gs::g_standaloneEngine->initialize(vertices);
+    return gt::gs::g_standaloneEngine->initialize(vertices, maxShDegree, prefixScan);
 }
 
 void GSComputeRenderer::run() {
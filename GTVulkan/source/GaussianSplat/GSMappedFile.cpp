@@ -0,0 +1,76 @@
+#include "GaussianSplat/GSMappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+GSMappedFile::GSMappedFile(const std::string& filename) {
+#ifdef _WIN32
+    file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER fileSize{};
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+        release();
+        throw std::runtime_error("Could not open " + filename);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) {
+        return;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        release();
+        throw std::runtime_error("Could not map " + filename);
+    }
+    data = static_cast<const uint8_t*>(view);
+#else
+    fd = open(filename.c_str(), O_RDONLY);
+    struct stat fileStat {};
+    if (fd < 0 || fstat(fd, &fileStat) != 0) {
+        release();
+        throw std::runtime_error("Could not open " + filename);
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+    if (size == 0) {
+        return;
+    }
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        release();
+        throw std::runtime_error("Could not map " + filename);
+    }
+    // the payload is read once front to back (per chunk), let the kernel read ahead
+    madvise(view, size, MADV_SEQUENTIAL);
+    data = static_cast<const uint8_t*>(view);
+#endif
+}
+
+GSMappedFile::~GSMappedFile() {
+    release();
+}
+
+void GSMappedFile::release() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file && file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    mapping = nullptr;
+    file = nullptr;
+#else
+    if (data) munmap(const_cast<uint8_t*>(data), size);
+    if (fd >= 0) close(fd);
+    fd = -1;
+#endif
+    data = nullptr;
+}
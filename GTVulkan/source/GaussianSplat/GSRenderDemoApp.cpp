@@ -9,9 +9,9 @@ GSRenderDemoApp::GSRenderDemoApp()
 
 GSRenderDemoApp::~GSRenderDemoApp() = default;
 
-bool GSRenderDemoApp::initialize(const std::string& plyPath) {
+bool GSRenderDemoApp::initialize(const std::string& plyPath, uint32_t maxShDegree, GSPrefixScan prefixScan) {
     const auto vertices = sceneLoader->load(plyPath);
-    return renderer->initialize(vertices);
+    return renderer->initialize(vertices, maxShDegree, prefixScan);
 }
 
 void GSRenderDemoApp::run() {
@@ -1,14 +1,21 @@
 #include "GaussianSplat/GSSceneLoader.h"
 
+#include "GaussianSplat/GSCompressedScene.h"
+#include "GaussianSplat/GSMappedFile.h"
+
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
+#include <functional>
 #include <limits>
-#include <map>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -49,32 +56,6 @@ PlyScalarType parseScalarType(const std::string& token) {
     return PlyScalarType::Unknown;
 }
 
-template <typename T>
-T readBinaryValue(std::ifstream& plyFile) {
-    T value{};
-    plyFile.read(reinterpret_cast<char*>(&value), sizeof(T));
-    if (!plyFile.good()) {
-        throw std::runtime_error("Failed to read binary PLY payload.");
-    }
-    return value;
-}
-
-float readBinaryScalarAsFloat(std::ifstream& plyFile, PlyScalarType type) {
-    switch (type) {
-    case PlyScalarType::Int8: return static_cast<float>(readBinaryValue<int8_t>(plyFile));
-    case PlyScalarType::UInt8: return static_cast<float>(readBinaryValue<uint8_t>(plyFile));
-    case PlyScalarType::Int16: return static_cast<float>(readBinaryValue<int16_t>(plyFile));
-    case PlyScalarType::UInt16: return static_cast<float>(readBinaryValue<uint16_t>(plyFile));
-    case PlyScalarType::Int32: return static_cast<float>(readBinaryValue<int32_t>(plyFile));
-    case PlyScalarType::UInt32: return static_cast<float>(readBinaryValue<uint32_t>(plyFile));
-    case PlyScalarType::Float32: return readBinaryValue<float>(plyFile);
-    case PlyScalarType::Float64: return static_cast<float>(readBinaryValue<double>(plyFile));
-    case PlyScalarType::Unknown:
-    default:
-        throw std::runtime_error("Unsupported PLY scalar property type.");
-    }
-}
-
 std::optional<int> parseIndexedProperty(const std::string& name, const std::string& prefix) {
     if (name.rfind(prefix, 0) != 0) {
         return std::nullopt;
@@ -93,7 +74,7 @@ std::optional<int> parseIndexedProperty(const std::string& name, const std::stri
     return value;
 }
 
-PlyHeader loadPlyHeader(std::ifstream& plyFile) {
+PlyHeader loadPlyHeader(std::istream& plyFile) {
     PlyHeader header{};
     std::string line;
     bool headerEnd = false;
@@ -165,109 +146,213 @@ PlyHeader loadPlyHeader(std::ifstream& plyFile) {
     return header;
 }
 
-std::vector<GSVertex> loadPlyVertices(const std::string& filename) {
-    std::ifstream plyFile(filename, std::ios::binary);
-    if (!plyFile.is_open()) {
-        throw std::runtime_error("Could not open PLY: " + filename);
+size_t scalarSize(PlyScalarType type) {
+    switch (type) {
+    case PlyScalarType::Int8:
+    case PlyScalarType::UInt8: return 1;
+    case PlyScalarType::Int16:
+    case PlyScalarType::UInt16: return 2;
+    case PlyScalarType::Int32:
+    case PlyScalarType::UInt32:
+    case PlyScalarType::Float32: return 4;
+    case PlyScalarType::Float64: return 8;
+    case PlyScalarType::Unknown:
+    default: return 0;
     }
+}
 
-    const auto header = loadPlyHeader(plyFile);
-    if (header.numVertices <= 0) {
-        throw std::runtime_error("PLY has no vertices: " + filename);
-    }
+// Per-vertex staging floats a decode op writes to; the SH block is copied to GSVertex::sh as is.
+enum StagingSlot : uint16_t {
+    SlotX, SlotY, SlotZ,
+    SlotOpacity,
+    SlotScale0, SlotScale1, SlotScale2,
+    SlotRot0, SlotRot1, SlotRot2, SlotRot3,
+    SlotSh,
+    SlotCount = SlotSh + 48
+};
 
-    std::map<std::string, size_t> propertyIndices;
-    std::map<int, size_t> restPropertyIndices;
-    for (size_t i = 0; i < header.vertexProperties.size(); i++) {
-        const auto& property = header.vertexProperties[i];
-        propertyIndices[property.name] = i;
-        if (const auto restIndex = parseIndexedProperty(property.name, "f_rest_"); restIndex.has_value()) {
-            restPropertyIndices[*restIndex] = i;
+struct DecodeOp {
+    uint32_t offset = 0;  // byte offset inside a vertex record
+    PlyScalarType type = PlyScalarType::Unknown;
+    uint16_t slot = 0;
+};
+
+// Built once from the header: which bytes of a vertex record land in which staging slot.
+// Properties the renderer does not use (normals, SH beyond degree 3, ...) have no op.
+struct DecodePlan {
+    size_t stride = 0;
+    std::vector<DecodeOp> ops;
+    bool allFloat32 = true;
+    float defaults[SlotCount] = {};
+};
+
+std::optional<uint16_t> stagingSlotFor(const std::string& name) {
+    static const std::pair<const char*, uint16_t> kNamedSlots[] = {
+        { "x", SlotX }, { "y", SlotY }, { "z", SlotZ },
+        { "opacity", SlotOpacity },
+        { "scale_0", SlotScale0 }, { "scale_1", SlotScale1 }, { "scale_2", SlotScale2 },
+        { "rot_0", SlotRot0 }, { "rot_1", SlotRot1 }, { "rot_2", SlotRot2 }, { "rot_3", SlotRot3 },
+        { "f_dc_0", SlotSh + 0 }, { "f_dc_1", SlotSh + 1 }, { "f_dc_2", SlotSh + 2 },
+    };
+    for (const auto& [slotName, slot] : kNamedSlots) {
+        if (name == slotName) {
+            return slot;
         }
     }
 
-    const auto requireProperty = [&](const std::string& propertyName) -> size_t {
-        const auto it = propertyIndices.find(propertyName);
-        if (it == propertyIndices.end()) {
-            throw std::runtime_error("PLY is missing required vertex property: " + propertyName);
+    // Runtime vertex layout supports up to SH degree 3 (16 basis functions * RGB).
+    // f_rest_* is channel-major (15 R, 15 G, 15 B); any higher-degree tail is ignored.
+    const auto restIndex = parseIndexedProperty(name, "f_rest_");
+    if (!restIndex.has_value() || *restIndex >= 45) {
+        return std::nullopt;
+    }
+    const int channel = *restIndex / 15;
+    const int basis = *restIndex % 15 + 1;
+    return static_cast<uint16_t>(SlotSh + basis * 3 + channel);
+}
+
+DecodePlan buildDecodePlan(const PlyHeader& header) {
+    DecodePlan plan;
+    plan.defaults[SlotRot0] = 1.0f;  // identity quaternion (w, x, y, z)
+
+    bool hasX = false, hasY = false, hasZ = false;
+    for (const auto& property : header.vertexProperties) {
+        const size_t size = scalarSize(property.type);
+        if (const auto slot = stagingSlotFor(property.name); slot.has_value()) {
+            plan.ops.push_back({ static_cast<uint32_t>(plan.stride), property.type, *slot });
+            plan.allFloat32 = plan.allFloat32 && property.type == PlyScalarType::Float32;
+            hasX = hasX || *slot == SlotX;
+            hasY = hasY || *slot == SlotY;
+            hasZ = hasZ || *slot == SlotZ;
         }
-        return it->second;
-    };
+        plan.stride += size;
+    }
+    if (!hasX || !hasY || !hasZ) {
+        throw std::runtime_error(std::string("PLY is missing required vertex property: ")
+            + (!hasX ? "x" : !hasY ? "y" : "z"));
+    }
+    return plan;
+}
 
-    const size_t xIdx = requireProperty("x");
-    const size_t yIdx = requireProperty("y");
-    const size_t zIdx = requireProperty("z");
+template <typename T>
+float loadScalar(const uint8_t* source) {
+    T value;
+    std::memcpy(&value, source, sizeof(T));
+    return static_cast<float>(value);
+}
 
-    const auto findProperty = [&](const std::string& propertyName) -> std::optional<size_t> {
-        const auto it = propertyIndices.find(propertyName);
-        return it == propertyIndices.end() ? std::nullopt : std::optional<size_t>(it->second);
-    };
+float decodeScalar(const uint8_t* source, PlyScalarType type) {
+    switch (type) {
+    case PlyScalarType::Int8: return loadScalar<int8_t>(source);
+    case PlyScalarType::UInt8: return loadScalar<uint8_t>(source);
+    case PlyScalarType::Int16: return loadScalar<int16_t>(source);
+    case PlyScalarType::UInt16: return loadScalar<uint16_t>(source);
+    case PlyScalarType::Int32: return loadScalar<int32_t>(source);
+    case PlyScalarType::UInt32: return loadScalar<uint32_t>(source);
+    case PlyScalarType::Float32: return loadScalar<float>(source);
+    case PlyScalarType::Float64: return loadScalar<double>(source);
+    case PlyScalarType::Unknown:
+    default: return 0.0f;
+    }
+}
 
-    const auto opacityIdx = findProperty("opacity");
-    const auto scale0Idx = findProperty("scale_0");
-    const auto scale1Idx = findProperty("scale_1");
-    const auto scale2Idx = findProperty("scale_2");
-    const auto rot0Idx = findProperty("rot_0");
-    const auto rot1Idx = findProperty("rot_1");
-    const auto rot2Idx = findProperty("rot_2");
-    const auto rot3Idx = findProperty("rot_3");
-    const auto dc0Idx = findProperty("f_dc_0");
-    const auto dc1Idx = findProperty("f_dc_1");
-    const auto dc2Idx = findProperty("f_dc_2");
-
-    std::vector<GSVertex> vertices(static_cast<size_t>(header.numVertices));
-    for (int i = 0; i < header.numVertices; i++) {
-        std::vector<float> values(header.vertexProperties.size(), 0.0f);
-        for (size_t propIndex = 0; propIndex < header.vertexProperties.size(); propIndex++) {
-            values[propIndex] = readBinaryScalarAsFloat(plyFile, header.vertexProperties[propIndex].type);
-        }
+void finalizeVertex(const float* staging, GSVertex& vertex) {
+    vertex.position = glm::vec4(staging[SlotX], staging[SlotY], staging[SlotZ], 1.0f);
+    vertex.scale_opacity = glm::vec4(
+        glm::exp(staging[SlotScale0]),
+        glm::exp(staging[SlotScale1]),
+        glm::exp(staging[SlotScale2]),
+        1.0f / (1.0f + std::exp(-staging[SlotOpacity])));
+
+    // Keep the same convention as 3DGS + shader `rotationFromQuaternion`:
+    // payload stores quaternion as (w, x, y, z).
+    const glm::vec4 rotationWxyz(staging[SlotRot0], staging[SlotRot1], staging[SlotRot2], staging[SlotRot3]);
+    const float rotationNorm = glm::length(rotationWxyz);
+    vertex.rotation = rotationNorm > std::numeric_limits<float>::epsilon()
+        ? (rotationWxyz / rotationNorm)
+        : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+    std::memcpy(vertex.sh, staging + SlotSh, sizeof(vertex.sh));
+}
 
-        auto& vertex = vertices[i];
-        vertex.position = glm::vec4(values[xIdx], values[yIdx], values[zIdx], 1.0f);
-
-        const float opacity = opacityIdx.has_value() ? values[*opacityIdx] : 0.0f;
-        const float sx = scale0Idx.has_value() ? values[*scale0Idx] : 0.0f;
-        const float sy = scale1Idx.has_value() ? values[*scale1Idx] : 0.0f;
-        const float sz = scale2Idx.has_value() ? values[*scale2Idx] : 0.0f;
-        vertices[i].scale_opacity = glm::vec4(
-            glm::exp(sx),
-            glm::exp(sy),
-            glm::exp(sz),
-            1.0f / (1.0f + std::exp(-opacity)));
-
-        // Keep the same convention as 3DGS + shader `rotationFromQuaternion`:
-        // payload stores quaternion as (w, x, y, z).
-        const float rw = rot0Idx.has_value() ? values[*rot0Idx] : 1.0f;
-        const float rx = rot1Idx.has_value() ? values[*rot1Idx] : 0.0f;
-        const float ry = rot2Idx.has_value() ? values[*rot2Idx] : 0.0f;
-        const float rz = rot3Idx.has_value() ? values[*rot3Idx] : 0.0f;
-        const glm::vec4 rotationWxyz(rw, rx, ry, rz);
-        const float rotationNorm = glm::length(rotationWxyz);
-        vertex.rotation = rotationNorm > std::numeric_limits<float>::epsilon()
-            ? (rotationWxyz / rotationNorm)
-            : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
-
-        for (float& shCoeff : vertex.sh) {
-            shCoeff = 0.0f;
-        }
-        if (dc0Idx.has_value()) vertex.sh[0] = values[*dc0Idx];
-        if (dc1Idx.has_value()) vertex.sh[1] = values[*dc1Idx];
-        if (dc2Idx.has_value()) vertex.sh[2] = values[*dc2Idx];
-
-        // Runtime vertex layout supports up to SH degree 3 (16 basis functions * RGB).
-        // Populate available f_rest_* coefficients and safely ignore any higher-degree tail.
-        for (const auto& [restIndex, propertyIndex] : restPropertyIndices) {
-            if (restIndex < 0 || restIndex >= 45) {
-                continue;
+void decodeVertexRange(const DecodePlan& plan, const uint8_t* payload, size_t first, size_t last,
+                       GSVertex* vertices) {
+    float staging[SlotCount];
+    const uint8_t* record = payload + first * plan.stride;
+    for (size_t i = first; i < last; i++, record += plan.stride) {
+        std::memcpy(staging, plan.defaults, sizeof(staging));
+        if (plan.allFloat32) {
+            for (const DecodeOp& op : plan.ops) {
+                std::memcpy(&staging[op.slot], record + op.offset, sizeof(float));
             }
-            if (restIndex < 15) {
-                vertex.sh[(restIndex + 1) * 3 + 0] = values[propertyIndex];
-            } else if (restIndex < 30) {
-                vertex.sh[(restIndex - 14) * 3 + 1] = values[propertyIndex];
-            } else {
-                vertex.sh[(restIndex - 29) * 3 + 2] = values[propertyIndex];
+        } else {
+            for (const DecodeOp& op : plan.ops) {
+                staging[op.slot] = decodeScalar(record + op.offset, op.type);
             }
         }
+        finalizeVertex(staging, vertices[i]);
+    }
+}
+
+// byte offset of the payload, just past the "end_header" line
+size_t findPayloadOffset(const GSMappedFile& file) {
+    constexpr std::string_view kHeaderEnd = "end_header";
+    const std::string_view text(reinterpret_cast<const char*>(file.data), file.size);
+    // the keyword alone at the start of a line, not inside a comment or property name
+    const auto isHeaderEnd = [&](size_t position) {
+        const size_t next = position + kHeaderEnd.size();
+        return (position == 0 || text[position - 1] == '\n')
+            && (next == text.size() || text[next] == '\n' || text[next] == '\r' || text[next] == ' ');
+    };
+    size_t position = text.find(kHeaderEnd);
+    while (position != std::string_view::npos && !isHeaderEnd(position)) {
+        position = text.find(kHeaderEnd, position + 1);
+    }
+    if (position == std::string_view::npos) {
+        throw std::runtime_error("Invalid PLY file: end_header not found.");
+    }
+    const size_t lineEnd = text.find('\n', position);
+    if (lineEnd == std::string_view::npos) {
+        throw std::runtime_error("Invalid PLY file: no payload after end_header.");
+    }
+    return lineEnd + 1;
+}
+
+std::vector<GSVertex> loadPlyVertices(const std::string& filename, unsigned threadCount) {
+    const GSMappedFile file(filename);
+    const size_t payloadOffset = findPayloadOffset(file);
+
+    std::istringstream headerText(std::string(reinterpret_cast<const char*>(file.data), payloadOffset));
+    const auto header = loadPlyHeader(headerText);
+    if (header.numVertices <= 0) {
+        throw std::runtime_error("PLY has no vertices: " + filename);
+    }
+
+    const DecodePlan plan = buildDecodePlan(header);
+    const size_t vertexCount = static_cast<size_t>(header.numVertices);
+    if (file.size - payloadOffset < vertexCount * plan.stride) {
+        throw std::runtime_error("Failed to read binary PLY payload: file is truncated.");
+    }
+    const uint8_t* payload = file.data + payloadOffset;
+
+    std::vector<GSVertex> vertices(vertexCount);
+
+    // contiguous ranges per thread; small scenes are not worth a thread
+    constexpr size_t kMinVerticesPerThread = 16384;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t threads = std::clamp<size_t>(vertexCount / kMinVerticesPerThread, 1, threadCount);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        workers.emplace_back(decodeVertexRange, std::cref(plan), payload,
+            vertexCount * t / threads, vertexCount * (t + 1) / threads, vertices.data());
+    }
+    decodeVertexRange(plan, payload, 0, vertexCount / threads, vertices.data());
+    for (auto& worker : workers) {
+        worker.join();
     }
     return vertices;
 }
@@ -287,12 +372,47 @@ std::vector<GSVertex> createFallbackScene() {
     return {v};
 }
 
+std::vector<GSVertex> loadGtsVertices(const std::string& filename, unsigned threadCount) {
+    const GtsSceneReader reader(filename);
+    if (reader.splatCount() == 0) {
+        throw std::runtime_error("GTS has no splats: " + filename);
+    }
+    std::vector<GSVertex> vertices(static_cast<size_t>(reader.splatCount()));
+    reader.decodeAll(vertices.data(), threadCount);
+    return vertices;
+}
+
+bool hasGtsExtension(const std::string& path) {
+    constexpr std::string_view kExtension = ".gts";
+    return path.size() >= kExtension.size()
+        && std::equal(kExtension.rbegin(), kExtension.rend(), path.rbegin(),
+            [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); });
+}
+
 } // namespace
 
-std::vector<GSVertex> GSSceneLoader::load(const std::string& plyPath) const {
-    if (plyPath.empty()) {
+std::vector<GSVertex> GSSceneLoader::load(const std::string& scenePath, unsigned threadCount) const {
+    if (scenePath.empty()) {
         return createFallbackScene();
     }
-    return loadPlyVertices(plyPath);
+    if (hasGtsExtension(scenePath)) {
+        return loadGtsVertices(scenePath, threadCount);
+    }
+    return loadPlyVertices(scenePath, threadCount);
 }
 
+uint32_t GSSceneLoader::shDegreeInUse(const std::vector<GSVertex>& vertices) {
+    uint32_t degree = 0;
+    for (const GSVertex& vertex : vertices) {
+        // only the bands above the degree found so far need a look
+        for (uint32_t k = gsShFloatCount(degree); k < gsShFloatCount(3); k++) {
+            if (vertex.sh[k] != 0.0f) {
+                degree = k < gsShFloatCount(1) ? 1 : k < gsShFloatCount(2) ? 2 : 3;
+            }
+        }
+        if (degree == 3) {
+            break;
+        }
+    }
+    return degree;
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+#include <vector>
+
 struct GLFWwindow;
 
 class GUIManager
@@ -13,14 +17,23 @@ public :
     void Render();
     void EndRender();
 
+    // pipelined frames: the main thread finishes the UI frame into `slot` (ImGui::Render + a copy of
+    // the draw lists, no GL), the render thread draws that copy over its scene later
+    void CaptureFrame(size_t slot);
+    void RenderCapturedFrame(size_t slot);
+
     bool IsInited();
 
 private:
     GUIManager() = default;
-    ~GUIManager() = default;
+    ~GUIManager();
     // forbidden copy and assign value
     GUIManager(const GUIManager&) = delete;
     GUIManager& operator=(const GUIManager&) = delete;
 
+    struct CapturedFrame;
+    void ReleaseCapturedFrames();
+
     bool mbInited{ false };
+    std::vector<std::unique_ptr<CapturedFrame>> mCapturedFrames;
 };
@@ -31,6 +31,7 @@ class FrameSync;
 class RenderThread;
 
 #include "TinyEngineHostUI.h"
+#include "memory/LinearArena.h"
 
 class EventHelper
 {
@@ -97,11 +98,26 @@ public:
 	// Resize RenderView when window size changes
 	void ResizeRenderView(int width, int height);
 
+	// rebuild programs when files under resources/shaders are saved (set before Run)
+	void SetHotShaderReload(bool enabled) { mHotShaderReload = enabled; }
+
+	// multithreaded rendering: 1 = main and render thread in lockstep, 2..3 = the main thread builds
+	// the next frames while the render thread draws (set before Run)
+	void SetFramesInFlight(uint32_t count) { mFramesInFlight = count; }
+	// pipelined frames: the main thread stops running ahead once the oldest frame is this old; 0 = off
+	void SetFrameLatencyBudget(double milliseconds) { mFrameLatencyBudgetMs = milliseconds; }
+
 private:
 	void RenderLoop();
 	void ProcessPendingSandboxSwitch();
 	void ActivateSandbox(int index);
+	void StartShaderHotReload();
+	void SubmitPipelinedFrame(std::vector<RenderCommand>& commands);
+	// blocks until the render thread has drawn every submitted frame (pipelined mode)
+	void WaitForRenderIdle();
 	std::vector<RenderCommand> GetSceneRenderCommands() const;
+	// refills commands, keeping its capacity
+	void CollectSceneRenderCommands(std::vector<RenderCommand>& commands) const;
 	std::shared_ptr<FragmentsSource> GetSceneFragmentsSource() const;
 	std::shared_ptr<BasicGeometry> GetSceneGeometry() const;
 
@@ -155,9 +171,18 @@ private:
 	std::shared_ptr<BasicGeometry> mpPickedGeometry;
 	glm::vec3 mSelectedGeomPosition{ 0.0f, 0.0f, 0.0f };
 	bool mMultithreadedRendering{ true };
+	uint32_t mFramesInFlight{ 2 };
+	double mFrameLatencyBudgetMs{ 50.0 };
+	std::vector<RenderCommand> mSceneCommands;  // this frame's commands, reused so steady frames do not allocate
+	te::LinearArena mSceneArena;  // frame scene of the lockstep / single-thread paths, one frame at a time
+	uint64_t mFrameIndex{ 0 };
+	bool mHotShaderReload{ true };
+	GLFWwindow* mShaderReloadWindow{ nullptr };  // hidden, its context belongs to the reload worker
 	bool mShowHelpWindow{ false };
 	bool mShowFileHandleWindow{ false };
 	bool mShowSceneHelperWindow{ true };
+	bool mShowProfilerWindow{ false };
+	std::string mLastTracePath;
 
 	TinyEngineHostUI mHostUI;
 };
\ No newline at end of file
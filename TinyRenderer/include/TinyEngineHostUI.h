@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <string>
@@ -7,6 +8,15 @@
 
 class BasicGeometry;
 
+/** One render pass row of the profiler panel (moving averages). */
+struct TinyEngineHostUIPassTiming
+{
+    std::string name;
+    float cpuMs{ 0.0f };
+    float gpuMs{ 0.0f };
+    bool hasGpu{ false };
+};
+
 /** Snapshot of host state for one frame; mutated by BuildLayout for toggles and sandbox selection. */
 struct TinyEngineHostUIState
 {
@@ -25,6 +35,34 @@ struct TinyEngineHostUIState
     glm::vec3 selectedHitPosition{ 0.0f };
     std::shared_ptr<BasicGeometry> pickedGeometry;
     std::shared_ptr<BasicGeometry> fallbackGeometry;
+
+    /** Renderer counters of the frame being built (instanced draws count once per call). */
+    uint32_t drawCalls{ 0 };
+    uint32_t drawnInstances{ 0 };
+
+    /** Render graph: render targets reused from the transient pool this frame. */
+    bool showResourcePool{ false };
+    uint32_t poolHits{ 0 };
+    uint32_t poolMisses{ 0 };
+    uint32_t poolTargets{ 0 };
+    float poolMemoryMB{ 0.0f };
+
+    /** Multithreaded rendering: per-frame moving averages of both threads. */
+    bool showFramePipeline{ false };
+    uint32_t framesInFlight{ 0 };
+    uint32_t maxFramesInFlight{ 1 };
+    float mainBusyMs{ 0.0f };
+    float mainIdleMs{ 0.0f };
+    float renderBusyMs{ 0.0f };
+    float renderIdleMs{ 0.0f };
+    float frameLatencyMs{ 0.0f };
+
+    /** Profiler: per-pass CPU / GPU timings; the host writes the trace file on request. */
+    bool showProfilerWindow{ false };
+    bool profilerEnabled{ false };
+    std::vector<TinyEngineHostUIPassTiming> passTimings;
+    bool pendingTraceCapture{ false };
+    std::string lastTracePath;
 };
 
 /** ImGui layout for TinyRenderer host (toolbar + tool panels). */
@@ -4,16 +4,35 @@
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 
+// draw lists cloned out of the ImGui context, valid across NewFrame
+struct GUIManager::CapturedFrame
+{
+    ImDrawData drawData;
+
+    void Release()
+    {
+        for (ImDrawList* drawList : drawData.CmdLists)
+        {
+            IM_DELETE(drawList);
+        }
+        drawData.Clear();
+    }
+};
+
 GUIManager& GUIManager::GetInstance()
 {
     static GUIManager guiManager;
     return guiManager;
 }
 
+GUIManager::~GUIManager() = default;
+
 void GUIManager::EndRender()
 {
     if (IsInited())
     {
+        // the clones use the context's shared draw data
+        ReleaseCapturedFrames();
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -56,6 +75,61 @@ void GUIManager::Render()
     }
 }
 
+void GUIManager::CaptureFrame(size_t slot)
+{
+    ImGui::Render();
+
+    if (mCapturedFrames.size() <= slot)
+    {
+        mCapturedFrames.resize(slot + 1);
+    }
+    auto& captured = mCapturedFrames[slot];
+    if (!captured)
+    {
+        captured = std::make_unique<CapturedFrame>();
+    }
+
+    // the slot's previous frame was presented before the slot was handed out again
+    captured->Release();
+    const ImDrawData* drawData = ImGui::GetDrawData();
+    if (!drawData || !drawData->Valid)
+    {
+        return;
+    }
+
+    captured->drawData = *drawData;
+    for (ImDrawList*& drawList : captured->drawData.CmdLists)
+    {
+        drawList = drawList->CloneOutput();
+    }
+}
+
+void GUIManager::RenderCapturedFrame(size_t slot)
+{
+    if (slot >= mCapturedFrames.size() || !mCapturedFrames[slot])
+    {
+        return;
+    }
+
+    ImDrawData& drawData = mCapturedFrames[slot]->drawData;
+    if (drawData.Valid && drawData.CmdListsCount > 0)
+    {
+        ImGui_ImplOpenGL3_RenderDrawData(&drawData);
+    }
+}
+
+void GUIManager::ReleaseCapturedFrames()
+{
+    for (auto& captured : mCapturedFrames)
+    {
+        if (captured)
+        {
+            captured->Release();
+        }
+    }
+    mCapturedFrames.clear();
+}
+
 bool GUIManager::IsInited()
 {
     return mbInited;
@@ -83,6 +157,9 @@ void GUIManager::Init(GLFWwindow* mWindow)
     // Setup Platform/Renderer backends
     ImGui_ImplGlfw_InitForOpenGL(mWindow, true);
     ImGui_ImplOpenGL3_Init("#version 330");
+    // created now, with the context current, so NewFrame never needs GL (pipelined frames build
+    // the UI on the main thread while the render thread owns the context)
+    ImGui_ImplOpenGL3_CreateDeviceObjects();
 
     mbInited = true;
 }
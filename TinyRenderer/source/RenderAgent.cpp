@@ -24,7 +24,14 @@
 #include "framework/RenderPassManager.h"
 #include "framework/RenderCommandQueue.h"
 #include "framework/FrameSync.h"
+#include "framework/FrameScene.h"
 #include "framework/RenderThread.h"
+#include "framework/JobSystem.h"
+#include "framework/Profiler.h"
+#include "shader/ProgramBinaryCache.h"
+#include "shader/ShaderVariants.h"
+#include "shader/ShaderHotReload.h"
+#include "filesystem.h"
 #include <mutex>
 
 #include "GUIManager.h"
@@ -201,6 +208,9 @@ void RenderAgent::ActivateSandbox(int index)
         return;
     }
 
+    // frames in flight still reference the current scene
+    WaitForRenderIdle();
+
     if (mSandbox && mpRenderer)
     {
         mSandbox->Teardown(mpRenderer);
@@ -223,6 +233,11 @@ void RenderAgent::ActivateSandbox(int index)
         enableInteraction = mSandbox->IsEnableInteraction();
     }
 
+    // cold (compiled) vs warm (cached binary) program build time of this switch
+    auto& programCache = te::ProgramBinaryCache::GetInstance();
+    programCache.LogStats("sandbox '" + mSandboxCatalog[static_cast<size_t>(index)].displayName + "'");
+    programCache.ResetStats();
+
     mActiveSandboxIndex = index;
     mSelectedSandboxIndex = index;
     mPendingSandboxIndex = -1;
@@ -244,6 +259,30 @@ void RenderAgent::Run()
 {
     PreRender();
 
+    // material variants used by previous runs, so the first frames do not compile them
+    {
+        // the render thread binds the context per frame, borrow it the way ActivateSandbox does
+        std::unique_lock<std::mutex> lock(g_GLContextMutex, std::defer_lock);
+        if (mMultithreadedRendering)
+        {
+            lock.lock();
+            glfwMakeContextCurrent(mWindow);
+        }
+        te::ShaderVariantCache::GetInstance().Precompile(te::ShaderVariantCache::GetDefaultManifestPath());
+        if (mMultithreadedRendering)
+        {
+            glfwMakeContextCurrent(nullptr);
+        }
+    }
+
+    if (mHotShaderReload)
+    {
+        StartShaderHotReload();
+    }
+
+    te::ProgramBinaryCache::GetInstance().LogStats("startup (render passes)");
+    te::ProgramBinaryCache::GetInstance().ResetStats();
+
     if (!mSandboxCatalog.empty() && mActiveSandboxIndex < 0 && !mSandbox)
     {
         ActivateSandbox(0);
@@ -265,11 +304,19 @@ void RenderAgent::Run()
 
 std::vector<RenderCommand> RenderAgent::GetSceneRenderCommands() const
 {
-    if (!mSandbox)
+    std::vector<RenderCommand> commands;
+    CollectSceneRenderCommands(commands);
+    return commands;
+}
+
+void RenderAgent::CollectSceneRenderCommands(std::vector<RenderCommand>& commands) const
+{
+    TE_PROFILE_SCOPE("CollectSceneRenderCommands");
+    commands.clear();
+    if (mSandbox)
     {
-        return {};
+        mSandbox->CollectRenderCommands(commands);
     }
-    return mSandbox->GetRenderCommands();
 }
 
 std::shared_ptr<FragmentsSource> RenderAgent::GetSceneFragmentsSource() const
@@ -290,8 +337,11 @@ void RenderAgent::RenderLoop()
 {
     // render loop
     // -----------
+    te::Profiler::GetInstance().SetThreadName("Main");
     while (!glfwWindowShouldClose(mWindow))
     {
+        TE_PROFILE_SCOPE("MainThread::Frame");
+
         // per-frame time logic
         // --------------------
         float currentFrame = static_cast<float>(glfwGetTime());
@@ -309,11 +359,24 @@ void RenderAgent::RenderLoop()
             mSandbox->Update(mpRenderer);
         }
 
-        auto sceneCommands = GetSceneRenderCommands();
+        CollectSceneRenderCommands(mSceneCommands);
+        std::vector<RenderCommand>& sceneCommands = mSceneCommands;
 
-        if (mMultithreadedRendering)
+        if (mMultithreadedRendering && mpFrameSync->IsPipelined())
         {
-            // multi-thread rendering path
+            // pipelined path: this frame is built while the render thread still draws older ones,
+            // the render thread renders the captured UI and presents
+            // (ImGui device objects exist since Init, so the UI needs no context here)
+            GUIManager::GetInstance().BeginRender();
+            UpdateGUI();
+
+            SubmitPipelinedFrame(sceneCommands);
+
+            glfwPollEvents();
+        }
+        else if (mMultithreadedRendering)
+        {
+            // multi-thread rendering path (lockstep)
             // 1. prepare ImGui frame (must be done early in main thread for input handling)
             //    This needs to happen before rendering so ImGui can process input
             {
@@ -326,13 +389,22 @@ void RenderAgent::RenderLoop()
                 glfwMakeContextCurrent(nullptr);  // release context
             }
             
-            // 2. generate render commands (main thread)
-            const std::vector<RenderCommand> commands = sceneCommands;
+            // 2. generate render commands (main thread), moved through the ring without refcount traffic,
+            //    and snapshot what they draw; the render thread is idle, so the arena can be reused
+            std::vector<RenderCommand>& commands = sceneCommands;
+            mSceneArena.Reset();
+            mpRenderContext->SetFrameScene(te::BuildFrameScene(mSceneArena, mFrameIndex++, *mpRenderContext,
+                mpRenderView.get(), commands));
 
             // 3. build ImGui UI (this can be done without OpenGL context)
             UpdateGUI();
             
-            // 4. push to command queue
+            // 4. publish the whole frame to the command ring
+            //    the render thread is idle here (it finished the last frame), so the ring may grow
+            if (commands.size() > mpCommandQueue->Capacity())
+            {
+                mpCommandQueue->Reserve(commands.size());
+            }
             mpCommandQueue->PushCommands(commands);
             
             // 5. signal frame ready (render thread can now start rendering)
@@ -361,6 +433,10 @@ void RenderAgent::RenderLoop()
         }
         else
         {
+            mSceneArena.Reset();
+            mpRenderContext->SetFrameScene(te::BuildFrameScene(mSceneArena, mFrameIndex++, *mpRenderContext,
+                mpRenderView.get(), sceneCommands));
+
             // Begin Render Frame
             mpRenderer->BeginFrame();
 
@@ -374,13 +450,8 @@ void RenderAgent::RenderLoop()
             }
             else
             {
-                for (const auto& command : sceneCommands)
-                {
-                    if (auto mesh = std::dynamic_pointer_cast<Mesh>(command.fragmentsSource))
-                    {
-                        mpRenderer->DrawMesh(mesh);
-                    }
-                }
+                // sorted and instanced by the renderer
+                mpRenderer->DrawMeshes(sceneCommands);
             }
 
             //mpRenderer->DrawBackgroud();
@@ -406,20 +477,102 @@ void RenderAgent::RenderLoop()
     }
 }
 
+void RenderAgent::SubmitPipelinedFrame(std::vector<RenderCommand>& commands)
+{
+    // blocks only while the render thread is mFramesInFlight frames or the latency budget behind
+    FrameSnapshot* frame = mpFrameSync->AcquireFrame();
+    if (!frame)
+    {
+        return;
+    }
+
+    // what the render thread draws this frame with, the main thread keeps moving the originals;
+    // the slot's arena was reset by AcquireFrame, its previous frame has retired
+    frame->scene = te::BuildFrameScene(frame->arena, frame->frameIndex, *mpRenderContext, mpRenderView.get(), commands);
+    GUIManager::GetInstance().CaptureFrame(frame->slot);
+
+    // frames share the ring; only a single frame larger than the ring needs it to grow,
+    // which is allowed once the render thread is idle
+    if (commands.size() > mpCommandQueue->Capacity())
+    {
+        mpFrameSync->WaitForIdle();
+        mpCommandQueue->Reserve(commands.size());
+    }
+    for (size_t pushed = 0; pushed < commands.size();)
+    {
+        const size_t count = mpCommandQueue->PushCommands(commands, pushed);
+        if (count == 0)
+        {
+            // older frames' commands still in the ring, the render thread drains them when it takes the frame
+            std::this_thread::yield();
+        }
+        pushed += count;
+    }
+    frame->commandCount = commands.size();
+
+    mpFrameSync->SubmitFrame(frame);
+}
+
+void RenderAgent::WaitForRenderIdle()
+{
+    if (mpFrameSync && mpFrameSync->IsPipelined() && mpRenderThread && mpRenderThread->IsRunning())
+    {
+        mpFrameSync->WaitForIdle();
+    }
+}
+
+void RenderAgent::StartShaderHotReload()
+{
+    // a hidden 1x1 window gives the worker a context that shares programs with mWindow;
+    // GLFW windows can only be created on the main thread
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    mShaderReloadWindow = glfwCreateWindow(1, 1, "shader reload", NULL, mWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (mShaderReloadWindow == NULL)
+    {
+        std::cout << "Failed to create the shader reload context, hot reload disabled" << std::endl;
+        return;
+    }
+
+    if (!te::ShaderHotReload::GetInstance().Start(mShaderReloadWindow, FileSystem::getPath("resources/shaders")))
+    {
+        glfwDestroyWindow(mShaderReloadWindow);
+        mShaderReloadWindow = nullptr;
+    }
+}
+
 void RenderAgent::PostRender()
 {
     // stop render thread
     if (mpRenderThread)
     {
+        const FramePipelineStats stats = mpFrameSync->GetStats();
+        std::cout << "[FrameSync] " << (mpFrameSync->IsPipelined() ? "pipelined" : "lockstep")
+                  << ", main busy " << stats.mainBusyMs << " / idle " << stats.mainIdleMs
+                  << " ms, render busy " << stats.renderBusyMs << " / idle " << stats.renderIdleMs
+                  << " ms, latency " << stats.latencyMs << " ms" << std::endl;
+
         mpRenderThread->Stop();
         mpRenderThread->Join();
+
+        // the render thread is gone, shutdown below needs the context on this thread
+        glfwMakeContextCurrent(mWindow);
     }
 
     // Terminate ImGui
     GUIManager::GetInstance().EndRender();
     te::RenderPassManager::GetInstance().GenerateVisualization("rendergraph.dot");
+    te::ShaderVariantCache::GetInstance().SaveManifest(te::ShaderVariantCache::GetDefaultManifestPath());
+
+    te::ShaderHotReload::GetInstance().Stop();
+    if (mShaderReloadWindow)
+    {
+        glfwDestroyWindow(mShaderReloadWindow);
+        mShaderReloadWindow = nullptr;
+    }
 
     mpRenderer->Shutdown();
+    te::JobSystem::GetInstance().Stop();
 
     // glfw: terminate, clearing all previously allocated GLFW resources.
     // ------------------------------------------------------------------
@@ -428,6 +581,9 @@ void RenderAgent::PostRender()
 
 void RenderAgent::PreRender()
 {
+    // workers for loading, bounds and pass preparation, before the sandboxes load anything
+    te::JobSystem::GetInstance().Start();
+
     SetupRenderer();
     SetupMultiPassRendering();
 
@@ -436,6 +592,10 @@ void RenderAgent::PreRender()
     {
         mpCommandQueue = std::make_shared<RenderCommandQueue>();
         mpFrameSync = std::make_shared<FrameSync>();
+        mpFrameSync->SetFramesInFlight(mFramesInFlight);
+        mpFrameSync->SetLatencyBudget(mFrameLatencyBudgetMs);
+        // pipelined frames upload geometry from their own copies, the scene may be edited meanwhile
+        te::MeshRegistry::GetInstance().SetStagedUploads(mpFrameSync->IsPipelined());
         
         // create render thread (share OpenGL context)
         // note: use mutex to synchronize context access
@@ -448,7 +608,13 @@ void RenderAgent::PreRender()
         
         // set RenderView to get viewport size
         mpRenderThread->SetRenderView(mpRenderView);
+        mpRenderThread->SetRenderContext(mpRenderContext);
+        mpRenderThread->SetOverlayRenderer([](const FrameSnapshot& frame) {
+            GUIManager::GetInstance().RenderCapturedFrame(frame.slot);
+        });
         
+        // from now on the main thread only borrows the context under g_GLContextMutex
+        glfwMakeContextCurrent(nullptr);
         mpRenderThread->Start();
         
         // wait for render thread initialization to complete
@@ -497,6 +663,7 @@ void RenderAgent::UpdateGUI()
     uiState.showHelpWindow = mShowHelpWindow;
     uiState.showSceneHelperWindow = mShowSceneHelperWindow;
     uiState.showFileHandleWindow = mShowFileHandleWindow;
+    uiState.showProfilerWindow = mShowProfilerWindow;
     uiState.cameraInteractionEnabled = enableInteraction;
     uiState.selectedSandboxIndex = mSelectedSandboxIndex;
     uiState.activeSandboxIndex = mActiveSandboxIndex;
@@ -505,6 +672,48 @@ void RenderAgent::UpdateGUI()
     uiState.pickedGeometry = mpPickedGeometry;
     uiState.fallbackGeometry = GetSceneGeometry();
 
+    // pipelined: the render thread is drawing an older frame, read the copy of its last completed one;
+    // otherwise it is idle (pass stats are folded into the renderer stats only at EndFrame, after the UI is built)
+    const FrameRenderStats rendered = mMultithreadedRendering && mpFrameSync->IsPipelined()
+        ? mpFrameSync->GetRenderStats()
+        : RenderThread::CollectRenderStats(*mpRenderer);
+    uiState.drawCalls = rendered.render.drawCalls;
+    uiState.drawnInstances = rendered.render.instances;
+
+    uiState.showResourcePool = rendered.hasResourcePool;
+    if (uiState.showResourcePool)
+    {
+        const te::TransientResourcePoolStats& pool = rendered.resourcePool;
+        uiState.poolHits = pool.hits;
+        uiState.poolMisses = pool.misses;
+        uiState.poolTargets = pool.targets;
+        uiState.poolMemoryMB = float(double(pool.gpuBytes) / (1024.0 * 1024.0));
+    }
+
+    if (mpFrameSync)
+    {
+        const FramePipelineStats pipeline = mpFrameSync->GetStats();
+        uiState.showFramePipeline = true;
+        uiState.framesInFlight = pipeline.framesInFlight;
+        uiState.maxFramesInFlight = std::max(1u, mpFrameSync->GetFramesInFlight());
+        uiState.mainBusyMs = float(pipeline.mainBusyMs);
+        uiState.mainIdleMs = float(pipeline.mainIdleMs);
+        uiState.renderBusyMs = float(pipeline.renderBusyMs);
+        uiState.renderIdleMs = float(pipeline.renderIdleMs);
+        uiState.frameLatencyMs = float(pipeline.latencyMs);
+    }
+
+    te::Profiler& profiler = te::Profiler::GetInstance();
+    uiState.profilerEnabled = profiler.IsEnabled();
+    uiState.lastTracePath = mLastTracePath;
+    if (uiState.showProfilerWindow)
+    {
+        for (const te::PassTiming& timing : profiler.GetPassTimings())
+        {
+            uiState.passTimings.push_back({ timing.name, float(timing.cpuMs), float(timing.gpuMs), timing.hasGpu });
+        }
+    }
+
     uiState.sandboxDisplayNames.reserve(mSandboxCatalog.size());
     for (const auto& entry : mSandboxCatalog)
     {
@@ -516,8 +725,15 @@ void RenderAgent::UpdateGUI()
     mShowHelpWindow = uiState.showHelpWindow;
     mShowSceneHelperWindow = uiState.showSceneHelperWindow;
     mShowFileHandleWindow = uiState.showFileHandleWindow;
+    mShowProfilerWindow = uiState.showProfilerWindow;
     mSelectedSandboxIndex = uiState.selectedSandboxIndex;
 
+    profiler.SetEnabled(uiState.profilerEnabled);
+    if (uiState.pendingTraceCapture && profiler.WriteChromeTrace("profile_trace.json"))
+    {
+        mLastTracePath = "profile_trace.json";
+    }
+
     if (uiState.pendingSandboxIndex >= 0
         && uiState.pendingSandboxIndex != mActiveSandboxIndex)
     {
@@ -644,10 +860,11 @@ bool RenderAgent::TrianglesIntersection(const Ray& ray, const std::shared_ptr<Ba
         return false;
     }
 
-    std::vector<Vertex> vertices = cur_frag.mpGeometry->GetVertices();
-    std::vector<unsigned int> indices = cur_frag.mpGeometry->GetIndices();
+    const te::GeometryView view = cur_frag.GetView();
+    const auto& vertices = view.vertices;
+    const auto& indices = view.indices;
     
-    if (vertices.empty() || indices.empty() || indices.size() % 3 != 0) {
+    if (view.Empty() || indices.size() % 3 != 0) {
         return false;
     }
 
@@ -1,6 +1,7 @@
 #include "SandboxCatalog.h"
 
 #include "RenderAgent.h"
+#include "sandbox/Sandbox_InstancingDemo.h"
 #include "sandbox/Sandbox_RendererDemo.h"
 #include "sandbox/Sandbox_ShadowRenderingDemo.h"
 #include "sandbox/Sandbox_TinyRenderer.h"
@@ -18,4 +19,8 @@ void RegisterDefaultSandboxes(RenderAgent& agent)
     agent.RegisterSandbox(
         "Shadow Rendering",
         []() { return std::make_unique<Sandbox_ShadowRenderingDemo>(); });
+
+    agent.RegisterSandbox(
+        "Instancing (10k meshes)",
+        []() { return std::make_unique<Sandbox_InstancingDemo>(); });
 }
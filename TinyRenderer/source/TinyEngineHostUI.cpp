@@ -37,6 +37,10 @@ namespace
         if (ImGui::MenuItem("Scene Helper", nullptr, &state.showSceneHelperWindow))
         {
         }
+        ImGui::Separator();
+        if (ImGui::MenuItem("Profiler", nullptr, &state.showProfilerWindow))
+        {
+        }
 
         const char* interactionLabel = state.cameraInteractionEnabled
             ? "Interaction: ON (Switch By INSERT Key)"
@@ -270,6 +274,19 @@ namespace
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
                     1000.0f / ImGui::GetIO().Framerate,
                     ImGui::GetIO().Framerate);
+        ImGui::Text("Draw calls: %u  Instances: %u", state.drawCalls, state.drawnInstances);
+        if (state.showResourcePool)
+        {
+            ImGui::Text("Graph targets: %u (%.1f MB)  hits %u / misses %u",
+                        state.poolTargets, state.poolMemoryMB, state.poolHits, state.poolMisses);
+        }
+        if (state.showFramePipeline)
+        {
+            ImGui::Text("Frames in flight: %u/%u  Latency: %.2f ms",
+                        state.framesInFlight, state.maxFramesInFlight, state.frameLatencyMs);
+            ImGui::Text("Main busy %.2f / idle %.2f ms", state.mainBusyMs, state.mainIdleMs);
+            ImGui::Text("Render busy %.2f / idle %.2f ms", state.renderBusyMs, state.renderIdleMs);
+        }
 
         ImGui::Separator();
         ImGui::Text("Material Properties");
@@ -279,6 +296,69 @@ namespace
 
         ImGui::End();
     }
+
+    void DrawProfilerPanel(TinyEngineHostUIState& state)
+    {
+        if (!state.showProfilerWindow)
+        {
+            return;
+        }
+
+        BeginPanelBelowToolbar("Profiler", &state.showProfilerWindow);
+
+        ImGui::Checkbox("Time passes", &state.profilerEnabled);
+        ImGui::SameLine();
+        if (ImGui::Button("Capture trace"))
+        {
+            state.pendingTraceCapture = true;
+        }
+        if (!state.lastTracePath.empty())
+        {
+            ImGui::TextDisabled("Last trace: %s (open in chrome://tracing)", state.lastTracePath.c_str());
+        }
+        ImGui::Separator();
+
+        if (state.passTimings.empty())
+        {
+            ImGui::TextDisabled(state.profilerEnabled ? "Waiting for pass timings..." : "Pass timing is off.");
+            ImGui::End();
+            return;
+        }
+
+        // GPU results arrive a few frames after the pass ran
+        float cpuTotal = 0.0f;
+        float gpuTotal = 0.0f;
+        if (ImGui::BeginTable("PassTimings", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+        {
+            ImGui::TableSetupColumn("Pass");
+            ImGui::TableSetupColumn("CPU ms");
+            ImGui::TableSetupColumn("GPU ms");
+            ImGui::TableHeadersRow();
+            for (const auto& timing : state.passTimings)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(timing.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", timing.cpuMs);
+                ImGui::TableNextColumn();
+                if (timing.hasGpu)
+                {
+                    ImGui::Text("%.3f", timing.gpuMs);
+                }
+                else
+                {
+                    ImGui::TextDisabled("-");
+                }
+                cpuTotal += timing.cpuMs;
+                gpuTotal += timing.gpuMs;
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Text("Total: CPU %.3f ms  GPU %.3f ms", cpuTotal, gpuTotal);
+
+        ImGui::End();
+    }
 }
 
 void TinyEngineHostUI::BuildLayout(TinyEngineHostUIState& state)
@@ -287,4 +367,5 @@ void TinyEngineHostUI::BuildLayout(TinyEngineHostUIState& state)
     DrawFileHandlePanel(state);
     DrawHelpPanel(state);
     DrawSceneHelperPanel(state);
+    DrawProfilerPanel(state);
 }
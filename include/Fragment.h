@@ -5,38 +5,65 @@
 #include "materials/BaseMaterial.h"
 #include "mesh/Vertex.h"
 #include "mesh/AaBB.h"
+#include "mesh/GeometryView.h"
 
 class GeometryItem
 {
 public:
     GeometryItem();
-    ~GeometryItem();
+    virtual ~GeometryItem();
 
+    GeometryItem(const GeometryItem&) = delete;
+    GeometryItem& operator=(const GeometryItem&) = delete;
+
+    // mutable access is treated as an edit: the GPU copy is re-uploaded on next draw
     std::vector<Vertex>& VerticesRef() noexcept
     {
+        MarkDirty();
         return mVertices;
     }
 
     std::vector<unsigned int>& IndicesRef() noexcept
     {
+        MarkDirty();
         return mIndices;
     }
 
-    std::vector<Vertex> GetVertices() const noexcept
+    // zero-copy read access, preferred by every per-frame consumer
+    te::GeometryView GetView() const noexcept
     {
-        return mVertices;
+        return { mVertices, mIndices, te::VertexLayout::Standard(mbHasUV), GetMeshHandle() };
     }
 
-    std::vector<unsigned int> GetIndices() const noexcept
-    {
-        return mIndices;
-    }
+    // owning copies, counted in RenderStats::geometryBytesCopied
+    std::vector<Vertex> GetVertices() const;
+    std::vector<unsigned int> GetIndices() const;
+
+    // bytes copied through GetVertices()/GetIndices() since the last call
+    static uint64_t ConsumeCopiedBytes() noexcept;
 
     std::optional<te::AaBB> GetAABB(bool update);
     std::optional<te::AaBB> GetLocalAABB();
     std::optional<te::AaBB> GetWorldAABB();
 
     void MarkHasUV(bool has);
+    bool HasUV() const noexcept { return mbHasUV; }
+
+    // GPU mesh registry handle, generation changes whenever vertices/indices/layout are edited
+    te::MeshHandle GetMeshHandle() const noexcept
+    {
+        return { mMeshSlot, mGeneration };
+    }
+    // fixed for the lifetime of the item, unlike the generation safe to read while it is edited
+    uint32_t GetMeshSlot() const noexcept
+    {
+        return mMeshSlot;
+    }
+    void MarkDirty() noexcept;
+
+    // Hash of vertices, indices and layout, recomputed only after an edit.
+    // Items with equal keys can be drawn from one another's GPU buffers (instancing).
+    uint64_t GetContentKey() const noexcept;
 
     void SetLocalTransform(const glm::mat4& trn);
     glm::mat4 GetLocalTransform() const noexcept
@@ -53,7 +80,7 @@ public:
     bool ValidateGeometryData() const noexcept;
     // Explicit OpenGL upload path, should only be called by OpenGL backend.
     bool EnsureOpenGLResources();
-    bool HasOpenGLResources() const noexcept { return initialized; }
+    bool HasOpenGLResources() const noexcept;
 
     bool VarifyValidation();
     void SubmitDrawCall();
@@ -69,8 +96,10 @@ protected:
     std::optional<te::AaBB> mAabb; /**< Optional axis-aligned bounding box. */
 
 private:
-    unsigned int mVAO, mVBO, mEBO = 0;
-    bool initialized = false;
+    uint32_t mMeshSlot{ te::MeshHandle::kInvalidSlot };
+    uint32_t mGeneration{ 0 };
+    mutable uint64_t mContentKey{ 0 };
+    mutable uint32_t mContentKeyGeneration{ 0 };
 
     bool mbHasUV = false;
 
@@ -88,6 +117,11 @@ struct Fragment final
         return (mpGeometry != nullptr) && mpGeometry->ValidateGeometryData();
     }
 
+    te::GeometryView GetView() const noexcept
+    {
+        return mpGeometry ? mpGeometry->GetView() : te::GeometryView{};
+    }
+
     bool mbPrimary{ false };
 };
 
@@ -96,7 +130,10 @@ class FragmentsSource : public RenderObject
 public:
     FragmentsSource() = default;
     virtual ~FragmentsSource() = default;
-	FragmentsSource& operator=(const FragmentsSource& rhs);
+
+    // fragments point at geometry the derived source owns (Mesh deletes it), a copy would share it
+    FragmentsSource(const FragmentsSource&) = delete;
+    FragmentsSource& operator=(const FragmentsSource&) = delete;
 
     const std::vector<Fragment>& GetFragments() const noexcept;
     uint8_t GetFragmentCount() const noexcept
@@ -25,8 +25,16 @@ class ModelLoader
         std::vector<std::shared_ptr<Mesh>> mMeshList;
         std::string mDirectory;
 
-        void processNode(aiNode *node, const aiScene *scene);
-        std::shared_ptr<Mesh> processMesh(aiMesh *mesh, const aiScene *scene);
+        // CPU side of a mesh, extracted on the job system
+        struct MeshData
+        {
+            std::vector<Vertex> vertices;
+            std::vector<int> indices;
+        };
+
+        void processNode(aiNode *node, const aiScene *scene, std::vector<aiMesh*>& outMeshes);
+        static void extractMeshData(const aiMesh *mesh, MeshData& outData);
+        std::shared_ptr<Mesh> processMesh(aiMesh *mesh, const aiScene *scene, const MeshData& data);
 
         std::shared_ptr<MaterialBase> processMaterial(aiMesh* mesh, const aiScene* scene);
 };
\ No newline at end of file
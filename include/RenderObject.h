@@ -5,24 +5,52 @@
 // cache
 struct MeshCache
 {
-	uint32_t vao, vbo, ebo;
-	size_t vertexCount, indexCount;
+	uint32_t vao = 0, vbo = 0, ebo = 0;
+	size_t vertexCount = 0, indexCount = 0;
 };
 
 struct RenderStats
 {
 	uint32_t drawCalls = 0;
+	// Objects drawn; larger than drawCalls when repeated meshes are instanced.
+	uint32_t instances = 0;
 	uint32_t triangles = 0;
 	uint32_t vertices = 0;
 	// Last-frame Vulkan deferred graph nodes executed (geometry / lighting / post / present).
 	uint32_t vulkanGraphNodesExecuted = 0;
+	// CPU bytes of vertex/index data copied out of GeometryItem this frame (zero on the steady-state path).
+	uint64_t geometryBytesCopied = 0;
+	// Program / material / VAO binds skipped by the sorted render queue.
+	uint32_t stateChangesAvoided = 0;
+	// te::FrameAllocator use of the rendering thread this frame; heap allocations are its arena growing.
+	uint32_t frameAllocations = 0;
+	uint64_t frameAllocatedBytes = 0;
+	uint32_t frameHeapAllocations = 0;
 
 	void Reset()
 	{
 		drawCalls = 0;
+		instances = 0;
 		triangles = 0;
 		vertices = 0;
 		vulkanGraphNodesExecuted = 0;
+		geometryBytesCopied = 0;
+		stateChangesAvoided = 0;
+		frameAllocations = 0;
+		frameAllocatedBytes = 0;
+		frameHeapAllocations = 0;
+	}
+
+	// Adds per-pass counters into the frame total (vulkanGraphNodesExecuted and the frame allocator
+	// counters are owned by the renderer).
+	void Accumulate(const RenderStats& other)
+	{
+		drawCalls += other.drawCalls;
+		instances += other.instances;
+		triangles += other.triangles;
+		vertices += other.vertices;
+		geometryBytesCopied += other.geometryBytesCopied;
+		stateChangesAvoided += other.stateChangesAvoided;
 	}
 };
 
@@ -35,7 +63,7 @@ public:
 	void SetMaterial(const std::shared_ptr<MaterialBase>& material);
 	std::shared_ptr<MaterialBase> GetMaterial();
 
-	virtual void Draw(std::unordered_map<size_t, MeshCache>& meshCache, RenderStats& stats) {}
+	virtual void Draw(RenderStats& stats) {}
 
 protected:
 	virtual void OnPrepareRenderFrame(){}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "mesh/GeometryView.h"
+#include "mesh/MeshRegistry.h"
+
+struct RenderCommand;
+class GeometryItem;
+class MaterialBase;
+class RenderContext;
+class RenderView;
+enum class RenderMode;
+
+namespace te
+{
+    class LinearArena;
+
+    struct FrameView
+    {
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::vec3 eye{ 0.0f };
+        float nearPlane = 0.1f;
+        float farPlane = 100.0f;
+        uint16_t viewportWidth = 0;
+        uint16_t viewportHeight = 0;
+    };
+
+    struct FrameLight
+    {
+        glm::vec3 position{ 0.0f };
+        glm::vec3 color{ 1.0f };
+        glm::vec3 direction{ 0.0f, 1.0f, 0.0f };
+    };
+
+    // one ready fragment of a RenderCommand
+    struct FrameDraw
+    {
+        glm::mat4 world{ 1.0f };
+        GeometryItem* geometry = nullptr;  // GPU mesh lookup (MeshRegistry::Acquire)
+        MeshHandle mesh;
+        uint64_t contentKey = 0;           // GeometryItem::GetContentKey, for instancing
+        MaterialBase* material = nullptr;
+    };
+
+    // Immutable copy of what one frame draws, built on the main thread at the end of its update and
+    // only read by the render thread, so the main thread may move the camera, lights and objects of
+    // the next frame meanwhile. Plain data allocated from a per-frame LinearArena; the pointers stay
+    // valid until that arena is reset, which happens once the frame has retired.
+    // Geometry and materials are referenced, not copied: the frame's RenderCommands keep them alive.
+    // The exception is geometry to upload while MeshRegistry stages uploads, see `uploads`.
+    struct FrameScene
+    {
+        uint64_t frameIndex = 0;
+        FrameView view;
+        const FrameLight* lights = nullptr;
+        uint32_t lightCount = 0;
+        const FrameDraw* draws = nullptr;
+        uint32_t drawCount = 0;
+        // copies of the drawn geometry that was not resident when the frame was built,
+        // for MeshRegistry::Upload before the frame is drawn
+        const GeometryView* uploads = nullptr;
+        uint32_t uploadCount = 0;
+    };
+
+    // Snapshots the attached camera, default light and the ready fragments of `commands` into `arena`
+    // and points each command at its draws (RenderCommand::sceneDraw / sceneDrawCount).
+    // With MeshRegistry staging uploads it also copies the geometry of draws whose mesh is not resident.
+    const FrameScene* BuildFrameScene(LinearArena& arena, uint64_t frameIndex, RenderContext& context,
+        const RenderView* renderView, std::vector<RenderCommand>& commands);
+}
@@ -3,37 +3,130 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "RenderObject.h"
+#include "framework/FrameScene.h"
+#include "framework/TransientResourcePool.h"
+#include "memory/LinearArena.h"
+
+// one frame handed from the main thread to the render thread when frames are pipelined,
+// so the main thread can move the camera / lights / objects while an older frame is still being drawn
+struct FrameSnapshot
+{
+    uint32_t slot = 0;
+    uint64_t frameIndex = 0;
+    size_t commandCount = 0;  // commands of this frame in the RenderCommandQueue, in order
+    te::LinearArena arena;    // backs `scene`, reset when the slot is acquired again (the frame has retired)
+    const te::FrameScene* scene = nullptr;
+    std::chrono::steady_clock::time_point submitTime;
+};
+
+// moving averages per frame
+struct FramePipelineStats
+{
+    double mainBusyMs = 0.0;
+    double mainIdleMs = 0.0;    // main thread blocked on the render thread
+    double renderBusyMs = 0.0;
+    double renderIdleMs = 0.0;  // render thread waiting for a frame
+    double latencyMs = 0.0;     // submit -> render complete
+    uint32_t framesInFlight = 0;
+};
+
+// what the render thread drew in its last completed frame, copied out so the main thread
+// does not read the renderer / pass manager / resource pool while the render thread uses them
+struct FrameRenderStats
+{
+    RenderStats render;
+    bool hasResourcePool = false;  // a render graph executor ran
+    te::TransientResourcePoolStats resourcePool;
+};
 
 class FrameSync
 {
 public:
     FrameSync() = default;
     ~FrameSync() = default;
-    
+
     //  disable copy
     FrameSync(const FrameSync&) = delete;
     FrameSync& operator=(const FrameSync&) = delete;
-    
+
+    // lockstep mode (frames in flight == 1)
     //  main thread: signal frame ready
     void SignalFrameReady();
-    
+
     //  render thread: wait for frame ready
     void WaitForFrameReady();
-    
+
     //  render thread: signal render complete
     void SignalRenderComplete();
-    
+
     //  main thread: wait for render complete
     void WaitForRenderComplete();
-    
+
     //  non-blocking check
     bool IsFrameReady() const;
     bool IsRenderComplete() const;
 
+    // pipelined mode: up to `count` (1..3) submitted frames not yet rendered, set before the render thread starts
+    void SetFramesInFlight(uint32_t count);
+    uint32_t GetFramesInFlight() const { return uint32_t(mSlots.size()); }
+    bool IsPipelined() const { return mSlots.size() > 1; }
+
+    // main thread does not get further ahead once the oldest frame in flight is older than this; 0 = off
+    void SetLatencyBudget(double milliseconds) { mLatencyBudgetMs = milliseconds; }
+    double GetLatencyBudget() const { return mLatencyBudgetMs; }
+
+    //  main thread: free slot to fill, blocks while all are in flight or over the latency budget;
+    //  nullptr after Shutdown
+    FrameSnapshot* AcquireFrame();
+    void SubmitFrame(FrameSnapshot* frame);
+    //  main thread: blocks until every submitted frame has been rendered
+    void WaitForIdle();
+
+    //  render thread: oldest submitted frame, nullptr after Shutdown
+    FrameSnapshot* WaitForFrame();
+    void CompleteFrame(FrameSnapshot* frame, const FrameRenderStats& stats);
+
+    // wakes up both threads for good
+    void Shutdown();
+
+    FramePipelineStats GetStats() const;
+    //  main thread: stats published with the last CompleteFrame
+    FrameRenderStats GetRenderStats() const;
+
 private:
+    using Clock = std::chrono::steady_clock;
+
+    // busy = time between two waits of a thread minus the time it spent waiting
+    struct ThreadTiming
+    {
+        Clock::time_point lastWaitEnd;
+        bool started = false;
+        double busyMs = 0.0;
+        double idleMs = 0.0;
+
+        void Record(Clock::time_point waitBegin, Clock::time_point waitEnd);
+    };
+
     std::atomic<bool> mFrameReady{false};
     std::atomic<bool> mRenderComplete{false};
     mutable std::mutex mMutex;
     std::condition_variable mFrameReadyCondition;
     std::condition_variable mRenderCompleteCondition;
+
+    std::vector<FrameSnapshot> mSlots;
+    uint64_t mAcquired = 0;   // frames handed to the main thread
+    uint64_t mSubmitted = 0;  // frames the render thread may take
+    uint64_t mTaken = 0;      // frames handed to the render thread
+    uint64_t mCompleted = 0;
+    double mLatencyBudgetMs = 0.0;
+    bool mShutdown = false;
+
+    ThreadTiming mMainTiming;
+    ThreadTiming mRenderTiming;
+    double mLatencyMs = 0.0;
+    FrameRenderStats mRenderStats;
 };
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+#include "glad/glad.h"
+
+namespace te
+{
+    // Per-instance world transforms for glDrawElementsInstanced.
+    // The mat4 is fed to vertex attribute locations 3..6 with divisor 1, shaders select it with `u_instanced`.
+    class InstanceBuffer
+    {
+    public:
+        static constexpr GLuint kFirstAttribLocation = 3;
+        // runs shorter than this are drawn one by one
+        static constexpr size_t kMinBatchSize = 2;
+
+        InstanceBuffer() = default;
+        InstanceBuffer(const InstanceBuffer&) = delete;
+        InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+        // GL side, must be called with the OpenGL context current
+        void Upload(const std::vector<glm::mat4>& transforms);
+        // set up / tear down the instance attributes on the currently bound VAO
+        void Attach() const;
+        void Detach() const;
+        void Release();
+
+    private:
+        GLuint mBuffer = 0;
+        size_t mCapacity = 0;  // in matrices
+    };
+}
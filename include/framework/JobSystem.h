@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "memory/PoolAllocator.h"
+
+namespace te
+{
+    struct Job;
+
+    // Counts the unfinished jobs of a group. Jobs run with a counter increment it when they are
+    // scheduled and decrement it when they finish; jobs depending on it are held back until it is zero.
+    // Only destroy a counter after JobSystem::Wait on it returned, the last job may still be using it.
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const noexcept { return mPending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> mPending{ 0 };
+        mutable std::mutex mMutex;  // guards mContinuations and the final decrement
+        mutable std::vector<Job*> mContinuations;  // jobs waiting for mPending to reach zero
+    };
+
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+    };
+
+    // Fixed-size Chase-Lev deque: the owning worker pushes and pops at the bottom,
+    // other threads steal from the top.
+    class WorkStealingDeque
+    {
+    public:
+        static constexpr size_t kCapacity = 4096;
+
+        bool Push(Job* job);    // owner only, false when full
+        Job* Pop();             // owner only
+        Job* Steal();           // any thread, nullptr when empty or when it lost a race
+
+    private:
+        alignas(64) std::atomic<int64_t> mTop{ 0 };
+        alignas(64) std::atomic<int64_t> mBottom{ 0 };
+        std::atomic<Job*> mSlots[kCapacity] = {};
+    };
+
+    // Engine-wide pool of worker threads for CPU work (loading, bounds, command preparation).
+    // Each worker owns a WorkStealingDeque; jobs scheduled from a worker go to its own deque, jobs from
+    // other threads go to a shared queue. Idle workers steal from the others. A thread waiting on a
+    // JobCounter runs jobs meanwhile, so waiting inside a job (nested ParallelFor) cannot deadlock.
+    // Jobs must not touch GL: workers have no context.
+    class JobSystem
+    {
+    public:
+        static JobSystem& GetInstance();
+
+        // `workerCount` 0 = one per hardware thread besides the calling one; until Start (and after Stop)
+        // jobs run inline on the scheduling thread
+        void Start(uint32_t workerCount = 0);
+        void Stop();
+        bool IsRunning() const noexcept { return !mWorkers.empty(); }
+        uint32_t GetWorkerCount() const noexcept { return uint32_t(mWorkers.size()); }
+
+        // schedules `function`; with `dependency`, not before that counter reached zero
+        void Run(std::function<void()> function, JobCounter* counter = nullptr, const JobCounter* dependency = nullptr);
+        // runs other jobs until `counter` reaches zero
+        void Wait(const JobCounter& counter);
+
+        // calls `function(begin, end)` for chunks of about `grain` items covering [0, count) and returns
+        // once all are done; the calling thread takes part
+        template <typename Function>
+        void ParallelFor(size_t count, size_t grain, Function&& function)
+        {
+            grain = std::max<size_t>(grain, 1);
+            if (count <= grain || mWorkers.empty())
+            {
+                if (count > 0)
+                    function(size_t(0), count);
+                return;
+            }
+
+            // a few chunks per thread so stealing can even out uneven chunks
+            const size_t maxChunks = size_t(mWorkers.size() + 1) * 4;
+            const size_t chunkSize = std::max(grain, (count + maxChunks - 1) / maxChunks);
+
+            JobCounter counter;
+            for (size_t begin = chunkSize; begin < count; begin += chunkSize)
+            {
+                const size_t end = std::min(count, begin + chunkSize);
+                Run([&function, begin, end]() { function(begin, end); }, &counter);
+            }
+            function(size_t(0), std::min(count, chunkSize));
+            Wait(counter);
+        }
+
+    private:
+        JobSystem() = default;
+        ~JobSystem();
+
+        struct Worker
+        {
+            std::thread thread;
+            WorkStealingDeque deque;
+        };
+
+        void WorkerLoop(uint32_t index);
+        void Schedule(Job* job);
+        Job* FindJob();
+        void Execute(Job* job);
+        Job* NewJob(std::function<void()> function, JobCounter* counter);
+        void DeleteJob(Job* job);
+
+        std::vector<std::unique_ptr<Worker>> mWorkers;
+        std::atomic<bool> mRunning{ false };
+
+        // jobs are created by one thread and freed by another, so one shared pool
+        std::mutex mJobPoolMutex;
+        ObjectPool<Job> mJobPool;
+
+        std::mutex mSharedMutex;
+        std::deque<Job*> mShared;  // jobs scheduled by non-worker threads or overflowing a deque
+
+        // sleeping workers are woken when a job is scheduled
+        std::mutex mSleepMutex;
+        std::condition_variable mWakeCondition;
+        std::atomic<uint32_t> mQueued{ 0 };    // scheduled, not yet taken
+        std::atomic<uint32_t> mSleeping{ 0 };
+    };
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace te
+{
+    // a closed CPU scope, or a GPU pass laid out on the GPU track
+    struct ProfileEvent
+    {
+        const char* name = nullptr;  // string literal or Profiler::Intern result
+        uint64_t startNs = 0;
+        uint64_t endNs = 0;
+    };
+
+    // moving averages of one render pass
+    struct PassTiming
+    {
+        std::string name;
+        double cpuMs = 0.0;
+        double gpuMs = 0.0;
+        bool hasGpu = false;  // no timer results yet, or timer queries unsupported
+    };
+
+    // CPU scopes and per-pass GPU timers.
+    // CPU events go to a ring buffer per thread (the oldest are overwritten). Pass timers wrap each
+    // pass in GL_TIME_ELAPSED queries (OpenGL) or a pair of timestamps (Vulkan); their results are
+    // read without stalling when the query slot comes round again, kGpuLatencyFrames frames later,
+    // and dropped if the GPU has not finished by then. Everything is off until SetEnabled(true).
+    class Profiler
+    {
+    public:
+        static constexpr uint32_t kEventsPerThread = 8192;
+        static constexpr uint32_t kGpuLatencyFrames = 4;
+        static constexpr uint32_t kMaxVulkanPasses = 32;  // timed Vulkan passes per frame
+
+        static Profiler& GetInstance();
+
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        void SetEnabled(bool enabled) { mEnabled.store(enabled, std::memory_order_relaxed); }
+        bool IsEnabled() const noexcept { return mEnabled.load(std::memory_order_relaxed); }
+
+        static uint64_t NowNs();
+
+        // stable copy of name for events, kept until the program exits
+        const char* Intern(const std::string& name);
+
+        // label of the calling thread's track in the trace
+        void SetThreadName(const std::string& name);
+
+        // name must stay valid (literal or interned)
+        void RecordCpu(const char* name, uint64_t startNs, uint64_t endNs);
+
+        // render thread, before the frame's first pass: resolves the timers of the slot reused now
+        void BeginFrame();
+
+        // OpenGL pass timer: CPU time plus a GL_TIME_ELAPSED query. Passes must not nest.
+        void BeginPass(const std::string& name);
+        void EndPass();
+
+        // Vulkan pass timer: timestamps written into commandBuffer. ResetVulkanQueries once per frame,
+        // outside a render pass and before the frame's first BeginVulkanPass.
+        void ResetVulkanQueries(VkCommandBuffer commandBuffer);
+        void BeginVulkanPass(VkCommandBuffer commandBuffer, const std::string& name);
+        void EndVulkanPass(VkCommandBuffer commandBuffer);
+
+        // GL queries need the GL context current, the query pool an idle device
+        void ReleaseGpuResources();
+
+        // passes in the order they first ran
+        std::vector<PassTiming> GetPassTimings() const;
+
+        // Chrome trace_event JSON (chrome://tracing, Perfetto) of every buffered CPU and GPU event
+        bool WriteChromeTrace(const std::string& filename) const;
+
+    private:
+        struct ThreadBuffer
+        {
+            std::string name;
+            uint32_t id = 0;
+            std::mutex mutex;  // taken by the owning thread and the exporter only
+            std::vector<ProfileEvent> events;
+            uint64_t written = 0;
+        };
+
+        struct GpuPassRecord
+        {
+            const char* name = nullptr;
+            uint64_t cpuStartNs = 0;
+            uint32_t query = 0;  // GL query name or first Vulkan query (end is query + 1)
+        };
+
+        struct FrameSlot
+        {
+            std::vector<GpuPassRecord> glPasses;
+            std::vector<GpuPassRecord> vkPasses;
+            std::vector<uint32_t> glQueries;  // reused across frames
+            uint32_t glQueriesUsed = 0;
+            bool vkReset = false;
+        };
+
+        struct OpenPass
+        {
+            const char* name = nullptr;
+            uint64_t startNs = 0;
+            bool gpu = false;  // a query was issued for it
+        };
+
+        Profiler();
+
+        ThreadBuffer& GetThreadBuffer();
+        void ResolveSlot(FrameSlot& slot);
+        void AddGpuEvent(const char* name, uint64_t cpuStartNs, uint64_t durationNs);
+        void UpdatePassTiming(const char* name, double ms, bool gpu);
+        bool EnsureVulkanQueryPool();
+
+        std::atomic<bool> mEnabled{ false };
+        const uint64_t mEpochNs;
+
+        mutable std::mutex mMutex;  // threads, GPU events and pass timings
+        std::vector<std::unique_ptr<ThreadBuffer>> mThreads;
+        std::vector<ProfileEvent> mGpuEvents;
+        uint64_t mGpuEventsWritten = 0;
+        uint64_t mGpuTrackEndNs = 0;
+        std::vector<PassTiming> mPassTimings;
+        std::unordered_map<const char*, size_t> mPassIndices;
+
+        std::mutex mNameMutex;
+        std::unordered_set<std::string> mNames;
+
+        // render thread only
+        FrameSlot mSlots[kGpuLatencyFrames];
+        uint32_t mSlot = 0;
+        OpenPass mOpenPass;
+        OpenPass mOpenVulkanPass;
+
+        VkDevice mVkDevice = VK_NULL_HANDLE;
+        VkQueryPool mVkQueryPool = VK_NULL_HANDLE;
+        double mTimestampPeriodNs = 1.0;
+        uint64_t mTimestampMask = ~0ull;
+        bool mVkUnsupported = false;
+    };
+
+    // CPU scope for the calling thread's track
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name)
+            : mName(name)
+            , mStartNs(Profiler::GetInstance().IsEnabled() ? Profiler::NowNs() : 0)
+        {
+        }
+        ~ProfileScope()
+        {
+            if (mStartNs)
+                Profiler::GetInstance().RecordCpu(mName, mStartNs, Profiler::NowNs());
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* mName;
+        uint64_t mStartNs;
+    };
+
+    // OpenGL pass timer for the enclosing scope
+    class ProfilePassScope
+    {
+    public:
+        explicit ProfilePassScope(const std::string& name) { Profiler::GetInstance().BeginPass(name); }
+        ~ProfilePassScope() { Profiler::GetInstance().EndPass(); }
+
+        ProfilePassScope(const ProfilePassScope&) = delete;
+        ProfilePassScope& operator=(const ProfilePassScope&) = delete;
+    };
+}
+
+#define TE_PROFILE_CONCAT_INNER(a, b) a##b
+#define TE_PROFILE_CONCAT(a, b) TE_PROFILE_CONCAT_INNER(a, b)
+#define TE_PROFILE_SCOPE(name) ::te::ProfileScope TE_PROFILE_CONCAT(teProfileScope, __LINE__)(name)
@@ -1,44 +1,67 @@
 #pragma once
 
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
+#include <vector>
 #include "framework/Renderer.h"
 
+// Bounded lock-free single-producer / single-consumer ring of render commands.
+// The main thread is the only producer and the render thread the only consumer; a whole frame is
+// published with one PushCommands call and taken with one DrainCommands call. Commands are moved
+// through the ring, so the FragmentsSource refcounts are not touched on the way.
 class RenderCommandQueue
 {
 public:
-    RenderCommandQueue() = default;
+    static constexpr size_t kDefaultCapacity = 1u << 16;
+
+    // capacity is rounded up to a power of two
+    explicit RenderCommandQueue(size_t capacity = kDefaultCapacity);
     ~RenderCommandQueue() = default;
     
     // unallow copy
     RenderCommandQueue(const RenderCommandQueue&) = delete;
     RenderCommandQueue& operator=(const RenderCommandQueue&) = delete;
     
-    // push single command
-    void PushCommand(const RenderCommand& command);
+    // producer: push single command, false when the ring is full
+    bool PushCommand(const RenderCommand& command);
+    bool PushCommand(RenderCommand&& command);
     
-    // push batch commands
-    void PushCommands(const std::vector<RenderCommand>& commands);
+    // producer: push as many commands as fit with a single publish, returns how many were taken
+    // (moved from `commands[first...]`)
+    size_t PushCommands(std::vector<RenderCommand>& commands, size_t first = 0);
+    size_t PushCommands(std::vector<RenderCommand>&& commands) { return PushCommands(commands, 0); }
     
-    // pop command (non-blocking)
+    // consumer: pop command (non-blocking)
     std::optional<RenderCommand> PopCommand();
     
-    // wait and pop command (blocking)
-    std::optional<RenderCommand> WaitAndPopCommand();
+    // consumer: append up to `maxCount` commands to `out` with a single release, returns how many
+    size_t DrainCommands(std::vector<RenderCommand>& out, size_t maxCount = SIZE_MAX);
     
-    // clear queue
+    // consumer side, or any thread while the consumer is idle (between frames)
     void Clear();
     
-    // get queue size
-    size_t Size() const;
+    // grows the ring; only valid while both sides are idle and the ring is empty
+    // (the main thread between WaitForRenderComplete and the next push)
+    bool Reserve(size_t capacity);
+    
+    size_t Capacity() const { return mSlots.size(); }
     
-    // is empty
-    bool Empty() const;
+    // snapshot, may be stale by the time it returns
+    size_t Size() const;
+    bool Empty() const { return Size() == 0; }
 
 private:
-    mutable std::mutex mMutex;
-    std::condition_variable mCondition;
-    std::queue<RenderCommand> mCommands;
-};
\ No newline at end of file
+    static constexpr size_t kCacheLine = 64;
+
+    std::vector<RenderCommand> mSlots;
+    size_t mMask = 0;
+
+    // producer and consumer indices live on their own cache lines, each side keeps a cached copy of
+    // the other one and only reloads it when the ring looks full / empty
+    alignas(kCacheLine) std::atomic<size_t> mTail{ 0 };  // written by the producer
+    size_t mCachedHead = 0;
+    alignas(kCacheLine) std::atomic<size_t> mHead{ 0 };  // written by the consumer
+    size_t mCachedTail = 0;
+};
@@ -5,6 +5,13 @@
 class Camera;
 class Light;
 
+namespace te
+{
+	struct FrameScene;
+	struct FrameView;
+	struct FrameLight;
+}
+
 class RenderContext
 {
 public:
@@ -17,7 +24,21 @@ public:
 	void PushAttachLight(const std::shared_ptr<Light>& light);
 	std::shared_ptr<Light> GetDefaultLight();
 
+	// the render side reads the frame's view / light from the te::FrameScene the main thread built for it,
+	// so it never touches the camera / lights the main thread keeps moving. Without a scene (examples
+	// that render directly) these fall back to the attached camera and default light, sampled per call.
+	void SetFrameScene(const te::FrameScene* scene);
+	const te::FrameScene* GetFrameScene() const noexcept { return mpFrameScene; }
+	const te::FrameView* GetRenderView();
+	const te::FrameLight* GetRenderLight();
+
 private:
 	std::weak_ptr<Camera> mpAttachCamera;
 	std::vector<std::shared_ptr<Light>> mpAttachLights;
+
+	const te::FrameScene* mpFrameScene{ nullptr };
+
+	// fallback when no scene is set
+	std::unique_ptr<te::FrameView> mpLiveView;
+	std::unique_ptr<te::FrameLight> mpLiveLight;
 };
@@ -9,6 +9,7 @@
 #include <tuple>
 #include "framework/RenderPass.h"
 #include "framework/FrameBuffer.h"
+#include "framework/TransientResourcePool.h"
 
 namespace te
 {
@@ -63,6 +64,37 @@ namespace te
         bool isAliasable = false;      // allow aliasing
     };
 
+    // How the compiler lets resources with disjoint lifetimes share memory
+    enum class ResourceAliasingMode
+    {
+        None,       // every resource gets its own target
+        Exact,      // same format and size only (OpenGL: a texture keeps its format)
+        ByteSize    // any resources, each allocation sized to its largest user (Vulkan memory aliasing)
+    };
+
+    // One allocation backing resources whose lifetimes do not overlap
+    struct PhysicalResource
+    {
+        std::string name;                    // first resource placed in it, the others alias it
+        uint64_t bytes = 0;
+        std::vector<std::string> resources;  // in order of first use
+        // filled with the schedule: what the executor acquires (the first resource's format and size)
+        // and the indices of resources
+        TransientResourceKey key;
+        std::vector<uint32_t> resourceIndices;
+    };
+
+    // Transient memory of a compiled graph
+    struct AliasingReport
+    {
+        ResourceAliasingMode mode = ResourceAliasingMode::Exact;
+        size_t resourceCount = 0;
+        size_t physicalCount = 0;
+        uint64_t unaliasedBytes = 0;  // every resource allocated on its own
+        uint64_t peakLiveBytes = 0;   // most bytes live during one pass, the lower bound for any aliasing
+        uint64_t aliasedBytes = 0;    // sum of the physical resources
+    };
+
     // Pass Node
     struct PassNode
     {
@@ -75,6 +107,9 @@ namespace te
         
         // dependencies
         std::vector<std::string> dependencies;
+
+        // never culled; passes writing no resources (drawing to the screen) are treated the same
+        bool hasSideEffects = false;
         
         // execution information
         std::function<void(const std::vector<RenderCommand>&)> executeFunc;
@@ -85,6 +120,7 @@ namespace te
     {
         size_t passIndex;
         std::vector<std::string> resources;
+        std::vector<uint32_t> resourceIndices;  // the declared ones, into CompiledGraph::resourceNames
         ResourceState fromState;
         ResourceState toState;
     };
@@ -98,6 +134,18 @@ namespace te
         size_t destroyPassIndex; // destroy resource pass index
     };
 
+    // What the executor does around one pass, as indices so the execute loop does no name lookups
+    struct PassSchedule
+    {
+        bool enabled = false;                               // RenderPass::ShouldExecute() when the schedule was built
+        bool culled = false;                                // enabled, but nothing live consumes its results
+        bool active = false;                                // enabled and not culled: runs
+        std::vector<uint32_t> acquire;                      // physical resources taken before the pass
+        std::vector<uint32_t> release;                      // physical resources given back after it
+        std::vector<std::pair<uint32_t, uint32_t>> inputs;  // index into the pass config's inputs, resource index
+        std::vector<uint32_t> syncPoints;                   // into CompiledGraph::syncPoints
+    };
+
     // Compiled Graph
     struct CompiledGraph
     {
@@ -106,6 +154,20 @@ namespace te
         
         // Pass nodes (in execution order)
         std::vector<PassNode> passes;
+
+        // passes that run (enabled and not culled) as of the last compile / patch, indices into passes in order
+        std::vector<size_t> activeOrder;
+
+        // passes, reads / writes and resource formats; sizes and enabled states are patched in place
+        uint64_t structureHash = 0;
+
+        // declared resources by index, the physical resource backing each (UINT32_MAX while unused)
+        std::vector<std::string> resourceNames;
+        std::unordered_map<std::string, uint32_t> resourceIndices;
+        std::vector<uint32_t> resourcePhysical;
+
+        // per pass (same indices as passes)
+        std::vector<PassSchedule> schedule;
         
         // resource allocations
         std::vector<ResourceAllocation> allocations;
@@ -121,6 +183,10 @@ namespace te
         
         // resource lifetimes
         std::unordered_map<std::string, ResourceLifetime> lifetimes;
+
+        // allocations after aliasing and their memory
+        std::vector<PhysicalResource> physicalResources;
+        AliasingReport aliasingReport;
     };
 
     // RenderGraph Builder
@@ -141,9 +207,15 @@ namespace te
         
         // set resource description
         RenderGraphBuilder& DeclareResource(const ResourceDesc& desc);
+
+        // Exact by default, the OpenGL executor cannot alias different formats
+        void SetAliasingMode(ResourceAliasingMode mode) { mAliasingMode = mode; }
         
         // compile graph
         std::unique_ptr<CompiledGraph> Compile();
+
+        // CompiledGraph::structureHash of what Compile() would produce
+        uint64_t ComputeStructureHash() const;
         
         // clear builder
         void Clear();
@@ -155,6 +227,7 @@ namespace te
         std::vector<PassNode> mPasses;
         std::unordered_map<std::string, ResourceDesc> mResources;
         PassNode* mCurrentPass;  // current pass being built
+        ResourceAliasingMode mAliasingMode = ResourceAliasingMode::Exact;
     };
 
     // RenderGraph Compiler
@@ -162,8 +235,20 @@ namespace te
     {
     public:
         static std::unique_ptr<CompiledGraph> Compile(
+            const std::vector<PassNode>& passes,
+            const std::unordered_map<std::string, ResourceDesc>& resources,
+            ResourceAliasingMode aliasingMode = ResourceAliasingMode::Exact);
+
+        // bytes a resource takes on the GPU (estimated, see TransientResourcePool)
+        static uint64_t GetResourceBytes(const ResourceDesc& desc);
+
+        static uint64_t HashStructure(
             const std::vector<PassNode>& passes,
             const std::unordered_map<std::string, ResourceDesc>& resources);
+
+        // redoes everything after the pass order (culling, lifetimes, aliasing, sync points, schedule)
+        // for the passes enabled now and the current resource descs; what enabling a pass or a resize needs
+        static void CompileResources(CompiledGraph& graph);
     
     private:
         // build dependency graph
@@ -181,11 +266,20 @@ namespace te
             const std::vector<size_t>& executionOrder,
             std::unordered_map<std::string, ResourceLifetime>& lifetimes);
         
-        // analyze resource aliasing
+        // analyze resource aliasing: interval partitioning of the lifetimes of each group,
+        // every alias names the first resource of its physical resource
         static void AnalyzeResourceAliasing(
             const std::unordered_map<std::string, ResourceDesc>& resources,
             const std::unordered_map<std::string, ResourceLifetime>& lifetimes,
-            std::unordered_map<std::string, std::string>& aliases);
+            ResourceAliasingMode mode,
+            std::unordered_map<std::string, std::string>& aliases,
+            std::vector<PhysicalResource>& physicalResources);
+
+        static AliasingReport BuildAliasingReport(
+            const std::unordered_map<std::string, ResourceDesc>& resources,
+            const std::unordered_map<std::string, ResourceLifetime>& lifetimes,
+            const std::vector<PhysicalResource>& physicalResources,
+            ResourceAliasingMode mode);
         
         // generate sync points
         static std::vector<SyncPoint> GenerateSyncPoints(
@@ -196,13 +290,22 @@ namespace te
         static std::vector<ResourceAllocation> GenerateResourceAllocations(
             const std::unordered_map<std::string, ResourceLifetime>& lifetimes,
             const std::unordered_map<std::string, std::string>& aliases);
+
+        // marks enabled passes nothing live consumes, walking back from the side-effect passes
+        // and the passes drawing to the screen
+        static std::vector<bool> CullPasses(const CompiledGraph& graph, const std::vector<bool>& enabled);
+
+        // integer tables of the execute loop
+        static void BuildSchedule(CompiledGraph& graph, const std::vector<bool>& enabled, const std::vector<bool>& culled);
     };
 
     // RenderGraph Executor
     class RenderGraphExecutor
     {
     public:
-        RenderGraphExecutor(std::unique_ptr<CompiledGraph> compiledGraph);
+        // without a pool the executor keeps its own, alive as long as the executor
+        RenderGraphExecutor(std::unique_ptr<CompiledGraph> compiledGraph,
+                            std::shared_ptr<TransientResourcePool> resourcePool = nullptr);
         ~RenderGraphExecutor();
         
         void Execute(const std::vector<RenderCommand>& commands);
@@ -212,25 +315,36 @@ namespace te
         
         // get compiled graph (for visualization, etc.)
         const CompiledGraph* GetCompiledGraph() const { return mCompiledGraph.get(); }
+
+        // patches the compiled graph instead of recompiling; both return true if anything changed
+        // picks up passes enabled / disabled and conditions changed since the last call (once per frame)
+        bool SyncPassStates();
+        // every declared resource takes the new size
+        bool ResizeResources(uint32_t width, uint32_t height);
+
+        // render targets reused across frames (hit / miss counts, GPU memory)
+        const TransientResourcePool& GetResourcePool() const { return *mResourcePool; }
         
-        // clear all resources
+        // return all resources to the pool
         void Clear();
     
     private:
         // resource management
-        void CreateResource(const std::string& name, const ResourceDesc& desc);
-        void DestroyResource(const std::string& name);
+        void AcquirePhysical(uint32_t physical);
+        void ReleasePhysical(uint32_t physical);
+        // releases everything and sizes the tables for the (patched) compiled graph
+        void ResetResources();
         
         // sync
         void InsertSyncPoint(const SyncPoint& sync);
         
         // state transition (OpenGL mainly deals with layout transitions, here simplified)
-        void TransitionResource(const std::string& name, 
-                               ResourceState from, ResourceState to);
+        void TransitionResource(uint32_t resource, ResourceState from, ResourceState to);
         
         std::unique_ptr<CompiledGraph> mCompiledGraph;
-        std::unordered_map<std::string, std::shared_ptr<RenderTarget>> mResources;
-        std::unordered_map<std::string, GLuint> mResourceHandles;
-        std::unordered_map<std::string, ResourceState> mResourceStates;
+        std::shared_ptr<TransientResourcePool> mResourcePool;
+        std::vector<std::shared_ptr<RenderTarget>> mPhysicalTargets;  // acquired from mResourcePool
+        std::vector<GLuint> mResourceHandles;                         // by resource index, 0 while not held
+        std::vector<ResourceState> mResourceStates;
     };
 }
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "framework/RenderGraph.h"
+#include "framework/Profiler.h"
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <sstream>
 
@@ -21,6 +24,9 @@ namespace te
         // Generate .dot content as string
         std::string GenerateDotContent(const CompiledGraph& graph);
 
+        // Annotate pass nodes with these timings (matched by pass name)
+        void SetPassTimings(const std::vector<PassTiming>& timings);
+
     private:
         // Helper methods for generating different parts of the graph
         void GenerateGraphHeader(std::ostringstream& oss);
@@ -40,5 +46,7 @@ namespace te
         
         // Helper to get pass type color
         std::string GetPassTypeColor(RenderPassType type);
+
+        std::unordered_map<std::string, PassTiming> mPassTimings;
     };
 }
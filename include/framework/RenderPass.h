@@ -11,6 +11,9 @@
 #include "materials/BaseMaterial.h"
 #include "framework/Renderer.h"
 #include "framework/RenderPassFlag.h"
+#include "framework/RenderQueue.h"
+#include "memory/StlAllocators.h"
+#include "framework/InstanceBuffer.h"
 
 #include "filesystem.h"
 
@@ -84,6 +87,12 @@ namespace te
         
         // Dependencies
         std::vector<RenderPassDependency> dependencies; // Dependency list
+
+        // RenderPassState::Conditional: the pass runs in frames where this returns true (unset = always)
+        std::function<bool()> condition;
+        // results are used outside the render graph (e.g. the shadow map BasePass takes from the pass),
+        // so the graph never culls the pass for having no consumers
+        bool sideEffects = false;
         
         // Render settings
         bool clearColor = true;              // Clear color
@@ -144,7 +153,11 @@ namespace te
         // State Management
         RenderPassState GetState() const { return mConfig.state; }
         void SetState(RenderPassState state) { mConfig.state = state; }
-        bool IsEnabled() const { return mConfig.state == RenderPassState::Enabled; }
+        // Enabled or Conditional
+        bool IsEnabled() const { return mConfig.state != RenderPassState::Disabled; }
+        // whether to run this frame: enabled, and the conditions of a Conditional pass and of its
+        // required dependencies hold
+        bool ShouldExecute() const;
 
         // Dependency Check
         bool CheckDependencies(const std::vector<std::shared_ptr<RenderPass>>& allPasses) const;
@@ -163,6 +176,14 @@ namespace te
 
         bool FindDependency(const std::string& passname);
 
+        // Draw counters of the last Execute()
+        RenderStats GetPassStats() const noexcept
+        {
+            RenderStats stats = mPassStats;
+            stats.stateChangesAvoided = mStateTracker.GetAvoidedCount();
+            return stats;
+        }
+
     protected:
         // Virtual functions that can be overridden by subclasses
         virtual void OnInitialize() = 0; // need to config your pass
@@ -170,6 +191,9 @@ namespace te
         virtual void OnPreExecute() {}
         virtual void OnPostExecute() {}
         virtual void ApplyRenderCommand(const std::vector<RenderCommand>& commands);
+        // Draws queue items [begin, end) that share geometry: one instanced call for a run
+        // of InstanceBuffer::kMinBatchSize or more, otherwise one call per item with `model` set.
+        void DrawQueueBatch(size_t begin, size_t end, const MeshCache& cache, Shader& shader);
 
         // Helper functions
         virtual void SetupFrameBuffer();
@@ -186,7 +210,13 @@ namespace te
         std::shared_ptr<RenderView> mpAttachView{ nullptr };
         std::shared_ptr<MaterialBase> mpOverMaterial{ nullptr };
         RenderPassFlag mRenderPassFlag{ RenderPassFlag::None };
-        std::vector<RenderCommand> mCandidateCommands;
+        FrameVector<const RenderCommand*> mCandidateCommands;  // this frame's matching commands, frame memory
+        RenderQueue mRenderQueue;            // mCandidateCommands sorted by state key
+        RenderStateTracker mStateTracker;
+        InstanceBuffer mInstanceBuffer;
+        std::vector<glm::mat4> mInstanceTransforms;
+        RenderStats mPassStats;
+        bool mSortBySourceMaterial = true;   // false when the pass ignores per-object materials
         ConfigChangeCallback mConfigChangeCallback;  // Callback for config changes
     };
 
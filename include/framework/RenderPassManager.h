@@ -55,12 +55,18 @@ public:
     
     // get RenderGraph Executor (for getting resource handles, etc.)
     RenderGraphExecutor* GetGraphExecutor() const { return mExecutor.get(); }
+    // render targets of the graph, kept across frames and recompiles
+    const TransientResourcePoolStats& GetResourcePoolStats() const { return mResourcePool->GetStats(); }
     
-    // set resource size (for RenderGraph compilation)
+    // set resource size (for RenderGraph compilation); a compiled graph is patched, not recompiled
     void SetResourceSize(uint32_t width, uint32_t height) 
     { 
         mResourceWidth = width; 
         mResourceHeight = height; 
+        if (mExecutor)
+        {
+            mExecutor->ResizeResources(width, height);
+        }
     }
     
     // generate visualization file (.dot format)
@@ -85,6 +91,9 @@ public:
     void SetVulkanCommandBuffer(VkCommandBuffer commandBuffer) { mVulkanCommandBuffer = commandBuffer; }
     uint32_t GetLastVulkanGraphPassCount() const { return mLastVulkanGraphPassCount; }
 
+    // Draw counters summed over the OpenGL passes of the last ExecuteAll()
+    const RenderStats& GetLastPassStats() const { return mLastPassStats; }
+
 private:
     RenderPassManager() = default;
     ~RenderPassManager() = default;
@@ -96,9 +105,11 @@ private:
     
     // RenderGraph members
     bool mUseRenderGraph = false;
+    bool mGraphDirty = true;  // passes added / removed or their dependencies changed
     RenderGraphBuilder mGraphBuilder;
     std::unique_ptr<CompiledGraph> mCompiledGraph;
     std::unique_ptr<RenderGraphExecutor> mExecutor;
+    std::shared_ptr<TransientResourcePool> mResourcePool = std::make_shared<TransientResourcePool>();
     uint32_t mResourceWidth = 1920;   // default resource width
     uint32_t mResourceHeight = 1080;  // default resource height
 
@@ -119,5 +130,6 @@ private:
     ActiveBackend mActiveBackend = ActiveBackend::OpenGL;
     VkCommandBuffer mVulkanCommandBuffer = VK_NULL_HANDLE;
     uint32_t mLastVulkanGraphPassCount = 0;
+    RenderStats mLastPassStats;
 };
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "framework/Renderer.h"
+#include "framework/FrameScene.h"
+
+namespace te
+{
+    // One draw (fragment of a RenderCommand) with its packed sort key
+    struct RenderQueueItem
+    {
+        uint64_t key = 0;
+        uint64_t geometryKey = 0;   // GeometryItem::GetContentKey()
+        uint32_t materialId = 0;
+        uint32_t world = 0;         // index of the world transform, see RenderQueue::GetWorld
+        const RenderCommand* command = nullptr;
+        GeometryItem* geometry = nullptr;
+        MaterialBase* material = nullptr;
+    };
+
+    // Sort-key render queue.
+    // Opaque key (MSB -> LSB): pass(4) | mode(3) | program(12) | material(12) | mesh(16) | depth(17, front-to-back)
+    // Transparent key:         pass(4) | mode(3) | depth(24, back-to-front) | program(12) | material(12) | mesh(9)
+    // The mesh field holds the low bits of the geometry content key so identical meshes end up adjacent.
+    class RenderQueue
+    {
+    public:
+        // Packs every ready fragment of the commands. Items keep pointers into `commands`,
+        // so the vector must outlive the queue contents.
+        // `overrideMaterial` replaces the program id for passes that draw with a single material;
+        // with `sourceMaterialMatters` false, draws of different source materials may share a batch.
+        // With a `scene`, the draws captured for each command are packed instead of its live fragments.
+        void Build(const std::vector<RenderCommand>& commands, uint8_t passId, const glm::mat4& view,
+            const MaterialBase* overrideMaterial = nullptr, bool sourceMaterialMatters = true,
+            const FrameScene* scene = nullptr);
+        // same for a pass's filtered subset of the frame's commands
+        void Build(std::span<const RenderCommand* const> commands, uint8_t passId, const glm::mat4& view,
+            const MaterialBase* overrideMaterial = nullptr, bool sourceMaterialMatters = true,
+            const FrameScene* scene = nullptr);
+        void Clear();
+
+        // LSD radix sort on the 64-bit keys (stable, byte columns with a single bucket are skipped)
+        void Sort();
+
+        // End of the run starting at `begin` whose items share mode, material and geometry,
+        // i.e. the range that can be drawn with one instanced call.
+        size_t NextBatch(size_t begin) const noexcept;
+        // world transforms of items [begin, end) for the instance buffer
+        void GatherTransforms(size_t begin, size_t end, std::vector<glm::mat4>& outTransforms) const;
+
+        const glm::mat4& GetWorld(const RenderQueueItem& item) const noexcept { return mWorlds[item.world]; }
+
+        const std::vector<RenderQueueItem>& GetItems() const noexcept { return mItems; }
+        bool Empty() const noexcept { return mItems.empty(); }
+
+        static uint64_t PackKey(uint8_t passId, RenderMode mode, uint32_t program, uint32_t material,
+            uint32_t mesh, float viewDepth);
+
+    private:
+        uint32_t MaterialIndex(const MaterialBase* material);
+        void AddCommand(const RenderCommand& command, uint8_t passId, const glm::mat4& view,
+            const MaterialBase* overrideMaterial, bool sourceMaterialMatters, const FrameScene* scene);
+        void AddItem(const RenderCommand& command, uint8_t passId, uint32_t program, const glm::mat4& view,
+            const glm::mat4& world, GeometryItem* geometry, uint64_t geometryKey, MaterialBase* material, bool sourceMaterialMatters);
+
+        std::vector<RenderQueueItem> mItems;
+        std::vector<glm::mat4> mWorlds;  // copied so items stay small and sorting does not move matrices
+        std::vector<RenderQueueItem> mScratch;
+        std::unordered_map<const MaterialBase*, uint32_t> mMaterialIds;
+    };
+
+    // Remembers what is currently bound while a sorted queue is emitted,
+    // each Bind* returns false (and counts it) when the bind would be redundant.
+    class RenderStateTracker
+    {
+    public:
+        bool BindProgram(MaterialBase* material);
+        bool BindMaterial(const MaterialBase* material);
+        bool BindVertexArray(GLuint vao);
+
+        void Reset();
+        uint32_t GetAvoidedCount() const noexcept { return mAvoided; }
+
+    private:
+        GLuint mProgram = 0;
+        const MaterialBase* mpMaterial = nullptr;
+        GLuint mVertexArray = 0;
+        uint32_t mAvoided = 0;
+    };
+}
@@ -2,8 +2,10 @@
 
 #include <thread>
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "framework/RenderCommandQueue.h"
 #include "framework/FrameSync.h"
 #include "framework/Renderer.h"
@@ -43,15 +45,31 @@ public:
     
     // set render view for viewport size
     void SetRenderView(std::shared_ptr<class RenderView> view) { mpRenderView = view; }
+    
+    // pipelined frames: the context that gets each frame's camera / light
+    void SetRenderContext(std::shared_ptr<class RenderContext> context) { mpRenderContext = context; }
+    
+    // pipelined frames: drawn over the scene before the render thread swaps (e.g. the captured UI)
+    void SetOverlayRenderer(std::function<void(const FrameSnapshot&)> overlay) { mOverlayRenderer = std::move(overlay); }
+
+    // stats of the frame `renderer` last ended, only valid on the thread that rendered it or while it is idle
+    static FrameRenderStats CollectRenderStats(const IRenderer& renderer);
 
 private:
     void RenderLoop();
+    // frames in flight == 1: main thread presents after SignalRenderComplete
+    void LockstepLoop();
+    // frames in flight > 1: consumes FrameSnapshots and presents itself
+    void PipelinedLoop();
+    // with the context current
+    void ExecuteFrame(std::vector<RenderCommand>& commands, uint16_t viewportWidth, uint16_t viewportHeight);
     void InitializeRenderContext();
     void CleanupRenderContext();
     
     std::shared_ptr<RenderCommandQueue> mCommandQueue;
     std::shared_ptr<FrameSync> mFrameSync;
     std::shared_ptr<IRenderer> mpRenderer;
+    std::vector<RenderCommand> mFrameCommands;  // drained commands of the frame being rendered
     
     std::thread mThread;
     std::atomic<bool> mRunning{false};
@@ -60,4 +78,6 @@ private:
     GLFWwindow* mMainWindow = nullptr;  // main window pointer
     void* mRenderContext = nullptr;  // maybe different types depending on the platform
     std::shared_ptr<class RenderView> mpRenderView = nullptr;  // for getting viewport size
+    std::shared_ptr<class RenderContext> mpRenderContext = nullptr;
+    std::function<void(const FrameSnapshot&)> mOverlayRenderer;
 };
\ No newline at end of file
@@ -23,6 +23,9 @@ namespace te
 {
     class RenderPass;
     class MultiRenderTarget;
+    class RenderQueue;
+    class RenderStateTracker;
+    class InstanceBuffer;
 }
 
 enum class RenderMode
@@ -37,11 +40,18 @@ enum class RenderMode
 // with renderobject
 struct RenderCommand
 {
+    static constexpr uint32_t kNoSceneDraws = UINT32_MAX;
+
     std::shared_ptr<FragmentsSource> fragmentsSource{ nullptr };
 
     RenderMode state;
     bool hasUV;
     RenderPassFlag renderpassflag;
+
+    // this command's draws in the frame's te::FrameScene (set by te::BuildFrameScene);
+    // without a scene the render side reads the fragments directly
+    uint32_t sceneDraw{ kNoSceneDraws };
+    uint32_t sceneDrawCount{ 0 };
     
     RenderCommand() : state(RenderMode::Opaque), hasUV(false), renderpassflag(RenderPassFlag::None) {}
 };
@@ -149,8 +159,12 @@ private:
     uint32_t mCurrentVBO = 0;
     uint32_t mCurrentEBO = 0;
     RenderMode mCurrentState = RenderMode::Opaque;
-    
-    std::unordered_map<size_t, MeshCache> mMeshCache;
+
+    // sort-key queue and instancing used by DrawMeshes
+    std::unique_ptr<te::RenderQueue> mpRenderQueue;
+    std::unique_ptr<te::RenderStateTracker> mpStateTracker;
+    std::unique_ptr<te::InstanceBuffer> mpInstanceBuffer;
+    std::vector<glm::mat4> mInstanceTransforms;
 
     std::shared_ptr<RenderContext> mpRenderContext{ nullptr };
 
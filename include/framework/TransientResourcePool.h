@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "framework/FrameBuffer.h"
+
+namespace te
+{
+    // what makes two transient render targets interchangeable
+    struct TransientResourceKey
+    {
+        RenderTargetFormat format = RenderTargetFormat::RGBA8;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        bool operator==(const TransientResourceKey& other) const noexcept
+        {
+            return format == other.format && width == other.width && height == other.height;
+        }
+    };
+
+    struct TransientResourcePoolStats
+    {
+        // Acquire calls of the current frame served by a pooled target / needing a new one
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint64_t totalHits = 0;
+        uint64_t totalMisses = 0;
+        uint32_t targets = 0;        // render targets alive in the pool
+        uint32_t targetsInUse = 0;
+        uint64_t gpuBytes = 0;       // estimated texture memory of every pooled target
+    };
+
+    // Render targets of the render graph kept alive across frames. Acquire hands out a free target
+    // with the same format and size, or creates one; Release returns it for later passes and frames.
+    // Targets nobody acquired for kMaxIdleFrames frames (e.g. the old size after a resize) are deleted.
+    // Shared between executors, so recompiling the graph keeps its targets. GL thread only.
+    class TransientResourcePool
+    {
+    public:
+        static constexpr uint32_t kMaxIdleFrames = 3;
+
+        TransientResourcePool() = default;
+        ~TransientResourcePool();
+
+        TransientResourcePool(const TransientResourcePool&) = delete;
+        TransientResourcePool& operator=(const TransientResourcePool&) = delete;
+
+        // once per executed graph: trims idle targets and restarts the frame counters
+        void BeginFrame();
+
+        // nullptr if the target could not be created
+        std::shared_ptr<RenderTarget> Acquire(const std::string& name, const TransientResourceKey& key);
+        void Release(const std::shared_ptr<RenderTarget>& target);
+
+        // deletes every target not in use
+        void Trim();
+        void Clear();
+
+        const TransientResourcePoolStats& GetStats() const { return mStats; }
+
+        static uint64_t EstimateBytes(const TransientResourceKey& key);
+
+    private:
+        struct Entry
+        {
+            TransientResourceKey key;
+            std::shared_ptr<RenderTarget> target;
+            uint64_t lastUsedFrame = 0;
+            bool inUse = false;
+        };
+
+        void RemoveEntry(size_t index);
+
+        std::vector<Entry> mEntries;
+        uint64_t mFrame = 0;
+        TransientResourcePoolStats mStats;
+    };
+}
@@ -3,6 +3,8 @@
 #include "framework/Renderer.h"
 #include "GTVulkan/VK_Deferred.h"
 #include "materials/BaseMaterial.h"
+#include "mesh/GeometryView.h"
+#include "framework/RenderQueue.h"
 #include <glm/glm.hpp>
 #include <unordered_map>
 
@@ -38,6 +40,8 @@ public:
     static VkVertexInputBindingDescription VertexBindingDescription();
     static std::array<VkVertexInputAttributeDescription, 3> VertexAttributeDescriptions();
     void SetViewProjection(const glm::mat4& view, const glm::mat4& proj);
+    /** Draw calls / instances / triangles of the last Record(). */
+    const RenderStats& GetLastStats() const { return lastStats_; }
 
 private:
     struct VulkanMeshBuffer {
@@ -47,10 +51,10 @@ private:
         VkDeviceMemory indexMemory = VK_NULL_HANDLE;
         uint32_t indexCount = 0;
         uint32_t vertexCount = 0;
+        uint32_t generation = 0;
     };
 
-    static size_t HashMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
-    bool GetOrCreateMeshBuffer(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, VulkanMeshBuffer& outBuffer);
+    bool GetOrCreateMeshBuffer(const GeometryView& view, VulkanMeshBuffer& outBuffer);
     void DestroyMeshBuffers();
     static void DestroyMeshBuffer(VulkanMeshBuffer& meshBuffer);
     static bool CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& outBuffer, VkDeviceMemory& outMemory);
@@ -65,7 +69,8 @@ private:
     bool GetOrCreateMaterialTextureSet(const std::shared_ptr<MaterialBase>& material, VkDescriptorSet& outDescriptorSet);
     void DestroyMaterialTextures();
     bool UpdateCameraUbo() const;
-    bool UpdateModelUbo(const glm::mat4& model, uint32_t objectIndex, uint32_t& outDynamicOffset) const;
+    bool EnsureInstanceCapacity(uint32_t instanceCount);
+    void WriteInstanceDescriptor();
 
     bool RebuildFramebuffer();
     std::vector<VkClearValue> BuildClearValues() const;
@@ -76,26 +81,27 @@ private:
         glm::mat4 proj{ 1.0f };
     };
 
-    struct ModelUbo {
-        glm::mat4 model{ 1.0f };
-    };
-
     vk::VulkanGBuffer gbuffer_{};
     VkRenderPass renderPass_ = VK_NULL_HANDLE;
     VkPipeline pipeline_ = VK_NULL_HANDLE;
     VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
     VkExtent2D extent_{ 0, 0 };
     VkFormat depthFormat_ = VK_FORMAT_D32_SFLOAT;
-    std::unordered_map<size_t, VulkanMeshBuffer> meshBuffers_{};
+    // keyed by MeshHandle slot, re-uploaded when the handle generation changes
+    std::unordered_map<uint32_t, VulkanMeshBuffer> meshBuffers_{};
 
     glm::mat4 view_{ 1.0f };
     glm::mat4 proj_{ 1.0f };
     mutable VkBuffer cameraUboBuffer_ = VK_NULL_HANDLE;
     mutable VkDeviceMemory cameraUboMemory_ = VK_NULL_HANDLE;
-    mutable VkBuffer modelUboBuffer_ = VK_NULL_HANDLE;
-    mutable VkDeviceMemory modelUboMemory_ = VK_NULL_HANDLE;
-    uint32_t modelUboStride_ = 0;
-    uint32_t modelUboCapacity_ = 0;
+    // per-instance model matrices (binding 1, indexed by gl_InstanceIndex), persistently mapped
+    VkBuffer instanceBuffer_ = VK_NULL_HANDLE;
+    VkDeviceMemory instanceMemory_ = VK_NULL_HANDLE;
+    void* instanceMapped_ = nullptr;
+    uint32_t instanceCapacity_ = 0;
+    std::vector<glm::mat4> instanceTransforms_{};
+    RenderQueue queue_{};
+    RenderStats lastStats_{};
     VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
     VkDescriptorSetLayout textureDescriptorSetLayout_ = VK_NULL_HANDLE;
     VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
@@ -1,9 +1,11 @@
 #pragma once
 #include<memory>
 #include<string>
+#include<vector>
 #include "textures/Texture.h"
 #include <glm/glm.hpp>
 #include "shader.h"
+#include "shader/ShaderVariants.h"
 #include "glad/glad.h"
 
 class Camera;
@@ -23,19 +25,32 @@ public:
 	void AttachedCamera(const std::shared_ptr<Camera>& pcamera);
 	void AttachedLight(const std::shared_ptr<Light>& pLight);
 
-	std::shared_ptr<Shader> GetShader() const noexcept 
-	{
-		return mpShader;
-	}
+	// program of the current feature combination, a variant material compiles it on first use
+	std::shared_ptr<Shader> GetShader() const;
+	te::ShaderVariantMask GetFeatureMask() const { return FeatureMask(); }
 
 	virtual void SetUseGeometryTarget(bool use) {}
 
 protected:
 	MaterialBase(const std::string& vs_path, const std::string& fs_path);
+	// variant material: `featureDefines[i]` is #defined in the program when feature bit i is set
+	MaterialBase(const std::string& vs_path, const std::string& fs_path, std::vector<std::string> featureDefines);
+
+	void SetFeature(te::ShaderVariantMask feature, bool enabled);
+	bool HasFeature(te::ShaderVariantMask feature) const { return (mFeatureMask & feature) != 0; }
+	// overridden when a feature follows state outside the material's setters (e.g. texture validity)
+	virtual te::ShaderVariantMask FeatureMask() const { return mFeatureMask; }
 
-	std::shared_ptr<Shader> mpShader{ nullptr };
+	mutable std::shared_ptr<Shader> mpShader{ nullptr };
 	std::weak_ptr<Camera> mpAttachedCamera;
 	std::weak_ptr<Light> mpAttachedLight;
+
+private:
+	std::string mVertexPath;
+	std::string mFragmentPath;
+	std::vector<std::string> mFeatureDefines;
+	te::ShaderVariantMask mFeatureMask = 0;
+	mutable te::ShaderVariantMask mResolvedMask = 0;  // mask mpShader was built for
 };
 
 class UnlitMaterial : public MaterialBase
@@ -79,14 +94,16 @@ public:
 
 	void SetUseGeometryTarget(bool use) override;
 
-	void SetShadowEnabled(bool enabled) { mShadowEnabled = enabled; }
+	void SetShadowEnabled(bool enabled) { SetFeature(kFeatureShadow, enabled); }
 	void SetShadowMap(GLuint texture) { mShadowMap = texture; }
-	void SetLightSpaceMatrix(const glm::mat4& matrix) { mLightSpaceMatrix = matrix; }
 	void SetShadowBias(float bias) { mShadowBias = glm::max(bias, 0.0f); }
-	void SetShadowPCFEnabled(bool enabled) { mShadowPCFEnabled = enabled; }
+	void SetShadowPCFEnabled(bool enabled) { SetFeature(kFeaturePCF, enabled); }
 
-protected:
-	glm::vec4 mUseEnables;
+	// shader variant features of phong.fs
+	static constexpr te::ShaderVariantMask kFeatureBlinn = 1u << 0;           // USE_BLINN
+	static constexpr te::ShaderVariantMask kFeatureGeometryTarget = 1u << 1;  // USE_GEOMETRY_TARGET
+	static constexpr te::ShaderVariantMask kFeatureShadow = 1u << 2;          // USE_SHADOW
+	static constexpr te::ShaderVariantMask kFeaturePCF = 1u << 3;             // USE_PCF
 
 private:
 	static constexpr int kShadowTextureUnit = 5;
@@ -95,9 +112,6 @@ private:
 	bool mbHasTexture = false;
 	glm::vec4 mIntensities{ 1.0f,1.0f, 1.0f, 1.0f};// environment,diffuse,specular,shininess
 
-	bool mShadowEnabled{ false };
 	GLuint mShadowMap{ 0 };
-	glm::mat4 mLightSpaceMatrix{ 1.0f };
 	float mShadowBias{ 0.005f };
-	bool mShadowPCFEnabled{ true };
 };
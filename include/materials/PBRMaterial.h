@@ -76,11 +76,22 @@ public:
     void SetExposure(float exposure) { mExposure = glm::max(exposure, 0.0f); }
     float GetExposure() const { return mExposure; }
 
-    void SetShadowEnabled(bool enabled) { mShadowEnabled = enabled; }
+    void SetShadowEnabled(bool enabled) { SetFeature(kFeatureShadow, enabled); }
     void SetShadowMap(GLuint texture) { mShadowMap = texture; }
-    void SetLightSpaceMatrix(const glm::mat4& matrix) { mLightSpaceMatrix = matrix; }
     void SetShadowBias(float bias) { mShadowBias = glm::max(bias, 0.0f); }
-    void SetShadowPCFEnabled(bool enabled) { mShadowPCFEnabled = enabled; }
+    void SetShadowPCFEnabled(bool enabled) { SetFeature(kFeaturePCF, enabled); }
+
+    // shader variant features of pbr.fs, the map bits follow the bound textures
+    static constexpr te::ShaderVariantMask kFeatureShadow = 1u << 0;        // USE_SHADOW
+    static constexpr te::ShaderVariantMask kFeaturePCF = 1u << 1;           // USE_PCF
+    static constexpr te::ShaderVariantMask kFeatureAlbedoMap = 1u << 2;     // HAS_ALBEDO_MAP
+    static constexpr te::ShaderVariantMask kFeatureNormalMap = 1u << 3;     // HAS_NORMAL_MAP
+    static constexpr te::ShaderVariantMask kFeatureMetallicMap = 1u << 4;   // HAS_METALLIC_MAP
+    static constexpr te::ShaderVariantMask kFeatureRoughnessMap = 1u << 5;  // HAS_ROUGHNESS_MAP
+    static constexpr te::ShaderVariantMask kFeatureAOMap = 1u << 6;         // HAS_AO_MAP
+
+protected:
+    te::ShaderVariantMask FeatureMask() const override;
 
 private:
     static constexpr int kShadowTextureUnit = 5;
@@ -101,9 +112,6 @@ private:
     float mLightIntensity{ 1.0f };     // Light intensity multiplier
     float mExposure{ 1.0f };          // Exposure for tone mapping
 
-    bool mShadowEnabled{ false };
     GLuint mShadowMap{ 0 };
-    glm::mat4 mLightSpaceMatrix{ 1.0f };
     float mShadowBias{ 0.005f };
-    bool mShadowPCFEnabled{ true };
 }; 
\ No newline at end of file
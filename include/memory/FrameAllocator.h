@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "memory/LinearArena.h"
+
+namespace te
+{
+    // counters of the frame started by the last FrameAllocator::BeginFrame
+    struct FrameAllocatorStats
+    {
+        uint32_t allocations = 0;
+        uint64_t bytes = 0;
+        uint32_t heapAllocations = 0;  // arena blocks taken from the heap, 0 once the workload settled
+    };
+
+    // Transient memory of the rendering thread: a ring of 2 (double buffered) or 3 (triple buffered)
+    // LinearArenas. BeginFrame() moves to the next arena and resets it, so memory handed out during a
+    // frame stays valid through the next 1 or 2 frames, e.g. for containers replaced at the start of
+    // the following frame. Not thread-safe: only the thread running the renderer's frames allocates.
+    class FrameAllocator
+    {
+    public:
+        static constexpr uint32_t kMaxBuffers = 3;
+
+        // the render thread's allocator, rotated by IRenderer::BeginFrame implementations
+        static FrameAllocator& GetInstance();
+
+        explicit FrameAllocator(uint32_t bufferCount = 2, size_t blockSize = LinearArena::kDefaultBlockSize);
+
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        // 2..3; resets every arena, so only between frames with no frame memory in use
+        void SetBufferCount(uint32_t count);
+        uint32_t GetBufferCount() const noexcept { return mBufferCount; }
+
+        void BeginFrame();
+        uint64_t GetFrameIndex() const noexcept { return mFrameIndex; }
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+        {
+            return GetArena().Allocate(size, alignment);
+        }
+
+        // arena of the current frame
+        LinearArena& GetArena() noexcept { return mArenas[mCurrent]; }
+
+        FrameAllocatorStats GetFrameStats() const;
+
+    private:
+        std::array<LinearArena, kMaxBuffers> mArenas;
+        uint32_t mBufferCount = 2;
+        uint32_t mCurrent = 0;
+        uint64_t mFrameIndex = 0;
+        uint64_t mHeapAllocationsAtBegin = 0;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace te
+{
+    // Bump allocator for data that lives exactly as long as one frame.
+    // Nothing is freed individually: Reset() reclaims everything at once and folds the blocks the
+    // frame needed into a single one, so a steady workload settles on one allocation per arena.
+    // Only trivially destructible types may live in it, destructors are never run.
+    class LinearArena
+    {
+    public:
+        static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+        explicit LinearArena(size_t blockSize = kDefaultBlockSize);
+        ~LinearArena() = default;
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+        LinearArena(LinearArena&&) noexcept = default;
+        LinearArena& operator=(LinearArena&&) noexcept = default;
+
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        template <typename T>
+        T* AllocateArray(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "LinearArena never runs destructors");
+            if (count == 0)
+                return nullptr;
+            T* items = static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+            std::uninitialized_default_construct_n(items, count);
+            return items;
+        }
+
+        template <typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "LinearArena never runs destructors");
+            return ::new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        // everything allocated so far becomes invalid
+        void Reset();
+
+        size_t GetUsedBytes() const noexcept { return mUsed; }
+        size_t GetCapacity() const noexcept { return mCapacity; }
+        // Allocate calls since Reset
+        uint32_t GetAllocationCount() const noexcept { return mAllocations; }
+        // blocks taken from the heap over the arena's lifetime, flat once the workload settled
+        uint64_t GetHeapAllocationCount() const noexcept { return mHeapAllocations; }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size = 0;
+        };
+
+        void AddBlock(size_t minSize);
+
+        std::vector<Block> mBlocks;
+        size_t mOffset = 0;    // into mBlocks.back()
+        size_t mUsed = 0;      // bytes handed out since Reset, padding included
+        size_t mCapacity = 0;  // sum of the block sizes
+        size_t mBlockSize = kDefaultBlockSize;
+        uint32_t mAllocations = 0;
+        uint64_t mHeapAllocations = 0;
+    };
+}
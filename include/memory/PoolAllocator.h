@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace te
+{
+    // Fixed-size blocks carved from chunks, recycled through an intrusive free list. Chunks are
+    // only returned when the pool is destroyed. Not thread-safe.
+    class PoolAllocator
+    {
+    public:
+        static constexpr size_t kDefaultBlocksPerChunk = 256;
+
+        PoolAllocator(size_t blockSize, size_t alignment = alignof(std::max_align_t),
+            size_t blocksPerChunk = kDefaultBlocksPerChunk);
+
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        void* Allocate();
+        void Free(void* block) noexcept;
+
+        size_t GetBlockSize() const noexcept { return mBlockSize; }
+        size_t GetLiveCount() const noexcept { return mLive; }
+        size_t GetCapacity() const noexcept { return mChunks.size() * mBlocksPerChunk; }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void AddChunk();
+
+        std::vector<std::unique_ptr<std::byte[]>> mChunks;
+        FreeBlock* mpFreeList = nullptr;
+        size_t mBlockSize;
+        size_t mAlignment;
+        size_t mBlocksPerChunk;
+        size_t mLive = 0;
+    };
+
+    // PoolAllocator sized for T, with construction / destruction
+    template <typename T>
+    class ObjectPool
+    {
+    public:
+        explicit ObjectPool(size_t blocksPerChunk = PoolAllocator::kDefaultBlocksPerChunk)
+            : mPool(sizeof(T), alignof(T), blocksPerChunk)
+        {
+        }
+
+        template <typename... Args>
+        T* New(Args&&... args)
+        {
+            void* block = mPool.Allocate();
+            return ::new (block) T(std::forward<Args>(args)...);
+        }
+
+        void Delete(T* object) noexcept
+        {
+            if (!object)
+                return;
+            object->~T();
+            mPool.Free(object);
+        }
+
+        size_t GetLiveCount() const noexcept { return mPool.GetLiveCount(); }
+        size_t GetCapacity() const noexcept { return mPool.GetCapacity(); }
+
+    private:
+        PoolAllocator mPool;
+    };
+}
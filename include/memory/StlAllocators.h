@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "memory/FrameAllocator.h"
+#include "memory/LinearArena.h"
+
+namespace te
+{
+    // std allocator over a LinearArena: deallocate is a no-op, the arena's Reset frees everything.
+    // Containers using it must be dropped (or replaced) before that reset; with the FrameAllocator
+    // this means within the next frame. Elements are destroyed by the container as usual.
+    template <typename T>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        ArenaAllocator() noexcept = default;
+        explicit ArenaAllocator(LinearArena& arena) noexcept : mpArena(&arena) {}
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept : mpArena(other.GetArena()) {}
+
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(mpArena->Allocate(sizeof(T) * count, alignof(T)));
+        }
+        void deallocate(T*, size_t) noexcept {}
+
+        LinearArena* GetArena() const noexcept { return mpArena; }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept { return mpArena == other.GetArena(); }
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept { return mpArena != other.GetArena(); }
+
+    private:
+        LinearArena* mpArena = nullptr;  // a default constructed allocator may only back empty containers
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    using FrameUnorderedMap = std::unordered_map<Key, Value, Hash, Equal, ArenaAllocator<std::pair<const Key, Value>>>;
+
+    // containers on the current frame of FrameAllocator::GetInstance() (rendering thread only)
+    template <typename T>
+    FrameVector<T> MakeFrameVector(size_t reserve = 0)
+    {
+        FrameVector<T> vector{ ArenaAllocator<T>(FrameAllocator::GetInstance().GetArena()) };
+        vector.reserve(reserve);
+        return vector;
+    }
+
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>>
+    FrameUnorderedMap<Key, Value, Hash, Equal> MakeFrameUnorderedMap(size_t buckets = 16)
+    {
+        using Allocator = ArenaAllocator<std::pair<const Key, Value>>;
+        return FrameUnorderedMap<Key, Value, Hash, Equal>(buckets, Hash(), Equal(),
+            Allocator(FrameAllocator::GetInstance().GetArena()));
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "mesh/Vertex.h"
+#include "mesh/MeshRegistry.h"
+
+namespace te
+{
+    // One interleaved float attribute inside a vertex
+    struct VertexAttribute
+    {
+        uint32_t location = 0;
+        uint32_t components = 0;  // number of floats
+        uint32_t offset = 0;      // bytes from the start of the vertex
+    };
+
+    // Describes how a vertex buffer is laid out, backends build their input state from it
+    struct VertexLayout
+    {
+        static constexpr size_t kMaxAttributes = 4;
+
+        uint32_t stride = 0;
+        uint32_t attributeCount = 0;
+        std::array<VertexAttribute, kMaxAttributes> attributes{};
+
+        // position(0) / normal(1) / optional uv(2) of the engine `Vertex`
+        static constexpr VertexLayout Standard(bool hasUV) noexcept
+        {
+            VertexLayout layout;
+            layout.stride = uint32_t(sizeof(Vertex));
+            layout.attributes[layout.attributeCount++] = { 0, 3, uint32_t(offsetof(Vertex, position)) };
+            layout.attributes[layout.attributeCount++] = { 1, 3, uint32_t(offsetof(Vertex, normal)) };
+            if (hasUV)
+            {
+                layout.attributes[layout.attributeCount++] = { 2, 2, uint32_t(offsetof(Vertex, texCoords)) };
+            }
+            return layout;
+        }
+
+        std::span<const VertexAttribute> Attributes() const noexcept
+        {
+            return { attributes.data(), attributeCount };
+        }
+    };
+
+    // Read-only, non-owning view of a GeometryItem's CPU data.
+    // Valid until the owning item is edited or destroyed; never copies.
+    struct GeometryView
+    {
+        std::span<const Vertex> vertices;
+        std::span<const unsigned int> indices;
+        VertexLayout layout;
+        MeshHandle handle;
+
+        bool Empty() const noexcept { return vertices.empty() || indices.empty(); }
+        size_t VertexBytes() const noexcept { return vertices.size_bytes(); }
+        size_t IndexBytes() const noexcept { return indices.size_bytes(); }
+        size_t TriangleCount() const noexcept { return indices.size() / 3; }
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "RenderObject.h"
+
+class GeometryItem;
+
+namespace te
+{
+    // Stable handle of a GeometryItem's GPU mesh.
+    // slot stays fixed for the lifetime of the item, generation is bumped on every CPU-side edit.
+    struct MeshHandle
+    {
+        static constexpr uint32_t kInvalidSlot = UINT32_MAX;
+
+        uint32_t slot = kInvalidSlot;
+        uint32_t generation = 0;
+
+        bool IsValid() const noexcept { return slot != kInvalidSlot; }
+    };
+
+    struct GeometryView;
+
+    // Persistent GPU mesh registry (OpenGL).
+    // Looks up VAO/VBO/EBO by handle slot in O(1), re-uploads only when the generation changes
+    // and evicts buffers of destroyed geometry at the next CollectReleased().
+    class MeshRegistry
+    {
+    public:
+        static MeshRegistry& GetInstance();
+
+        // CPU side, may be called from any thread
+        uint32_t RegisterSlot();
+        void ReleaseSlot(uint32_t slot);
+
+        // Pipelined frames: the main thread may edit geometry while the render thread draws, so
+        // BuildFrameScene copies every mesh that is not resident and the render thread uploads the copy.
+        // Set before the render thread starts.
+        void SetStagedUploads(bool enabled) { mStagedUploads = enabled; }
+        bool UsesStagedUploads() const { return mStagedUploads; }
+
+        // GL side, must be called with the OpenGL context current
+        // the pointer stays valid until the slot is released and collected
+        // a mesh once uploaded through Upload() is never re-uploaded from the live item
+        const MeshCache* Acquire(const GeometryItem& geometry);
+        // uploads a copy taken by BuildFrameScene, skipped when that generation is already resident
+        void Upload(const GeometryView& snapshot);
+        bool IsResident(const MeshHandle& handle) const;
+        void CollectReleased();
+        void ReleaseAll();
+
+        size_t GetResidentCount() const;
+
+    private:
+        MeshRegistry() = default;
+        ~MeshRegistry() = default;
+
+        struct Entry
+        {
+            MeshCache cache{};
+            uint32_t uploadedGeneration = 0;
+            bool uploaded = false;
+            bool alive = false;
+            bool staged = false;  // uploaded from frame copies only
+        };
+
+        static void CreateBuffers(Entry& entry);
+        static void DestroyBuffers(Entry& entry);
+
+        mutable std::mutex mMutex;
+        // deque: Acquire hands out pointers into entries, RegisterSlot must not move them
+        std::deque<Entry> mEntries;
+        std::vector<uint32_t> mFreeSlots;
+        std::vector<uint32_t> mReleasedSlots;  // waiting for GL eviction
+        std::atomic<bool> mStagedUploads{ false };
+    };
+}
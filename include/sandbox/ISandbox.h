@@ -12,8 +12,14 @@ public:
     virtual void Teardown(const std::shared_ptr<IRenderer>& renderer);
     /** Primary drawable (e.g. mouse picking); nullptr if not applicable. */
     virtual std::shared_ptr<FragmentsSource> GetFragmentsSource() const { return nullptr; }
-    /** Drawables submitted to the host render loop each frame. */
-    virtual std::vector<RenderCommand> GetRenderCommands() const;
+    /** Drawables submitted to the host render loop each frame, appended to commands (whose capacity the host reuses). */
+    virtual void CollectRenderCommands(std::vector<RenderCommand>& commands) const;
+    std::vector<RenderCommand> GetRenderCommands() const
+    {
+        std::vector<RenderCommand> commands;
+        CollectRenderCommands(commands);
+        return commands;
+    }
 
     bool IsEnableInteraction() const noexcept
     {
@@ -0,0 +1,20 @@
+#pragma once
+#include "sandbox/ISandbox.h"
+
+class BasicGeometry;
+
+// Large grid of identical meshes sharing a material: exercises automatic instancing,
+// the draw call count in RenderStats stays at a handful while instances reach 10k+.
+class Sandbox_InstancingDemo : public ISandbox
+{
+public:
+    void Init(const std::shared_ptr<IRenderer>& renderer) override;
+    void Update(const std::shared_ptr<IRenderer>& renderer) override;
+    void Teardown(const std::shared_ptr<IRenderer>& renderer) override;
+    std::shared_ptr<FragmentsSource> GetFragmentsSource() const override;
+    void CollectRenderCommands(std::vector<RenderCommand>& commands) const override;
+
+private:
+    std::vector<std::shared_ptr<BasicGeometry>> mGeometries;
+    std::vector<RenderCommand> mCommands;
+};
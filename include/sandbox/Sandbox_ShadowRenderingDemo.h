@@ -10,7 +10,7 @@ public:
     void Update(const std::shared_ptr<IRenderer>& renderer) override;
     void Teardown(const std::shared_ptr<IRenderer>& renderer) override;
     std::shared_ptr<FragmentsSource> GetFragmentsSource() const override;
-    std::vector<RenderCommand> GetRenderCommands() const override;
+    void CollectRenderCommands(std::vector<RenderCommand>& commands) const override;
 
 private:
     std::shared_ptr<BasicGeometry> mpGeometry;
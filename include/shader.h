@@ -5,9 +5,11 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
 #include "glad/glad.h"
 #include "glm/glm.hpp"
 #include "shader/ShaderPreprocessor.h"
+#include "shader/UniformId.h"
 
 GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path);
 
@@ -29,32 +31,48 @@ public:
 
 	void use();
 
-	void setBool(const std::string& name, bool value) const;
+	// names convert implicitly to te::UniformId; hot paths pass the pre-hashed te::uniform constants
+	void setBool(te::UniformId id, bool value) const;
 
-	void setInt(const std::string& name, int value) const;
+	void setInt(te::UniformId id, int value) const;
 
-	void setFloat(const std::string& name, float value) const;
+	void setFloat(te::UniformId id, float value) const;
 
-	void setVec2(const std::string& name, const glm::vec2& value) const;
+	void setVec2(te::UniformId id, const glm::vec2& value) const;
 
-	void setVec3(const std::string& name, const glm::vec3& value) const;
+	void setVec3(te::UniformId id, const glm::vec3& value) const;
 
-	void setVec3(const std::string& name, float x, float y, float z) const;
+	void setVec3(te::UniformId id, float x, float y, float z) const;
 
-	void setVec4(const std::string& name, const glm::vec4& value) const;
+	void setVec4(te::UniformId id, const glm::vec4& value) const;
 
-	void setVec4(const std::string& name, float x, float y, float z, float w) const;
+	void setVec4(te::UniformId id, float x, float y, float z, float w) const;
 
-	void setMat2(const std::string& name, const glm::mat2& mat) const;
+	void setMat2(te::UniformId id, const glm::mat2& mat) const;
 
-	void setMat3(const std::string& name, const glm::mat3& mat) const;
+	void setMat3(te::UniformId id, const glm::mat3& mat) const;
 
-	void setMat4(const std::string& name, const glm::mat4& mat) const;
+	void setMat4(te::UniformId id, const glm::mat4& mat) const;
+
+	// cached location, -1 if the program has no such active uniform
+	GLint GetUniformLocation(te::UniformId id) const;
+	// true when the program reads the shared per-frame uniform block
+	bool UsesFrameUniforms() const noexcept { return mUsesFrameUniforms; }
 
 	unsigned int GetID() const noexcept { return mId; }
 	
 	// check if shader is valid
 	bool IsValid() const noexcept { return mId != 0; }
+
+	// source files and the preprocessor (with its macros) the program was built from
+	const std::string& GetVertexPath() const noexcept { return mVertexPath; }
+	const std::string& GetFragmentPath() const noexcept { return mFragmentPath; }
+	const te::ShaderPreprocessor& GetPreprocessor() const noexcept { return mPreprocessor; }
+
+	// compiles and links preprocessed sources in the current context, 0 on failure (errors are logged)
+	static GLuint CompileProgram(const std::string& vertexCode, const std::string& fragmentCode, bool retrievableBinary = false);
+	// installs a program linked elsewhere (hot reload), the previous one is deleted
+	void ReplaceProgram(GLuint program);
 	
 	// static method: create shader with ShaderBuilder
 	static std::shared_ptr<Shader> CreateWithBuilder(const std::string& vertexPath, const std::string& fragmentPath);
@@ -64,11 +82,23 @@ public:
 private:
 	unsigned int mId;
 	te::ShaderPreprocessor mPreprocessor;  // preprocessor instance
+	std::string mVertexPath;
+	std::string mFragmentPath;
+
+	// uniform name hash -> location, filled from reflection after link (misses are cached lazily).
+	// A hash shared by two active uniforms is found during reflection and maps to kHashCollision,
+	// those uniforms are looked up by name on every set.
+	static constexpr GLint kHashCollision = -2;
+	mutable std::unordered_map<uint32_t, GLint> mUniformLocations;
+	bool mUsesFrameUniforms = false;
+
+	void reflectUniforms();
 
-	bool checkCompileErrors(unsigned int shader, std::string type);
+	static bool checkCompileErrors(unsigned int shader, std::string type);
 	
 	// internal constructor, support preprocessor
 	void constructWithPreprocessor(const char* vertexPath, const char* fragmentPath, te::ShaderPreprocessor& preprocessor);
+	void buildProgram(te::ShaderPreprocessor& preprocessor);
 	
 	// helper functions
 	bool isOpenGLContextValid() const;
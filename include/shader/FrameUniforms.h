@@ -0,0 +1,59 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "glad/glad.h"
+
+class Camera;
+class Light;
+class RenderContext;
+
+namespace te
+{
+    struct FrameView;
+    struct FrameLight;
+
+    // std140 mirror of the `FrameData` block in shaders/includes/frame_uniforms.glsl
+    struct FrameUniforms
+    {
+        glm::mat4 view{ 1.0f };
+        glm::mat4 projection{ 1.0f };
+        glm::mat4 lightSpaceMatrix{ 1.0f };
+        glm::vec4 viewPos{ 0.0f };     // xyz
+        glm::vec4 lightPos{ 0.0f };    // xyz
+        glm::vec4 lightColor{ 1.0f };  // xyz
+    };
+    static_assert(sizeof(FrameUniforms) == 3 * sizeof(glm::mat4) + 3 * sizeof(glm::vec4), "FrameUniforms must match std140");
+
+    // Uniform buffer holding the per-frame camera / light data, bound once at kBindingPoint.
+    // Programs declaring the FrameData block are pointed at it when they are linked.
+    class FrameUniformBuffer
+    {
+    public:
+        static constexpr GLuint kBindingPoint = 0;
+        static constexpr const char* kBlockName = "FrameData";
+
+        static FrameUniformBuffer& GetInstance();
+
+        void SetCamera(const Camera& camera);
+        void SetLight(const Light& light);
+        void SetView(const FrameView& view);
+        void SetLight(const FrameLight& light);
+        void SetLightSpaceMatrix(const glm::mat4& lightSpaceMatrix);
+        // view + light the context renders with (RenderContext::GetRenderView / GetRenderLight), then Upload()
+        void UpdateFromContext(RenderContext& context);
+
+        // writes pending changes with a single glBufferSubData and (re)binds the buffer
+        void Upload();
+        void Release();
+
+        const FrameUniforms& GetData() const noexcept { return mData; }
+
+    private:
+        FrameUniformBuffer() = default;
+        ~FrameUniformBuffer() = default;
+
+        FrameUniforms mData;
+        GLuint mBuffer = 0;
+        bool mDirty = true;
+    };
+}
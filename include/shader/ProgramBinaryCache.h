@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "glad/glad.h"
+
+namespace te
+{
+    struct ProgramCacheStats
+    {
+        uint32_t loaded = 0;     // programs restored from a cached binary
+        uint32_t compiled = 0;   // programs compiled from source (cache miss or fallback)
+        uint32_t rejected = 0;   // cached binaries the driver refused (format / driver change)
+        double loadMs = 0.0;
+        double compileMs = 0.0;
+    };
+
+    // On-disk cache of linked GL program binaries.
+    // The key hashes the fully preprocessed vertex + fragment source and the macro set, a file
+    // also records GL_VENDOR / GL_RENDERER / GL_VERSION so binaries of another driver are never fed back.
+    class ProgramBinaryCache
+    {
+    public:
+        static ProgramBinaryCache& GetInstance();
+
+        // directory the binaries are written to, created on first store
+        void SetDirectory(const std::string& directory);
+        const std::string& GetDirectory() const noexcept { return mDirectory; }
+        void SetEnabled(bool enabled) { mEnabled = enabled; }
+        // needs a current context exposing glProgramBinary (GL 4.1 / ARB_get_program_binary)
+        bool IsAvailable() const;
+
+        static uint64_t ComputeKey(const std::string& vertexSource, const std::string& fragmentSource,
+            const std::string& macroSignature);
+
+        // links `program` from the cached binary, false (and the file dropped) when missing or rejected
+        bool Load(uint64_t key, GLuint program);
+        // stores the binary of a successfully linked program
+        bool Store(uint64_t key, GLuint program);
+
+        void RecordBuild(bool fromCache, double milliseconds);
+        const ProgramCacheStats& GetStats() const noexcept { return mStats; }
+        void ResetStats() { mStats = {}; }
+        // one line summary, e.g. after startup or a sandbox switch
+        void LogStats(const std::string& label) const;
+
+    private:
+        ProgramBinaryCache();
+        ~ProgramBinaryCache() = default;
+
+        std::string GetFilePath(uint64_t key) const;
+        uint64_t GetDriverHash() const;
+
+        std::string mDirectory;
+        bool mEnabled = true;
+        mutable uint64_t mDriverHash = 0;
+        ProgramCacheStats mStats;
+    };
+}
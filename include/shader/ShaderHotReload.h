@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "glad/glad.h"
+#include "shader/ShaderPreprocessor.h"
+
+struct GLFWwindow;
+class Shader;
+
+namespace te
+{
+    // Hot shader reload for look-dev.
+    // A worker thread watches the shader directory (inotify on Linux, mtime polling elsewhere), finds the
+    // programs affected by a saved file through the ShaderSourceCache include graph and rebuilds them in
+    // its own shared GL context. Finished programs are installed by ApplyPendingSwaps() at a frame
+    // boundary once their fence has signalled; a failed build is dropped and the old program stays.
+    class ShaderHotReload
+    {
+    public:
+        static ShaderHotReload& GetInstance();
+
+        // `workerWindow`: hidden window sharing objects with the render context, created on the
+        // main thread (GLFW requirement); the worker makes its context current
+        bool Start(GLFWwindow* workerWindow, const std::string& watchDirectory);
+        void Stop();
+        bool IsRunning() const noexcept { return mRunning; }
+
+        // every Shader registers itself on construction
+        void Register(Shader* shader);
+        void Unregister(Shader* shader);
+
+        // rendering thread, between frames: swaps in the rebuilt programs that are ready, never waits
+        void ApplyPendingSwaps();
+        // rendering thread, at shutdown: deletes rebuilt programs that were never swapped in
+        void ReleaseGpuResources();
+
+        uint32_t GetReloadCount() const noexcept { return mReloadCount; }
+        uint32_t GetFailureCount() const noexcept { return mFailureCount; }
+
+    private:
+        ShaderHotReload() = default;
+
+        struct Job
+        {
+            Shader* shader = nullptr;
+            uint64_t serial = 0;
+            std::string vertexPath;
+            std::string fragmentPath;
+            ShaderPreprocessor preprocessor;  // copy, carries the variant macros
+        };
+
+        struct PendingSwap
+        {
+            Shader* shader = nullptr;
+            uint64_t serial = 0;
+            GLuint program = 0;
+            GLsync fence = nullptr;
+        };
+
+        void WorkerLoop();
+        std::vector<Job> CollectJobs(const std::vector<std::string>& changedFiles);
+        void Build(Job& job);
+        void DeleteDiscarded();  // mMutex held, rendering thread
+
+        // platform file watching, paths are ShaderSourceCache::NormalizePath keys
+        bool OpenWatch();
+        void CloseWatch();
+        std::vector<std::string> WaitForChanges();
+
+        GLFWwindow* mpWorkerWindow = nullptr;
+        std::string mWatchDirectory;
+        std::thread mWorker;
+        std::atomic<bool> mRunning{ false };
+
+        std::mutex mMutex;
+        std::unordered_map<Shader*, uint64_t> mShaders;  // registered shader -> registration serial
+        uint64_t mNextSerial = 1;
+        std::vector<PendingSwap> mPending;
+        std::vector<PendingSwap> mDiscarded;  // dropped by Stop() / Unregister(), deleted on the rendering thread
+
+        std::atomic<uint32_t> mReloadCount{ 0 };
+        std::atomic<uint32_t> mFailureCount{ 0 };
+
+        int mNotifyFd = -1;
+        std::unordered_map<int, std::string> mWatchDirectories;  // inotify watch -> directory
+        std::unordered_map<std::string, std::filesystem::file_time_type> mWriteTimes;  // polling fallback
+    };
+}
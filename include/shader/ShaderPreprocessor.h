@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,6 +12,8 @@ class Shader;
 
 namespace te
 {
+    struct ShaderSourceFile;
+
     // shader preprocessor configuration
     struct ShaderPreprocessorConfig
     {
@@ -18,6 +21,7 @@ namespace te
         std::string includeDirectory = "resources/shaders/includes/";  // include directory
         bool enableMacroExpansion = false;  // enable macro expansion
         bool enableIncludeProcessing = true;  // enable include processing
+        bool emitLineDirectives = true;  // wrap expanded includes in `#line <line> <source>` (GLSL 330+ numbering)
     };
 
     // macro definition structure
@@ -51,6 +55,8 @@ namespace te
         void UndefineMacro(const std::string& name);
         void ClearMacros();
         bool IsMacroDefined(const std::string& name) const;
+        // sorted "NAME=value;" list of the defined macros, part of the program cache key
+        std::string GetMacroSignature() const;
 
         // configuration management
         void SetConfig(const ShaderPreprocessorConfig& config);
@@ -58,14 +64,15 @@ namespace te
 
         // get the processed shader content (for debugging)
         const std::string& GetLastProcessedContent() const { return mLastProcessedContent; }
+        // source string number used in the #line directives -> file path (0 is the shader itself)
+        const std::vector<std::string>& GetLastSourceMap() const { return mSourceMap; }
 
     private:
         // core processing function
-        std::string ProcessIncludes(const std::string& content, const std::string& basePath, int depth = 0);
-        std::string ProcessLineDirectives(const std::string& content, const std::string& originalPath);
+        std::string ProcessParsed(const ShaderSourceFile& source, const std::string& basePath);
+        void ProcessIncludes(const ShaderSourceFile& source, uint32_t sourceIndex, int depth, bool lineDirectives, std::string& out);
 
         // auxiliary function
-        std::string ReadFile(const std::string& filePath);
         std::string ResolveIncludePath(const std::string& includePath, const std::string& basePath);
         bool IsValidIncludeDepth(int depth);
 
@@ -73,6 +80,7 @@ namespace te
         ShaderPreprocessorConfig mConfig;
         std::unordered_map<std::string, ShaderMacro> mMacros;
         std::unordered_set<std::string> mProcessedFiles;  // prevent circular inclusion
+        std::vector<std::string> mSourceMap;
         std::string mLastProcessedContent;
         
         // builtin macro definition
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace te
+{
+    // `#include <path>` / `#include "path"` found at the start of a line, outside block comments
+    struct ShaderIncludeDirective
+    {
+        size_t begin = 0;       // offset of the directive line
+        size_t end = 0;         // offset of the line's '\n' (or the end of the text)
+        uint32_t line = 0;      // 1-based line number
+        std::string path;       // as written between the delimiters
+    };
+
+    // A shader source file tokenised once: the raw text plus the include directives in it
+    struct ShaderSourceFile
+    {
+        std::string text;
+        std::vector<ShaderIncludeDirective> includes;
+        uint32_t versionLine = 0;   // line of `#version`, 0 when absent
+        std::filesystem::file_time_type writeTime{};
+
+        // single pass over `text` filling `includes` and `versionLine`
+        void Tokenize();
+    };
+
+    struct ShaderSourceCacheStats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;    // first read of a path
+        uint64_t reloads = 0;   // re-read because the file's mtime changed
+    };
+
+    // Process-wide cache of parsed shader sources keyed by path and mtime,
+    // and the dependency graph between root shaders and the files they include.
+    class ShaderSourceCache
+    {
+    public:
+        static ShaderSourceCache& GetInstance();
+
+        // parsed file, re-read when its mtime changed; nullptr if it cannot be read
+        std::shared_ptr<const ShaderSourceFile> Get(const std::string& path);
+        void Invalidate(const std::string& path);
+        void Clear();
+
+        // replaces the recorded includes (transitive, in include order) of a root shader
+        void SetDependencies(const std::string& shaderPath, const std::vector<std::string>& includes);
+        std::vector<std::string> GetDependencies(const std::string& shaderPath) const;
+        // root shaders that (transitively) include `path`
+        std::vector<std::string> GetDependents(const std::string& path) const;
+
+        ShaderSourceCacheStats GetStats() const;
+        void ResetStats();
+
+        // canonical key for a path so includes and roots resolved differently still match
+        static std::string NormalizePath(const std::string& path);
+
+    private:
+        ShaderSourceCache() = default;
+
+        mutable std::mutex mMutex;
+        std::unordered_map<std::string, std::shared_ptr<const ShaderSourceFile>> mFiles;
+        std::unordered_map<std::string, std::vector<std::string>> mDependencies;
+        std::unordered_map<std::string, std::unordered_set<std::string>> mDependents;
+        ShaderSourceCacheStats mStats;
+    };
+}
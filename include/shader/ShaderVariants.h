@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Shader;
+
+namespace te
+{
+    // bit i set -> the i-th feature define of the material is compiled in
+    using ShaderVariantMask = uint32_t;
+
+    // Process-wide cache of shader permutations.
+    // A variant is a vertex/fragment pair built through ShaderBuilder with a set of `#define NAME 1`,
+    // compiled on first request and shared by every material asking for the same combination.
+    class ShaderVariantCache
+    {
+    public:
+        static ShaderVariantCache& GetInstance();
+
+        // `features[i]` is defined when bit i of `mask` is set
+        std::shared_ptr<Shader> Get(const std::string& vertexPath, const std::string& fragmentPath,
+            const std::vector<std::string>& features, ShaderVariantMask mask);
+        std::shared_ptr<Shader> Get(const std::string& vertexPath, const std::string& fragmentPath,
+            std::vector<std::string> defines);
+
+        // builds every variant listed in the manifest (one "vs<TAB>fs<TAB>DEFINE DEFINE..." per line),
+        // returns how many were compiled
+        size_t Precompile(const std::string& manifestPath);
+        // writes the variants built so far, so the next start can precompile them
+        bool SaveManifest(const std::string& manifestPath) const;
+        // <program binary cache directory>/shader_variants.txt
+        static std::string GetDefaultManifestPath();
+
+        size_t GetVariantCount() const;
+        void Clear();
+
+    private:
+        ShaderVariantCache() = default;
+
+        struct Variant
+        {
+            std::string vertexPath;
+            std::string fragmentPath;
+            std::vector<std::string> defines;
+            std::shared_ptr<Shader> shader;
+        };
+
+        static std::string MakeKey(const std::string& vertexPath, const std::string& fragmentPath,
+            const std::vector<std::string>& defines);
+
+        mutable std::mutex mMutex;
+        std::unordered_map<std::string, Variant> mVariants;
+    };
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace te
+{
+    // Uniform name with its FNV-1a hash, the key into a Shader's location cache.
+    // The constants in te::uniform are hashed at compile time; ad-hoc names hash once per call.
+    struct UniformId
+    {
+        uint32_t hash = 0;
+        const char* name = nullptr;  // only used to query the location on a cache miss
+
+        constexpr UniformId(const char* uniformName) noexcept
+            : hash(Hash(uniformName)), name(uniformName) {}
+        UniformId(const std::string& uniformName) noexcept
+            : hash(Hash(uniformName)), name(uniformName.c_str()) {}
+
+        static constexpr uint32_t Hash(std::string_view text) noexcept
+        {
+            uint32_t value = 2166136261u;
+            for (char c : text)
+            {
+                value ^= uint8_t(c);
+                value *= 16777619u;
+            }
+            return value;
+        }
+    };
+
+    // uniforms set by the renderer on every draw
+    namespace uniform
+    {
+        inline constexpr UniformId Model{ "model" };
+        inline constexpr UniformId Instanced{ "u_instanced" };
+        inline constexpr UniformId LightSpaceMatrix{ "lightSpaceMatrix" };
+    }
+}
@@ -3,6 +3,7 @@
 // include common math functions
 #include <includes/math_common.glsl>
 #include <includes/shadow_common.glsl>
+#include <includes/frame_uniforms.glsl>
 
 out vec4 FragColor;
 
@@ -25,25 +26,18 @@ uniform float u_metallic;           // Metallic factor (0.0 = dielectric, 1.0 =
 uniform float u_roughness;          // Roughness factor (0.0 = smooth, 1.0 = rough)
 uniform float u_ao;                 // Ambient occlusion factor
 
-// Texture flags
-uniform vec4 u_hasTextures;         // x: albedo, y: normal, z: metallic, w: roughness
+// Variant features (PBRMaterial feature bits):
+// HAS_ALBEDO_MAP, HAS_NORMAL_MAP, HAS_METALLIC_MAP, HAS_ROUGHNESS_MAP, HAS_AO_MAP  sample the map instead of the uniform
+// USE_SHADOW, USE_PCF  shadow map lookup, 3x3 PCF
 
-// Lighting
-uniform vec3 u_lightPos;
-uniform vec3 u_lightColor;
-uniform vec3 u_viewPos;
+// Lighting: u_lightPos / u_lightColor / u_viewPos come from the FrameData block
 
 // Brightness and lighting controls
 uniform float u_exposure;             // Exposure for tone mapping (default: 1.0)
 uniform vec2 u_intensities;          // x: ambient(default: 0.3), y: light(default: 1.0)
 
-// IBL (Image Based Lighting) - optional
-uniform vec2 u_useIBL_ao;             // x: IBL, y: AO
-
 // Shadow mapping
-uniform float u_enableShadow;         // 0 = off, 1 = on
 uniform float u_shadowBias;           // base depth bias
-uniform float u_enablePCF;            // 0 = hard shadow, 1 = 3x3 PCF
 
 // ============================================
 // PBR Functions
@@ -120,15 +114,34 @@ vec3 getNormalFromMap()
 void main()
 {
     // Sample textures or use uniform values
-    vec3 albedo = u_hasTextures.x > 0.5 ? mix(pow(texture(u_albedoMap, TexCoords).rgb, vec3(2.2)), u_albedo, 0.05): u_albedo;
-    float metallic = u_hasTextures.z > 0.5 ? texture(u_metallicMap, TexCoords).r : u_metallic;
-    float roughness = u_hasTextures.w > 0.5 ? texture(u_roughnessMap, TexCoords).r : u_roughness;
-    // AO texture is optional, always sample but use uniform as fallback
-    float ao = u_useIBL_ao.y > 0.5 ? texture(u_aoMap, TexCoords).r : u_ao;
+#ifdef HAS_ALBEDO_MAP
+    vec3 albedo = mix(pow(texture(u_albedoMap, TexCoords).rgb, vec3(2.2)), u_albedo, 0.05);
+#else
+    vec3 albedo = u_albedo;
+#endif
+#ifdef HAS_METALLIC_MAP
+    float metallic = texture(u_metallicMap, TexCoords).r;
+#else
+    float metallic = u_metallic;
+#endif
+#ifdef HAS_ROUGHNESS_MAP
+    float roughness = texture(u_roughnessMap, TexCoords).r;
+#else
+    float roughness = u_roughness;
+#endif
+#ifdef HAS_AO_MAP
+    float ao = texture(u_aoMap, TexCoords).r;
     if (ao < 0.0) ao = u_ao; // Use uniform value if texture returns 0 (likely unbound)
+#else
+    float ao = u_ao;
+#endif
     
     // Get normal
-    vec3 N = u_hasTextures.y > 0.5 ? getNormalFromMap() : normalize(Normal);
+#ifdef HAS_NORMAL_MAP
+    vec3 N = getNormalFromMap();
+#else
+    vec3 N = normalize(Normal);
+#endif
     vec3 V = normalize(u_viewPos - FragPos);
     
     // Calculate reflectance at normal incidence
@@ -171,12 +184,10 @@ void main()
     float NdotL = max(dot(N, L), 0.0);
     Lo += (kD * albedo / PI + specular) * radiance * NdotL;
 
-    float shadow = 0.0;
-    if (u_enableShadow > 0.5)
-    {
-        shadow = ShadowCalculation(FragPosLightSpace, u_shadowMap, N, L, u_shadowBias, u_enablePCF);
-        Lo *= (1.0 - shadow);
-    }
+#ifdef USE_SHADOW
+    float shadow = ShadowCalculation(FragPosLightSpace, u_shadowMap, N, L, u_shadowBias, kShadowPCF);
+    Lo *= (1.0 - shadow);
+#endif
 
     // Ambient lighting with adjustable intensity
     vec3 ambient = u_intensities.x * albedo * ao;
@@ -3,6 +3,7 @@
 // include common math functions
 #include <includes/math_common.glsl>
 #include <includes/shadow_common.glsl>
+#include <includes/frame_uniforms.glsl>
 
 out vec4 FragColor;
 
@@ -18,26 +19,14 @@ uniform sampler2D u_geomPositionMap; // texture sampler(optional)
 uniform sampler2D u_geomDepthMap; // texture sampler(optional)
 uniform sampler2D u_shadowMap;    // texture unit 5
 
-uniform vec3 u_lightPos;
-uniform vec3 u_viewPos;
-uniform vec3 u_lightColor;
 uniform vec3 u_objectColor;
 uniform vec4 u_Strengths; // x: ambientStrength, y: diffuseStrength, z: specularStrength, w: shininess
-uniform vec4 u_useBlinn_Geometry; // if true, use Blinn-Phong shading model, otherwise use Phong shading model
-
-uniform float u_enableShadow;
 uniform float u_shadowBias;
-uniform float u_enablePCF;
-
-bool isBlinnPhong()
-{
-    return u_useBlinn_Geometry.x > 0.5;
-}
 
-bool isUseGeometryTarget()
-{
-    return u_useBlinn_Geometry.y > 0.5;
-}
+// Variant features (PhongMaterial feature bits):
+// USE_BLINN            Blinn-Phong instead of Phong specular
+// USE_GEOMETRY_TARGET  read normal / position / albedo from the geometry pass targets
+// USE_SHADOW, USE_PCF  shadow map lookup, 3x3 PCF
 
 vec3 CalculatePhongColor()
 {
@@ -48,21 +37,16 @@ vec3 CalculatePhongColor()
     // 2. Calculate the diffuse lighting
     float diffuseStrength = u_Strengths.y;
 
-    vec3 norm;
-    vec3 fragPos;
-    if(isUseGeometryTarget())
-    {
-        // Use geometry pass data
-        norm = texture(u_geomNormalMap, TexCoords).rgb;
-        norm = normalize(norm * 2.0 - 1.0); // Convert from [0,1] to [-1,1] range
-        fragPos = texture(u_geomPositionMap, TexCoords).rgb;
-    }
-    else
-    {
-        // Use interpolated vertex data
-        norm = normalize(Normal);
-        fragPos = FragPos;
-    }
+#ifdef USE_GEOMETRY_TARGET
+    // Use geometry pass data
+    vec3 norm = texture(u_geomNormalMap, TexCoords).rgb;
+    norm = normalize(norm * 2.0 - 1.0); // Convert from [0,1] to [-1,1] range
+    vec3 fragPos = texture(u_geomPositionMap, TexCoords).rgb;
+#else
+    // Use interpolated vertex data
+    vec3 norm = normalize(Normal);
+    vec3 fragPos = FragPos;
+#endif
     vec3 lightDir = normalize(u_lightPos - fragPos);
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = diffuseStrength * diff * u_lightColor;
@@ -71,25 +55,20 @@ vec3 CalculatePhongColor()
     float specularStrength = u_Strengths.z;
     float shininess = u_Strengths.w;
     vec3 viewDir = normalize(u_viewPos - fragPos);
+#ifdef USE_BLINN
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(norm, halfwayDir), 0.0), shininess);
+#else
     vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = 0.0;
-    if(isBlinnPhong())
-    {
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        spec = pow(max(dot(norm, halfwayDir), 0.0), shininess);
-    }
-    else
-    {
-        spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    }
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+#endif
     vec3 specular = specularStrength * spec * u_lightColor;
 
     vec3 direct = diffuse + specular;
-    if (u_enableShadow > 0.5)
-    {
-        float shadow = ShadowCalculation(FragPosLightSpace, u_shadowMap, norm, lightDir, u_shadowBias, u_enablePCF);
-        direct *= (1.0 - shadow);
-    }
+#ifdef USE_SHADOW
+    float shadow = ShadowCalculation(FragPosLightSpace, u_shadowMap, norm, lightDir, u_shadowBias, kShadowPCF);
+    direct *= (1.0 - shadow);
+#endif
 
     return ambient + direct;
 }
@@ -99,11 +78,11 @@ void main()
     vec3 result = u_objectColor;
     
     // Get albedo color
+#ifdef USE_GEOMETRY_TARGET
+    vec3 geomAlbedo = texture(u_geomAlbedoMap, TexCoords).rgb;
+#else
     vec3 geomAlbedo = texture(u_diffuseTexture, TexCoords).rgb;
-    if(isUseGeometryTarget())
-    {
-        geomAlbedo = texture(u_geomAlbedoMap, TexCoords).rgb;
-    }
+#endif
     result *= geomAlbedo;
 
     // Calculate lighting
@@ -2,19 +2,22 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in mat4 aInstanceModel; // per-instance transform (locations 3..6)
+
+#include <includes/frame_uniforms.glsl>
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform bool u_instanced;
 
 void main()
 {
-    FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    mat4 worldModel = u_instanced ? aInstanceModel : model;
+    FragPos = vec3(worldModel * vec4(aPos, 1.0));
+    Normal = mat3(transpose(inverse(worldModel))) * aNormal;
     TexCoords = aTexCoords;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
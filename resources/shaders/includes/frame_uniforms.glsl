@@ -0,0 +1,19 @@
+#ifndef FRAME_UNIFORMS_GLSL
+#define FRAME_UNIFORMS_GLSL
+
+// Per-frame data shared by every program, filled once per frame by te::FrameUniformBuffer.
+// Layout must match te::FrameUniforms (std140).
+layout (std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    mat4 u_lightSpaceMatrix;
+    vec3 u_viewPos;
+    float u_framePad0;
+    vec3 u_lightPos;
+    float u_framePad1;
+    vec3 u_lightColor;
+    float u_framePad2;
+};
+
+#endif
@@ -1,6 +1,13 @@
 #ifndef SHADOW_COMMON_GLSL
 #define SHADOW_COMMON_GLSL
 
+// enablePCF argument for variants built with / without USE_PCF
+#ifdef USE_PCF
+const float kShadowPCF = 1.0;
+#else
+const float kShadowPCF = 0.0;
+#endif
+
 float ShadowCompare(float currentDepth, float closestDepth, float slopeBias)
 {
     return (currentDepth - slopeBias > closestDepth) ? 1.0 : 0.0;
@@ -1,11 +1,14 @@
 #version 330 core
 
 layout (location = 0) in vec3 aPos;
+layout (location = 3) in mat4 aInstanceModel; // per-instance transform (locations 3..6)
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+uniform bool u_instanced;
 
 void main()
 {
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    mat4 worldModel = u_instanced ? aInstanceModel : model;
+    gl_Position = lightSpaceMatrix * worldModel * vec4(aPos, 1.0);
 }
@@ -9,18 +9,20 @@ layout(set = 0, binding = 0) uniform CameraUBO {
     mat4 proj;
 } cameraUBO;
 
-layout(set = 0, binding = 1) uniform ModelUBO {
-    mat4 model;
-} modelUBO;
+// one model matrix per instance, instanced draws start at their queue index (firstInstance)
+layout(std430, set = 0, binding = 1) readonly buffer InstanceSSBO {
+    mat4 models[];
+} instanceSSBO;
 
 layout(location = 0) out vec3 vWorldPos;
 layout(location = 1) out vec3 vWorldNormal;
 layout(location = 2) out vec2 vUV;
 
 void main() {
-    vec4 worldPos = modelUBO.model * vec4(inPos, 1.0);
+    mat4 model = instanceSSBO.models[gl_InstanceIndex];
+    vec4 worldPos = model * vec4(inPos, 1.0);
     vWorldPos = worldPos.xyz;
-    vWorldNormal = mat3(modelUBO.model) * inNormal;
+    vWorldNormal = mat3(model) * inNormal;
     vUV = inUV;
     gl_Position = cameraUBO.proj * cameraUBO.view * worldPos;
 }
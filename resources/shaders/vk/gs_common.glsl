@@ -32,11 +32,18 @@ const float SH_C3[] = {
 -0.5900435899266435f
 };
 
-struct Vertex {
-    vec4 position;
-    vec4 scale_opacity;
-    vec4 rotation;
-    float sh[48];
+// Splats are stored as one array per attribute (GSComputeRenderer createBuffers): culling reads
+// only the hot position and cov3D arrays, the SH array holds SH_FLOATS floats per splat.
+layout (constant_id = 0) const uint SH_DEGREE = 3;
+const uint SH_FLOATS = 3u * (SH_DEGREE + 1u) * (SH_DEGREE + 1u);
+
+// Written by gs_indirect_args.comp (GSSortIndirectArgs on the CPU). Over capacity the instance
+// list is truncated for the frame and the CPU grows the sort buffers from requestedInstances.
+struct IndirectArgs {
+    uint sortGroups[3];
+    uint tileBoundaryGroups[3];
+    uint numInstances;
+    uint requestedInstances;
 };
 
 struct VertexAttribute {
@@ -1,16 +1,23 @@
 #include "Fragment.h"
+#include <atomic>
+
+namespace
+{
+    // generations are unique across items so a recycled slot never matches a stale GPU copy
+    std::atomic<uint32_t> sNextGeneration{ 1 };
+    std::atomic<uint64_t> sCopiedBytes{ 0 };
+}
 
 GeometryItem::GeometryItem()
+    : mMeshSlot(te::MeshRegistry::GetInstance().RegisterSlot())
+    , mGeneration(sNextGeneration.fetch_add(1, std::memory_order_relaxed))
 {
-    if (initialized) {
-        glDeleteVertexArrays(1, &mVAO);
-        glDeleteBuffers(1, &mVBO);
-        glDeleteBuffers(1, &mEBO);
-    }
 }
 
 GeometryItem::~GeometryItem()
 {
+    // GPU buffers are evicted by the registry on the GL thread
+    te::MeshRegistry::GetInstance().ReleaseSlot(mMeshSlot);
 }
 
 std::optional<te::AaBB> GeometryItem::GetAABB(bool update)
@@ -54,57 +61,80 @@ std::optional<te::AaBB> GeometryItem::GetWorldAABB()
     return worldAABB;
 }
 
-void GeometryItem::MarkHasUV(bool has)
+std::vector<Vertex> GeometryItem::GetVertices() const
 {
-    mbHasUV = has;
+    sCopiedBytes.fetch_add(mVertices.size() * sizeof(Vertex), std::memory_order_relaxed);
+    return mVertices;
 }
 
-void GeometryItem::SetLocalTransform(const glm::mat4& trn)
+std::vector<unsigned int> GeometryItem::GetIndices() const
 {
-    mLocalTransform = trn;
+    sCopiedBytes.fetch_add(mIndices.size() * sizeof(unsigned int), std::memory_order_relaxed);
+    return mIndices;
 }
 
-void GeometryItem::SetWorldTransform(const glm::mat4& trn)
+uint64_t GeometryItem::ConsumeCopiedBytes() noexcept
 {
-    mWorldTransform = trn;
+    return sCopiedBytes.exchange(0, std::memory_order_relaxed);
 }
 
-void GeometryItem::SetupMesh()
+void GeometryItem::MarkDirty() noexcept
 {
-    if (mVertices.empty())
+    mGeneration = sNextGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t GeometryItem::GetContentKey() const noexcept
+{
+    if (mContentKeyGeneration == mGeneration)
     {
-        return;
+        return mContentKey;
     }
 
-    glGenVertexArrays(1, &mVAO);
-    glGenBuffers(1, &mVBO);
-    glGenBuffers(1, &mEBO);
-
-    glBindVertexArray(mVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
-    glBufferData(GL_ARRAY_BUFFER, mVertices.size() * sizeof(Vertex), &mVertices[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mIndices.size() * sizeof(unsigned int), &mIndices[0], GL_STATIC_DRAW);
-
-    // position
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    // FNV-1a over 32-bit words, geometry buffers are always 4-byte aligned
+    constexpr uint64_t kPrime = 1099511628211ull;
+    uint64_t hash = 1469598103934665603ull;
+    auto hashWords = [&hash](const void* data, size_t bytes) {
+        const uint32_t* words = static_cast<const uint32_t*>(data);
+        for (size_t i = 0; i < bytes / sizeof(uint32_t); ++i)
+        {
+            hash ^= words[i];
+            hash *= kPrime;
+        }
+    };
+    const uint64_t counts[2] = { mVertices.size(), mIndices.size() };
+    hashWords(counts, sizeof(counts));
+    hashWords(mVertices.data(), mVertices.size() * sizeof(Vertex));
+    hashWords(mIndices.data(), mIndices.size() * sizeof(unsigned int));
+    hash ^= uint64_t(mbHasUV);
+    hash *= kPrime;
 
-    // normal
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    mContentKey = hash;
+    mContentKeyGeneration = mGeneration;
+    return mContentKey;
+}
 
-    if (mbHasUV)
+void GeometryItem::MarkHasUV(bool has)
+{
+    if (mbHasUV != has)
     {
-        // uv
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+        mbHasUV = has;
+        MarkDirty();
     }
+}
 
-    glBindVertexArray(0);
-    initialized = true;
+void GeometryItem::SetLocalTransform(const glm::mat4& trn)
+{
+    mLocalTransform = trn;
+}
+
+void GeometryItem::SetWorldTransform(const glm::mat4& trn)
+{
+    mWorldTransform = trn;
+}
+
+void GeometryItem::SetupMesh()
+{
+    te::MeshRegistry::GetInstance().Acquire(*this);
 }
 
 bool GeometryItem::ValidateGeometryData() const noexcept
@@ -123,23 +153,19 @@ bool GeometryItem::EnsureOpenGLResources()
     {
         return false;
     }
-    if (!initialized)
-    {
-        SetupMesh();
-    }
-    return initialized;
+
+    SetupMesh();
+    return HasOpenGLResources();
 }
 
-bool GeometryItem::SubmitMesh()
+bool GeometryItem::HasOpenGLResources() const noexcept
 {
-    if (!ValidateGeometryData())
-    {
-        return false;
-    }
-
-    SetupMesh();
+    return te::MeshRegistry::GetInstance().IsResident(GetMeshHandle());
+}
 
-    return initialized;
+bool GeometryItem::SubmitMesh()
+{
+    return EnsureOpenGLResources();
 }
 
 bool GeometryItem::VarifyValidation()
@@ -149,24 +175,16 @@ bool GeometryItem::VarifyValidation()
 
 void GeometryItem::SubmitDrawCall()
 {
-    if (!initialized)
+    const MeshCache* cache = te::MeshRegistry::GetInstance().Acquire(*this);
+    if (!cache)
     {
         return;
     }
-    glBindVertexArray(mVAO);
-    glDrawElements(GL_TRIANGLES, GLsizei(mIndices.size()), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(cache->vao);
+    glDrawElements(GL_TRIANGLES, GLsizei(cache->indexCount), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
-FragmentsSource& FragmentsSource::operator=(const FragmentsSource& rhs)
-{
-    if (this != &rhs)
-    {
-        mFragments = rhs.mFragments;
-    }
-
-    return (*this);
-}
 const std::vector<Fragment>& FragmentsSource::GetFragments() const noexcept
 {
     return mFragments;
@@ -1,6 +1,7 @@
 #include "ModelLoader.h"
 #include "materials/BlinnPhongMaterial.h"
 #include "filesystem.h"
+#include "framework/JobSystem.h"
 
 namespace
 {
@@ -63,36 +64,53 @@ void ModelLoader::loadModel(std::string const& path)
     std::cout << "Model::loadModel - Number of materials: " << scene->mNumMaterials << std::endl;
     std::cout << "Model::loadModel - Directory: " << mDirectory << std::endl;
 
-    // process ASSIMP's root node recursively
-    processNode(scene->mRootNode, scene);
+    // process ASSIMP's root node recursively, collecting the meshes in node order
+    std::vector<aiMesh*> meshes;
+    processNode(scene->mRootNode, scene, meshes);
+
+    // vertex / index extraction is plain CPU work, one mesh per job; creating the meshes and
+    // their materials stays on this thread, in the original order
+    std::vector<MeshData> meshData(meshes.size());
+    te::JobSystem::GetInstance().ParallelFor(meshes.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            extractMeshData(meshes[i], meshData[i]);
+        }
+    });
+
+    mMeshList.reserve(mMeshList.size() + meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        mMeshList.push_back(processMesh(meshes[i], scene, meshData[i]));
+    }
     
     std::cout << "Model::loadModel - Processed " << mMeshList.size() << " meshes" << std::endl;
 }
 
 // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
-void ModelLoader::processNode(aiNode* node, const aiScene* scene)
+void ModelLoader::processNode(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& outMeshes)
 {
     // process each mesh located at the current node
     for (unsigned int i = 0; i < node->mNumMeshes; i++)
     {
         // the node object only contains indices to index the actual objects in the scene. 
         // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        mMeshList.push_back(processMesh(mesh, scene));
+        outMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
     }
     // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
     for (unsigned int i = 0; i < node->mNumChildren; i++)
     {
-        processNode(node->mChildren[i], scene);
+        processNode(node->mChildren[i], scene, outMeshes);
     }
 }
 
-std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh* mesh, const aiScene* scene)
+void ModelLoader::extractMeshData(const aiMesh* mesh, MeshData& outData)
 {
     // data to fill
-    auto pMesh = std::make_shared<Mesh>();
-    std::vector<Vertex> vertices;
-    std::vector<int> indices;
+    std::vector<Vertex>& vertices = outData.vertices;
+    std::vector<int>& indices = outData.indices;
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve(size_t(mesh->mNumFaces) * 3);
 
     // walk through each of the mesh's vertices
     for (unsigned int i = 0; i < mesh->mNumVertices; i++)
@@ -142,13 +160,17 @@ std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh* mesh, const aiScene* scen
     // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
     for (unsigned int i = 0; i < mesh->mNumFaces; i++)
     {
-        aiFace face = mesh->mFaces[i];
+        const aiFace& face = mesh->mFaces[i];
         // retrieve all indices of the face and store them in the indices vector
         for (unsigned int j = 0; j < face.mNumIndices; j++)
             indices.push_back(face.mIndices[j]);
     }
+}
 
-    pMesh->DoGenerateMesh(vertices.data(), uint32_t(vertices.size()), indices.data(), uint32_t(indices.size()), true);
+std::shared_ptr<Mesh> ModelLoader::processMesh(aiMesh* mesh, const aiScene* scene, const MeshData& data)
+{
+    auto pMesh = std::make_shared<Mesh>();
+    pMesh->DoGenerateMesh(data.vertices.data(), uint32_t(data.vertices.size()), data.indices.data(), uint32_t(data.indices.size()), true);
 
     // process materials
     pMesh->SetMaterial(processMaterial(mesh, scene));
@@ -74,7 +74,9 @@ void RenderView::Resize(int width, int height)
 
 void RenderView::BindCamera(const std::shared_ptr<Subject>& camera)
 {
-	if (!camera)
+	// called every frame by the renderer; only the first bind registers, so a camera driven by
+	// another thread does not get its observer set modified under it
+	if (!camera || mwp_Camera.lock() == camera)
 	{
 		return;
 	}
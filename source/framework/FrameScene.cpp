@@ -0,0 +1,104 @@
+#include "framework/FrameScene.h"
+#include "framework/Renderer.h"
+#include "framework/RenderContext.h"
+#include "memory/LinearArena.h"
+#include "RenderView.h"
+#include "Camera.h"
+#include "Light.h"
+#include <algorithm>
+
+namespace te
+{
+    namespace
+    {
+        GeometryView CopyGeometry(LinearArena& arena, const GeometryView& view)
+        {
+            Vertex* vertices = arena.AllocateArray<Vertex>(view.vertices.size());
+            std::copy(view.vertices.begin(), view.vertices.end(), vertices);
+            unsigned int* indices = arena.AllocateArray<unsigned int>(view.indices.size());
+            std::copy(view.indices.begin(), view.indices.end(), indices);
+            return { { vertices, view.vertices.size() }, { indices, view.indices.size() }, view.layout, view.handle };
+        }
+    }
+
+    const FrameScene* BuildFrameScene(LinearArena& arena, uint64_t frameIndex, RenderContext& context,
+        const RenderView* renderView, std::vector<RenderCommand>& commands)
+    {
+        FrameScene* scene = arena.New<FrameScene>();
+        scene->frameIndex = frameIndex;
+
+        if (auto pCamera = context.GetAttachedCamera())
+        {
+            scene->view.view = pCamera->GetViewMatrix();
+            scene->view.projection = pCamera->GetProjectionMatrix();
+            scene->view.eye = pCamera->GetEye();
+            scene->view.nearPlane = pCamera->GetNearPlane();
+            scene->view.farPlane = pCamera->GetFarPlane();
+        }
+        if (renderView)
+        {
+            scene->view.viewportWidth = renderView->Width();
+            scene->view.viewportHeight = renderView->Height();
+        }
+
+        // only the default light is used by the passes so far
+        if (auto pLight = context.GetDefaultLight())
+        {
+            FrameLight* light = arena.New<FrameLight>();
+            light->position = pLight->GetPosition();
+            light->color = pLight->GetColor();
+            light->direction = pLight->GetDirection();
+            scene->lights = light;
+            scene->lightCount = 1;
+        }
+
+        // upper bound first so the draws are one contiguous array
+        size_t fragmentCount = 0;
+        for (const RenderCommand& command : commands)
+        {
+            if (command.fragmentsSource)
+                fragmentCount += command.fragmentsSource->GetFragments().size();
+        }
+
+        FrameDraw* draws = arena.AllocateArray<FrameDraw>(fragmentCount);
+        uint32_t drawCount = 0;
+
+        // the render thread uploads these instead of reading geometry the main thread may be editing
+        MeshRegistry& registry = MeshRegistry::GetInstance();
+        const bool stageUploads = registry.UsesStagedUploads();
+        GeometryView* uploads = stageUploads ? arena.AllocateArray<GeometryView>(fragmentCount) : nullptr;
+        uint32_t uploadCount = 0;
+        for (RenderCommand& command : commands)
+        {
+            command.sceneDraw = drawCount;
+            command.sceneDrawCount = 0;
+            if (!command.fragmentsSource)
+                continue;
+
+            MaterialBase* material = command.fragmentsSource->GetMaterial().get();
+            for (const Fragment& fragment : command.fragmentsSource->GetFragments())
+            {
+                if (!fragment.IsReady())
+                    continue;
+
+                FrameDraw& draw = draws[drawCount++];
+                draw.world = fragment.mpGeometry->GetWorldTransform();
+                draw.geometry = fragment.mpGeometry;
+                draw.mesh = fragment.mpGeometry->GetMeshHandle();
+                draw.contentKey = fragment.mpGeometry->GetContentKey();
+                draw.material = material;
+                ++command.sceneDrawCount;
+
+                if (stageUploads && !registry.IsResident(draw.mesh))
+                {
+                    uploads[uploadCount++] = CopyGeometry(arena, fragment.mpGeometry->GetView());
+                }
+            }
+        }
+        scene->draws = draws;
+        scene->drawCount = drawCount;
+        scene->uploads = uploads;
+        scene->uploadCount = uploadCount;
+        return scene;
+    }
+}
@@ -1,6 +1,36 @@
 #include "framework/FrameSync.h"
+#include <algorithm>
 #include <iostream>
 
+namespace
+{
+    // weight of the newest frame in the moving averages
+    constexpr double kAverageWeight = 0.1;
+
+    double Average(double average, double sample)
+    {
+        return average + (sample - average) * kAverageWeight;
+    }
+
+    double Milliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+void FrameSync::ThreadTiming::Record(Clock::time_point waitBegin, Clock::time_point waitEnd)
+{
+    if (started)
+    {
+        const double idle = Milliseconds(waitEnd - waitBegin);
+        const double frame = Milliseconds(waitEnd - lastWaitEnd);
+        idleMs = Average(idleMs, idle);
+        busyMs = Average(busyMs, std::max(0.0, frame - idle));
+    }
+    lastWaitEnd = waitEnd;
+    started = true;
+}
+
 void FrameSync::SignalFrameReady()
 {
     {
@@ -12,9 +42,11 @@ void FrameSync::SignalFrameReady()
 
 void FrameSync::WaitForFrameReady()
 {
+    const auto waitBegin = Clock::now();
     std::unique_lock<std::mutex> lock(mMutex);
     mFrameReadyCondition.wait(lock, [this] { return mFrameReady.load(); });
     mFrameReady = false;
+    mRenderTiming.Record(waitBegin, Clock::now());
 }
 
 void FrameSync::SignalRenderComplete()
@@ -28,9 +60,11 @@ void FrameSync::SignalRenderComplete()
 
 void FrameSync::WaitForRenderComplete()
 {
+    const auto waitBegin = Clock::now();
     std::unique_lock<std::mutex> lock(mMutex);
     mRenderCompleteCondition.wait(lock, [this] { return mRenderComplete.load(); });
     mRenderComplete = false;
+    mMainTiming.Record(waitBegin, Clock::now());
 }
 
 bool FrameSync::IsFrameReady() const
@@ -42,3 +76,122 @@ bool FrameSync::IsRenderComplete() const
 {
     return mRenderComplete.load();
 }
+
+void FrameSync::SetFramesInFlight(uint32_t count)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    count = std::clamp(count, 1u, 3u);
+    mSlots = std::vector<FrameSnapshot>(count == 1 ? 0 : count);
+    for (uint32_t i = 0; i < mSlots.size(); ++i)
+    {
+        mSlots[i].slot = i;
+    }
+    mAcquired = mSubmitted = mTaken = mCompleted = 0;
+}
+
+FrameSnapshot* FrameSync::AcquireFrame()
+{
+    const auto waitBegin = Clock::now();
+    std::unique_lock<std::mutex> lock(mMutex);
+    mRenderCompleteCondition.wait(lock, [this] {
+        if (mShutdown)
+            return true;
+        const uint64_t inFlight = mAcquired - mCompleted;
+        if (inFlight >= mSlots.size())
+            return false;
+        if (mLatencyBudgetMs > 0.0 && inFlight > 0)
+        {
+            // the oldest frame the render thread has not finished yet
+            const FrameSnapshot& oldest = mSlots[mCompleted % mSlots.size()];
+            if (Milliseconds(Clock::now() - oldest.submitTime) > mLatencyBudgetMs)
+                return false;
+        }
+        return true;
+    });
+    mMainTiming.Record(waitBegin, Clock::now());
+
+    if (mShutdown)
+    {
+        return nullptr;
+    }
+
+    FrameSnapshot* frame = &mSlots[mAcquired % mSlots.size()];
+    frame->frameIndex = mAcquired++;
+    frame->commandCount = 0;
+    frame->arena.Reset();
+    frame->scene = nullptr;
+    return frame;
+}
+
+void FrameSync::SubmitFrame(FrameSnapshot* frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        frame->submitTime = Clock::now();
+        ++mSubmitted;
+    }
+    mFrameReadyCondition.notify_one();
+}
+
+void FrameSync::WaitForIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mRenderCompleteCondition.wait(lock, [this] { return mShutdown || mCompleted == mSubmitted; });
+}
+
+FrameSnapshot* FrameSync::WaitForFrame()
+{
+    const auto waitBegin = Clock::now();
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFrameReadyCondition.wait(lock, [this] { return mShutdown || mTaken < mSubmitted; });
+    mRenderTiming.Record(waitBegin, Clock::now());
+
+    if (mShutdown)
+    {
+        return nullptr;
+    }
+    return &mSlots[mTaken++ % mSlots.size()];
+}
+
+void FrameSync::CompleteFrame(FrameSnapshot* frame, const FrameRenderStats& stats)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRenderStats = stats;
+        mLatencyMs = Average(mLatencyMs, Milliseconds(Clock::now() - frame->submitTime));
+        ++mCompleted;
+    }
+    // the main thread may wait in AcquireFrame or WaitForIdle
+    mRenderCompleteCondition.notify_all();
+}
+
+void FrameSync::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShutdown = true;
+        mFrameReady = true;
+        mRenderComplete = true;
+    }
+    mFrameReadyCondition.notify_all();
+    mRenderCompleteCondition.notify_all();
+}
+
+FramePipelineStats FrameSync::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    FramePipelineStats stats;
+    stats.mainBusyMs = mMainTiming.busyMs;
+    stats.mainIdleMs = mMainTiming.idleMs;
+    stats.renderBusyMs = mRenderTiming.busyMs;
+    stats.renderIdleMs = mRenderTiming.idleMs;
+    stats.latencyMs = IsPipelined() ? mLatencyMs : mRenderTiming.busyMs;
+    stats.framesInFlight = uint32_t(mAcquired - mCompleted);
+    return stats;
+}
+
+FrameRenderStats FrameSync::GetRenderStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mRenderStats;
+}
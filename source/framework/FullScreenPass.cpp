@@ -1,6 +1,7 @@
 #include "framework/FullScreenPass.h"
 #include "RenderView.h"
 #include "framework/FullscreenQuad.h"
+#include "mesh/MeshRegistry.h"
 
 namespace te
 {
@@ -58,43 +59,15 @@ namespace te
         auto currentFrag = mQuad->GetDefaultFragment();
         if (currentFrag.IsReady())
         {
-            auto vertices = currentFrag.mpGeometry->GetVertices();
-            auto indices = currentFrag.mpGeometry->GetIndices();
-
-            if (vertices.empty() || indices.empty())
-                return;
-
             // postprocess material should not transform vertices, so we use the identity matrix
-            // Create and bind VAO
-            GLuint VAO, VBO, EBO;
-            glGenVertexArrays(1, &VAO);
-            glGenBuffers(1, &VBO);
-            glGenBuffers(1, &EBO);
-
-            glBindVertexArray(VAO);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-            // Position attribute
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-            // Normal attribute
-            glEnableVertexAttribArray(1);
-            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-            // UV coordinate attribute
-            glEnableVertexAttribArray(2);
-            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
+            const MeshCache* cache = MeshRegistry::GetInstance().Acquire(*currentFrag.mpGeometry);
+            if (!cache)
+                return;
 
             // Draw
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-
-            // Cleanup
-            glDeleteVertexArrays(1, &VAO);
-            glDeleteBuffers(1, &VBO);
-            glDeleteBuffers(1, &EBO);
+            glBindVertexArray(cache->vao);
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cache->indexCount), GL_UNSIGNED_INT, 0);
+            glBindVertexArray(0);
             // Unbind input textures
 
             // Unbind FrameBuffer (only if we have outputs)
@@ -0,0 +1,55 @@
+#include "framework/InstanceBuffer.h"
+
+namespace te
+{
+    void InstanceBuffer::Upload(const std::vector<glm::mat4>& transforms)
+    {
+        if (mBuffer == 0)
+        {
+            glGenBuffers(1, &mBuffer);
+        }
+
+        if (transforms.size() > mCapacity)
+        {
+            // grow geometrically so steady-state frames keep the same storage size
+            mCapacity = transforms.size() > mCapacity * 2 ? transforms.size() : mCapacity * 2;
+        }
+
+        // orphan the previous storage so the driver does not stall on batches still in flight
+        glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+        glBufferData(GL_ARRAY_BUFFER, mCapacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, transforms.size() * sizeof(glm::mat4), transforms.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void InstanceBuffer::Attach() const
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            const GLuint location = kFirstAttribLocation + column;
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * column));
+            glVertexAttribDivisor(location, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void InstanceBuffer::Detach() const
+    {
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glDisableVertexAttribArray(kFirstAttribLocation + column);
+        }
+    }
+
+    void InstanceBuffer::Release()
+    {
+        if (mBuffer != 0)
+        {
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+        mCapacity = 0;
+    }
+}
@@ -0,0 +1,317 @@
+#include "framework/JobSystem.h"
+#include <iostream>
+
+namespace te
+{
+    namespace
+    {
+        // worker index of the current thread in tSystem, -1 on threads that are not workers
+        thread_local JobSystem* tSystem = nullptr;
+        thread_local int tWorker = -1;
+
+        // rounds without work before a worker goes to sleep
+        constexpr int kSpinRounds = 64;
+    }
+
+    bool WorkStealingDeque::Push(Job* job)
+    {
+        const int64_t bottom = mBottom.load(std::memory_order_relaxed);
+        const int64_t top = mTop.load(std::memory_order_acquire);
+        if (bottom - top >= int64_t(kCapacity))
+            return false;
+
+        mSlots[bottom & (kCapacity - 1)].store(job, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    Job* WorkStealingDeque::Pop()
+    {
+        const int64_t bottom = mBottom.load(std::memory_order_relaxed) - 1;
+        mBottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = mTop.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            // empty
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = mSlots[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // last job: race the thieves for it
+            if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            mBottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    Job* WorkStealingDeque::Steal()
+    {
+        int64_t top = mTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = mBottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+
+        Job* job = mSlots[top & (kCapacity - 1)].load(std::memory_order_relaxed);
+        if (!mTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    JobSystem& JobSystem::GetInstance()
+    {
+        static JobSystem instance;
+        return instance;
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Stop();
+    }
+
+    void JobSystem::Start(uint32_t workerCount)
+    {
+        if (!mWorkers.empty())
+            return;
+
+        if (workerCount == 0)
+        {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+        if (workerCount == 0)
+        {
+            std::cout << "[JobSystem] single hardware thread, jobs run inline" << std::endl;
+            return;
+        }
+
+        mRunning = true;
+        mWorkers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            mWorkers.push_back(std::make_unique<Worker>());
+        }
+        // all deques exist before any worker may steal from them
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            mWorkers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+        }
+        std::cout << "[JobSystem] " << workerCount << " workers" << std::endl;
+    }
+
+    void JobSystem::Stop()
+    {
+        if (mWorkers.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mRunning = false;
+        }
+        mWakeCondition.notify_all();
+        for (auto& worker : mWorkers)
+        {
+            worker->thread.join();
+        }
+
+        // finish what was still queued on this thread, nobody else touches the queues now
+        std::vector<std::unique_ptr<Worker>> workers = std::move(mWorkers);
+        mWorkers.clear();
+        {
+            std::lock_guard<std::mutex> lock(mSharedMutex);
+            for (auto& worker : workers)
+            {
+                while (Job* job = worker->deque.Pop())
+                {
+                    mShared.push_back(job);
+                }
+            }
+        }
+        for (Job* job = FindJob(); job; job = FindJob())
+        {
+            Execute(job);
+        }
+    }
+
+    void JobSystem::Run(std::function<void()> function, JobCounter* counter, const JobCounter* dependency)
+    {
+        if (mWorkers.empty())
+        {
+            // no workers: everything ran inline before, so `dependency` is done as well
+            function();
+            return;
+        }
+
+        if (counter)
+        {
+            counter->mPending.fetch_add(1, std::memory_order_relaxed);
+        }
+        Job* job = NewJob(std::move(function), counter);
+
+        if (dependency && !dependency->IsDone())
+        {
+            std::lock_guard<std::mutex> lock(dependency->mMutex);
+            // checked again under the lock, the last job of `dependency` takes the continuations with it
+            if (!dependency->IsDone())
+            {
+                dependency->mContinuations.push_back(job);
+                return;
+            }
+        }
+        Schedule(job);
+    }
+
+    void JobSystem::Wait(const JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            if (Job* job = FindJob())
+            {
+                Execute(job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // the job that brought the counter to zero may still hold its lock
+        std::lock_guard<std::mutex> lock(counter.mMutex);
+    }
+
+    void JobSystem::Schedule(Job* job)
+    {
+        ++mQueued;
+        if (tSystem != this || tWorker < 0 || !mWorkers[tWorker]->deque.Push(job))
+        {
+            std::lock_guard<std::mutex> lock(mSharedMutex);
+            mShared.push_back(job);
+        }
+
+        // a worker about to sleep counts itself in mSleeping before checking mQueued, so one of us sees the other
+        if (mSleeping.load() > 0)
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+            mWakeCondition.notify_one();
+        }
+    }
+
+    Job* JobSystem::FindJob()
+    {
+        const int self = tSystem == this ? tWorker : -1;
+        if (self >= 0)
+        {
+            if (Job* job = mWorkers[self]->deque.Pop())
+            {
+                --mQueued;
+                return job;
+            }
+        }
+
+        if (mQueued.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mSharedMutex);
+            if (!mShared.empty())
+            {
+                Job* job = mShared.front();
+                mShared.pop_front();
+                --mQueued;
+                return job;
+            }
+        }
+
+        // steal, starting after ourselves so the workers do not all hit the same victim
+        const size_t count = mWorkers.size();
+        const size_t first = self >= 0 ? size_t(self) + 1 : 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t victim = (first + i) % count;
+            if (int(victim) == self)
+                continue;
+            if (Job* job = mWorkers[victim]->deque.Steal())
+            {
+                --mQueued;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        job->function();
+
+        if (JobCounter* counter = job->counter)
+        {
+            std::vector<Job*> continuations;
+            {
+                std::lock_guard<std::mutex> lock(counter->mMutex);
+                if (counter->mPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    continuations.swap(counter->mContinuations);
+                }
+            }
+            // the counter may be gone from here on
+            for (Job* continuation : continuations)
+            {
+                Schedule(continuation);
+            }
+        }
+        DeleteJob(job);
+    }
+
+    Job* JobSystem::NewJob(std::function<void()> function, JobCounter* counter)
+    {
+        std::lock_guard<std::mutex> lock(mJobPoolMutex);
+        return mJobPool.New(Job{ std::move(function), counter });
+    }
+
+    void JobSystem::DeleteJob(Job* job)
+    {
+        // destroy the function (and what it captured) outside the lock
+        job->function = nullptr;
+        std::lock_guard<std::mutex> lock(mJobPoolMutex);
+        mJobPool.Delete(job);
+    }
+
+    void JobSystem::WorkerLoop(uint32_t index)
+    {
+        tSystem = this;
+        tWorker = int(index);
+
+        int idleRounds = 0;
+        while (mRunning.load(std::memory_order_relaxed))
+        {
+            if (Job* job = FindJob())
+            {
+                Execute(job);
+                idleRounds = 0;
+                continue;
+            }
+
+            if (++idleRounds < kSpinRounds)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            ++mSleeping;
+            mWakeCondition.wait(lock, [this] { return !mRunning || mQueued.load() > 0; });
+            --mSleeping;
+            idleRounds = 0;
+        }
+
+        tSystem = nullptr;
+        tWorker = -1;
+    }
+}
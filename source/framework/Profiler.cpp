@@ -0,0 +1,401 @@
+#include "framework/Profiler.h"
+#include "glad/glad.h"
+#include "GTVulkan/VK_Base.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+namespace te
+{
+    namespace
+    {
+        // weight of the newest sample in the per-pass moving averages
+        constexpr double kSmoothing = 0.1;
+        constexpr uint32_t kGpuTrackId = 0;
+        // llvmpipe reports a raw timestamp for a GL_TIME_ELAPSED query begun before the first draw
+        constexpr uint64_t kMaxPassGpuNs = 10'000'000'000ull;
+
+        thread_local void* tThreadBuffer = nullptr;
+
+        void WriteJsonString(std::ofstream& out, const char* text)
+        {
+            out << '"';
+            for (const char* c = text ? text : ""; *c; ++c)
+            {
+                switch (*c)
+                {
+                case '"': out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\n': out << "\\n"; break;
+                case '\t': out << "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20)
+                    {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                        out << escaped;
+                    }
+                    else
+                    {
+                        out << *c;
+                    }
+                }
+            }
+            out << '"';
+        }
+
+        // ring contents oldest first
+        template <typename Visit>
+        void ForEachInRing(const std::vector<ProfileEvent>& ring, uint64_t written, Visit&& visit)
+        {
+            const uint64_t count = std::min<uint64_t>(written, ring.size());
+            for (uint64_t i = written - count; i < written; ++i)
+            {
+                visit(ring[i % ring.size()]);
+            }
+        }
+    }
+
+    Profiler& Profiler::GetInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler::Profiler()
+        : mEpochNs(NowNs())
+    {
+        mGpuEvents.resize(kEventsPerThread);
+    }
+
+    uint64_t Profiler::NowNs()
+    {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const char* Profiler::Intern(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mNameMutex);
+        return mNames.insert(name).first->c_str();
+    }
+
+    Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+    {
+        if (!tThreadBuffer)
+        {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->events.resize(kEventsPerThread);
+            std::lock_guard<std::mutex> lock(mMutex);
+            buffer->id = uint32_t(mThreads.size()) + 1;
+            buffer->name = "Thread " + std::to_string(buffer->id);
+            tThreadBuffer = buffer.get();
+            mThreads.push_back(std::move(buffer));
+        }
+        return *static_cast<ThreadBuffer*>(tThreadBuffer);
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.name = name;
+    }
+
+    void Profiler::RecordCpu(const char* name, uint64_t startNs, uint64_t endNs)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events[buffer.written % buffer.events.size()] = { name, startNs, endNs };
+        ++buffer.written;
+    }
+
+    void Profiler::BeginFrame()
+    {
+        // the slot reused now was filled kGpuLatencyFrames frames ago
+        mSlot = (mSlot + 1) % kGpuLatencyFrames;
+        FrameSlot& slot = mSlots[mSlot];
+        ResolveSlot(slot);
+        slot.glPasses.clear();
+        slot.vkPasses.clear();
+        slot.glQueriesUsed = 0;
+        slot.vkReset = false;
+    }
+
+    void Profiler::ResolveSlot(FrameSlot& slot)
+    {
+        if (!slot.glPasses.empty() && glad_glGetQueryObjectui64v)
+        {
+            for (const GpuPassRecord& record : slot.glPasses)
+            {
+                GLint available = 0;
+                glGetQueryObjectiv(record.query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                    continue;
+                GLuint64 elapsedNs = 0;
+                glGetQueryObjectui64v(record.query, GL_QUERY_RESULT, &elapsedNs);
+                if (elapsedNs > kMaxPassGpuNs)
+                    continue;
+                AddGpuEvent(record.name, record.cpuStartNs, elapsedNs);
+            }
+        }
+
+        if (!slot.vkPasses.empty() && mVkQueryPool)
+        {
+            for (const GpuPassRecord& record : slot.vkPasses)
+            {
+                // { begin, available, end, available }
+                uint64_t results[4] = {};
+                vkGetQueryPoolResults(mVkDevice, mVkQueryPool, record.query, 2, sizeof(results), results,
+                    2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+                if (!results[1] || !results[3])
+                    continue;
+                const uint64_t ticks = (results[2] - results[0]) & mTimestampMask;
+                AddGpuEvent(record.name, record.cpuStartNs, uint64_t(double(ticks) * mTimestampPeriodNs));
+            }
+        }
+    }
+
+    void Profiler::AddGpuEvent(const char* name, uint64_t cpuStartNs, uint64_t durationNs)
+    {
+        {
+            // without a shared clock, GPU work starts no earlier than its recording and after the previous pass
+            std::lock_guard<std::mutex> lock(mMutex);
+            const uint64_t startNs = std::max(cpuStartNs, mGpuTrackEndNs);
+            mGpuTrackEndNs = startNs + durationNs;
+            mGpuEvents[mGpuEventsWritten % mGpuEvents.size()] = { name, startNs, mGpuTrackEndNs };
+            ++mGpuEventsWritten;
+        }
+        UpdatePassTiming(name, double(durationNs) * 1e-6, true);
+    }
+
+    void Profiler::UpdatePassTiming(const char* name, double ms, bool gpu)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto [it, inserted] = mPassIndices.try_emplace(name, mPassTimings.size());
+        if (inserted)
+        {
+            mPassTimings.push_back({ name });
+        }
+        PassTiming& timing = mPassTimings[it->second];
+        if (gpu)
+        {
+            timing.gpuMs = timing.hasGpu ? timing.gpuMs + (ms - timing.gpuMs) * kSmoothing : ms;
+            timing.hasGpu = true;
+        }
+        else
+        {
+            timing.cpuMs = inserted ? ms : timing.cpuMs + (ms - timing.cpuMs) * kSmoothing;
+        }
+    }
+
+    void Profiler::BeginPass(const std::string& name)
+    {
+        if (!IsEnabled() || mOpenPass.name)
+            return;
+
+        mOpenPass.name = Intern(name);
+        mOpenPass.gpu = false;
+
+        // GL_TIME_ELAPSED queries cannot nest, so a pass is only timed when none is running
+        if (glad_glGenQueries)
+        {
+            FrameSlot& slot = mSlots[mSlot];
+            if (slot.glQueriesUsed == slot.glQueries.size())
+            {
+                GLuint query = 0;
+                glGenQueries(1, &query);
+                slot.glQueries.push_back(query);
+            }
+            const GLuint query = slot.glQueries[slot.glQueriesUsed++];
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            mOpenPass.gpu = true;
+            mOpenPass.startNs = NowNs();
+            slot.glPasses.push_back({ mOpenPass.name, mOpenPass.startNs, query });
+            return;
+        }
+        mOpenPass.startNs = NowNs();
+    }
+
+    void Profiler::EndPass()
+    {
+        if (!mOpenPass.name)
+            return;
+
+        const uint64_t endNs = NowNs();
+        if (mOpenPass.gpu)
+        {
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        RecordCpu(mOpenPass.name, mOpenPass.startNs, endNs);
+        UpdatePassTiming(mOpenPass.name, double(endNs - mOpenPass.startNs) * 1e-6, false);
+        mOpenPass = {};
+    }
+
+    bool Profiler::EnsureVulkanQueryPool()
+    {
+        if (mVkQueryPool)
+            return true;
+        if (mVkUnsupported)
+            return false;
+
+        const auto& base = vk::GraphicsBase::Base();
+        mVkDevice = base.Device();
+        if (!mVkDevice)
+            return false;
+
+        // timestamps need a graphics queue with valid bits
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(base.PhysicalDevice(), &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(base.PhysicalDevice(), &familyCount, families.data());
+        const uint32_t family = base.QueueFamilyIndex_Graphics();
+        const uint32_t validBits = family < familyCount ? families[family].timestampValidBits : 0;
+        if (validBits == 0)
+        {
+            std::cout << "Profiler: graphics queue has no timestamp support, Vulkan passes are CPU timed only" << std::endl;
+            mVkUnsupported = true;
+            return false;
+        }
+        mTimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        mTimestampPeriodNs = double(base.PhysicalDeviceProperties().limits.timestampPeriod);
+
+        VkQueryPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = kGpuLatencyFrames * kMaxVulkanPasses * 2;
+        if (vkCreateQueryPool(mVkDevice, &createInfo, nullptr, &mVkQueryPool) != VK_SUCCESS)
+        {
+            std::cout << "Profiler: failed to create the timestamp query pool" << std::endl;
+            mVkQueryPool = VK_NULL_HANDLE;
+            mVkUnsupported = true;
+            return false;
+        }
+        return true;
+    }
+
+    void Profiler::ResetVulkanQueries(VkCommandBuffer commandBuffer)
+    {
+        if (!IsEnabled() || !commandBuffer || !EnsureVulkanQueryPool())
+            return;
+
+        FrameSlot& slot = mSlots[mSlot];
+        vkCmdResetQueryPool(commandBuffer, mVkQueryPool, mSlot * kMaxVulkanPasses * 2, kMaxVulkanPasses * 2);
+        slot.vkReset = true;
+    }
+
+    void Profiler::BeginVulkanPass(VkCommandBuffer commandBuffer, const std::string& name)
+    {
+        if (!IsEnabled() || mOpenVulkanPass.name)
+            return;
+
+        mOpenVulkanPass.name = Intern(name);
+        mOpenVulkanPass.startNs = NowNs();
+        mOpenVulkanPass.gpu = false;
+
+        FrameSlot& slot = mSlots[mSlot];
+        if (slot.vkReset && slot.vkPasses.size() < kMaxVulkanPasses)
+        {
+            const uint32_t query = (mSlot * kMaxVulkanPasses + uint32_t(slot.vkPasses.size())) * 2;
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, mVkQueryPool, query);
+            slot.vkPasses.push_back({ mOpenVulkanPass.name, mOpenVulkanPass.startNs, query });
+            mOpenVulkanPass.gpu = true;
+        }
+    }
+
+    void Profiler::EndVulkanPass(VkCommandBuffer commandBuffer)
+    {
+        if (!mOpenVulkanPass.name)
+            return;
+
+        if (mOpenVulkanPass.gpu)
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, mVkQueryPool,
+                mSlots[mSlot].vkPasses.back().query + 1);
+        }
+        // CPU side of a Vulkan pass is its command recording
+        const uint64_t endNs = NowNs();
+        RecordCpu(mOpenVulkanPass.name, mOpenVulkanPass.startNs, endNs);
+        UpdatePassTiming(mOpenVulkanPass.name, double(endNs - mOpenVulkanPass.startNs) * 1e-6, false);
+        mOpenVulkanPass = {};
+    }
+
+    void Profiler::ReleaseGpuResources()
+    {
+        for (FrameSlot& slot : mSlots)
+        {
+            if (!slot.glQueries.empty() && glad_glDeleteQueries)
+            {
+                glDeleteQueries(GLsizei(slot.glQueries.size()), slot.glQueries.data());
+            }
+            slot = {};
+        }
+        if (mVkQueryPool)
+        {
+            vkDestroyQueryPool(mVkDevice, mVkQueryPool, nullptr);
+            mVkQueryPool = VK_NULL_HANDLE;
+        }
+        mVkDevice = VK_NULL_HANDLE;
+        mVkUnsupported = false;
+        mOpenPass = {};
+        mOpenVulkanPass = {};
+    }
+
+    std::vector<PassTiming> Profiler::GetPassTimings() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPassTimings;
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& filename) const
+    {
+        std::ofstream out(filename);
+        if (!out.is_open())
+        {
+            std::cout << "Profiler: failed to open " << filename << std::endl;
+            return false;
+        }
+
+        size_t eventCount = 0;
+        bool first = true;
+        auto writeEvent = [&](const ProfileEvent& event, uint32_t tid) {
+            if (!event.name || event.startNs < mEpochNs)
+                return;
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            WriteJsonString(out, event.name);
+            out << ",\"cat\":\"" << (tid == kGpuTrackId ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << double(event.startNs - mEpochNs) * 1e-3
+                << ",\"dur\":" << double(event.endNs - event.startNs) * 1e-3 << "}";
+            first = false;
+            ++eventCount;
+        };
+        auto writeThreadName = [&](uint32_t tid, const char* name) {
+            out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+                << ",\"args\":{\"name\":";
+            WriteJsonString(out, name);
+            out << "}}";
+            first = false;
+        };
+
+        out.precision(3);
+        out << std::fixed << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            writeThreadName(kGpuTrackId, "GPU");
+            ForEachInRing(mGpuEvents, mGpuEventsWritten, [&](const ProfileEvent& event) { writeEvent(event, kGpuTrackId); });
+
+            for (const auto& buffer : mThreads)
+            {
+                std::lock_guard<std::mutex> bufferLock(buffer->mutex);
+                writeThreadName(buffer->id, buffer->name.c_str());
+                ForEachInRing(buffer->events, buffer->written, [&](const ProfileEvent& event) { writeEvent(event, buffer->id); });
+            }
+        }
+        out << "\n]}\n";
+
+        std::cout << "Profiler: wrote " << eventCount << " events to " << filename << std::endl;
+        return out.good();
+    }
+}
@@ -1,68 +1,130 @@
 #include "framework/RenderCommandQueue.h"
-#include <iostream>
+#include <algorithm>
+#include <bit>
 
-void RenderCommandQueue::PushCommand(const RenderCommand& command)
+RenderCommandQueue::RenderCommandQueue(size_t capacity)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    mCommands.push(command);
-    mCondition.notify_one();
+    Reserve(capacity);
 }
 
-void RenderCommandQueue::PushCommands(const std::vector<RenderCommand>& commands)
+bool RenderCommandQueue::PushCommand(const RenderCommand& command)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    for (const auto& cmd : commands)
+    RenderCommand copy = command;
+    return PushCommand(std::move(copy));
+}
+
+bool RenderCommandQueue::PushCommand(RenderCommand&& command)
+{
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead == mSlots.size())
+    {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        if (tail - mCachedHead == mSlots.size())
+        {
+            return false;
+        }
+    }
+
+    mSlots[tail & mMask] = std::move(command);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+size_t RenderCommandQueue::PushCommands(std::vector<RenderCommand>& commands, size_t first)
+{
+    if (first >= commands.size())
+    {
+        return 0;
+    }
+
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    const size_t wanted = commands.size() - first;
+    if (mSlots.size() - (tail - mCachedHead) < wanted)
+    {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+    }
+
+    const size_t count = std::min(wanted, mSlots.size() - (tail - mCachedHead));
+    for (size_t i = 0; i < count; ++i)
     {
-        mCommands.push(cmd);
+        mSlots[(tail + i) & mMask] = std::move(commands[first + i]);
     }
-    mCondition.notify_one();
+
+    // one release publishes the whole batch
+    mTail.store(tail + count, std::memory_order_release);
+    return count;
 }
 
 std::optional<RenderCommand> RenderCommandQueue::PopCommand()
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    if (mCommands.empty())
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mCachedTail)
     {
-        return std::nullopt;
+        mCachedTail = mTail.load(std::memory_order_acquire);
+        if (head == mCachedTail)
+        {
+            return std::nullopt;
+        }
     }
-    
-    RenderCommand cmd = mCommands.front();
-    mCommands.pop();
-    return cmd;
+
+    RenderCommand command = std::move(mSlots[head & mMask]);
+    mHead.store(head + 1, std::memory_order_release);
+    return command;
 }
 
-std::optional<RenderCommand> RenderCommandQueue::WaitAndPopCommand()
+size_t RenderCommandQueue::DrainCommands(std::vector<RenderCommand>& out, size_t maxCount)
 {
-    std::unique_lock<std::mutex> lock(mMutex);
-    mCondition.wait(lock, [this] { return !mCommands.empty(); });
-    
-    if (mCommands.empty())
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    mCachedTail = mTail.load(std::memory_order_acquire);
+
+    const size_t count = std::min(maxCount, mCachedTail - head);
+    out.reserve(out.size() + count);
+    for (size_t i = 0; i < count; ++i)
     {
-        return std::nullopt;
+        out.push_back(std::move(mSlots[(head + i) & mMask]));
     }
-    
-    RenderCommand cmd = mCommands.front();
-    mCommands.pop();
-    return cmd;
+
+    mHead.store(head + count, std::memory_order_release);
+    return count;
 }
 
 void RenderCommandQueue::Clear()
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    while (!mCommands.empty())
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    mCachedTail = mTail.load(std::memory_order_acquire);
+    for (size_t i = head; i != mCachedTail; ++i)
     {
-        mCommands.pop();
+        // drop the FragmentsSource references now rather than when the slot is reused
+        mSlots[i & mMask] = RenderCommand();
     }
+    mHead.store(mCachedTail, std::memory_order_release);
 }
 
-size_t RenderCommandQueue::Size() const
+bool RenderCommandQueue::Reserve(size_t capacity)
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    return mCommands.size();
+    capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+    if (capacity <= mSlots.size())
+    {
+        return true;
+    }
+    if (Size() != 0)
+    {
+        return false;
+    }
+
+    mSlots.clear();
+    mSlots.resize(capacity);
+    mMask = capacity - 1;
+    mTail.store(0, std::memory_order_relaxed);
+    mHead.store(0, std::memory_order_relaxed);
+    mCachedHead = 0;
+    mCachedTail = 0;
+    return true;
 }
 
-bool RenderCommandQueue::Empty() const
+size_t RenderCommandQueue::Size() const
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    return mCommands.empty();
+    const size_t head = mHead.load(std::memory_order_acquire);
+    const size_t tail = mTail.load(std::memory_order_acquire);
+    return tail - head;
 }
@@ -1,6 +1,7 @@
 #include "framework/RenderContext.h"
 #include "Light.h"
 #include "Camera.h"
+#include "framework/FrameScene.h"
 
 RenderContext::RenderContext()
 {
@@ -44,3 +45,56 @@ std::shared_ptr<Light> RenderContext::GetDefaultLight()
 
 	return mpAttachLights[0];
 }
+
+void RenderContext::SetFrameScene(const te::FrameScene* scene)
+{
+	mpFrameScene = scene;
+}
+
+const te::FrameView* RenderContext::GetRenderView()
+{
+	if (mpFrameScene)
+	{
+		return &mpFrameScene->view;
+	}
+
+	auto pCamera = GetAttachedCamera();
+	if (!pCamera)
+	{
+		return nullptr;
+	}
+
+	if (!mpLiveView)
+	{
+		mpLiveView = std::make_unique<te::FrameView>();
+	}
+	mpLiveView->view = pCamera->GetViewMatrix();
+	mpLiveView->projection = pCamera->GetProjectionMatrix();
+	mpLiveView->eye = pCamera->GetEye();
+	mpLiveView->nearPlane = pCamera->GetNearPlane();
+	mpLiveView->farPlane = pCamera->GetFarPlane();
+	return mpLiveView.get();
+}
+
+const te::FrameLight* RenderContext::GetRenderLight()
+{
+	if (mpFrameScene)
+	{
+		return mpFrameScene->lightCount > 0 ? &mpFrameScene->lights[0] : nullptr;
+	}
+
+	auto pLight = GetDefaultLight();
+	if (!pLight)
+	{
+		return nullptr;
+	}
+
+	if (!mpLiveLight)
+	{
+		mpLiveLight = std::make_unique<te::FrameLight>();
+	}
+	mpLiveLight->position = pLight->GetPosition();
+	mpLiveLight->color = pLight->GetColor();
+	mpLiveLight->direction = pLight->GetDirection();
+	return mpLiveLight.get();
+}
@@ -1,5 +1,6 @@
 #include "framework/RenderGraph.h"
 #include "framework/RenderPass.h"
+#include "framework/Profiler.h"
 #include "glad/glad.h"
 #include <iostream>
 #include <algorithm>
@@ -29,6 +30,7 @@ namespace te
         PassNode node;
         node.name = name;
         node.pass = pass;
+        node.hasSideEffects = pass->GetConfig().sideEffects;
         
         // Get dependencies from RenderPass configuration
         const auto& config = pass->GetConfig();
@@ -141,7 +143,12 @@ namespace te
 
     std::unique_ptr<CompiledGraph> RenderGraphBuilder::Compile()
     {
-        return RenderGraphCompiler::Compile(mPasses, mResources);
+        return RenderGraphCompiler::Compile(mPasses, mResources, mAliasingMode);
+    }
+
+    uint64_t RenderGraphBuilder::ComputeStructureHash() const
+    {
+        return RenderGraphCompiler::HashStructure(mPasses, mResources);
     }
 
     void RenderGraphBuilder::Clear()
@@ -157,10 +164,23 @@ namespace te
 
     std::unique_ptr<CompiledGraph> RenderGraphCompiler::Compile(
         const std::vector<PassNode>& passes,
-        const std::unordered_map<std::string, ResourceDesc>& resources)
+        const std::unordered_map<std::string, ResourceDesc>& resources,
+        ResourceAliasingMode aliasingMode)
     {
         auto compiledGraph = std::make_unique<CompiledGraph>();
         compiledGraph->resources = resources;
+        compiledGraph->structureHash = HashStructure(passes, resources);
+
+        // resources by index, sorted by name so indices do not depend on the hash order
+        for (const auto& [name, desc] : resources)
+        {
+            compiledGraph->resourceNames.push_back(name);
+        }
+        std::sort(compiledGraph->resourceNames.begin(), compiledGraph->resourceNames.end());
+        for (uint32_t i = 0; i < compiledGraph->resourceNames.size(); ++i)
+        {
+            compiledGraph->resourceIndices[compiledGraph->resourceNames[i]] = i;
+        }
 
         // build dependency graph
         std::vector<std::vector<size_t>> adjacencyList(passes.size());
@@ -200,27 +220,237 @@ namespace te
             }
         }
 
+        // lifetimes, aliasing, sync points and the schedule of the enabled passes
+        compiledGraph->aliasingReport.mode = aliasingMode;
+        CompileResources(*compiledGraph);
+
+        return compiledGraph;
+    }
+
+    namespace
+    {
+        constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+
+        uint64_t HashBytes(const void* data, size_t size, uint64_t hash)
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        uint64_t HashString(const std::string& text, uint64_t hash)
+        {
+            const uint64_t length = text.size();
+            hash = HashBytes(&length, sizeof(length), hash);
+            return HashBytes(text.data(), text.size(), hash);
+        }
+
+        template <typename T>
+        uint64_t HashValue(const T& value, uint64_t hash)
+        {
+            return HashBytes(&value, sizeof(value), hash);
+        }
+    }
+
+    uint64_t RenderGraphCompiler::HashStructure(
+        const std::vector<PassNode>& passes,
+        const std::unordered_map<std::string, ResourceDesc>& resources)
+    {
+        uint64_t hash = HashValue(uint64_t(passes.size()), kFnvOffset);
+        for (const auto& pass : passes)
+        {
+            hash = HashString(pass.name, hash);
+            // the attached object too: a pass replaced under the same name must not reuse the
+            // executor, whose nodes would keep running (and owning) the old one. The compiled
+            // graph holds the old pass, so its address cannot be reused while that graph lives
+            hash = HashValue(pass.pass.get(), hash);
+            hash = HashValue(pass.hasSideEffects, hash);
+            hash = HashValue(uint64_t(pass.dependencies.size()), hash);
+            for (const auto& dependency : pass.dependencies)
+            {
+                hash = HashString(dependency, hash);
+            }
+            for (const auto* usages : { &pass.reads, &pass.writes })
+            {
+                hash = HashValue(uint64_t(usages->size()), hash);
+                for (const auto& usage : *usages)
+                {
+                    hash = HashString(usage.resourceName, hash);
+                    hash = HashValue(usage.access, hash);
+                }
+            }
+        }
+
+        // sizes are left out, a resize is patched
+        std::vector<const ResourceDesc*> descs;
+        for (const auto& [name, desc] : resources)
+        {
+            descs.push_back(&desc);
+        }
+        std::sort(descs.begin(), descs.end(), [](const ResourceDesc* a, const ResourceDesc* b) {
+            return a->name < b->name;
+        });
+        for (const ResourceDesc* desc : descs)
+        {
+            hash = HashString(desc->name, hash);
+            hash = HashValue(desc->format, hash);
+            hash = HashValue(desc->allowAliasing, hash);
+        }
+        return hash;
+    }
+
+    void RenderGraphCompiler::CompileResources(CompiledGraph& graph)
+    {
+        // passes is already in execution order; the enabled ones whose results are consumed run
+        std::vector<bool> enabled(graph.passes.size());
+        for (size_t i = 0; i < graph.passes.size(); ++i)
+        {
+            const auto& pass = graph.passes[i].pass;
+            enabled[i] = !pass || pass->ShouldExecute();
+        }
+        const std::vector<bool> culled = CullPasses(graph, enabled);
+
+        graph.activeOrder.clear();
+        for (size_t i = 0; i < graph.passes.size(); ++i)
+        {
+            if (enabled[i] && !culled[i])
+            {
+                graph.activeOrder.push_back(i);
+            }
+        }
+
         // analyze resource lifetimes
-        AnalyzeResourceLifetimes(compiledGraph->passes, 
-                                 compiledGraph->executionOrder,
-                                 compiledGraph->lifetimes);
+        graph.lifetimes.clear();
+        AnalyzeResourceLifetimes(graph.passes, graph.activeOrder, graph.lifetimes);
 
         // analyze resource aliasing
-        AnalyzeResourceAliasing(resources, 
-                                compiledGraph->lifetimes,
-                                compiledGraph->aliases);
+        const ResourceAliasingMode aliasingMode = graph.aliasingReport.mode;
+        graph.aliases.clear();
+        graph.physicalResources.clear();
+        AnalyzeResourceAliasing(graph.resources, graph.lifetimes, aliasingMode,
+                                graph.aliases, graph.physicalResources);
+        graph.aliasingReport = BuildAliasingReport(graph.resources, graph.lifetimes,
+                                                   graph.physicalResources, aliasingMode);
 
         // generate resource allocations
-        compiledGraph->allocations = GenerateResourceAllocations(
-            compiledGraph->lifetimes,
-            compiledGraph->aliases);
+        graph.allocations = GenerateResourceAllocations(graph.lifetimes, graph.aliases);
 
         // generate sync points
-        compiledGraph->syncPoints = GenerateSyncPoints(
-            compiledGraph->passes,
-            compiledGraph->executionOrder);
+        graph.syncPoints = GenerateSyncPoints(graph.passes, graph.activeOrder);
 
-        return compiledGraph;
+        BuildSchedule(graph, enabled, culled);
+    }
+
+    std::vector<bool> RenderGraphCompiler::CullPasses(const CompiledGraph& graph, const std::vector<bool>& enabled)
+    {
+        // walking back in execution order every consumer is seen before its producers
+        std::unordered_set<std::string> neededResources;
+        std::unordered_set<std::string> neededPasses;
+
+        std::vector<bool> culled(graph.passes.size(), false);
+        for (size_t i = graph.passes.size(); i-- > 0;)
+        {
+            if (!enabled[i])
+                continue;
+
+            const PassNode& pass = graph.passes[i];
+            bool live = pass.hasSideEffects || pass.writes.empty() || neededPasses.count(pass.name) > 0;
+            for (size_t w = 0; w < pass.writes.size() && !live; ++w)
+            {
+                live = neededResources.count(pass.writes[w].resourceName) > 0;
+            }
+
+            if (!live)
+            {
+                culled[i] = true;
+                continue;
+            }
+            for (const auto& read : pass.reads)
+            {
+                neededResources.insert(read.resourceName);
+            }
+            for (const auto& dependency : pass.dependencies)
+            {
+                neededPasses.insert(dependency);
+            }
+        }
+        return culled;
+    }
+
+    void RenderGraphCompiler::BuildSchedule(CompiledGraph& graph, const std::vector<bool>& enabled, const std::vector<bool>& culled)
+    {
+        graph.schedule.assign(graph.passes.size(), PassSchedule());
+        for (size_t i = 0; i < graph.passes.size(); ++i)
+        {
+            graph.schedule[i].enabled = enabled[i];
+            graph.schedule[i].culled = culled[i];
+        }
+        graph.resourcePhysical.assign(graph.resourceNames.size(), UINT32_MAX);
+
+        // a physical resource is held from the first use of its first resource to the last use of its last
+        for (uint32_t physicalIndex = 0; physicalIndex < graph.physicalResources.size(); ++physicalIndex)
+        {
+            PhysicalResource& physical = graph.physicalResources[physicalIndex];
+            const ResourceDesc& desc = graph.resources.at(physical.name);
+            physical.key.format = desc.format;
+            physical.key.width = desc.width;
+            physical.key.height = desc.height;
+
+            size_t firstUse = SIZE_MAX;
+            size_t lastUse = 0;
+            physical.resourceIndices.clear();
+            for (const auto& name : physical.resources)
+            {
+                const uint32_t resource = graph.resourceIndices.at(name);
+                physical.resourceIndices.push_back(resource);
+                graph.resourcePhysical[resource] = physicalIndex;
+
+                const ResourceLifetime& lifetime = graph.lifetimes.at(name);
+                firstUse = std::min(firstUse, lifetime.firstUse);
+                lastUse = std::max(lastUse, lifetime.lastUse);
+            }
+            graph.schedule[graph.activeOrder[firstUse]].acquire.push_back(physicalIndex);
+            graph.schedule[graph.activeOrder[lastUse]].release.push_back(physicalIndex);
+        }
+
+        // inputs bound from declared resources
+        for (size_t passIndex : graph.activeOrder)
+        {
+            PassSchedule& schedule = graph.schedule[passIndex];
+            schedule.active = true;
+
+            const auto& pass = graph.passes[passIndex].pass;
+            if (!pass)
+                continue;
+            const auto& inputs = pass->GetConfig().inputs;
+            for (uint32_t input = 0; input < inputs.size(); ++input)
+            {
+                auto it = graph.resourceIndices.find(inputs[input].sourceTarget);
+                if (it != graph.resourceIndices.end())
+                {
+                    schedule.inputs.emplace_back(input, it->second);
+                }
+            }
+        }
+
+        for (uint32_t syncIndex = 0; syncIndex < graph.syncPoints.size(); ++syncIndex)
+        {
+            SyncPoint& sync = graph.syncPoints[syncIndex];
+            sync.resourceIndices.clear();
+            for (const auto& name : sync.resources)
+            {
+                auto it = graph.resourceIndices.find(name);
+                if (it != graph.resourceIndices.end())
+                {
+                    sync.resourceIndices.push_back(it->second);
+                }
+            }
+            graph.schedule[sync.passIndex].syncPoints.push_back(syncIndex);
+        }
     }
 
     void RenderGraphCompiler::BuildDependencyGraph(
@@ -371,63 +601,163 @@ namespace te
         }
     }
 
+    uint64_t RenderGraphCompiler::GetResourceBytes(const ResourceDesc& desc)
+    {
+        TransientResourceKey key;
+        key.format = desc.format;
+        key.width = desc.width;
+        key.height = desc.height;
+        return TransientResourcePool::EstimateBytes(key);
+    }
+
     void RenderGraphCompiler::AnalyzeResourceAliasing(
         const std::unordered_map<std::string, ResourceDesc>& resources,
         const std::unordered_map<std::string, ResourceLifetime>& lifetimes,
-        std::unordered_map<std::string, std::string>& aliases)
+        ResourceAliasingMode mode,
+        std::unordered_map<std::string, std::string>& aliases,
+        std::vector<PhysicalResource>& physicalResources)
     {
-        // group resources by format and size
-        std::map<std::tuple<RenderTargetFormat, uint32_t, uint32_t>, 
-                 std::vector<std::string>> resourceGroups;
-        
+        struct Candidate
+        {
+            const std::string* name;
+            const ResourceDesc* desc;
+            ResourceLifetime lifetime;
+            uint64_t bytes;
+        };
+
+        // declared resources the graph uses, by first use; ties larger first, then by name,
+        // so the result does not depend on the hash order
+        std::vector<Candidate> candidates;
         for (const auto& [name, desc] : resources)
         {
-            if (!desc.allowAliasing)
-                continue;
-                
             auto it = lifetimes.find(name);
-            if (it == lifetimes.end())
+            if (it == lifetimes.end() || it->second.firstUse == SIZE_MAX)
                 continue;
-                
-            auto key = std::make_tuple(desc.format, desc.width, desc.height);
-            resourceGroups[key].push_back(name);
+            candidates.push_back({ &name, &desc, it->second, GetResourceBytes(desc) });
         }
-        
-        // for each group of resources, check if they can be aliased
-        for (auto& [key, resourceNames] : resourceGroups)
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            if (a.lifetime.firstUse != b.lifetime.firstUse)
+                return a.lifetime.firstUse < b.lifetime.firstUse;
+            if (a.bytes != b.bytes)
+                return a.bytes > b.bytes;
+            return *a.name < *b.name;
+        });
+
+        // interval partitioning: walking the lifetimes by start, a physical resource is reused once
+        // the lifetime of its last user ended, a new one is added only when none is free. Within a
+        // group of interchangeable resources this needs as many as the most lifetimes overlapping.
+        struct Slot
         {
-            if (resourceNames.size() < 2) continue;
-            
-            // check if lifetimes overlap
-            for (size_t i = 0; i < resourceNames.size(); ++i)
+            size_t physical;
+            size_t lastUse;
+            const ResourceDesc* desc;  // of the first user, what Exact compares against
+            bool aliasable;
+        };
+        std::vector<Slot> slots;
+
+        auto isCompatible = [mode](const Slot& slot, const Candidate& candidate)
+        {
+            switch (mode)
+            {
+            case ResourceAliasingMode::Exact:
+                return slot.desc->format == candidate.desc->format &&
+                       slot.desc->width == candidate.desc->width &&
+                       slot.desc->height == candidate.desc->height;
+            case ResourceAliasingMode::ByteSize:
+                return true;
+            default:
+                return false;
+            }
+        };
+
+        for (const Candidate& candidate : candidates)
+        {
+            Slot* best = nullptr;
+            if (candidate.desc->allowAliasing)
             {
-                for (size_t j = i + 1; j < resourceNames.size(); ++j)
+                for (Slot& slot : slots)
                 {
-                    const std::string& name1 = resourceNames[i];
-                    const std::string& name2 = resourceNames[j];
-                    
-                    auto it1 = lifetimes.find(name1);
-                    auto it2 = lifetimes.find(name2);
-                    
-                    if (it1 == lifetimes.end() || it2 == lifetimes.end())
+                    if (!slot.aliasable || slot.lastUse >= candidate.lifetime.firstUse || !isCompatible(slot, candidate))
                         continue;
-                    
-                    const auto& lifetime1 = it1->second;
-                    const auto& lifetime2 = it2->second;
-                    
-                    // if lifetimes do not overlap, can be aliased
-                    if (lifetime1.lastUse < lifetime2.firstUse || 
-                        lifetime2.lastUse < lifetime1.firstUse)
+                    if (!best)
                     {
-                        // alias name2 to name1
-                        if (aliases.find(name2) == aliases.end())
-                        {
-                            aliases[name2] = name1;
-                        }
+                        best = &slot;
+                        continue;
                     }
+
+                    // best fit: the smallest allocation holding the candidate, else the largest (grows least)
+                    const uint64_t slotBytes = physicalResources[slot.physical].bytes;
+                    const uint64_t bestBytes = physicalResources[best->physical].bytes;
+                    const bool slotFits = slotBytes >= candidate.bytes;
+                    const bool bestFits = bestBytes >= candidate.bytes;
+                    if (slotFits != bestFits ? slotFits : (slotFits ? slotBytes < bestBytes : slotBytes > bestBytes))
+                    {
+                        best = &slot;
+                    }
+                }
+            }
+
+            if (best)
+            {
+                PhysicalResource& physical = physicalResources[best->physical];
+                physical.bytes = std::max(physical.bytes, candidate.bytes);
+                physical.resources.push_back(*candidate.name);
+                aliases[*candidate.name] = physical.name;
+                best->lastUse = candidate.lifetime.lastUse;
+                continue;
+            }
+
+            PhysicalResource physical;
+            physical.name = *candidate.name;
+            physical.bytes = candidate.bytes;
+            physical.resources.push_back(*candidate.name);
+            physicalResources.push_back(std::move(physical));
+            slots.push_back({ physicalResources.size() - 1, candidate.lifetime.lastUse, candidate.desc,
+                              candidate.desc->allowAliasing });
+        }
+    }
+
+    AliasingReport RenderGraphCompiler::BuildAliasingReport(
+        const std::unordered_map<std::string, ResourceDesc>& resources,
+        const std::unordered_map<std::string, ResourceLifetime>& lifetimes,
+        const std::vector<PhysicalResource>& physicalResources,
+        ResourceAliasingMode mode)
+    {
+        AliasingReport report;
+        report.mode = mode;
+        report.physicalCount = physicalResources.size();
+
+        size_t passCount = 0;
+        for (const auto& physical : physicalResources)
+        {
+            report.resourceCount += physical.resources.size();
+            report.aliasedBytes += physical.bytes;
+            for (const auto& name : physical.resources)
+            {
+                report.unaliasedBytes += GetResourceBytes(resources.at(name));
+                passCount = std::max(passCount, lifetimes.at(name).lastUse + 1);
+            }
+        }
+
+        // bytes live in each pass
+        std::vector<uint64_t> liveBytes(passCount, 0);
+        for (const auto& physical : physicalResources)
+        {
+            for (const auto& name : physical.resources)
+            {
+                const ResourceLifetime& lifetime = lifetimes.at(name);
+                const uint64_t bytes = GetResourceBytes(resources.at(name));
+                for (size_t pass = lifetime.firstUse; pass <= lifetime.lastUse; ++pass)
+                {
+                    liveBytes[pass] += bytes;
                 }
             }
         }
+        for (uint64_t bytes : liveBytes)
+        {
+            report.peakLiveBytes = std::max(report.peakLiveBytes, bytes);
+        }
+        return report;
     }
 
     std::vector<SyncPoint> RenderGraphCompiler::GenerateSyncPoints(
@@ -454,7 +784,7 @@ namespace te
             const auto& pass = passes[passIdx];
             
             SyncPoint sync;
-            sync.passIndex = orderIdx;
+            sync.passIndex = passIdx;
             
             // check if read resources need state transition
             for (const auto& read : pass.reads)
@@ -492,6 +822,9 @@ namespace te
         
         for (const auto& [name, lifetime] : lifetimes)
         {
+            if (lifetime.firstUse == SIZE_MAX)
+                continue;  // only used by disabled passes
+
             ResourceAllocation allocation;
             allocation.resourceName = name;
             
@@ -519,8 +852,10 @@ namespace te
     // RenderGraphExecutor Implementation
     // ============================================================================
 
-    RenderGraphExecutor::RenderGraphExecutor(std::unique_ptr<CompiledGraph> compiledGraph)
+    RenderGraphExecutor::RenderGraphExecutor(std::unique_ptr<CompiledGraph> compiledGraph,
+                                             std::shared_ptr<TransientResourcePool> resourcePool)
         : mCompiledGraph(std::move(compiledGraph))
+        , mResourcePool(resourcePool ? std::move(resourcePool) : std::make_shared<TransientResourcePool>())
     {
         if (!mCompiledGraph)
         {
@@ -528,11 +863,7 @@ namespace te
             return;
         }
 
-        // initialize resource states
-        for (const auto& [name, desc] : mCompiledGraph->resources)
-        {
-            mResourceStates[name] = desc.initialState;
-        }
+        ResetResources();
     }
 
     RenderGraphExecutor::~RenderGraphExecutor()
@@ -548,234 +879,191 @@ namespace te
             return;
         }
 
-        // track resource creation/destruction for each Pass
-        std::unordered_map<std::string, bool> resourceCreated;
-        
-        for (size_t i = 0; i < mCompiledGraph->executionOrder.size(); ++i)
+        mResourcePool->BeginFrame();
+
+        // passes are in execution order; everything below is precomputed indices
+        const CompiledGraph& graph = *mCompiledGraph;
+        for (size_t i = 0; i < graph.passes.size(); ++i)
         {
-            size_t passIdx = mCompiledGraph->executionOrder[i];
-            const auto& pass = mCompiledGraph->passes[passIdx];
+            const PassSchedule& schedule = graph.schedule[i];
+            if (!schedule.active)
+                continue;
+            const auto& pass = graph.passes[i];
             
             // create required resources
-            for (const auto& read : pass.reads)
-            {
-                if (!resourceCreated[read.resourceName])
-                {
-                    auto it = mCompiledGraph->resources.find(read.resourceName);
-                    if (it != mCompiledGraph->resources.end())
-                    {
-                        CreateResource(read.resourceName, it->second);
-                        resourceCreated[read.resourceName] = true;
-                    }
-                }
-            }
-            for (const auto& write : pass.writes)
+            for (uint32_t physical : schedule.acquire)
             {
-                if (!resourceCreated[write.resourceName])
-                {
-                    auto it = mCompiledGraph->resources.find(write.resourceName);
-                    if (it != mCompiledGraph->resources.end())
-                    {
-                        CreateResource(write.resourceName, it->second);
-                        resourceCreated[write.resourceName] = true;
-                    }
-                }
+                AcquirePhysical(physical);
             }
             
             // insert sync points
-            for (const auto& sync : mCompiledGraph->syncPoints)
+            for (uint32_t sync : schedule.syncPoints)
             {
-                if (sync.passIndex == i)
-                {
-                    InsertSyncPoint(sync);
-                }
+                InsertSyncPoint(graph.syncPoints[sync]);
             }
             
-            // set Pass's input resources
+            // set Pass's input resources, then prepare it
             if (pass.pass)
             {
-                for (const auto& read : pass.reads)
+                const auto& inputs = pass.pass->GetConfig().inputs;
+                for (const auto& [input, resource] : schedule.inputs)
                 {
-                    GLuint handle = GetResourceHandle(read.resourceName);
-                    if (handle != 0)
+                    GLuint handle = mResourceHandles[resource];
+                    if (handle != 0 && input < inputs.size())
                     {
-                        // find corresponding input name in configuration
-                        const auto& config = pass.pass->GetConfig();
-                        for (const auto& input : config.inputs)
-                        {
-                            if (input.sourceTarget == read.resourceName)
-                            {
-                                pass.pass->SetInput(input.name, handle);
-                                break;
-                            }
-                        }
+                        pass.pass->SetInput(inputs[input].name, handle);
                     }
                 }
-            }
-            
-            // prepare Pass
-            if (pass.pass)
-            {
                 pass.pass->Prepare();
             }
             
             // execute Pass
             if (pass.executeFunc)
             {
+                ProfilePassScope profile(pass.name);
                 pass.executeFunc(commands);
             }
             
-            // destroy resources that are no longer needed
-            for (const auto& allocation : mCompiledGraph->allocations)
+            // give back resources that are no longer needed
+            for (uint32_t physical : schedule.release)
             {
-                if (allocation.destroyPassIndex == i + 1)
-                {
-                    DestroyResource(allocation.resourceName);
-                    resourceCreated[allocation.resourceName] = false;
-                }
+                ReleasePhysical(physical);
             }
         }
     }
 
-    GLuint RenderGraphExecutor::GetResourceHandle(const std::string& resourceName) const
+    bool RenderGraphExecutor::SyncPassStates()
     {
-        // check if there is an alias
-        auto aliasIt = mCompiledGraph->aliases.find(resourceName);
-        std::string actualName = (aliasIt != mCompiledGraph->aliases.end()) 
-                                ? aliasIt->second 
-                                : resourceName;
-        
-        auto it = mResourceHandles.find(actualName);
-        return (it != mResourceHandles.end()) ? it->second : 0;
+        if (!mCompiledGraph)
+            return false;
+
+        bool changed = false;
+        for (size_t i = 0; i < mCompiledGraph->passes.size() && !changed; ++i)
+        {
+            const auto& pass = mCompiledGraph->passes[i].pass;
+            const bool enabled = !pass || pass->ShouldExecute();
+            changed = enabled != mCompiledGraph->schedule[i].enabled;
+        }
+        if (!changed)
+            return false;
+
+        // the pass order stands, culling, lifetimes and aliasing follow the enabled passes
+        Clear();
+        RenderGraphCompiler::CompileResources(*mCompiledGraph);
+        ResetResources();
+        return true;
     }
 
-    void RenderGraphExecutor::CreateResource(const std::string& name, const ResourceDesc& desc)
+    bool RenderGraphExecutor::ResizeResources(uint32_t width, uint32_t height)
     {
-        // check if there is an alias resource
-        auto aliasIt = mCompiledGraph->aliases.find(name);
-        std::string actualName = (aliasIt != mCompiledGraph->aliases.end()) 
-                                ? aliasIt->second 
-                                : name;
-        
-        // if alias resource exists, use it
-        if (aliasIt != mCompiledGraph->aliases.end())
+        if (!mCompiledGraph)
+            return false;
+
+        bool changed = false;
+        for (auto& [name, desc] : mCompiledGraph->resources)
         {
-            auto it = mResources.find(actualName);
-            if (it != mResources.end())
+            if (desc.width != width || desc.height != height)
             {
-                mResourceHandles[name] = it->second->GetTextureHandle();
-                mResourceStates[name] = desc.initialState;
-                return;
+                desc.width = width;
+                desc.height = height;
+                changed = true;
             }
         }
-        
-        // create new resource
-        RenderTargetDesc targetDesc;
-        targetDesc.name = actualName;
-        targetDesc.width = desc.width;
-        targetDesc.height = desc.height;
-        targetDesc.format = desc.format;
-        
-        // determine type based on format
-        switch (desc.format)
-        {
-        case RenderTargetFormat::Depth24:
-        case RenderTargetFormat::Depth32F:
-            targetDesc.type = RenderTargetType::Depth;
-            break;
-        case RenderTargetFormat::Depth24Stencil8:
-            targetDesc.type = RenderTargetType::ColorDepthStencil;
-            break;
-        default:
-            targetDesc.type = RenderTargetType::Color;
-            break;
-        }
-        
-        auto renderTarget = std::make_shared<RenderTarget>();
-        if (renderTarget->Initialize(targetDesc))
-        {
-            mResources[actualName] = renderTarget;
-            mResourceHandles[name] = renderTarget->GetTextureHandle();
-            mResourceStates[name] = desc.initialState;
-        }
-        else
+        if (!changed)
+            return false;
+
+        // the pool hands out targets of the new size, the old ones are trimmed once idle
+        Clear();
+        RenderGraphCompiler::CompileResources(*mCompiledGraph);
+        ResetResources();
+        return true;
+    }
+
+    GLuint RenderGraphExecutor::GetResourceHandle(const std::string& resourceName) const
+    {
+        if (!mCompiledGraph)
+            return 0;
+        auto it = mCompiledGraph->resourceIndices.find(resourceName);
+        return (it != mCompiledGraph->resourceIndices.end()) ? mResourceHandles[it->second] : 0;
+    }
+
+    void RenderGraphExecutor::ResetResources()
+    {
+        const CompiledGraph& graph = *mCompiledGraph;
+        mPhysicalTargets.assign(graph.physicalResources.size(), nullptr);
+        mResourceHandles.assign(graph.resourceNames.size(), 0);
+        mResourceStates.resize(graph.resourceNames.size());
+        for (size_t i = 0; i < graph.resourceNames.size(); ++i)
         {
-            std::cout << "RenderGraphExecutor::CreateResource: Failed to create resource " << name << std::endl;
+            mResourceStates[i] = graph.resources.at(graph.resourceNames[i]).initialState;
         }
     }
 
-    void RenderGraphExecutor::DestroyResource(const std::string& name)
+    void RenderGraphExecutor::AcquirePhysical(uint32_t physical)
     {
-        // check if there is an alias
-        auto aliasIt = mCompiledGraph->aliases.find(name);
-        std::string actualName = (aliasIt != mCompiledGraph->aliases.end()) 
-                                ? aliasIt->second 
-                                : name;
-        
-        // if resource is aliased, do not destroy (managed by main resource)
-        if (aliasIt != mCompiledGraph->aliases.end())
+        if (mPhysicalTargets[physical])
+            return;
+
+        // take a target of the same format and size from the pool, created only on a miss
+        const PhysicalResource& resource = mCompiledGraph->physicalResources[physical];
+        auto renderTarget = mResourcePool->Acquire(resource.name, resource.key);
+        if (!renderTarget)
         {
-            mResourceHandles.erase(name);
+            std::cout << "RenderGraphExecutor::AcquirePhysical: Failed to create resource " << resource.name << std::endl;
             return;
         }
-        
-        // check if there are other resources using this actual resource
-        bool stillInUse = false;
-        for (const auto& [aliasName, actual] : mCompiledGraph->aliases)
+
+        // every resource aliasing it sees the same texture
+        mPhysicalTargets[physical] = renderTarget;
+        for (uint32_t index : resource.resourceIndices)
         {
-            if (actual == actualName && aliasName != name)
-            {
-                stillInUse = true;
-                break;
-            }
+            mResourceHandles[index] = renderTarget->GetTextureHandle();
+            mResourceStates[index] = mCompiledGraph->resources.at(mCompiledGraph->resourceNames[index]).initialState;
         }
-        
-        if (!stillInUse)
+    }
+
+    void RenderGraphExecutor::ReleasePhysical(uint32_t physical)
+    {
+        auto& target = mPhysicalTargets[physical];
+        if (!target)
+            return;
+
+        // back to the pool, later passes and frames reuse it
+        mResourcePool->Release(target);
+        target.reset();
+        for (uint32_t index : mCompiledGraph->physicalResources[physical].resourceIndices)
         {
-            auto it = mResources.find(actualName);
-            if (it != mResources.end())
-            {
-                it->second->Shutdown();
-                mResources.erase(it);
-            }
+            mResourceHandles[index] = 0;
         }
-        
-        mResourceHandles.erase(name);
-        mResourceStates.erase(name);
     }
 
     void RenderGraphExecutor::InsertSyncPoint(const SyncPoint& sync)
     {
         // in OpenGL, synchronization is mainly through glFinish or glMemoryBarrier
         // here simplified, in actual application, more precise synchronization may be needed
-        for (const auto& resourceName : sync.resources)
+        for (uint32_t resource : sync.resourceIndices)
         {
-            TransitionResource(resourceName, sync.fromState, sync.toState);
+            TransitionResource(resource, sync.fromState, sync.toState);
         }
         
         // insert memory barrier (if needed)
         glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
     }
 
-    void RenderGraphExecutor::TransitionResource(const std::string& name, 
-                                                  ResourceState from, ResourceState to)
+    void RenderGraphExecutor::TransitionResource(uint32_t resource, ResourceState from, ResourceState to)
     {
         // in OpenGL, resource state transition is mainly conceptual
         // actual state transition is handled automatically when binding resources
         // here mainly update internal state tracking
-        mResourceStates[name] = to;
+        mResourceStates[resource] = to;
     }
 
     void RenderGraphExecutor::Clear()
     {
-        // destroy all resources
-        for (auto& [name, target] : mResources)
+        // the pool keeps the targets for the next frame / executor
+        for (uint32_t physical = 0; physical < mPhysicalTargets.size(); ++physical)
         {
-            target->Shutdown();
+            ReleasePhysical(physical);
         }
-        
-        mResources.clear();
-        mResourceHandles.clear();
-        mResourceStates.clear();
     }
 }
@@ -49,12 +49,30 @@ namespace te
         GenerateDependencyEdges(graph, oss);
         GenerateResourceEdges(graph, oss);
         GenerateAliasEdges(graph, oss);
+
+        // transient memory before / after aliasing
+        const AliasingReport& report = graph.aliasingReport;
+        const double toMB = 1.0 / (1024.0 * 1024.0);
+        oss << std::fixed << std::setprecision(1);
+        oss << "    labelloc=b;\n";
+        oss << "    label=\"" << report.resourceCount << " resources in " << report.physicalCount << " targets: "
+            << report.unaliasedBytes * toMB << " MB unaliased, " << report.aliasedBytes * toMB << " MB aliased, peak live "
+            << report.peakLiveBytes * toMB << " MB\";\n";
         
         GenerateGraphFooter(oss);
         
         return oss.str();
     }
 
+    void RenderGraphVisualizer::SetPassTimings(const std::vector<PassTiming>& timings)
+    {
+        mPassTimings.clear();
+        for (const auto& timing : timings)
+        {
+            mPassTimings[timing.name] = timing;
+        }
+    }
+
     void RenderGraphVisualizer::GenerateGraphHeader(std::ostringstream& oss)
     {
         oss << "digraph RenderGraph {\n";
@@ -110,15 +128,35 @@ namespace te
                 }
             }
             
+            // measured cost, if the profiler timed this pass
+            auto timing = mPassTimings.find(pass.name);
+            if (timing != mPassTimings.end())
+            {
+                label << std::fixed << std::setprecision(2) << "\\nCPU " << timing->second.cpuMs << " ms";
+                if (timing->second.hasGpu)
+                {
+                    label << " / GPU " << timing->second.gpuMs << " ms";
+                }
+            }
+
             // Get color based on pass type
             std::string color = "\"#ADD8E6\"";  // lightblue
             if (pass.pass)
             {
                 color = GetPassTypeColor(pass.pass->GetConfig().type);
             }
+
+            // passes that did not run at the last compile / patch are greyed out
+            std::string style = "\"rounded,filled\"";
+            if (i < graph.schedule.size() && !graph.schedule[i].active)
+            {
+                label << (graph.schedule[i].culled ? "\\n[Culled]" : "\\n[Disabled]");
+                color = "\"#D3D3D3\"";
+                style = "\"rounded,filled,dashed\"";
+            }
             
             oss << "        " << nodeName << " [label=\"" << label.str() 
-                << "\", fillcolor=" << color << ", style=\"rounded,filled\"];\n";
+                << "\", fillcolor=" << color << ", style=" << style << "];\n";
         }
     }
 
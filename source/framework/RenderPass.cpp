@@ -10,8 +10,13 @@
 #include "materials/SkyboxMaterial.h"
 #include "framework/RenderPassManager.h"
 #include "framework/FullscreenQuad.h"
+#include "mesh/MeshRegistry.h"
+#include "shader/FrameUniforms.h"
 #include <iostream>
 #include "framework/RenderContext.h"
+#include "framework/JobSystem.h"
+#include "memory/StlAllocators.h"
+#include <algorithm>
 
 namespace te
 {
@@ -99,6 +104,7 @@ namespace te
         
         mInputTextures.clear();
         mOutputTargets.clear();
+        mInstanceBuffer.Release();
     }
 
     bool RenderPass::CheckDependencies(const std::vector<std::shared_ptr<RenderPass>>& allPasses) const
@@ -129,6 +135,22 @@ namespace te
         return true;
     }
 
+    bool RenderPass::ShouldExecute() const
+    {
+        if (mConfig.state == RenderPassState::Disabled)
+            return false;
+
+        if (mConfig.state == RenderPassState::Conditional && mConfig.condition && !mConfig.condition())
+            return false;
+
+        for (const auto& dep : mConfig.dependencies)
+        {
+            if (dep.required && dep.condition && !dep.condition())
+                return false;
+        }
+        return true;
+    }
+
     void RenderPass::SetInput(const std::string& name, GLuint textureHandle)
     {
         mInputTextures[name] = textureHandle;
@@ -310,12 +332,12 @@ namespace te
             glBindTexture(GL_TEXTURE_2D, 0);
         }
 
-        for (const auto& command : mCandidateCommands)
+        for (const RenderCommand* command : mCandidateCommands)
         {
-            if (!command.fragmentsSource)
+            if (!command->fragmentsSource)
                 continue;
             
-            auto pMaterial = command.fragmentsSource->GetMaterial();
+            auto pMaterial = command->fragmentsSource->GetMaterial();
             if (pMaterial)
             {
                 pMaterial->UnBind();
@@ -325,21 +347,114 @@ namespace te
 
     void RenderPass::ApplyRenderCommand(const std::vector<RenderCommand>& commands)
     {
-        mCandidateCommands.clear();
+        // pointers into `commands` (alive until the frame's passes ran) in this frame's memory;
+        // the previous list lives in the previous frame's arena and is simply dropped
+        mCandidateCommands = MakeFrameVector<const RenderCommand*>();
         
         std::cout << "ApplyRenderCommand for " << mConfig.name << " (flag: " << static_cast<int>(mRenderPassFlag) << ")" << std::endl;
 
-        for (auto cmd: commands)
+        // large frames are filtered in chunks on the job system, then compacted in the original order
+        // (no per-command logging, it would serialize the workers on std::cout)
+        constexpr size_t kFilterGrain = 4096;
+        if (commands.size() <= kFilterGrain || !JobSystem::GetInstance().IsRunning())
+        {
+            mCandidateCommands.reserve(commands.size());
+            for (const auto& cmd : commands)
+            {
+                if (cmd.renderpassflag & mRenderPassFlag)
+                {
+                    mCandidateCommands.push_back(&cmd);
+                }
+            }
+        }
+        else
         {
-            std::cout << "  Command flag: " << static_cast<int>(cmd.renderpassflag) << ", match: " << (cmd.renderpassflag & mRenderPassFlag) << std::endl;
-            if (cmd.renderpassflag & mRenderPassFlag)
+            // each chunk writes its matches at the start of its own range, the arena is only used here
+            const size_t chunkCount = (commands.size() + kFilterGrain - 1) / kFilterGrain;
+            mCandidateCommands.resize(commands.size());
+            FrameVector<size_t> matchCounts = MakeFrameVector<size_t>();
+            matchCounts.resize(chunkCount);
+            JobSystem::GetInstance().ParallelFor(chunkCount, 1, [&](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; ++chunk)
+                {
+                    const size_t begin = chunk * kFilterGrain;
+                    const size_t end = std::min(commands.size(), begin + kFilterGrain);
+                    size_t matches = 0;
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        if (commands[i].renderpassflag & mRenderPassFlag)
+                        {
+                            mCandidateCommands[begin + matches++] = &commands[i];
+                        }
+                    }
+                    matchCounts[chunk] = matches;
+                }
+            });
+
+            size_t total = 0;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
             {
-                mCandidateCommands.emplace_back(cmd);
-                std::cout << "  Added command to " << mConfig.name << std::endl;
+                const size_t begin = chunk * kFilterGrain;
+                if (begin != total)
+                {
+                    std::copy_n(mCandidateCommands.begin() + begin, matchCounts[chunk], mCandidateCommands.begin() + total);
+                }
+                total += matchCounts[chunk];
             }
+            mCandidateCommands.resize(total);
         }
         
         std::cout << "  Total candidate commands for " << mConfig.name << ": " << mCandidateCommands.size() << std::endl;
+
+        // pack and sort the draws so consecutive ones share program / material / mesh
+        glm::mat4 view(1.0f);
+        const FrameScene* pScene = nullptr;
+        if (mpRenderContext)
+        {
+            if (const FrameView* pView = mpRenderContext->GetRenderView())
+            {
+                view = pView->view;
+            }
+            pScene = mpRenderContext->GetFrameScene();
+        }
+        mRenderQueue.Build(mCandidateCommands, uint8_t(mConfig.type), view, mpOverMaterial.get(), mSortBySourceMaterial, pScene);
+        mRenderQueue.Sort();
+        mStateTracker.Reset();
+        mPassStats.Reset();
+    }
+
+    void RenderPass::DrawQueueBatch(size_t begin, size_t end, const MeshCache& cache, Shader& shader)
+    {
+        const auto& items = mRenderQueue.GetItems();
+        const size_t count = end - begin;
+
+        mStateTracker.BindVertexArray(cache.vao);
+        if (count >= InstanceBuffer::kMinBatchSize)
+        {
+            mRenderQueue.GatherTransforms(begin, end, mInstanceTransforms);
+            mInstanceBuffer.Upload(mInstanceTransforms);
+            mInstanceBuffer.Attach();
+
+            shader.setBool(uniform::Instanced, true);
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(cache.indexCount), GL_UNSIGNED_INT, 0, static_cast<GLsizei>(count));
+            shader.setBool(uniform::Instanced, false);
+
+            mInstanceBuffer.Detach();
+            ++mPassStats.drawCalls;
+        }
+        else
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                shader.setMat4(uniform::Model, mRenderQueue.GetWorld(items[i]));
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cache.indexCount), GL_UNSIGNED_INT, 0);
+                ++mPassStats.drawCalls;
+            }
+        }
+
+        mPassStats.instances += uint32_t(count);
+        mPassStats.triangles += uint32_t(count * (cache.indexCount / 3));
+        mPassStats.vertices += uint32_t(count * cache.vertexCount);
     }
 
     // GeometryPass Implementation
@@ -405,40 +520,32 @@ namespace te
         }
 
         auto pGeometryMat = std::dynamic_pointer_cast<te::GeometryMaterial>(mpOverMaterial);
-        // Render all geometry to G-Buffer
-        for (const auto& command : mCandidateCommands)
+        if (mpRenderContext)
         {
-            if (!command.fragmentsSource)
-                continue;
-
-            // Process all fragments from the fragmentsSource
-            const auto& fragments = command.fragmentsSource->GetFragments();
-            for (const auto& frag : fragments)
-            {
-                if (!frag.IsReady())
-                    continue;
-
-                auto vertices = frag.mpGeometry->GetVertices();
-                auto indices = frag.mpGeometry->GetIndices();
-                auto transform = frag.mpGeometry->GetWorldTransform();
+            FrameUniformBuffer::GetInstance().UpdateFromContext(*mpRenderContext);
+        }
 
-                if (vertices.empty() || indices.empty())
-                    continue;
+        // Render all geometry to G-Buffer in sort-key order, runs of the same mesh + material are instanced
+        const auto& items = mRenderQueue.GetItems();
+        for (size_t begin = 0, end = 0; begin < items.size(); begin = end)
+        {
+            end = mRenderQueue.NextBatch(begin);
+            const RenderQueueItem& item = items[begin];
 
-                // Get material from fragmentsSource (shared_ptr) or use fragment's material pointer
-                auto pMaterial = command.fragmentsSource->GetMaterial();
-                if (!pMaterial)
-                    continue;
+            // Use geometry material, camera matrices come from the FrameData block
+            mStateTracker.BindProgram(pGeometryMat.get());
 
-                // Get texture information from original material and set to geometry material
-                if (auto blinnPhongMaterial = std::dynamic_pointer_cast<BlinnPhongMaterial>(pMaterial))
+            // Get texture information from original material and set to geometry material
+            if (mStateTracker.BindMaterial(item.material))
+            {
+                if (auto blinnPhongMaterial = dynamic_cast<BlinnPhongMaterial*>(item.material))
                 {
                     if (auto texture = blinnPhongMaterial->GetDiffuseTexture())
                     {
                         pGeometryMat->SetDiffuseTexture(texture);
                     }
                 }
-                else if (auto pbrMaterial = std::dynamic_pointer_cast<PBRMaterial>(pMaterial))
+                else if (auto pbrMaterial = dynamic_cast<PBRMaterial*>(item.material))
                 {
                     // For PBR materials, use albedo texture as diffuse texture for geometry pass
                     if (auto texture = pbrMaterial->GetAlbedoTexture())
@@ -451,61 +558,22 @@ namespace te
                         pGeometryMat->SetObjectColor(pbrMaterial->GetAlbedo());
                     }
                 }
-                
-                // Use geometry material
-                pGeometryMat->OnApply();
-                
-                // Set transformation matrix
-                pGeometryMat->GetShader()->setMat4("model", transform);
-                
-                // Set camera matrices
-                if (auto pCamera = mpRenderContext->GetAttachedCamera())
-                {
-                    pGeometryMat->GetShader()->setMat4("view", pCamera->GetViewMatrix());
-                    pGeometryMat->GetShader()->setMat4("projection", pCamera->GetProjectionMatrix());
-                }
-                
+
                 // Update material uniforms
                 pGeometryMat->UpdateUniform();
 
                 // Bind material resources
                 pGeometryMat->OnBind();
+            }
 
-                // Create and bind VAO
-                GLuint VAO, VBO, EBO;
-                glGenVertexArrays(1, &VAO);
-                glGenBuffers(1, &VBO);
-                glGenBuffers(1, &EBO);
-
-                glBindVertexArray(VAO);
-                glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-                // Position attribute
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-                // Normal attribute
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-                // UV coordinate attribute
-                if (command.hasUV)
-                {
-                    glEnableVertexAttribArray(2);
-                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-                }
-
-                // Draw
-                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+            // Persistent VAO from the mesh registry, shared by the whole run
+            const MeshCache* cache = MeshRegistry::GetInstance().Acquire(*item.geometry);
+            if (!cache)
+                continue;
 
-                // Cleanup
-                glDeleteVertexArrays(1, &VAO);
-                glDeleteBuffers(1, &VBO);
-                glDeleteBuffers(1, &EBO);
-            }
+            DrawQueueBatch(begin, end, *cache, *pGeometryMat->GetShader());
         }
+        glBindVertexArray(0);
 
         // Unbind FrameBuffer
         mFrameBuffer->Unbind();
@@ -632,31 +700,35 @@ namespace te
         }
         const bool shadowAvailable = shadowMapTexture != 0;
 
-        // Render all geometry
-        for (const auto& command : mCandidateCommands)
+        // camera, light and light-space matrix are shared by every program through FrameData
+        auto& frameUniforms = FrameUniformBuffer::GetInstance();
+        frameUniforms.SetLightSpaceMatrix(lightSpaceMatrix);
+        if (mpRenderContext)
         {
-            if (!command.fragmentsSource)
-                continue;
-
-            // Process all fragments from the fragmentsSource
-            const auto& fragments = command.fragmentsSource->GetFragments();
-            for (const auto& frag : fragments)
-            {
-                if (!frag.IsReady())
-                    continue;
-
-                auto vertices = frag.mpGeometry->GetVertices();
-                auto indices = frag.mpGeometry->GetIndices();
-                auto transform = frag.mpGeometry->GetWorldTransform();
+            frameUniforms.UpdateFromContext(*mpRenderContext);
+        }
+        else
+        {
+            frameUniforms.Upload();
+        }
 
-                if (vertices.empty() || indices.empty())
-                    continue;
+        // Render all geometry in sort-key order, material setup only runs when the material changes
+        // and runs of the same mesh + material are instanced
+        MaterialBase* pBoundMaterial = nullptr;
+        const auto& items = mRenderQueue.GetItems();
+        for (size_t begin = 0, end = 0; begin < items.size(); begin = end)
+        {
+            end = mRenderQueue.NextBatch(begin);
+            const RenderQueueItem& item = items[begin];
+            MaterialBase* pMaterial = item.material;
 
-                // Get material from fragmentsSource (shared_ptr) or use fragment's material pointer
-                // Try to get shared_ptr from fragmentsSource first
-                auto pMaterial = command.fragmentsSource->GetMaterial();
-                if (!pMaterial)
-                    continue;
+            if (mStateTracker.BindMaterial(pMaterial))
+            {
+                if (pBoundMaterial)
+                {
+                    pBoundMaterial->UnBind();
+                }
+                pBoundMaterial = pMaterial;
 
                 if (FindDependency("GeometryPass"))
                 {
@@ -669,74 +741,38 @@ namespace te
                     pMaterial->AttachedLight(pLight);
                 }
 
-                if (auto pbrMaterial = std::dynamic_pointer_cast<PBRMaterial>(pMaterial))
+                if (auto pbrMaterial = dynamic_cast<PBRMaterial*>(pMaterial))
                 {
                     pbrMaterial->SetShadowEnabled(shadowAvailable);
-                    pbrMaterial->SetLightSpaceMatrix(lightSpaceMatrix);
                     pbrMaterial->SetShadowMap(shadowMapTexture);
                 }
-                else if (auto phongMaterial = std::dynamic_pointer_cast<PhongMaterial>(pMaterial))
+                else if (auto phongMaterial = dynamic_cast<PhongMaterial*>(pMaterial))
                 {
                     phongMaterial->SetShadowEnabled(shadowAvailable);
-                    phongMaterial->SetLightSpaceMatrix(lightSpaceMatrix);
                     phongMaterial->SetShadowMap(shadowMapTexture);
                 }
 
-                pMaterial->OnApply();
-
-                // Set transformation matrix
-                pMaterial->GetShader()->setMat4("model", transform);
-
-                // Set camera matrices
-                if (auto pCamera = mpRenderContext->GetAttachedCamera())
-                {
-                    pMaterial->GetShader()->setMat4("view", pCamera->GetViewMatrix());
-                    pMaterial->GetShader()->setMat4("projection", pCamera->GetProjectionMatrix());
-                }
+                mStateTracker.BindProgram(pMaterial);
 
                 // Bind material resources first
                 pMaterial->OnBind();
 
                 // Update material uniforms
                 pMaterial->UpdateUniform();
+            }
 
-                // Create and bind VAO
-                GLuint VAO, VBO, EBO;
-                glGenVertexArrays(1, &VAO);
-                glGenBuffers(1, &VBO);
-                glGenBuffers(1, &EBO);
-
-                glBindVertexArray(VAO);
-                glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-                // Position attribute
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-                // Normal attribute
-                glEnableVertexAttribArray(1);
-                glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-                // UV coordinate attribute
-                if (command.hasUV)
-                {
-                    glEnableVertexAttribArray(2);
-                    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-                }
-
-                // Draw
-                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
-
-                // Cleanup
-                glDeleteVertexArrays(1, &VAO);
-                glDeleteBuffers(1, &VBO);
-                glDeleteBuffers(1, &EBO);
-
-                pMaterial->UnBind();
+            // Persistent VAO from the mesh registry, shared by the whole run
+            if (const MeshCache* cache = MeshRegistry::GetInstance().Acquire(*item.geometry))
+            {
+                DrawQueueBatch(begin, end, *cache, *pMaterial->GetShader());
             }
         }
+        glBindVertexArray(0);
+
+        if (pBoundMaterial)
+        {
+            pBoundMaterial->UnBind();
+        }
 
         // Unbind input textures
         UnbindInputs();
@@ -1118,11 +1154,11 @@ namespace te
             pSkyboxMat->OnApply(); // bind cubemap to GL_TEXTURE7
 
             // Set camera matrices
-            if (auto pCamera = mpRenderContext->GetAttachedCamera())
+            if (const FrameView* pView = mpRenderContext->GetRenderView())
             {
-                glm::mat4 viewNoTrans = glm::mat4(glm::mat3(pCamera->GetViewMatrix())); // remove translation from view matrix
+                glm::mat4 viewNoTrans = glm::mat4(glm::mat3(pView->view)); // remove translation from view matrix
                 pSkyboxMat->GetShader()->setMat4("view", viewNoTrans);
-                pSkyboxMat->GetShader()->setMat4("projection", pCamera->GetProjectionMatrix());
+                pSkyboxMat->GetShader()->setMat4("projection", pView->projection);
             }
 
             // Bind material resources first
@@ -3,6 +3,7 @@
 #include "framework/RenderGraph.h"
 #include "framework/RenderGraphVisualizer.h"
 #include "framework/Renderer.h"
+#include "framework/Profiler.h"
 #include "framework/VulkanGpuDebug.h"
 #include <unordered_set>
 #include <algorithm>
@@ -40,10 +41,12 @@ namespace te
         // Register callback for config changes
         pass->SetConfigChangeCallback([this]() {
             mDirty = true;
+            mGraphDirty = true;
         });
 
         // Mark dependency graph as dirty
         mDirty = true;
+        mGraphDirty = true;
 
         return true;
     }
@@ -71,6 +74,7 @@ namespace te
 
         // Mark dependency graph as dirty
         mDirty = true;
+        mGraphDirty = true;
     }
 
     std::shared_ptr<RenderPass> RenderPassManager::GetPass(const std::string& name) const
@@ -85,6 +89,7 @@ namespace te
     void RenderPassManager::ExecuteAll(const std::vector<RenderCommand>& commands)
     {
         std::cout << "RenderPassManager::ExecuteAll called with " << commands.size() << " commands" << std::endl;
+        mLastPassStats.Reset();
 
         // Unified dispatch entry: route to Vulkan graph when backend is Vulkan.
         if (mActiveBackend == ActiveBackend::Vulkan && mUseVulkanGraph)
@@ -115,7 +120,7 @@ namespace te
 
         for (const auto& pass : mPasses)
         {
-            if (!pass->IsEnabled())
+            if (!pass->ShouldExecute())
             {
                 std::cout << "Pass " << pass->GetConfig().name << " is disabled, skipping" << std::endl;
                 continue;
@@ -155,7 +160,11 @@ namespace te
             //Prepare Pass
             pass->Prepare();
             //  Execute Pass
-            pass->Execute(commands);
+            {
+                ProfilePassScope profile(pass->GetConfig().name);
+                pass->Execute(commands);
+            }
+            mLastPassStats.Accumulate(pass->GetPassStats());
         }
     }
 
@@ -219,11 +228,13 @@ namespace te
         mPasses.clear();
         mPassIndexMap.clear();
         mDirty = true;  // Mark as dirty after clearing
+        mGraphDirty = true;
         
         // Clear RenderGraph
         mGraphBuilder.Clear();
         mCompiledGraph.reset();
         mExecutor.reset();
+        mResourcePool->Clear();
         mVulkanPassNodes.clear();
         mVulkanResourceHandles.clear();
         mVulkanPostProcessCallback = {};
@@ -245,12 +256,10 @@ namespace te
         // clear previous builder
         mGraphBuilder.Clear();
 
-        // build RenderGraph from existing Passes
+        // build RenderGraph from existing Passes, disabled ones included: enabling a pass
+        // later is patched into the compiled graph instead of recompiling it
         for (const auto& pass : mPasses)
         {
-            if (!pass->IsEnabled())
-                continue;
-
             const std::string& name = pass->GetConfig().name;
             mGraphBuilder.AddPass(name, pass);
 
@@ -282,6 +291,18 @@ namespace te
             }
         }
 
+        // same passes, reads / writes and formats: keep the executor and its targets,
+        // only sizes and enabled passes may need patching
+        if (mExecutor && mExecutor->GetCompiledGraph() &&
+            mExecutor->GetCompiledGraph()->structureHash == mGraphBuilder.ComputeStructureHash())
+        {
+            mExecutor->ResizeResources(mResourceWidth, mResourceHeight);
+            mExecutor->SyncPassStates();
+            mGraphDirty = false;
+            std::cout << "RenderPassManager::CompileRenderGraph: RenderGraph unchanged, reusing it" << std::endl;
+            return true;
+        }
+
         // compile graph
         mCompiledGraph = mGraphBuilder.Compile();
         if (!mCompiledGraph)
@@ -290,14 +311,27 @@ namespace te
             return false;
         }
 
+        // transient memory before / after aliasing
+        {
+            const AliasingReport& report = mCompiledGraph->aliasingReport;
+            const double toMB = 1.0 / (1024.0 * 1024.0);
+            std::cout << "RenderPassManager::CompileRenderGraph: " << report.resourceCount << " transient resources in "
+                      << report.physicalCount << " targets, " << report.unaliasedBytes * toMB << " MB unaliased, "
+                      << report.aliasedBytes * toMB << " MB aliased (peak live " << report.peakLiveBytes * toMB
+                      << " MB)" << std::endl;
+        }
+
         // create executor
-        mExecutor = std::make_unique<RenderGraphExecutor>(std::move(mCompiledGraph));
+        // the old executor hands its targets back first, so the new graph reuses them
+        mExecutor.reset();
+        mExecutor = std::make_unique<RenderGraphExecutor>(std::move(mCompiledGraph), mResourcePool);
         if (!mExecutor)
         {
             std::cout << "RenderPassManager::CompileRenderGraph: Failed to create RenderGraphExecutor" << std::endl;
             return false;
         }
 
+        mGraphDirty = false;
         std::cout << "RenderPassManager::CompileRenderGraph: Successfully compiled RenderGraph" << std::endl;
         return true;
     }
@@ -315,9 +349,32 @@ namespace te
                 return;
             }
         }
+        else if (mGraphDirty)
+        {
+            CompileRenderGraph();
+        }
+        else
+        {
+            // a pass toggled since the last frame patches lifetimes and aliasing only
+            mExecutor->SyncPassStates();
+        }
 
         std::cout << "RenderPassManager::ExecuteWithRenderGraph: Executing with RenderGraph" << std::endl;
+        mLastPassStats.Reset();
         mExecutor->Execute(commands);
+
+        // only passes that ran this frame: skipped Conditional and culled passes still hold
+        // the counters of the last frame they ran
+        if (const CompiledGraph* graph = mExecutor->GetCompiledGraph())
+        {
+            for (size_t i = 0; i < graph->passes.size(); ++i)
+            {
+                if (graph->schedule[i].active && graph->passes[i].pass)
+                {
+                    mLastPassStats.Accumulate(graph->passes[i].pass->GetPassStats());
+                }
+            }
+        }
     }
 
     bool RenderPassManager::GenerateVisualization(const std::string& filename)
@@ -353,6 +410,7 @@ namespace te
         }
 
         RenderGraphVisualizer visualizer;
+        visualizer.SetPassTimings(Profiler::GetInstance().GetPassTimings());
         bool success = visualizer.GenerateDotFile(*compiledGraph, filename);
         
         if (success)
@@ -482,11 +540,16 @@ namespace te
             }
         }
 
+        Profiler& profiler = Profiler::GetInstance();
+        profiler.ResetVulkanQueries(commandBuffer);
+
         mLastVulkanGraphPassCount = 0;
         for (size_t idx : order) {
             if (mVulkanPassNodes[idx].execute) {
                 VulkanCmdDebugScopeBegin(commandBuffer, mVulkanPassNodes[idx].name.c_str());
+                profiler.BeginVulkanPass(commandBuffer, mVulkanPassNodes[idx].name);
                 mVulkanPassNodes[idx].execute(commandBuffer, commands);
+                profiler.EndVulkanPass(commandBuffer);
                 VulkanCmdDebugScopeEnd(commandBuffer);
                 ++mLastVulkanGraphPassCount;
             }
@@ -0,0 +1,262 @@
+#include "framework/RenderQueue.h"
+#include <bit>
+
+namespace te
+{
+    namespace
+    {
+        constexpr uint64_t Mask(uint32_t bits) { return (uint64_t(1) << bits) - 1; }
+
+        // transparent goes last so it blends over everything else in the pass
+        uint32_t ModeOrder(RenderMode mode)
+        {
+            return mode == RenderMode::Transparent ? 7u : uint32_t(mode);
+        }
+
+        // positive floats compare like their bit patterns, keep the top `bits` below the sign bit
+        uint32_t QuantizeDepth(float viewDepth, uint32_t bits)
+        {
+            const float depth = viewDepth > 0.0f ? viewDepth : 0.0f;
+            return std::bit_cast<uint32_t>(depth) >> (31 - bits);
+        }
+    }
+
+    uint64_t RenderQueue::PackKey(uint8_t passId, RenderMode mode, uint32_t program, uint32_t material,
+        uint32_t mesh, float viewDepth)
+    {
+        uint64_t key = (uint64_t(passId) & Mask(4)) << 60;
+        key |= (uint64_t(ModeOrder(mode)) & Mask(3)) << 57;
+
+        if (mode == RenderMode::Transparent)
+        {
+            const uint64_t depth = Mask(24) - QuantizeDepth(viewDepth, 24);
+            key |= depth << 33;
+            key |= (uint64_t(program) & Mask(12)) << 21;
+            key |= (uint64_t(material) & Mask(12)) << 9;
+            key |= uint64_t(mesh) & Mask(9);
+        }
+        else
+        {
+            key |= (uint64_t(program) & Mask(12)) << 45;
+            key |= (uint64_t(material) & Mask(12)) << 33;
+            key |= (uint64_t(mesh) & Mask(16)) << 17;
+            key |= uint64_t(QuantizeDepth(viewDepth, 17));
+        }
+        return key;
+    }
+
+    void RenderQueue::Clear()
+    {
+        mItems.clear();
+        mWorlds.clear();
+        mMaterialIds.clear();
+    }
+
+    uint32_t RenderQueue::MaterialIndex(const MaterialBase* material)
+    {
+        auto [it, inserted] = mMaterialIds.try_emplace(material, uint32_t(mMaterialIds.size()));
+        return it->second;
+    }
+
+    void RenderQueue::AddItem(const RenderCommand& command, uint8_t passId, uint32_t program, const glm::mat4& view,
+        const glm::mat4& world, GeometryItem* geometry, uint64_t geometryKey, MaterialBase* material, bool sourceMaterialMatters)
+    {
+        const float viewDepth = -(view * world[3]).z;
+        const uint32_t materialId = sourceMaterialMatters ? MaterialIndex(material) : 0;
+
+        RenderQueueItem item;
+        item.geometryKey = geometryKey;
+        item.materialId = materialId;
+        item.key = PackKey(passId, command.state, program, materialId, uint32_t(geometryKey), viewDepth);
+        item.world = uint32_t(mWorlds.size());
+        item.command = &command;
+        item.geometry = geometry;
+        item.material = material;
+        mWorlds.push_back(world);
+        mItems.push_back(item);
+    }
+
+    void RenderQueue::Build(const std::vector<RenderCommand>& commands, uint8_t passId, const glm::mat4& view,
+        const MaterialBase* overrideMaterial, bool sourceMaterialMatters, const FrameScene* scene)
+    {
+        Clear();
+        for (const auto& command : commands)
+        {
+            AddCommand(command, passId, view, overrideMaterial, sourceMaterialMatters, scene);
+        }
+    }
+
+    void RenderQueue::Build(std::span<const RenderCommand* const> commands, uint8_t passId, const glm::mat4& view,
+        const MaterialBase* overrideMaterial, bool sourceMaterialMatters, const FrameScene* scene)
+    {
+        Clear();
+        for (const RenderCommand* command : commands)
+        {
+            AddCommand(*command, passId, view, overrideMaterial, sourceMaterialMatters, scene);
+        }
+    }
+
+    void RenderQueue::AddCommand(const RenderCommand& command, uint8_t passId, const glm::mat4& view,
+        const MaterialBase* overrideMaterial, bool sourceMaterialMatters, const FrameScene* scene)
+    {
+        if (!command.fragmentsSource)
+            return;
+
+        if (scene && command.sceneDraw != RenderCommand::kNoSceneDraws)
+        {
+            // the material and draws as they were when the main thread built the frame
+            const FrameDraw* draws = scene->draws + command.sceneDraw;
+            for (uint32_t i = 0; i < command.sceneDrawCount; ++i)
+            {
+                const FrameDraw& draw = draws[i];
+                if (!draw.material)
+                    continue;
+
+                const MaterialBase* programSource = overrideMaterial ? overrideMaterial : draw.material;
+                const uint32_t program = programSource->GetShader() ? programSource->GetShader()->GetID() : 0;
+                AddItem(command, passId, program, view, draw.world, draw.geometry, draw.contentKey,
+                    draw.material, sourceMaterialMatters);
+            }
+            return;
+        }
+
+        auto pMaterial = command.fragmentsSource->GetMaterial();
+        if (!pMaterial)
+            return;
+
+        const MaterialBase* programSource = overrideMaterial ? overrideMaterial : pMaterial.get();
+        const uint32_t program = programSource->GetShader() ? programSource->GetShader()->GetID() : 0;
+
+        for (const auto& frag : command.fragmentsSource->GetFragments())
+        {
+            if (!frag.IsReady())
+                continue;
+
+            AddItem(command, passId, program, view, frag.mpGeometry->GetWorldTransform(), frag.mpGeometry,
+                frag.mpGeometry->GetContentKey(), pMaterial.get(), sourceMaterialMatters);
+        }
+    }
+
+    void RenderQueue::Sort()
+    {
+        const size_t count = mItems.size();
+        if (count < 2)
+            return;
+
+        mScratch.resize(count);
+        RenderQueueItem* src = mItems.data();
+        RenderQueueItem* dst = mScratch.data();
+
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            size_t histogram[256] = {};
+            for (size_t i = 0; i < count; ++i)
+            {
+                ++histogram[(src[i].key >> shift) & 0xFF];
+            }
+
+            // every key shares this byte: the column is already sorted
+            if (histogram[(src[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t offset = 0;
+            for (size_t& bucket : histogram)
+            {
+                const size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != mItems.data())
+        {
+            mItems.swap(mScratch);
+        }
+    }
+
+    size_t RenderQueue::NextBatch(size_t begin) const noexcept
+    {
+        const size_t count = mItems.size();
+        if (begin >= count)
+            return count;
+
+        const RenderQueueItem& first = mItems[begin];
+        size_t end = begin + 1;
+        while (end < count)
+        {
+            const RenderQueueItem& item = mItems[end];
+            if (item.geometryKey != first.geometryKey || item.materialId != first.materialId
+                || item.command->state != first.command->state)
+            {
+                break;
+            }
+            ++end;
+        }
+        return end;
+    }
+
+    void RenderQueue::GatherTransforms(size_t begin, size_t end, std::vector<glm::mat4>& outTransforms) const
+    {
+        outTransforms.clear();
+        for (size_t i = begin; i < end && i < mItems.size(); ++i)
+        {
+            outTransforms.push_back(mWorlds[mItems[i].world]);
+        }
+    }
+
+    bool RenderStateTracker::BindProgram(MaterialBase* material)
+    {
+        if (!material || !material->GetShader())
+            return false;
+
+        const GLuint program = material->GetShader()->GetID();
+        if (program == mProgram)
+        {
+            ++mAvoided;
+            return false;
+        }
+
+        mProgram = program;
+        material->OnApply();
+        return true;
+    }
+
+    bool RenderStateTracker::BindMaterial(const MaterialBase* material)
+    {
+        if (material == mpMaterial)
+        {
+            ++mAvoided;
+            return false;
+        }
+
+        mpMaterial = material;
+        return true;
+    }
+
+    bool RenderStateTracker::BindVertexArray(GLuint vao)
+    {
+        if (vao == mVertexArray)
+        {
+            ++mAvoided;
+            return false;
+        }
+
+        mVertexArray = vao;
+        glBindVertexArray(vao);
+        return true;
+    }
+
+    void RenderStateTracker::Reset()
+    {
+        mProgram = 0;
+        mpMaterial = nullptr;
+        mVertexArray = 0;
+        mAvoided = 0;
+    }
+}
@@ -1,6 +1,9 @@
 #include "framework/RenderThread.h"
 #include "framework/RenderPassManager.h"
+#include "framework/Profiler.h"
+#include "mesh/MeshRegistry.h"
 #include "RenderView.h"
+#include "framework/RenderContext.h"
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 #include <iostream>
@@ -57,7 +60,7 @@ void RenderThread::Stop()
     // wake up waiting thread
     if (mFrameSync)
     {
-        mFrameSync->SignalFrameReady();
+        mFrameSync->Shutdown();
     }
     
     std::cout << "RenderThread::Stop - Stopping render thread" << std::endl;
@@ -75,6 +78,7 @@ void RenderThread::Join()
 void RenderThread::RenderLoop()
 {
     std::cout << "RenderThread::RenderLoop - Entering render loop" << std::endl;
+    te::Profiler::GetInstance().SetThreadName("Render");
     
     // initialize render context
     // note: due to GLFW's limitation, we need to use main window
@@ -94,26 +98,48 @@ void RenderThread::RenderLoop()
     {
         std::lock_guard<std::mutex> lock(g_GLContextMutex);
         glfwMakeContextCurrent(mMainWindow);
+        
+        //// ensure GLAD is loaded (if not already)
+        //if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        //{
+        //    std::cerr << "RenderThread::RenderLoop - Failed to initialize GLAD" << std::endl;
+        //    mRunning = false;
+        //    return;
+        //}
+        
+        std::cout << "RenderThread::RenderLoop - OpenGL context initialized" << std::endl;
+        
+        // set render state
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LESS);
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_BACK);
+        glFrontFace(GL_CCW);
+        
+        // every frame re-binds the context, until then the main thread may use it
+        glfwMakeContextCurrent(nullptr);
     }
     
-    //// ensure GLAD is loaded (if not already)
-    //if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    //{
-    //    std::cerr << "RenderThread::RenderLoop - Failed to initialize GLAD" << std::endl;
-    //    mRunning = false;
-    //    return;
-    //}
-    
-    std::cout << "RenderThread::RenderLoop - OpenGL context initialized" << std::endl;
+    if (mFrameSync->IsPipelined())
+    {
+        PipelinedLoop();
+    }
+    else
+    {
+        LockstepLoop();
+    }
     
-    // set render state
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
+    // cleanup: release context
+    {
+        std::lock_guard<std::mutex> lock(g_GLContextMutex);
+        glfwMakeContextCurrent(nullptr);
+    }
     
-    // render loop
+    std::cout << "RenderThread::RenderLoop - Exiting render loop" << std::endl;
+}
+
+void RenderThread::LockstepLoop()
+{
     while (mRunning.load())
     {
         // wait for frame ready signal
@@ -124,21 +150,10 @@ void RenderThread::RenderLoop()
             break;
         }
         
-        // collect render commands
-        std::vector<RenderCommand> commands;
-        commands.reserve(1024);  // pre-allocate space
-        
-        // batch collect commands
-        while (auto cmd = mCommandQueue->PopCommand())
-        {
-            commands.push_back(*cmd);
-            
-            // limit batch size, avoid processing too many at once
-            if (commands.size() >= 1024)
-            {
-                break;
-            }
-        }
+        // take the whole frame in one drain, the vector keeps its capacity between frames
+        std::vector<RenderCommand>& commands = mFrameCommands;
+        commands.clear();
+        mCommandQueue->DrainCommands(commands);
         
         if (commands.empty())
         {
@@ -147,6 +162,21 @@ void RenderThread::RenderLoop()
             continue;
         }
         
+        // viewport size captured with the frame scene, otherwise from RenderView
+        uint16_t viewportWidth = 800;
+        uint16_t viewportHeight = 600;
+        const te::FrameScene* scene = mpRenderContext ? mpRenderContext->GetFrameScene() : nullptr;
+        if (scene && scene->view.viewportWidth > 0)
+        {
+            viewportWidth = scene->view.viewportWidth;
+            viewportHeight = scene->view.viewportHeight;
+        }
+        else if (mpRenderView)
+        {
+            viewportWidth = mpRenderView->Width();
+            viewportHeight = mpRenderView->Height();
+        }
+        
         // start rendering frame (under mutex protection)
         {
             std::lock_guard<std::mutex> lock(g_GLContextMutex);
@@ -155,56 +185,120 @@ void RenderThread::RenderLoop()
             // The context was released after the previous frame's ImGui rendering
             glfwMakeContextCurrent(mMainWindow);
             
-            // start rendering frame
-            mpRenderer->BeginFrame();
+            ExecuteFrame(commands, viewportWidth, viewportHeight);
             
-            // set viewport and clear color (these should be set in BeginFrame, but for safety, we set them here)
-            // get viewport size from RenderView
-            uint16_t viewportWidth = 800;
-            uint16_t viewportHeight = 600;
-            if (mpRenderView)
-            {
-                viewportWidth = mpRenderView->Width();
-                viewportHeight = mpRenderView->Height();
-            }
-            mpRenderer->SetViewport(0, 0, viewportWidth, viewportHeight);
-            mpRenderer->SetClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-            mpRenderer->Clear(0x3);  // clear color and depth
+            // IMPORTANT: Release context after rendering so main thread can use it for ImGui
+            // The context will be re-bound in the next frame
+            glfwMakeContextCurrent(nullptr);
+        }
+        
+        // notify main thread rendering complete
+        mFrameSync->SignalRenderComplete();
+    }
+}
+
+void RenderThread::PipelinedLoop()
+{
+    // the render thread presents: the main thread is already building the next frame
+    while (mRunning.load())
+    {
+        FrameSnapshot* frame = mFrameSync->WaitForFrame();
+        if (!frame || !mRunning.load())
+        {
+            break;
+        }
+        
+        // the frame's commands were pushed before it was submitted
+        std::vector<RenderCommand>& commands = mFrameCommands;
+        commands.clear();
+        mCommandQueue->DrainCommands(commands, frame->commandCount);
+        
+        FrameRenderStats stats;
+        {
+            std::lock_guard<std::mutex> lock(g_GLContextMutex);
+            glfwMakeContextCurrent(mMainWindow);
             
-            // execute rendering
-            if (mpRenderer->IsMultiPassEnabled())
+            if (mpRenderContext)
             {
-                // multi-pass rendering
-                te::RenderPassManager::GetInstance().ExecuteAll(commands);
+                mpRenderContext->SetFrameScene(frame->scene);
             }
-            else
+            if (frame->scene)
             {
-                // single-pass rendering
-                for (const auto& cmd : commands)
+                // geometry that was not resident, copied when the frame was built
+                for (uint32_t i = 0; i < frame->scene->uploadCount; ++i)
                 {
-                    mpRenderer->DrawMesh(cmd);
+                    te::MeshRegistry::GetInstance().Upload(frame->scene->uploads[i]);
                 }
             }
             
-            // end rendering frame
-            mpRenderer->EndFrame();
+            ExecuteFrame(commands, frame->scene ? frame->scene->view.viewportWidth : 800,
+                frame->scene ? frame->scene->view.viewportHeight : 600);
+            stats = CollectRenderStats(*mpRenderer);
+            
+            if (mOverlayRenderer)
+            {
+                mOverlayRenderer(*frame);
+            }
+            glfwSwapBuffers(mMainWindow);
             
-            // IMPORTANT: Release context after rendering so main thread can use it for ImGui
-            // The context will be re-bound in the next frame
             glfwMakeContextCurrent(nullptr);
         }
         
-        // notify main thread rendering complete
-        mFrameSync->SignalRenderComplete();
+        mFrameSync->CompleteFrame(frame, stats);
     }
     
-    // cleanup: release context
+    if (mpRenderContext)
     {
-        std::lock_guard<std::mutex> lock(g_GLContextMutex);
-        glfwMakeContextCurrent(nullptr);
+        mpRenderContext->SetFrameScene(nullptr);
     }
+}
+
+void RenderThread::ExecuteFrame(std::vector<RenderCommand>& commands, uint16_t viewportWidth, uint16_t viewportHeight)
+{
+    TE_PROFILE_SCOPE("RenderThread::ExecuteFrame");
+
+    // start rendering frame
+    mpRenderer->BeginFrame();
     
-    std::cout << "RenderThread::RenderLoop - Exiting render loop" << std::endl;
+    // set viewport and clear color (these should be set in BeginFrame, but for safety, we set them here)
+    mpRenderer->SetViewport(0, 0, viewportWidth, viewportHeight);
+    mpRenderer->SetClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    mpRenderer->Clear(0x3);  // clear color and depth
+    
+    // execute rendering
+    if (commands.empty())
+    {
+        // nothing to draw, the frame is still cleared and presented
+    }
+    else if (mpRenderer->IsMultiPassEnabled())
+    {
+        // multi-pass rendering
+        te::RenderPassManager::GetInstance().ExecuteAll(commands);
+    }
+    else
+    {
+        // single-pass rendering, sorted and instanced by the renderer
+        mpRenderer->DrawMeshes(commands);
+    }
+    
+    // end rendering frame
+    mpRenderer->EndFrame();
+    
+    // release the FragmentsSource references before the main thread may tear the scene down
+    commands.clear();
+}
+
+FrameRenderStats RenderThread::CollectRenderStats(const IRenderer& renderer)
+{
+    auto& passManager = te::RenderPassManager::GetInstance();
+    FrameRenderStats stats;
+    stats.render = renderer.IsMultiPassEnabled() ? passManager.GetLastPassStats() : renderer.GetRenderStats();
+    stats.hasResourcePool = passManager.IsRenderGraphEnabled() && passManager.GetGraphExecutor();
+    if (stats.hasResourcePool)
+    {
+        stats.resourcePool = passManager.GetResourcePoolStats();
+    }
+    return stats;
 }
 
 void RenderThread::InitializeRenderContext()
@@ -1,15 +1,22 @@
 #include "framework/Renderer.h"
 #include "framework/RenderPass.h"
 #include "framework/RenderPassManager.h"
+#include "framework/RenderQueue.h"
+#include "memory/FrameAllocator.h"
+#include "framework/Profiler.h"
+#include "framework/InstanceBuffer.h"
 #include "framework/VulkanDeferredPipeline.h"
 #include "framework/VulkanGeometryPass.h"
 #include "framework/VulkanPostProcessPass.h"
 #include "framework/VulkanPresentPass.h"
 #include "glad/glad.h"
 #include "shader.h"
+#include "shader/ShaderHotReload.h"
+#include "shader/FrameUniforms.h"
 #include "Camera.h"
 #include "Light.h"
 #include "mesh/Mesh.h"
+#include "mesh/MeshRegistry.h"
 #include "GTVulkan/GlfwGeneral.h"
 #include "GTVulkan/EasyVulkan.h"
 #include <glm/gtc/matrix_transform.hpp>
@@ -51,6 +58,9 @@ std::shared_ptr<IRenderer> RendererFactory::CreateRenderer(RendererBackend backe
 
 // OpenGL renderer Impl
 OpenGLRenderer::OpenGLRenderer()
+    : mpRenderQueue(std::make_unique<te::RenderQueue>())
+    , mpStateTracker(std::make_unique<te::RenderStateTracker>())
+    , mpInstanceBuffer(std::make_unique<te::InstanceBuffer>())
 {
     std::cout << "OpenGLRenderer constructor called" << std::endl;
     // mpRenderContext is initialized in header with nullptr
@@ -96,28 +106,57 @@ bool OpenGLRenderer::Initialize()
 void OpenGLRenderer::Shutdown()
 {
     // clean up cached mesh data
-    for (auto& [hash, cache] : mMeshCache)
+    te::MeshRegistry::GetInstance().ReleaseAll();
+    if (mpInstanceBuffer)
     {
-        Mesh::CleanupMeshBuffers(cache.vao, cache.vbo, cache.ebo);
+        mpInstanceBuffer->Release();
     }
-    mMeshCache.clear();
+    te::FrameUniformBuffer::GetInstance().Release();
+    te::Profiler::GetInstance().ReleaseGpuResources();
+    te::ShaderHotReload::GetInstance().ReleaseGpuResources();
 }
 
 void OpenGLRenderer::BeginFrame()
 {
     mStats.Reset();
 
+    // transient containers of this frame (pass command lists, graph bookkeeping)
+    te::FrameAllocator::GetInstance().BeginFrame();
+    // pass timer results of a few frames ago
+    te::Profiler::GetInstance().BeginFrame();
+
+    // programs rebuilt by the hot reload worker are only installed between frames
+    te::ShaderHotReload::GetInstance().ApplyPendingSwaps();
+
+    // evict GPU meshes of geometry destroyed since last frame
+    te::MeshRegistry::GetInstance().CollectReleased();
+
     // init bachground
     if (mpRenderView)
     {
         mpRenderView->BindCamera(mpRenderContext->GetAttachedCamera());
         mpRenderView->Update();
     }
+
+    // camera / light go to the shared FrameData block once, not per draw
+    if (mpRenderContext)
+    {
+        te::FrameUniformBuffer::GetInstance().UpdateFromContext(*mpRenderContext);
+    }
 }
 
 void OpenGLRenderer::EndFrame()
 {
-    // can add cleanup work here
+    mStats.geometryBytesCopied += GeometryItem::ConsumeCopiedBytes();
+    if (mMultiPassEnabled)
+    {
+        mStats.Accumulate(te::RenderPassManager::GetInstance().GetLastPassStats());
+    }
+
+    const te::FrameAllocatorStats frameMemory = te::FrameAllocator::GetInstance().GetFrameStats();
+    mStats.frameAllocations = frameMemory.allocations;
+    mStats.frameAllocatedBytes = frameMemory.bytes;
+    mStats.frameHeapAllocations = frameMemory.heapAllocations;
 }
 
 void OpenGLRenderer::DrawMesh(const RenderCommand& command)
@@ -134,28 +173,13 @@ void OpenGLRenderer::DrawMesh(const RenderCommand& command)
 
     // get data from fragment
     auto material = command.fragmentsSource->GetMaterial();
-    auto vertices = frag.mpGeometry->GetVertices();
-    auto indices = frag.mpGeometry->GetIndices();
     auto transform = frag.mpGeometry->GetWorldTransform();
 
     // set material
     material->OnApply();
 
-    // set transform matrix
-    material->GetShader()->setMat4("model", transform);
-
-    // set camera and light parameters
-    if (auto pCamera = mpRenderContext->GetAttachedCamera())
-    {
-        material->GetShader()->setMat4("view", pCamera->GetViewMatrix());
-        material->GetShader()->setMat4("projection", pCamera->GetProjectionMatrix());
-    }
-
-    if (auto pLight = mpRenderContext->GetDefaultLight())
-    {
-        material->GetShader()->setVec3("u_lightPos", pLight->GetPosition());
-        material->GetShader()->setVec3("u_lightColor", pLight->GetColor());
-    }
+    // set transform matrix (camera and light live in the FrameData block)
+    material->GetShader()->setMat4(te::uniform::Model, transform);
 
     // update material uniform
     material->UpdateUniform();
@@ -163,31 +187,21 @@ void OpenGLRenderer::DrawMesh(const RenderCommand& command)
     // bind material resources
     material->OnBind();
 
-    // calculate mesh hash for caching
-    size_t meshHash = std::hash<std::string>{}(std::string((char*)vertices.data(), vertices.size() * sizeof(Vertex))) ^
-        std::hash<std::string>{}(std::string((char*)indices.data(), indices.size() * sizeof(unsigned int)));
-
-    // find or create cached mesh data
-    auto it = mMeshCache.find(meshHash);
-    if (it == mMeshCache.end())
-    {
-        MeshCache cache;
-        Mesh::SetupMeshBuffers(vertices, indices, cache.vao, cache.vbo, cache.ebo);
-        cache.vertexCount = vertices.size();
-        cache.indexCount = indices.size();
-        mMeshCache[meshHash] = cache;
-        it = mMeshCache.find(meshHash);
-    }
+    // find or upload GPU mesh by registry handle
+    const MeshCache* cache = te::MeshRegistry::GetInstance().Acquire(*frag.mpGeometry);
+    if (!cache)
+        return;
 
     // bind VAO and draw
-    glBindVertexArray(it->second.vao);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(it->second.indexCount), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(cache->vao);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cache->indexCount), GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 
     // update stats
     mStats.drawCalls++;
-    mStats.triangles += uint32_t(indices.size()) / 3;
-    mStats.vertices += uint32_t(vertices.size());
+    mStats.instances++;
+    mStats.triangles += uint32_t(cache->indexCount) / 3;
+    mStats.vertices += uint32_t(cache->vertexCount);
 }
 
 void OpenGLRenderer::DrawMesh(const std::shared_ptr<Mesh> pMesh)
@@ -204,21 +218,8 @@ void OpenGLRenderer::DrawMesh(const std::shared_ptr<Mesh> pMesh)
    // set material
    material->OnApply();
    
-   // set transform matrix
-   material->GetShader()->setMat4("model", pMesh->GetWorldTransform());
-   
-   // set camera and light parameters
-   if (auto pCamera = mpRenderContext->GetAttachedCamera())
-   {
-       material->GetShader()->setMat4("view", pCamera->GetViewMatrix());
-       material->GetShader()->setMat4("projection", pCamera->GetProjectionMatrix());
-   }
-   
-   if (auto pLight = mpRenderContext->GetDefaultLight())
-   {
-       material->GetShader()->setVec3("u_lightPos", pLight->GetPosition());
-       material->GetShader()->setVec3("u_lightColor", pLight->GetColor());
-   }
+   // set transform matrix (camera and light live in the FrameData block)
+   material->GetShader()->setMat4(te::uniform::Model, pMesh->GetWorldTransform());
    
    // update material uniform
    material->UpdateUniform();
@@ -227,15 +228,78 @@ void OpenGLRenderer::DrawMesh(const std::shared_ptr<Mesh> pMesh)
    material->OnBind();
 
    // will update stats
-   pMesh->Draw(mMeshCache, mStats);
+   pMesh->Draw(mStats);
 }
 
 void OpenGLRenderer::DrawMeshes(const std::vector<RenderCommand>& commands)
 {
-   for (const auto& command : commands)
-   {
-       DrawMesh(command);
-   }
+    const te::FrameView* pView = mpRenderContext ? mpRenderContext->GetRenderView() : nullptr;
+    const te::FrameScene* pScene = mpRenderContext ? mpRenderContext->GetFrameScene() : nullptr;
+
+    // sort by (mode, program, material, mesh, depth) so redundant binds can be skipped
+    mpRenderQueue->Build(commands, 0, pView ? pView->view : glm::mat4(1.0f), nullptr, true, pScene);
+    mpRenderQueue->Sort();
+    mpStateTracker->Reset();
+
+    // runs sharing mesh + material become one instanced draw
+    const auto& items = mpRenderQueue->GetItems();
+    for (size_t begin = 0, end = 0; begin < items.size(); begin = end)
+    {
+        end = mpRenderQueue->NextBatch(begin);
+        const auto& item = items[begin];
+        MaterialBase* material = item.material;
+        auto pShader = material->GetShader();
+
+        // apply render state
+        ApplyRenderState(item.command->state);
+
+        // camera and light come from the FrameData block uploaded in BeginFrame
+        mpStateTracker->BindProgram(material);
+
+        // update material uniform and bind its resources once per material run
+        if (mpStateTracker->BindMaterial(material))
+        {
+            material->UpdateUniform();
+            material->OnBind();
+        }
+
+        const MeshCache* cache = te::MeshRegistry::GetInstance().Acquire(*item.geometry);
+        if (!cache)
+            continue;
+
+        const size_t count = end - begin;
+        mpStateTracker->BindVertexArray(cache->vao);
+        if (count >= te::InstanceBuffer::kMinBatchSize)
+        {
+            mpRenderQueue->GatherTransforms(begin, end, mInstanceTransforms);
+            mpInstanceBuffer->Upload(mInstanceTransforms);
+            mpInstanceBuffer->Attach();
+
+            pShader->setBool(te::uniform::Instanced, true);
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(cache->indexCount), GL_UNSIGNED_INT, 0, static_cast<GLsizei>(count));
+            pShader->setBool(te::uniform::Instanced, false);
+
+            mpInstanceBuffer->Detach();
+            mStats.drawCalls++;
+        }
+        else
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                pShader->setMat4(te::uniform::Model, mpRenderQueue->GetWorld(items[i]));
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cache->indexCount), GL_UNSIGNED_INT, 0);
+                mStats.drawCalls++;
+            }
+        }
+
+        // update stats
+        mStats.instances += uint32_t(count);
+        mStats.triangles += uint32_t(count * (cache->indexCount / 3));
+        mStats.vertices += uint32_t(count * cache->vertexCount);
+    }
+    glBindVertexArray(0);
+
+    mStats.stateChangesAvoided += mpStateTracker->GetAvoidedCount();
 }
 
 void OpenGLRenderer::SetViewport(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
@@ -378,10 +442,11 @@ void OpenGLRenderer::ExecuteRenderPasses(const std::vector<RenderCommand>& comma
     // execute all Pass
     for (const auto& pass : mRenderPasses)
     {
-        if (!pass->IsEnabled())
+        if (!pass->ShouldExecute())
             continue;
 
         // execute Pass
+        te::ProfilePassScope profile(pass->GetConfig().name);
         pass->Execute(commands);
     }
 } 
@@ -958,6 +1023,7 @@ void VulkanRenderer::Shutdown()
     }
 
     vk::GraphicsBase::Base().WaitIdle();
+    te::Profiler::GetInstance().ReleaseGpuResources();
 
     // Pipelines and pipeline layouts reference descriptor set layouts owned by deferred / post / present passes.
     // Destroy pipelines and layouts before pass Shutdown() runs vkDestroyDescriptorSetLayout on those handles.
@@ -1006,6 +1072,8 @@ void VulkanRenderer::BeginFrame()
     }
 
     mStats.Reset();
+    te::FrameAllocator::GetInstance().BeginFrame();
+    te::Profiler::GetInstance().BeginFrame();
     impl.pendingCommands.clear();
     if (!impl.imageAvailable || !impl.frameFence || impl.renderingOverSemaphores.empty()) {
         return;
@@ -1024,16 +1092,17 @@ void VulkanRenderer::BeginFrame()
                                       float(impl.extent.width) / (std::max)(1.0f, float(impl.extent.height)),
                                       0.1f,
                                       100.0f);
-    if (mpRenderContext && mpRenderContext->GetAttachedCamera()) {
-        view = mpRenderContext->GetAttachedCamera()->GetViewMatrix();
-        proj = mpRenderContext->GetAttachedCamera()->GetProjectionMatrix();
+    const te::FrameView* frameView = mpRenderContext ? mpRenderContext->GetRenderView() : nullptr;
+    if (frameView) {
+        view = frameView->view;
+        proj = frameView->projection;
     }
     proj[1][1] *= -1.0f;
     impl.deferredPipeline.GeometryPass().SetViewProjection(view, proj);
 
-    if (mpRenderContext && mpRenderContext->GetDefaultLight()) {
-        const glm::vec3 lightPos = mpRenderContext->GetDefaultLight()->GetPosition();
-        const glm::vec3 lightColor = mpRenderContext->GetDefaultLight()->GetColor();
+    if (const te::FrameLight* frameLight = mpRenderContext ? mpRenderContext->GetRenderLight() : nullptr) {
+        const glm::vec3 lightPos = frameLight->position;
+        const glm::vec3 lightColor = frameLight->color;
         std::array<glm::vec4, 4> pointPositions = {
             glm::vec4(lightPos, 1.0f),
             glm::vec4(0.0f),
@@ -1058,9 +1127,9 @@ void VulkanRenderer::BeginFrame()
         const glm::mat4 invVp = glm::inverse(vp);
         float zNear = 0.1f;
         float zFar = 100.0f;
-        if (mpRenderContext && mpRenderContext->GetAttachedCamera()) {
-            zNear = mpRenderContext->GetAttachedCamera()->GetNearPlane();
-            zFar = mpRenderContext->GetAttachedCamera()->GetFarPlane();
+        if (frameView) {
+            zNear = frameView->nearPlane;
+            zFar = frameView->farPlane;
         }
         impl.deferredPipeline.LightingPass().SetDeferredFrameMatrices(invVp, zNear, zFar, impl.extent);
     }
@@ -1124,19 +1193,9 @@ void VulkanRenderer::EndFrame()
     vk::GraphicsBase::Base().PresentImage(*renderingOver);
     impl.frameFence->WaitAndReset();
 
-    for (const auto& cmd : impl.pendingCommands) {
-        if (!cmd.fragmentsSource) {
-            continue;
-        }
-        auto& frag = cmd.fragmentsSource->GetDefaultFragment();
-        if (!frag.mpGeometry) {
-            continue;
-        }
-        // Avoid Fragment::IsReady() in Vulkan path: it triggers OpenGL VAO/VBO setup.
-        ++mStats.drawCalls;
-        mStats.vertices += static_cast<uint32_t>(frag.mpGeometry->GetVertices().size());
-        mStats.triangles += static_cast<uint32_t>(frag.mpGeometry->GetIndices().size() / 3);
-    }
+    // the geometry pass batches identical meshes into instanced draws, take its counts
+    mStats.Accumulate(impl.deferredPipeline.GeometryPass().GetLastStats());
+    mStats.geometryBytesCopied += GeometryItem::ConsumeCopiedBytes();
 
     impl.pendingCommands.clear();
     impl.firstFrame = false;
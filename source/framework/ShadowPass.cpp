@@ -3,6 +3,7 @@
 #include "framework/RenderContext.h"
 #include "materials/ShadowDepthMaterial.h"
 #include "mesh/Mesh.h"
+#include "mesh/MeshRegistry.h"
 #include "mesh/Vertex.h"
 #include "Light.h"
 #include "glad/glad.h"
@@ -17,6 +18,7 @@ namespace te
         mConfig.type = RenderPassType::Shadow;
         mpOverMaterial = std::make_shared<ShadowDepthMaterial>();
         mRenderPassFlag = RenderPassFlag::Shadowing;
+        mSortBySourceMaterial = false;
     }
 
     void ShadowPass::OnInitialize()
@@ -29,6 +31,7 @@ namespace te
             {"ShadowMap", "shadowmap", RenderTargetFormat::Depth32F}
         };
         mConfig.dependencies = {};
+        mConfig.sideEffects = true;  // BasePass takes the shadow map from this pass, not through the graph
         mConfig.clearColor = false;
         mConfig.clearDepth = true;
         mConfig.clearStencil = false;
@@ -146,14 +149,14 @@ namespace te
             return glm::normalize(glm::vec3(0.3f, -1.0f, 0.3f));
         }
 
-        if (auto light = mpRenderContext->GetDefaultLight())
+        if (auto light = mpRenderContext->GetRenderLight())
         {
-            const glm::vec3 direction = light->GetDirection();
+            const glm::vec3 direction = light->direction;
             if (glm::length(direction) > 1e-4f)
             {
                 return glm::normalize(direction);
             }
-            const glm::vec3 toScene = sceneCenter - light->GetPosition();
+            const glm::vec3 toScene = sceneCenter - light->position;
             if (glm::length(toScene) > 1e-4f)
             {
                 return glm::normalize(toScene);
@@ -206,58 +209,25 @@ namespace te
             glClear(GL_DEPTH_BUFFER_BIT);
         }
 
-        shadowMaterial->OnApply();
+        mStateTracker.BindProgram(shadowMaterial.get());
+        shadowMaterial->UpdateUniform();
 
         // Default back-face depth (front-face cull breaks closed meshes like spheres:
         // only the far shell is written and the ground shadow becomes a thin crescent).
-        for (const auto& command : mCandidateCommands)
+        // Depth only needs the mesh, so every run of identical geometry becomes one instanced draw.
+        const auto& items = mRenderQueue.GetItems();
+        for (size_t begin = 0, end = 0; begin < items.size(); begin = end)
         {
-            if (!command.fragmentsSource)
+            end = mRenderQueue.NextBatch(begin);
+            const MeshCache* cache = MeshRegistry::GetInstance().Acquire(*items[begin].geometry);
+            if (!cache)
             {
                 continue;
             }
 
-            const auto& fragments = command.fragmentsSource->GetFragments();
-            for (const auto& frag : fragments)
-            {
-                if (!frag.IsReady())
-                {
-                    continue;
-                }
-
-                auto vertices = frag.mpGeometry->GetVertices();
-                auto indices = frag.mpGeometry->GetIndices();
-                const auto transform = frag.mpGeometry->GetWorldTransform();
-
-                if (vertices.empty() || indices.empty())
-                {
-                    continue;
-                }
-
-                shadowMaterial->GetShader()->setMat4("model", transform);
-                shadowMaterial->UpdateUniform();
-
-                GLuint VAO = 0, VBO = 0, EBO = 0;
-                glGenVertexArrays(1, &VAO);
-                glGenBuffers(1, &VBO);
-                glGenBuffers(1, &EBO);
-
-                glBindVertexArray(VAO);
-                glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-                glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-                glEnableVertexAttribArray(0);
-                glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(0));
-
-                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, nullptr);
-
-                glDeleteVertexArrays(1, &VAO);
-                glDeleteBuffers(1, &VBO);
-                glDeleteBuffers(1, &EBO);
-            }
+            DrawQueueBatch(begin, end, *cache, *shadowMaterial->GetShader());
         }
+        glBindVertexArray(0);
 
         mFrameBuffer->Unbind();
         RestoreRenderSettings();
@@ -0,0 +1,153 @@
+#include "framework/TransientResourcePool.h"
+#include <iostream>
+
+namespace te
+{
+    namespace
+    {
+        RenderTargetType GetTargetType(RenderTargetFormat format)
+        {
+            switch (format)
+            {
+            case RenderTargetFormat::Depth24:
+            case RenderTargetFormat::Depth32F:
+                return RenderTargetType::Depth;
+            case RenderTargetFormat::Depth24Stencil8:
+                return RenderTargetType::ColorDepthStencil;
+            default:
+                return RenderTargetType::Color;
+            }
+        }
+    }
+
+    TransientResourcePool::~TransientResourcePool()
+    {
+        Clear();
+    }
+
+    uint64_t TransientResourcePool::EstimateBytes(const TransientResourceKey& key)
+    {
+        // drivers pad 3-component formats to 4 components
+        uint64_t bytesPerPixel = 4;
+        switch (key.format)
+        {
+        case RenderTargetFormat::RGB16F:
+        case RenderTargetFormat::RGBA16F:
+            bytesPerPixel = 8;
+            break;
+        case RenderTargetFormat::RGB32F:
+        case RenderTargetFormat::RGBA32F:
+            bytesPerPixel = 16;
+            break;
+        default:
+            break;
+        }
+        return bytesPerPixel * key.width * key.height;
+    }
+
+    void TransientResourcePool::BeginFrame()
+    {
+        ++mFrame;
+        mStats.hits = 0;
+        mStats.misses = 0;
+
+        for (size_t i = mEntries.size(); i-- > 0;)
+        {
+            const Entry& entry = mEntries[i];
+            if (!entry.inUse && mFrame - entry.lastUsedFrame > kMaxIdleFrames)
+            {
+                RemoveEntry(i);
+            }
+        }
+    }
+
+    std::shared_ptr<RenderTarget> TransientResourcePool::Acquire(const std::string& name, const TransientResourceKey& key)
+    {
+        for (Entry& entry : mEntries)
+        {
+            if (!entry.inUse && entry.key == key)
+            {
+                entry.inUse = true;
+                entry.lastUsedFrame = mFrame;
+                ++mStats.hits;
+                ++mStats.totalHits;
+                ++mStats.targetsInUse;
+                return entry.target;
+            }
+        }
+
+        ++mStats.misses;
+        ++mStats.totalMisses;
+
+        RenderTargetDesc desc(name, GetTargetType(key.format), key.format, key.width, key.height);
+        auto target = std::make_shared<RenderTarget>();
+        if (!target->Initialize(desc))
+        {
+            std::cout << "TransientResourcePool::Acquire: Failed to create render target " << name << std::endl;
+            return nullptr;
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.target = target;
+        entry.lastUsedFrame = mFrame;
+        entry.inUse = true;
+        mEntries.push_back(std::move(entry));
+
+        ++mStats.targets;
+        ++mStats.targetsInUse;
+        mStats.gpuBytes += EstimateBytes(key);
+        return target;
+    }
+
+    void TransientResourcePool::Release(const std::shared_ptr<RenderTarget>& target)
+    {
+        for (Entry& entry : mEntries)
+        {
+            if (entry.target == target && entry.inUse)
+            {
+                entry.inUse = false;
+                entry.lastUsedFrame = mFrame;
+                --mStats.targetsInUse;
+                return;
+            }
+        }
+    }
+
+    void TransientResourcePool::Trim()
+    {
+        for (size_t i = mEntries.size(); i-- > 0;)
+        {
+            if (!mEntries[i].inUse)
+            {
+                RemoveEntry(i);
+            }
+        }
+    }
+
+    void TransientResourcePool::Clear()
+    {
+        for (Entry& entry : mEntries)
+        {
+            entry.target->Shutdown();
+        }
+        mEntries.clear();
+        mStats.targets = 0;
+        mStats.targetsInUse = 0;
+        mStats.gpuBytes = 0;
+    }
+
+    void TransientResourcePool::RemoveEntry(size_t index)
+    {
+        Entry& entry = mEntries[index];
+        entry.target->Shutdown();
+        --mStats.targets;
+        mStats.gpuBytes -= EstimateBytes(entry.key);
+
+        if (index + 1 != mEntries.size())
+        {
+            entry = std::move(mEntries.back());
+        }
+        mEntries.pop_back();
+    }
+}
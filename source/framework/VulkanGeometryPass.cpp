@@ -6,6 +6,7 @@
 #include "textures/Texture.h"
 #include "filesystem.h"
 #include "mesh/Vertex.h"
+#include <algorithm>
 #include <cstring>
 #include <stb_image.h>
 
@@ -105,6 +106,7 @@ void VulkanGeometryPass::Record(VkCommandBuffer commandBuffer, const std::vector
     // 3) Iterate render commands (draw path will be filled in later M1 tasks).
     gbuffer_.CmdTransitionForGeometryWrite(commandBuffer);
     UpdateCameraUbo();
+    lastStats_.Reset();
 
     std::vector<VkClearValue> clearValues = BuildClearValues();
     VkRenderPassBeginInfo beginInfo{};
@@ -120,53 +122,59 @@ void VulkanGeometryPass::Record(VkCommandBuffer commandBuffer, const std::vector
     if (pipeline_ != VK_NULL_HANDLE) {
         vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
 
-        // Minimal M1 draw path:
-        // Upload each fragment mesh into transient host-visible buffers and draw with
-        // a fixed Vertex layout { vec3 position, vec3 normal, vec2 texCoord }.
-        uint32_t drawObjectIndex = 0;
-        for (const auto& command : commands) {
-            if (!command.fragmentsSource) {
-                continue;
-            }
+        // Fragments are sorted by material / geometry; every run of identical geometry becomes one
+        // instanced draw. All transforms of the frame are written once into the instance buffer in
+        // queue order, so a run's firstInstance is simply its queue index.
+        queue_.Build(commands, 0, view_);
+        queue_.Sort();
+        const auto& items = queue_.GetItems();
+        queue_.GatherTransforms(0, items.size(), instanceTransforms_);
+        if (!instanceTransforms_.empty() && EnsureInstanceCapacity(static_cast<uint32_t>(instanceTransforms_.size()))) {
+            std::memcpy(instanceMapped_, instanceTransforms_.data(), instanceTransforms_.size() * sizeof(glm::mat4));
+        }
+        if (pipelineLayout_ != VK_NULL_HANDLE && descriptorSet_ != VK_NULL_HANDLE) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1, &descriptorSet_, 0, nullptr);
+        }
 
-            const auto& fragments = command.fragmentsSource->GetFragments();
-            for (const auto& fragment : fragments) {
-                if (fragment.mpGeometry == nullptr) {
-                    continue;
-                }
-                const auto vertices = fragment.mpGeometry->GetVertices();
-                const auto indices = fragment.mpGeometry->GetIndices();
-                if (vertices.empty() || indices.empty()) {
-                    continue;
-                }
+        VkBuffer boundVertexBuffer = VK_NULL_HANDLE;
+        const MaterialBase* boundMaterial = nullptr;
+        for (size_t begin = 0; begin < items.size() && begin < instanceCapacity_;) {
+            const size_t end = std::min<size_t>(queue_.NextBatch(begin), instanceCapacity_);
+            const RenderQueueItem& item = items[begin];
+            const size_t first = begin;
+            begin = end;
 
-                VulkanMeshBuffer meshBuffer{};
-                if (!GetOrCreateMeshBuffer(vertices, indices, meshBuffer)) {
-                    continue;
-                }
-                uint32_t dynamicOffset = 0;
-                if (!UpdateModelUbo(fragment.mpGeometry->GetWorldTransform(), drawObjectIndex, dynamicOffset)) {
-                    continue;
-                }
-                ++drawObjectIndex;
+            VulkanMeshBuffer meshBuffer{};
+            if (!GetOrCreateMeshBuffer(item.geometry->GetView(), meshBuffer)) {
+                continue;
+            }
 
+            if (meshBuffer.vertexBuffer != boundVertexBuffer) {
                 VkDeviceSize vertexOffset = 0;
                 vkCmdBindVertexBuffers(commandBuffer, 0, 1, &meshBuffer.vertexBuffer, &vertexOffset);
                 vkCmdBindIndexBuffer(commandBuffer, meshBuffer.indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-                if (pipelineLayout_ != VK_NULL_HANDLE && descriptorSet_ != VK_NULL_HANDLE) {
-                    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 0, 1, &descriptorSet_, 1, &dynamicOffset);
-                }
+                boundVertexBuffer = meshBuffer.vertexBuffer;
+            } else {
+                ++lastStats_.stateChangesAvoided;
+            }
+
+            if (item.material != boundMaterial && pipelineLayout_ != VK_NULL_HANDLE) {
+                const auto& material = item.command->fragmentsSource->GetMaterial();
                 VkDescriptorSet materialSet = VK_NULL_HANDLE;
-                if (GetOrCreateMaterialTextureSet(command.fragmentsSource->GetMaterial(), materialSet) &&
-                    pipelineLayout_ != VK_NULL_HANDLE && materialSet != VK_NULL_HANDLE) {
+                if (GetOrCreateMaterialTextureSet(material, materialSet) && materialSet != VK_NULL_HANDLE) {
                     vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout_, 1, 1, &materialSet, 0, nullptr);
                 }
-                if (pipelineLayout_ != VK_NULL_HANDLE) {
-                    const glm::vec4 matPush = MaterialPushParams(command.fragmentsSource->GetMaterial());
-                    vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(glm::vec4), &matPush);
-                }
-                vkCmdDrawIndexed(commandBuffer, meshBuffer.indexCount, 1, 0, 0, 0);
+                const glm::vec4 matPush = MaterialPushParams(material);
+                vkCmdPushConstants(commandBuffer, pipelineLayout_, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(glm::vec4), &matPush);
+                boundMaterial = item.material;
             }
+
+            const uint32_t instanceCount = static_cast<uint32_t>(end - first);
+            vkCmdDrawIndexed(commandBuffer, meshBuffer.indexCount, instanceCount, 0, 0, static_cast<uint32_t>(first));
+            ++lastStats_.drawCalls;
+            lastStats_.instances += instanceCount;
+            lastStats_.triangles += (meshBuffer.indexCount / 3) * instanceCount;
+            lastStats_.vertices += meshBuffer.vertexCount * instanceCount;
         }
     } else {
         (void)commands;
@@ -194,44 +202,36 @@ std::vector<VkClearValue> VulkanGeometryPass::BuildClearValues() const
     return clearValues;
 }
 
-size_t VulkanGeometryPass::HashMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+bool VulkanGeometryPass::GetOrCreateMeshBuffer(const GeometryView& view, VulkanMeshBuffer& outBuffer)
 {
-    constexpr size_t kFNVOffsetBasis = sizeof(size_t) == 8 ? 1469598103934665603ull : 2166136261u;
-    constexpr size_t kFNVPrime = sizeof(size_t) == 8 ? 1099511628211ull : 16777619u;
-    size_t hash = kFNVOffsetBasis;
-
-    auto hashBytes = [&hash, kFNVPrime](const uint8_t* bytes, size_t size) {
-        for (size_t i = 0; i < size; ++i) {
-            hash ^= static_cast<size_t>(bytes[i]);
-            hash *= kFNVPrime;
-        }
-    };
-    hashBytes(reinterpret_cast<const uint8_t*>(vertices.data()), vertices.size() * sizeof(Vertex));
-    hashBytes(reinterpret_cast<const uint8_t*>(indices.data()), indices.size() * sizeof(unsigned int));
-    return hash;
-}
+    if (!view.handle.IsValid()) {
+        return false;
+    }
 
-bool VulkanGeometryPass::GetOrCreateMeshBuffer(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, VulkanMeshBuffer& outBuffer)
-{
-    const size_t meshHash = HashMeshData(vertices, indices);
-    const auto it = meshBuffers_.find(meshHash);
+    auto it = meshBuffers_.find(view.handle.slot);
     if (it != meshBuffers_.end()) {
-        outBuffer = it->second;
-        return true;
+        if (it->second.generation == view.handle.generation) {
+            outBuffer = it->second;
+            return true;
+        }
+        // geometry was edited (or the slot recycled): previous frame has already retired on the frame fence
+        DestroyMeshBuffer(it->second);
+        meshBuffers_.erase(it);
     }
 
     VulkanMeshBuffer meshBuffer{};
-    const VkDeviceSize vertexDataSize = static_cast<VkDeviceSize>(vertices.size() * sizeof(Vertex));
-    const VkDeviceSize indexDataSize = static_cast<VkDeviceSize>(indices.size() * sizeof(uint32_t));
-    if (!UploadDeviceLocalBuffer(vertices.data(), vertexDataSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, meshBuffer.vertexBuffer, meshBuffer.vertexMemory) ||
-        !UploadDeviceLocalBuffer(indices.data(), indexDataSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, meshBuffer.indexBuffer, meshBuffer.indexMemory)) {
+    const VkDeviceSize vertexDataSize = static_cast<VkDeviceSize>(view.VertexBytes());
+    const VkDeviceSize indexDataSize = static_cast<VkDeviceSize>(view.IndexBytes());
+    if (!UploadDeviceLocalBuffer(view.vertices.data(), vertexDataSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, meshBuffer.vertexBuffer, meshBuffer.vertexMemory) ||
+        !UploadDeviceLocalBuffer(view.indices.data(), indexDataSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, meshBuffer.indexBuffer, meshBuffer.indexMemory)) {
         DestroyMeshBuffer(meshBuffer);
         return false;
     }
 
-    meshBuffer.vertexCount = static_cast<uint32_t>(vertices.size());
-    meshBuffer.indexCount = static_cast<uint32_t>(indices.size());
-    meshBuffers_.emplace(meshHash, meshBuffer);
+    meshBuffer.vertexCount = static_cast<uint32_t>(view.vertices.size());
+    meshBuffer.indexCount = static_cast<uint32_t>(view.indices.size());
+    meshBuffer.generation = view.handle.generation;
+    meshBuffers_.emplace(view.handle.slot, meshBuffer);
     outBuffer = meshBuffer;
     return true;
 }
@@ -373,22 +373,13 @@ bool VulkanGeometryPass::CreatePerObjectDescriptorResources()
                       cameraUboBuffer_, cameraUboMemory_)) {
         return false;
     }
-    const VkDeviceSize minAlignment = vk::GraphicsBase::Base().PhysicalDeviceProperties().limits.minUniformBufferOffsetAlignment;
-    modelUboStride_ = static_cast<uint32_t>((sizeof(ModelUbo) + minAlignment - 1) / minAlignment * minAlignment);
-    modelUboCapacity_ = 1024;
-    if (!CreateBuffer(static_cast<VkDeviceSize>(modelUboStride_) * modelUboCapacity_, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                      modelUboBuffer_, modelUboMemory_)) {
-        return false;
-    }
-
     VkDescriptorSetLayoutBinding bindings[2]{};
     bindings[0].binding = 0;
     bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     bindings[0].descriptorCount = 1;
     bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     bindings[1].binding = 1;
-    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     bindings[1].descriptorCount = 1;
     bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
@@ -405,14 +396,14 @@ bool VulkanGeometryPass::CreatePerObjectDescriptorResources()
     poolSizes[0].descriptorCount = 1;
     poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     poolSizes[1].descriptorCount = 1;
-    VkDescriptorPoolSize dynamicUboPoolSize{};
-    dynamicUboPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-    dynamicUboPoolSize.descriptorCount = 1;
+    VkDescriptorPoolSize instancePoolSize{};
+    instancePoolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    instancePoolSize.descriptorCount = 1;
     if (descriptorPool_ == VK_NULL_HANDLE) {
         VkDescriptorPoolCreateInfo poolCi{};
         poolCi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolCi.maxSets = 2;
-        VkDescriptorPoolSize allPoolSizes[3] = { poolSizes[0], poolSizes[1], dynamicUboPoolSize };
+        VkDescriptorPoolSize allPoolSizes[3] = { poolSizes[0], poolSizes[1], instancePoolSize };
         poolCi.poolSizeCount = 3;
         poolCi.pPoolSizes = allPoolSizes;
         if (vkCreateDescriptorPool(vk::GraphicsBase::Base().Device(), &poolCi, nullptr, &descriptorPool_) != VK_SUCCESS) {
@@ -430,22 +421,15 @@ bool VulkanGeometryPass::CreatePerObjectDescriptorResources()
     }
 
     VkDescriptorBufferInfo cameraInfo{ cameraUboBuffer_, 0, sizeof(CameraUbo) };
-    VkDescriptorBufferInfo modelInfo{ modelUboBuffer_, 0, sizeof(ModelUbo) };
-    VkWriteDescriptorSet writes[2]{};
-    writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[0].dstSet = descriptorSet_;
-    writes[0].dstBinding = 0;
-    writes[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    writes[0].descriptorCount = 1;
-    writes[0].pBufferInfo = &cameraInfo;
-    writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    writes[1].dstSet = descriptorSet_;
-    writes[1].dstBinding = 1;
-    writes[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-    writes[1].descriptorCount = 1;
-    writes[1].pBufferInfo = &modelInfo;
-    vkUpdateDescriptorSets(vk::GraphicsBase::Base().Device(), 2, writes, 0, nullptr);
-    return true;
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptorSet_;
+    write.dstBinding = 0;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &cameraInfo;
+    vkUpdateDescriptorSets(vk::GraphicsBase::Base().Device(), 1, &write, 0, nullptr);
+    return EnsureInstanceCapacity(1024);
 }
 
 void VulkanGeometryPass::DestroyPerObjectDescriptorResources()
@@ -458,14 +442,16 @@ void VulkanGeometryPass::DestroyPerObjectDescriptorResources()
         vkFreeMemory(vk::GraphicsBase::Base().Device(), cameraUboMemory_, nullptr);
         cameraUboMemory_ = VK_NULL_HANDLE;
     }
-    if (modelUboBuffer_ != VK_NULL_HANDLE) {
-        vkDestroyBuffer(vk::GraphicsBase::Base().Device(), modelUboBuffer_, nullptr);
-        modelUboBuffer_ = VK_NULL_HANDLE;
+    if (instanceBuffer_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(vk::GraphicsBase::Base().Device(), instanceBuffer_, nullptr);
+        instanceBuffer_ = VK_NULL_HANDLE;
     }
-    if (modelUboMemory_ != VK_NULL_HANDLE) {
-        vkFreeMemory(vk::GraphicsBase::Base().Device(), modelUboMemory_, nullptr);
-        modelUboMemory_ = VK_NULL_HANDLE;
+    if (instanceMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(vk::GraphicsBase::Base().Device(), instanceMemory_, nullptr);
+        instanceMemory_ = VK_NULL_HANDLE;
     }
+    instanceMapped_ = nullptr;
+    instanceCapacity_ = 0;
     descriptorSet_ = VK_NULL_HANDLE;
     if (descriptorSetLayout_ != VK_NULL_HANDLE) {
         vkDestroyDescriptorSetLayout(vk::GraphicsBase::Base().Device(), descriptorSetLayout_, nullptr);
@@ -763,27 +749,59 @@ bool VulkanGeometryPass::UpdateCameraUbo() const
     return true;
 }
 
-bool VulkanGeometryPass::UpdateModelUbo(const glm::mat4& model, uint32_t objectIndex, uint32_t& outDynamicOffset) const
+bool VulkanGeometryPass::EnsureInstanceCapacity(uint32_t instanceCount)
 {
-    if (modelUboMemory_ == VK_NULL_HANDLE) {
-        return false;
+    if (instanceCount <= instanceCapacity_ && instanceMapped_ != nullptr) {
+        return true;
     }
-    if (modelUboStride_ == 0 || modelUboCapacity_ == 0) {
+    if (descriptorSet_ == VK_NULL_HANDLE) {
         return false;
     }
-    const uint32_t slot = objectIndex % modelUboCapacity_;
-    outDynamicOffset = slot * modelUboStride_;
 
-    ModelUbo modelUbo{};
-    modelUbo.model = model;
-    void* mapped = nullptr;
-    if (vkMapMemory(vk::GraphicsBase::Base().Device(), modelUboMemory_, outDynamicOffset, sizeof(ModelUbo), 0, &mapped) != VK_SUCCESS) {
+    uint32_t capacity = instanceCapacity_ > 0 ? instanceCapacity_ : 1024u;
+    while (capacity < instanceCount) {
+        capacity *= 2;
+    }
+
+    // the previous frame has retired on the frame fence before Record, so the old buffer can go
+    if (instanceBuffer_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(vk::GraphicsBase::Base().Device(), instanceBuffer_, nullptr);
+        instanceBuffer_ = VK_NULL_HANDLE;
+    }
+    if (instanceMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(vk::GraphicsBase::Base().Device(), instanceMemory_, nullptr);
+        instanceMemory_ = VK_NULL_HANDLE;
+    }
+    instanceMapped_ = nullptr;
+    instanceCapacity_ = 0;
+
+    const VkDeviceSize size = static_cast<VkDeviceSize>(capacity) * sizeof(glm::mat4);
+    if (!CreateBuffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      instanceBuffer_, instanceMemory_)) {
         return false;
     }
-    std::memcpy(mapped, &modelUbo, sizeof(ModelUbo));
-    vkUnmapMemory(vk::GraphicsBase::Base().Device(), modelUboMemory_);
+    if (vkMapMemory(vk::GraphicsBase::Base().Device(), instanceMemory_, 0, size, 0, &instanceMapped_) != VK_SUCCESS) {
+        instanceMapped_ = nullptr;
+        return false;
+    }
+    instanceCapacity_ = capacity;
+    WriteInstanceDescriptor();
     return true;
 }
 
+void VulkanGeometryPass::WriteInstanceDescriptor()
+{
+    VkDescriptorBufferInfo instanceInfo{ instanceBuffer_, 0, VK_WHOLE_SIZE };
+    VkWriteDescriptorSet write{};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = descriptorSet_;
+    write.dstBinding = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.descriptorCount = 1;
+    write.pBufferInfo = &instanceInfo;
+    vkUpdateDescriptorSets(vk::GraphicsBase::Base().Device(), 1, &write, 0, nullptr);
+}
+
 } // namespace te
 
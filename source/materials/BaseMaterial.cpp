@@ -11,6 +11,33 @@ MaterialBase::MaterialBase(const std::string& vs_path, const std::string& fs_pat
 	mpShader = std::make_shared<Shader>(vs_path.c_str(), fs_path.c_str());
 }
 
+MaterialBase::MaterialBase(const std::string& vs_path, const std::string& fs_path, std::vector<std::string> featureDefines)
+    : mVertexPath(vs_path)
+    , mFragmentPath(fs_path)
+    , mFeatureDefines(std::move(featureDefines))
+{
+    // compiled lazily by GetShader() once the features are known
+}
+
+std::shared_ptr<Shader> MaterialBase::GetShader() const
+{
+    if (!mFeatureDefines.empty())
+    {
+        const te::ShaderVariantMask mask = FeatureMask();
+        if (!mpShader || mask != mResolvedMask)
+        {
+            mpShader = te::ShaderVariantCache::GetInstance().Get(mVertexPath, mFragmentPath, mFeatureDefines, mask);
+            mResolvedMask = mask;
+        }
+    }
+    return mpShader;
+}
+
+void MaterialBase::SetFeature(te::ShaderVariantMask feature, bool enabled)
+{
+    mFeatureMask = enabled ? (mFeatureMask | feature) : (mFeatureMask & ~feature);
+}
+
 void MaterialBase::AttachedCamera(const std::shared_ptr<Camera>& pcamera)
 {
     mpAttachedCamera = pcamera;
@@ -23,7 +50,7 @@ void MaterialBase::AttachedLight(const std::shared_ptr<Light>& pLight)
 
 void MaterialBase::OnApply()
 {
-    mpShader->use();
+    GetShader()->use();
 }
 
 UnlitMaterial::UnlitMaterial(const std::string& vs_path, const std::string& fs_path)
@@ -52,13 +79,7 @@ void UnlitMaterial::OnPerFrameUpdate()
 
 void UnlitMaterial::UpdateUniform()
 {
-    // Note: model matrix is set by the renderer, don't override it here
-    
-    if (auto pCamera = mpAttachedCamera.lock())
-    {
-        mpShader->setMat4("view", pCamera->GetViewMatrix());
-        mpShader->setMat4("projection", pCamera->GetProjectionMatrix());
-    }
+    // Note: model matrix is set by the renderer, camera comes from the FrameData block
 
     // Set lighting parameters
     mpShader->setVec3("objectColor", glm::vec3(0.7f, 0.3f, 0.3f));
@@ -78,10 +99,10 @@ void UnlitMaterial::SetTexturePath(const std::string& path)
 }
 
 PhongMaterial::PhongMaterial(const std::string& vs_path, const std::string& fs_path)
-	: MaterialBase(vs_path, fs_path)
+	: MaterialBase(vs_path, fs_path, { "USE_BLINN", "USE_GEOMETRY_TARGET", "USE_SHADOW", "USE_PCF" })
     , mpDiffuseTexture(std::make_shared<Texture2D>())
 {
-    mUseEnables = glm::vec4(0.0f, 0.0f, 0.0f, 0.0f);
+    SetFeature(kFeaturePCF, true);
 }
 
 PhongMaterial::~PhongMaterial()
@@ -109,7 +130,7 @@ void PhongMaterial::OnBind()
         }
     }
 
-    if (mShadowEnabled && mShadowMap != 0)
+    if (HasFeature(kFeatureShadow) && mShadowMap != 0)
     {
         glActiveTexture(GL_TEXTURE0 + kShadowTextureUnit);
         glBindTexture(GL_TEXTURE_2D, mShadowMap);
@@ -127,38 +148,22 @@ void PhongMaterial::UnBind()
 
 void PhongMaterial::UpdateUniform()
 {
-    // Note: model matrix is set by the renderer, don't override it here
+    // Note: model matrix is set by the renderer; camera, light and
+    // light-space matrix come from the FrameData block.
+    // Blinn / geometry target / shadow / PCF are compiled into the variant, no uniforms for them.
+    const auto pShader = GetShader();
 
-    if (auto pCamera = mpAttachedCamera.lock())
-    {
-        mpShader->setMat4("view", pCamera->GetViewMatrix());
-        mpShader->setMat4("projection", pCamera->GetProjectionMatrix());
-        mpShader->setVec3("u_viewPos", pCamera->GetEye());
-    }
+    pShader->setVec3("u_objectColor", glm::vec3(0.7f, 0.3f, 0.3f));
+    pShader->setVec4("u_Strengths", mIntensities);
     
-    mpShader->setVec3("u_objectColor", glm::vec3(0.7f, 0.3f, 0.3f));
-    mpShader->setVec4("u_Strengths", mIntensities);
-    
-    mpShader->setInt("u_diffuseTexture", 0);
-    mpShader->setInt("u_geomAlbedoMap", 1);
-    mpShader->setInt("u_geomNormalMap", 2);
-    mpShader->setInt("u_geomPositionMap", 3);
-    mpShader->setInt("u_geomDepthMap", 4);
-
-    // Set lighting parameters
-    if (auto pLight = mpAttachedLight.lock())
-    {
-        mpShader->setVec3("u_lightColor", pLight->GetColor());
-        mpShader->setVec3("u_lightPos", pLight->GetPosition());
-    }
-
-    mpShader->setVec4("u_useBlinn_Geometry", mUseEnables);
+    pShader->setInt("u_diffuseTexture", 0);
+    pShader->setInt("u_geomAlbedoMap", 1);
+    pShader->setInt("u_geomNormalMap", 2);
+    pShader->setInt("u_geomPositionMap", 3);
+    pShader->setInt("u_geomDepthMap", 4);
 
-    mpShader->setMat4("u_lightSpaceMatrix", mLightSpaceMatrix);
-    mpShader->setInt("u_shadowMap", kShadowTextureUnit);
-    mpShader->setFloat("u_enableShadow", mShadowEnabled ? 1.0f : 0.0f);
-    mpShader->setFloat("u_shadowBias", mShadowBias);
-    mpShader->setFloat("u_enablePCF", mShadowPCFEnabled ? 1.0f : 0.0f);
+    pShader->setInt("u_shadowMap", kShadowTextureUnit);
+    pShader->setFloat("u_shadowBias", mShadowBias);
 }
 
 void PhongMaterial::SetDiffuseTexturePath(const std::string& path)
@@ -175,5 +180,5 @@ void PhongMaterial::SetDiffuseTexturePath(const std::string& path)
 
 void PhongMaterial::SetUseGeometryTarget(bool use)
 {
-    mUseEnables[1] = use ? 1.0f : 0.0f;
+    SetFeature(kFeatureGeometryTarget, use);
 }
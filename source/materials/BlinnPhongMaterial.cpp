@@ -3,7 +3,7 @@
 BlinnPhongMaterial::BlinnPhongMaterial(const std::string& vs_path, const std::string& fs_path)
     : PhongMaterial(vs_path, fs_path)
 {
-    mUseEnables[0] = 1.0f; //use blinnphong
+    SetFeature(kFeatureBlinn, true); //use blinnphong
 }
 
 BlinnPhongMaterial::~BlinnPhongMaterial()
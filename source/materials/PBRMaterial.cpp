@@ -6,8 +6,10 @@
 #include <iostream>
 
 PBRMaterial::PBRMaterial(const std::string& vs_path, const std::string& fs_path)
-    : MaterialBase(vs_path, fs_path)
+    : MaterialBase(vs_path, fs_path, { "USE_SHADOW", "USE_PCF", "HAS_ALBEDO_MAP", "HAS_NORMAL_MAP",
+        "HAS_METALLIC_MAP", "HAS_ROUGHNESS_MAP", "HAS_AO_MAP" })
 {
+    SetFeature(kFeaturePCF, true);
 }
 
 PBRMaterial::~PBRMaterial()
@@ -52,7 +54,7 @@ void PBRMaterial::OnBind()
         glBindTexture(GL_TEXTURE_2D, mpAOTexture->GetHandle());
     }
 
-    if (mShadowEnabled && mShadowMap != 0)
+    if (HasFeature(kFeatureShadow) && mShadowMap != 0)
     {
         glActiveTexture(GL_TEXTURE0 + kShadowTextureUnit);
         glBindTexture(GL_TEXTURE_2D, mShadowMap);
@@ -69,61 +71,47 @@ void PBRMaterial::UnBind()
     }
 }
 
-void PBRMaterial::UpdateUniform()
+te::ShaderVariantMask PBRMaterial::FeatureMask() const
 {
-    // Note: model matrix is set by the renderer, don't override it here
+    auto valid = [](const std::shared_ptr<TextureBase>& texture) { return texture && texture->IsValid(); };
+
+    te::ShaderVariantMask mask = MaterialBase::FeatureMask();
+    mask |= valid(mpAlbedoTexture) ? kFeatureAlbedoMap : 0u;
+    mask |= valid(mpNormalTexture) ? kFeatureNormalMap : 0u;
+    mask |= valid(mpMetallicTexture) ? kFeatureMetallicMap : 0u;
+    mask |= valid(mpRoughnessTexture) ? kFeatureRoughnessMap : 0u;
+    mask |= valid(mpAOTexture) ? kFeatureAOMap : 0u;
+    return mask;
+}
 
-    if (auto pCamera = mpAttachedCamera.lock())
-    {
-        mpShader->setMat4("view", pCamera->GetViewMatrix());
-        mpShader->setMat4("projection", pCamera->GetProjectionMatrix());
-        mpShader->setVec3("u_viewPos", pCamera->GetEye());
-    }
+void PBRMaterial::UpdateUniform()
+{
+    // Note: model matrix is set by the renderer; camera, light and
+    // light-space matrix come from the FrameData block.
+    // Which maps are bound, shadows and PCF are compiled into the variant (see FeatureMask()).
+    const auto pShader = GetShader();
 
     // Set material properties (fallback when textures are not available)
-    mpShader->setVec3("u_albedo", mAlbedo);
-    mpShader->setFloat("u_metallic", mMetallic);
-    mpShader->setFloat("u_roughness", mRoughness);
-    mpShader->setFloat("u_ao", mAO);
+    pShader->setVec3("u_albedo", mAlbedo);
+    pShader->setFloat("u_metallic", mMetallic);
+    pShader->setFloat("u_roughness", mRoughness);
+    pShader->setFloat("u_ao", mAO);
 
     // Set texture unit indices
-    mpShader->setInt("u_albedoMap", 0);
-    mpShader->setInt("u_normalMap", 1);
-    mpShader->setInt("u_metallicMap", 2);
-    mpShader->setInt("u_roughnessMap", 3);
-    mpShader->setInt("u_aoMap", 4);
-
-    // Set texture flags (which textures are available)
-    glm::vec4 hasTextures(
-        (mpAlbedoTexture && mpAlbedoTexture->IsValid()) ? 1.0f : 0.0f,
-        (mpNormalTexture && mpNormalTexture->IsValid()) ? 1.0f : 0.0f,
-        (mpMetallicTexture && mpMetallicTexture->IsValid()) ? 1.0f : 0.0f,
-        (mpRoughnessTexture && mpRoughnessTexture->IsValid()) ? 1.0f : 0.0f
-    );
-    mpShader->setVec4("u_hasTextures", hasTextures);
-
-    // Set lighting parameters
-    if (auto pLight = mpAttachedLight.lock())
-    {
-        mpShader->setVec3("u_lightColor", pLight->GetColor());
-        mpShader->setVec3("u_lightPos", pLight->GetPosition());
-    }
-    
+    pShader->setInt("u_albedoMap", 0);
+    pShader->setInt("u_normalMap", 1);
+    pShader->setInt("u_metallicMap", 2);
+    pShader->setInt("u_roughnessMap", 3);
+    pShader->setInt("u_aoMap", 4);
+
     // Set brightness and lighting controls
     // Note: u_intensities.x = ambient, u_intensities.y = light (as per shader comment)
     glm::vec2 intensities(mAmbientIntensity, mLightIntensity);
-    mpShader->setVec2("u_intensities", intensities);
-    mpShader->setFloat("u_exposure", mExposure);
-    
-    // Disable IBL by default (can be enabled later if needed)
-    glm::vec2 use_ibl_ao(0.0f, (mpAOTexture && mpAOTexture->IsValid()) ? 1.0f : 0.0f);
-    mpShader->setVec2("u_useIBL_ao", use_ibl_ao);
-
-    mpShader->setMat4("u_lightSpaceMatrix", mLightSpaceMatrix);
-    mpShader->setInt("u_shadowMap", kShadowTextureUnit);
-    mpShader->setFloat("u_enableShadow", mShadowEnabled ? 1.0f : 0.0f);
-    mpShader->setFloat("u_shadowBias", mShadowBias);
-    mpShader->setFloat("u_enablePCF", mShadowPCFEnabled ? 1.0f : 0.0f);
+    pShader->setVec2("u_intensities", intensities);
+    pShader->setFloat("u_exposure", mExposure);
+
+    pShader->setInt("u_shadowMap", kShadowTextureUnit);
+    pShader->setFloat("u_shadowBias", mShadowBias);
 }
 void PBRMaterial::SetAlbedoTexturePath(const std::string& path)
 {
@@ -15,6 +15,6 @@ namespace te
         {
             return;
         }
-        mpShader->setMat4("lightSpaceMatrix", mLightSpaceMatrix);
+        mpShader->setMat4(uniform::LightSpaceMatrix, mLightSpaceMatrix);
     }
 }
@@ -81,7 +81,7 @@ void SkyboxMaterial::UpdateUniform()
     mpShader->setInt("u_skyboxMap", 0); // Background texture
     
     // Debug: Check if uniform was set correctly
-    GLint uniformLocation = glGetUniformLocation(mpShader->GetID(), "u_skyboxMap");
+    GLint uniformLocation = mpShader->GetUniformLocation("u_skyboxMap");
     if (uniformLocation == -1) {
         std::cout << "ERROR: SkyboxMaterial::UpdateUniform() - u_skyboxMap uniform not found in shader!" << std::endl;
     } else {
@@ -0,0 +1,50 @@
+#include "memory/FrameAllocator.h"
+#include <algorithm>
+
+namespace te
+{
+    FrameAllocator& FrameAllocator::GetInstance()
+    {
+        static FrameAllocator instance;
+        return instance;
+    }
+
+    FrameAllocator::FrameAllocator(uint32_t bufferCount, size_t blockSize)
+        : mBufferCount(std::clamp(bufferCount, 2u, kMaxBuffers))
+    {
+        for (LinearArena& arena : mArenas)
+        {
+            arena = LinearArena(blockSize);
+        }
+    }
+
+    void FrameAllocator::SetBufferCount(uint32_t count)
+    {
+        mBufferCount = std::clamp(count, 2u, kMaxBuffers);
+        mCurrent = 0;
+        for (LinearArena& arena : mArenas)
+        {
+            arena.Reset();
+        }
+        mHeapAllocationsAtBegin = mArenas[mCurrent].GetHeapAllocationCount();
+    }
+
+    void FrameAllocator::BeginFrame()
+    {
+        // the arena reused now was last written mBufferCount - 1 frames ago
+        mCurrent = (mCurrent + 1) % mBufferCount;
+        mArenas[mCurrent].Reset();
+        mHeapAllocationsAtBegin = mArenas[mCurrent].GetHeapAllocationCount();
+        ++mFrameIndex;
+    }
+
+    FrameAllocatorStats FrameAllocator::GetFrameStats() const
+    {
+        const LinearArena& arena = mArenas[mCurrent];
+        FrameAllocatorStats stats;
+        stats.allocations = arena.GetAllocationCount();
+        stats.bytes = arena.GetUsedBytes();
+        stats.heapAllocations = uint32_t(arena.GetHeapAllocationCount() - mHeapAllocationsAtBegin);
+        return stats;
+    }
+}
@@ -0,0 +1,62 @@
+#include "memory/LinearArena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace te
+{
+    LinearArena::LinearArena(size_t blockSize)
+        : mBlockSize(std::max<size_t>(blockSize, 256))
+    {
+    }
+
+    void LinearArena::AddBlock(size_t minSize)
+    {
+        // grow geometrically so a frame that outgrows the arena needs few extra blocks
+        const size_t size = std::max({ minSize, mBlockSize, mCapacity });
+        mBlocks.push_back({ std::make_unique<std::byte[]>(size), size });
+        mCapacity += size;
+        ++mHeapAllocations;
+        mOffset = 0;
+    }
+
+    void* LinearArena::Allocate(size_t size, size_t alignment)
+    {
+        ++mAllocations;
+        if (!mBlocks.empty())
+        {
+            Block& block = mBlocks.back();
+            const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+            const uintptr_t aligned = (base + mOffset + alignment - 1) & ~uintptr_t(alignment - 1);
+            const size_t offset = size_t(aligned - base);
+            if (offset + size <= block.size)
+            {
+                mUsed += offset + size - mOffset;
+                mOffset = offset + size;
+                return block.data.get() + offset;
+            }
+        }
+
+        AddBlock(size + alignment);
+        Block& block = mBlocks.back();
+        const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t offset = size_t(((base + alignment - 1) & ~uintptr_t(alignment - 1)) - base);
+        mUsed += offset + size;
+        mOffset = offset + size;
+        return block.data.get() + offset;
+    }
+
+    void LinearArena::Reset()
+    {
+        // the next frame gets one block as large as everything this one needed
+        if (mBlocks.size() > 1)
+        {
+            const size_t capacity = mCapacity;
+            mBlocks.clear();
+            mCapacity = 0;
+            AddBlock(capacity);
+        }
+        mOffset = 0;
+        mUsed = 0;
+        mAllocations = 0;
+    }
+}
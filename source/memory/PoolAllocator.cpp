@@ -0,0 +1,53 @@
+#include "memory/PoolAllocator.h"
+#include <algorithm>
+
+namespace te
+{
+    PoolAllocator::PoolAllocator(size_t blockSize, size_t alignment, size_t blocksPerChunk)
+        : mAlignment(std::max(alignment, alignof(FreeBlock)))
+        , mBlocksPerChunk(std::max<size_t>(blocksPerChunk, 1))
+    {
+        // every block has to hold the free list link and keep the next block aligned
+        const size_t size = std::max(blockSize, sizeof(FreeBlock));
+        mBlockSize = (size + mAlignment - 1) & ~(mAlignment - 1);
+    }
+
+    void PoolAllocator::AddChunk()
+    {
+        // over-allocate so the first block can be aligned beyond what new[] guarantees
+        auto chunk = std::make_unique<std::byte[]>(mBlockSize * mBlocksPerChunk + mAlignment);
+        const auto base = reinterpret_cast<uintptr_t>(chunk.get());
+        std::byte* first = chunk.get() + (((base + mAlignment - 1) & ~uintptr_t(mAlignment - 1)) - base);
+
+        // thread the new blocks onto the free list in address order
+        for (size_t i = mBlocksPerChunk; i-- > 0;)
+        {
+            auto* block = reinterpret_cast<FreeBlock*>(first + i * mBlockSize);
+            block->next = mpFreeList;
+            mpFreeList = block;
+        }
+        mChunks.push_back(std::move(chunk));
+    }
+
+    void* PoolAllocator::Allocate()
+    {
+        if (!mpFreeList)
+        {
+            AddChunk();
+        }
+        FreeBlock* block = mpFreeList;
+        mpFreeList = block->next;
+        ++mLive;
+        return block;
+    }
+
+    void PoolAllocator::Free(void* block) noexcept
+    {
+        if (!block)
+            return;
+        auto* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = mpFreeList;
+        mpFreeList = freeBlock;
+        --mLive;
+    }
+}
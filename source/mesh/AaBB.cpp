@@ -1,6 +1,9 @@
 #include "mesh/AaBB.h"
 #include "math/GTSIMD.h"
+#include "framework/JobSystem.h"
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 //#define GLM_FORCE_SWIZZLE
 #include <glm/gtc/quaternion.hpp>
@@ -199,18 +202,40 @@ namespace te
 	{
 		makeEmpty(_outAabb);
 
-		uint8_t* vertex = (uint8_t*)_vertices;
-		for (uint32_t ii = 0; ii < _numVertices; ++ii)
+		const uint8_t* positions = static_cast<const uint8_t*>(_vertices) + positionOffset;
+		auto accumulate = [positions, _stride](AaBB& bounds, size_t begin, size_t end)
 		{
-			vertex += positionOffset;
-			float* p = (float*)vertex;
+			for (size_t ii = begin; ii < end; ++ii)
+			{
+				const float* p = reinterpret_cast<const float*>(positions + ii * _stride);
+				const glm::vec3 pos = { p[0], p[1], p[2] };
 
-			glm::vec3 pos = { p[0], p[1], p[2] };
+				bounds.min = glm::min(pos, bounds.min);
+				bounds.max = glm::max(pos, bounds.max);
+			}
+		};
+
+		// large meshes (scans, loaded models) are split over the job system, one partial box per chunk
+		constexpr size_t kGrain = 64 * 1024;
+		if (_numVertices <= kGrain)
+		{
+			accumulate(_outAabb, 0, _numVertices);
+			return;
+		}
 
-			_outAabb.min = glm::min(pos, _outAabb.min);
-			_outAabb.max = glm::max(pos, _outAabb.max);
+		std::vector<AaBB> partials((_numVertices + kGrain - 1) / kGrain, _outAabb);
+		JobSystem::GetInstance().ParallelFor(partials.size(), 1, [&](size_t first, size_t last)
+		{
+			for (size_t chunk = first; chunk < last; ++chunk)
+			{
+				accumulate(partials[chunk], chunk * kGrain, std::min<size_t>(_numVertices, (chunk + 1) * kGrain));
+			}
+		});
 
-			vertex += _stride;
+		for (const AaBB& partial : partials)
+		{
+			_outAabb.min = glm::min(partial.min, _outAabb.min);
+			_outAabb.max = glm::max(partial.max, _outAabb.max);
 		}
 	}
 }
\ No newline at end of file
@@ -6,43 +6,6 @@ namespace
     const glm::mat4 sEntityMat = glm::mat4(1.0f);
 }
 
-void Mesh::SetupMeshBuffers(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, uint32_t& vao, uint32_t& vbo, uint32_t& ebo)
-{
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-
-    glBindVertexArray(vao);
-
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-
-    // position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-    // normal attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    // UV attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-
-    glBindVertexArray(0);
-}
-
-void Mesh::CleanupMeshBuffers(uint32_t vao, uint32_t vbo, uint32_t ebo)
-{
-    glDeleteVertexArrays(1, &vao);
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
-}
-
-
 Mesh::Mesh(/* args */)
 {
     AddFragment(true);
@@ -50,6 +13,11 @@ Mesh::Mesh(/* args */)
 
 Mesh::~Mesh()
 {
+    // geometry is owned by the mesh that generated it; releasing it evicts the GPU copy
+    ForeachFragment([](Fragment& frag, uint8_t) {
+        delete frag.mpGeometry;
+        frag.mpGeometry = nullptr;
+    });
 }
 
 void Mesh::SetLocalTransform(const glm::mat4& trn)
@@ -100,7 +68,7 @@ void Mesh::OnPrepareRenderFrame()
         });
 }
 
-void Mesh::Draw(std::unordered_map<size_t, MeshCache>& meshCache, RenderStats& stats)
+void Mesh::Draw(RenderStats& stats)
 {
     ForeachFragment([&](Fragment& frag, uint8_t fragIdx) {
         if (!frag.IsReady())
@@ -112,32 +80,20 @@ void Mesh::Draw(std::unordered_map<size_t, MeshCache>& meshCache, RenderStats& s
         pMaterial->UpdateUniform();
         pMaterial->OnBind();
 
-        const auto& vertices = frag.mpGeometry->GetVertices();
-        const auto& indices = frag.mpGeometry->GetIndices();
-
-        // calculate mesh hash for caching
-        size_t meshHash = std::hash<std::string>{}(std::string((char*)vertices.data(), vertices.size() * sizeof(Vertex))) ^
-            std::hash<std::string>{}(std::string((char*)indices.data(), indices.size() * sizeof(unsigned int)));
-
-        // find or create cached mesh data
-        auto it = meshCache.find(meshHash);
-        if (it == meshCache.end())
+        const MeshCache* cache = te::MeshRegistry::GetInstance().Acquire(*frag.mpGeometry);
+        if (!cache)
         {
-            MeshCache cache;
-            SetupMeshBuffers(vertices, indices, cache.vao, cache.vbo, cache.ebo);
-            cache.vertexCount = vertices.size();
-            cache.indexCount = indices.size();
-            meshCache[meshHash] = cache;
-            it = meshCache.find(meshHash);
+            return;
         }
 
-        glBindVertexArray(it->second.vao);
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(it->second.indexCount), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(cache->vao);
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(cache->indexCount), GL_UNSIGNED_INT, 0);
         glBindVertexArray(0);
 
         stats.drawCalls++;
-        stats.triangles += uint32_t(frag.mpGeometry->GetIndices().size()) / 3;
-        stats.vertices += uint32_t(frag.mpGeometry->GetVertices().size());
+        stats.instances++;
+        stats.triangles += uint32_t(cache->indexCount) / 3;
+        stats.vertices += uint32_t(cache->vertexCount);
     });
 }
 
@@ -150,9 +106,9 @@ void Mesh::DoGenerateMesh(const Vertex* vertices, uint32_t numVertices, const in
 
     auto& currentFrag = GetDefaultFragment();
 
-    // Ensure we have a geometry container. Since GeometryItem caches GPU buffers,
-    // we only create it once; the current renderer path uses CPU-side
-    // vertices/indices (hash-cached) for drawing.
+    // Ensure we have a geometry container. It keeps a stable MeshRegistry slot,
+    // so we only create it once; editing the data below bumps its generation
+    // and the GPU copy is re-uploaded on the next draw.
     if (!currentFrag.mpGeometry)
     {
         currentFrag.mpGeometry = new GeometryItem();
@@ -0,0 +1,241 @@
+#include "mesh/MeshRegistry.h"
+#include "Fragment.h"
+#include "glad/glad.h"
+
+namespace te
+{
+    namespace
+    {
+        constexpr GLuint kMaxVertexAttribLocation = 3;
+
+        void UploadGeometry(const GeometryView& view, MeshCache& cache)
+        {
+            glBindVertexArray(cache.vao);
+
+            glBindBuffer(GL_ARRAY_BUFFER, cache.vbo);
+            glBufferData(GL_ARRAY_BUFFER, view.VertexBytes(), view.vertices.data(), GL_STATIC_DRAW);
+
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cache.ebo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, view.IndexBytes(), view.indices.data(), GL_STATIC_DRAW);
+
+            // attribute pointers straight from the layout descriptor
+            bool enabled[kMaxVertexAttribLocation] = {};
+            for (const auto& attribute : view.layout.Attributes())
+            {
+                glEnableVertexAttribArray(attribute.location);
+                glVertexAttribPointer(attribute.location, GLint(attribute.components), GL_FLOAT, GL_FALSE,
+                    GLsizei(view.layout.stride), (void*)uintptr_t(attribute.offset));
+                if (attribute.location < kMaxVertexAttribLocation)
+                {
+                    enabled[attribute.location] = true;
+                }
+            }
+            for (GLuint location = 0; location < kMaxVertexAttribLocation; ++location)
+            {
+                if (!enabled[location])
+                {
+                    glDisableVertexAttribArray(location);
+                }
+            }
+
+            glBindVertexArray(0);
+
+            cache.vertexCount = view.vertices.size();
+            cache.indexCount = view.indices.size();
+        }
+    }
+
+    MeshRegistry& MeshRegistry::GetInstance()
+    {
+        static MeshRegistry instance;
+        return instance;
+    }
+
+    uint32_t MeshRegistry::RegisterSlot()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        uint32_t slot = 0;
+        if (!mFreeSlots.empty())
+        {
+            slot = mFreeSlots.back();
+            mFreeSlots.pop_back();
+        }
+        else
+        {
+            slot = uint32_t(mEntries.size());
+            mEntries.emplace_back();
+        }
+
+        mEntries[slot] = Entry{};
+        mEntries[slot].alive = true;
+        return slot;
+    }
+
+    void MeshRegistry::ReleaseSlot(uint32_t slot)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (slot >= mEntries.size() || !mEntries[slot].alive)
+        {
+            return;
+        }
+
+        auto& entry = mEntries[slot];
+        entry.alive = false;
+
+        // never reached the GPU (e.g. Vulkan backend): the slot can be reused right away
+        if (!entry.uploaded)
+        {
+            mFreeSlots.push_back(slot);
+            return;
+        }
+
+        // GL objects can only be deleted on the thread owning the context
+        mReleasedSlots.push_back(slot);
+    }
+
+    const MeshCache* MeshRegistry::Acquire(const GeometryItem& geometry)
+    {
+        // the slot never changes, the generation is only read for geometry uploaded from the live item
+        const uint32_t slot = geometry.GetMeshSlot();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (slot >= mEntries.size() || !mEntries[slot].alive)
+        {
+            return nullptr;
+        }
+
+        auto& entry = mEntries[slot];
+        if (entry.staged)
+        {
+            // the main thread may be editing the item: an edit made after the frame was built
+            // draws the previous copy until the next frame's copy is uploaded
+            return entry.uploaded ? &entry.cache : nullptr;
+        }
+
+        const MeshHandle handle = geometry.GetMeshHandle();
+        if (entry.uploaded && entry.uploadedGeneration == handle.generation)
+        {
+            return &entry.cache;
+        }
+
+        if (!geometry.ValidateGeometryData())
+        {
+            return nullptr;
+        }
+
+        CreateBuffers(entry);
+        UploadGeometry(geometry.GetView(), entry.cache);
+        entry.uploadedGeneration = handle.generation;
+
+        return &entry.cache;
+    }
+
+    void MeshRegistry::Upload(const GeometryView& snapshot)
+    {
+        const MeshHandle handle = snapshot.handle;
+        if (!handle.IsValid() || snapshot.Empty())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (handle.slot >= mEntries.size() || !mEntries[handle.slot].alive)
+        {
+            return;
+        }
+
+        auto& entry = mEntries[handle.slot];
+        entry.staged = true;
+        // frames built while an older one was in flight copy the same generation again
+        if (entry.uploaded && entry.uploadedGeneration == handle.generation)
+        {
+            return;
+        }
+
+        CreateBuffers(entry);
+        UploadGeometry(snapshot, entry.cache);
+        entry.uploadedGeneration = handle.generation;
+    }
+
+    bool MeshRegistry::IsResident(const MeshHandle& handle) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!handle.IsValid() || handle.slot >= mEntries.size())
+        {
+            return false;
+        }
+
+        const auto& entry = mEntries[handle.slot];
+        return entry.alive && entry.uploaded && entry.uploadedGeneration == handle.generation;
+    }
+
+    void MeshRegistry::CollectReleased()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (uint32_t slot : mReleasedSlots)
+        {
+            DestroyBuffers(mEntries[slot]);
+            mFreeSlots.push_back(slot);
+        }
+        mReleasedSlots.clear();
+    }
+
+    void MeshRegistry::ReleaseAll()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto& entry : mEntries)
+        {
+            DestroyBuffers(entry);
+        }
+
+        // live geometry keeps its slot and re-uploads on next Acquire
+        for (uint32_t slot : mReleasedSlots)
+        {
+            mFreeSlots.push_back(slot);
+        }
+        mReleasedSlots.clear();
+    }
+
+    size_t MeshRegistry::GetResidentCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t count = 0;
+        for (const auto& entry : mEntries)
+        {
+            if (entry.uploaded)
+            {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    void MeshRegistry::CreateBuffers(Entry& entry)
+    {
+        if (entry.uploaded)
+        {
+            return;
+        }
+
+        glGenVertexArrays(1, &entry.cache.vao);
+        glGenBuffers(1, &entry.cache.vbo);
+        glGenBuffers(1, &entry.cache.ebo);
+        entry.uploaded = true;
+    }
+
+    void MeshRegistry::DestroyBuffers(Entry& entry)
+    {
+        if (!entry.uploaded)
+        {
+            return;
+        }
+
+        glDeleteVertexArrays(1, &entry.cache.vao);
+        glDeleteBuffers(1, &entry.cache.vbo);
+        glDeleteBuffers(1, &entry.cache.ebo);
+        entry.cache = MeshCache{};
+        entry.uploaded = false;
+        entry.uploadedGeneration = 0;
+    }
+}
@@ -18,12 +18,10 @@ void ISandbox::Teardown(const std::shared_ptr<IRenderer>& renderer)
     (void)renderer;
 }
 
-std::vector<RenderCommand> ISandbox::GetRenderCommands() const
+void ISandbox::CollectRenderCommands(std::vector<RenderCommand>& commands) const
 {
-    std::vector<RenderCommand> commands;
     if (auto source = GetFragmentsSource())
     {
         commands.push_back(MakeOpaqueGeometryCommand(source));
     }
-    return commands;
 }
@@ -0,0 +1,89 @@
+#include "sandbox/Sandbox_InstancingDemo.h"
+
+#include "geometry/BasicGeometry.h"
+#include "geometry/Sphere.h"
+#include "materials/PBRMaterial.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace
+{
+    constexpr int kBoxGridSize = 100;      // 100 x 100 boxes
+    constexpr int kSphereGridSize = 10;    // 10 x 10 spheres above them
+    constexpr float kSpacing = 0.5f;
+}
+
+void Sandbox_InstancingDemo::Init(const std::shared_ptr<IRenderer>& renderer)
+{
+    (void)renderer;
+
+    auto boxMaterial = std::make_shared<PBRMaterial>();
+    boxMaterial->SetAlbedo({ 0.8f, 0.6f, 0.3f });
+    auto sphereMaterial = std::make_shared<PBRMaterial>();
+    sphereMaterial->SetAlbedo({ 0.3f, 0.5f, 0.9f });
+
+    mGeometries.reserve(kBoxGridSize * kBoxGridSize + kSphereGridSize * kSphereGridSize);
+
+    // every box generates the same vertex data, the render queue detects that and instances them
+    const float boxOrigin = -0.5f * kSpacing * float(kBoxGridSize - 1);
+    for (int z = 0; z < kBoxGridSize; ++z)
+    {
+        for (int x = 0; x < kBoxGridSize; ++x)
+        {
+            auto box = std::make_shared<Box>(0.25f, 0.25f, 0.25f);
+            box->SetMaterial(boxMaterial);
+            box->SetWorldTransform(glm::translate(glm::mat4(1.0f),
+                glm::vec3(boxOrigin + kSpacing * x, -1.0f, boxOrigin + kSpacing * z)));
+            mGeometries.push_back(box);
+        }
+    }
+
+    const float sphereSpacing = 4.0f * kSpacing;
+    const float sphereOrigin = -0.5f * sphereSpacing * float(kSphereGridSize - 1);
+    for (int z = 0; z < kSphereGridSize; ++z)
+    {
+        for (int x = 0; x < kSphereGridSize; ++x)
+        {
+            auto sphere = std::make_shared<Sphere>(0.4f, 16, 8);
+            sphere->SetMaterial(sphereMaterial);
+            sphere->SetWorldTransform(glm::translate(glm::mat4(1.0f),
+                glm::vec3(sphereOrigin + sphereSpacing * x, 0.5f, sphereOrigin + sphereSpacing * z)));
+            mGeometries.push_back(sphere);
+        }
+    }
+
+    mCommands.reserve(mGeometries.size());
+    for (const auto& geometry : mGeometries)
+    {
+        RenderCommand command;
+        command.fragmentsSource = geometry;
+        command.state = RenderMode::Opaque;
+        command.hasUV = true;
+        command.renderpassflag = RenderPassFlag::Shadowing
+                               | RenderPassFlag::Geometry
+                               | RenderPassFlag::BaseColor;
+        mCommands.push_back(command);
+    }
+}
+
+void Sandbox_InstancingDemo::Update(const std::shared_ptr<IRenderer>& renderer)
+{
+    (void)renderer;
+}
+
+void Sandbox_InstancingDemo::Teardown(const std::shared_ptr<IRenderer>& renderer)
+{
+    (void)renderer;
+    mCommands.clear();
+    mGeometries.clear();
+}
+
+std::shared_ptr<FragmentsSource> Sandbox_InstancingDemo::GetFragmentsSource() const
+{
+    return mGeometries.empty() ? nullptr : mGeometries.back();
+}
+
+void Sandbox_InstancingDemo::CollectRenderCommands(std::vector<RenderCommand>& commands) const
+{
+    commands.insert(commands.end(), mCommands.begin(), mCommands.end());
+}
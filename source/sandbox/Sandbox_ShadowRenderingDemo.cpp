@@ -45,10 +45,8 @@ std::shared_ptr<FragmentsSource> Sandbox_ShadowRenderingDemo::GetFragmentsSource
     return mpGeometry;
 }
 
-std::vector<RenderCommand> Sandbox_ShadowRenderingDemo::GetRenderCommands() const
+void Sandbox_ShadowRenderingDemo::CollectRenderCommands(std::vector<RenderCommand>& commands) const
 {
-    std::vector<RenderCommand> commands;
-    commands.reserve(2);
 
     if (mpGeometry)
     {
@@ -72,6 +70,4 @@ std::vector<RenderCommand> Sandbox_ShadowRenderingDemo::GetRenderCommands() cons
         planeCommand.renderpassflag = RenderPassFlag::Geometry | RenderPassFlag::BaseColor;
         commands.push_back(planeCommand);
     }
-
-    return commands;
 }
@@ -16,6 +16,10 @@ using namespace std;
 
 #include "shader.h"
 #include "shader/ShaderPreprocessor.h"
+#include "shader/FrameUniforms.h"
+#include "shader/ProgramBinaryCache.h"
+#include "shader/ShaderHotReload.h"
+#include <chrono>
 
 GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path){
 
@@ -121,30 +125,84 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath, const te::Shade
 }
 
 Shader::Shader(const char* vertexPath, const char* fragmentPath, te::ShaderPreprocessor& preprocessor)
-	: mId(0)
+	: mId(0), mPreprocessor(preprocessor)
 {
-	constructWithPreprocessor(vertexPath, fragmentPath, preprocessor);
+	// keep a copy so the macros (e.g. variant defines) stay with the program
+	constructWithPreprocessor(vertexPath, fragmentPath, mPreprocessor);
 }
 
 void Shader::constructWithPreprocessor(const char* vertexPath, const char* fragmentPath, te::ShaderPreprocessor& preprocessor)
 {
+	mVertexPath = vertexPath;
+	mFragmentPath = fragmentPath;
+	buildProgram(preprocessor);
+
+	// watched for edits from now on, a failed build is retried when the file is saved again
+	te::ShaderHotReload::GetInstance().Register(this);
+}
+
+void Shader::buildProgram(te::ShaderPreprocessor& preprocessor)
+{
+	const auto buildStart = std::chrono::steady_clock::now();
+	auto elapsedMs = [&buildStart]() {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+	};
+
 	// 1. use the preprocessor to process the shader source code
-	std::string vertexCode = preprocessor.ProcessShader(vertexPath);
-	std::string fragmentCode = preprocessor.ProcessShader(fragmentPath);
+	std::string vertexCode = preprocessor.ProcessShader(mVertexPath);
+	std::string fragmentCode = preprocessor.ProcessShader(mFragmentPath);
 
 	if (vertexCode.empty() || fragmentCode.empty())
 	{
 		std::cout << "ERROR::SHADER::PREPROCESSOR_FAILED" << std::endl;
-		std::cout << "Vertex Shader: " << vertexPath << std::endl;
-		std::cout << "Fragment Shader: " << fragmentPath << std::endl;
+		std::cout << "Vertex Shader: " << mVertexPath << std::endl;
+		std::cout << "Fragment Shader: " << mFragmentPath << std::endl;
 		mId = 0; // Ensure mId is 0 on failure
 		return;
 	}
 
+	// 2. reuse the linked binary of an identical program from a previous run
+	auto& programCache = te::ProgramBinaryCache::GetInstance();
+	const bool useProgramCache = programCache.IsAvailable();
+	const uint64_t cacheKey = useProgramCache
+		? te::ProgramBinaryCache::ComputeKey(vertexCode, fragmentCode, preprocessor.GetMacroSignature())
+		: 0;
+	if (useProgramCache)
+	{
+		mId = glCreateProgram();
+		if (mId != 0 && programCache.Load(cacheKey, mId))
+		{
+			reflectUniforms();
+			programCache.RecordBuild(true, elapsedMs());
+			return;
+		}
+
+		// missing or rejected by the driver: compile from source below
+		if (mId != 0)
+		{
+			glDeleteProgram(mId);
+			mId = 0;
+		}
+	}
+
+	// 3. compile and link
+	mId = CompileProgram(vertexCode, fragmentCode, useProgramCache);
+	if (mId != 0)
+	{
+		reflectUniforms();
+		if (useProgramCache)
+		{
+			programCache.Store(cacheKey, mId);
+		}
+		programCache.RecordBuild(false, elapsedMs());
+	}
+}
+
+GLuint Shader::CompileProgram(const std::string& vertexCode, const std::string& fragmentCode, bool retrievableBinary)
+{
 	const char* vShaderCode = vertexCode.c_str();
 	const char* fShaderCode = fragmentCode.c_str();
 
-	// 2. compile shaders
 	unsigned int vertex = 0, fragment = 0;
 	bool compilationSuccess = true;
 
@@ -167,36 +225,52 @@ void Shader::constructWithPreprocessor(const char* vertexPath, const char* fragm
 	}
 
 	// Only create program if compilation was successful
+	GLuint program = 0;
 	if (compilationSuccess)
 	{
 		// shader Program
-		mId = glCreateProgram();
-		if (mId != 0)
+		program = glCreateProgram();
+		if (program != 0)
 		{
-			glAttachShader(mId, vertex);
-			glAttachShader(mId, fragment);
-			glLinkProgram(mId);
-			if (!checkCompileErrors(mId, "PROGRAM"))
+			glAttachShader(program, vertex);
+			glAttachShader(program, fragment);
+			if (retrievableBinary)
+			{
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+			glLinkProgram(program);
+			if (!checkCompileErrors(program, "PROGRAM"))
 			{
 				// Link failed, clean up program
-				glDeleteProgram(mId);
-				mId = 0;
+				glDeleteProgram(program);
+				program = 0;
 			}
 		}
 	}
-	else
-	{
-		// Compilation failed, ensure mId is 0
-		mId = 0;
-	}
 
 	// delete the shaders as they're linked into our program now and no longer necessary
 	if (vertex != 0) glDeleteShader(vertex);
 	if (fragment != 0) glDeleteShader(fragment);
+	return program;
+}
+
+void Shader::ReplaceProgram(GLuint program)
+{
+	if (program == 0 || program == mId)
+		return;
+
+	if (mId != 0)
+	{
+		glDeleteProgram(mId);
+	}
+	mId = program;
+	reflectUniforms();
 }
 
 Shader::~Shader() 
 {
+	te::ShaderHotReload::GetInstance().Unregister(this);
+
 	if (mId != 0)
 	{
 		glDeleteProgram(mId);
@@ -260,90 +334,164 @@ void Shader::use()
 	}
 }
 
+// reflection: cache every active uniform location once after link
+// ------------------------------------------------------------------------
+void Shader::reflectUniforms()
+{
+	mUniformLocations.clear();
+
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(mId, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(mId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	// names are only kept while reflecting, to find hashes shared by two active uniforms
+	std::unordered_map<uint32_t, std::string> names;
+	auto addUniformLocation = [this, &names](std::string_view name, GLint location) {
+		const uint32_t hash = te::UniformId::Hash(name);
+		auto [it, inserted] = names.try_emplace(hash, name);
+		if (inserted)
+		{
+			mUniformLocations[hash] = location;
+		}
+		else if (it->second != name)
+		{
+			std::cout << "Shader: uniforms \"" << it->second << "\" and \"" << name
+			          << "\" have the same hash, both bypass the location cache" << std::endl;
+			mUniformLocations[hash] = kHashCollision;
+		}
+	};
+
+	std::vector<char> nameBuffer(std::max(maxNameLength, 1));
+	for (GLint i = 0; i < uniformCount; ++i)
+	{
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(mId, GLuint(i), GLsizei(nameBuffer.size()), &length, &size, &type, nameBuffer.data());
+
+		std::string name(nameBuffer.data(), length);
+		const GLint location = glGetUniformLocation(mId, name.c_str());
+		if (location < 0)
+			continue; // member of a uniform block
+
+		addUniformLocation(name, location);
+		// arrays are reported as "name[0]", also answer to the bare name
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+		{
+			addUniformLocation(std::string_view(name).substr(0, name.size() - 3), location);
+		}
+	}
+
+	const GLuint frameBlock = glGetUniformBlockIndex(mId, te::FrameUniformBuffer::kBlockName);
+	mUsesFrameUniforms = frameBlock != GL_INVALID_INDEX;
+	if (mUsesFrameUniforms)
+	{
+		glUniformBlockBinding(mId, frameBlock, te::FrameUniformBuffer::kBindingPoint);
+	}
+}
+
+GLint Shader::GetUniformLocation(te::UniformId id) const
+{
+	auto it = mUniformLocations.find(id.hash);
+	if (it != mUniformLocations.end() && it->second != kHashCollision)
+	{
+		return it->second;
+	}
+
+	const GLint location = mId != 0 ? glGetUniformLocation(mId, id.name) : -1;
+	if (it == mUniformLocations.end())
+	{
+		// e.g. "lights[2].color": not listed by reflection, query once and remember
+		mUniformLocations.emplace(id.hash, location);
+	}
+	return location;
+}
+
 // utility uniform functions
 // ------------------------------------------------------------------------
-void Shader::setBool(const std::string& name, bool value) const
+void Shader::setBool(te::UniformId id, bool value) const
 {
 	if (mId != 0)
 	{
-		glUniform1i(glGetUniformLocation(mId, name.c_str()), (int)value);
+		glUniform1i(GetUniformLocation(id), (int)value);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setInt(const std::string& name, int value) const
+void Shader::setInt(te::UniformId id, int value) const
 {
 	if (mId != 0)
 	{
-		glUniform1i(glGetUniformLocation(mId, name.c_str()), value);
+		glUniform1i(GetUniformLocation(id), value);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setFloat(const std::string& name, float value) const
+void Shader::setFloat(te::UniformId id, float value) const
 {
 	if (mId != 0)
 	{
-		glUniform1f(glGetUniformLocation(mId, name.c_str()), value);
+		glUniform1f(GetUniformLocation(id), value);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setVec2(const std::string& name, const glm::vec2& value) const
+void Shader::setVec2(te::UniformId id, const glm::vec2& value) const
 {
 	if (mId != 0)
 	{
-		glUniform2fv(glGetUniformLocation(mId, name.c_str()), 1, &value[0]);
+		glUniform2fv(GetUniformLocation(id), 1, &value[0]);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setVec3(const std::string& name, const glm::vec3& value) const
+void Shader::setVec3(te::UniformId id, const glm::vec3& value) const
 {
 	if (mId != 0)
 	{
-		glUniform3fv(glGetUniformLocation(mId, name.c_str()), 1, &value[0]);
+		glUniform3fv(GetUniformLocation(id), 1, &value[0]);
 	}
 }
-void Shader::setVec3(const std::string& name, float x, float y, float z) const
+void Shader::setVec3(te::UniformId id, float x, float y, float z) const
 {
 	if (mId != 0)
 	{
-		glUniform3f(glGetUniformLocation(mId, name.c_str()), x, y, z);
+		glUniform3f(GetUniformLocation(id), x, y, z);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setVec4(const std::string& name, const glm::vec4& value) const
+void Shader::setVec4(te::UniformId id, const glm::vec4& value) const
 {
 	if (mId != 0)
 	{
-		glUniform4fv(glGetUniformLocation(mId, name.c_str()), 1, &value[0]);
+		glUniform4fv(GetUniformLocation(id), 1, &value[0]);
 	}
 }
-void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
+void Shader::setVec4(te::UniformId id, float x, float y, float z, float w) const
 {
 	if (mId != 0)
 	{
-		glUniform4f(glGetUniformLocation(mId, name.c_str()), x, y, z, w);
+		glUniform4f(GetUniformLocation(id), x, y, z, w);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
+void Shader::setMat2(te::UniformId id, const glm::mat2& mat) const
 {
 	if (mId != 0)
 	{
-		glUniformMatrix2fv(glGetUniformLocation(mId, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix2fv(GetUniformLocation(id), 1, GL_FALSE, &mat[0][0]);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
+void Shader::setMat3(te::UniformId id, const glm::mat3& mat) const
 {
 	if (mId != 0)
 	{
-		glUniformMatrix3fv(glGetUniformLocation(mId, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix3fv(GetUniformLocation(id), 1, GL_FALSE, &mat[0][0]);
 	}
 }
 // ------------------------------------------------------------------------
-void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
+void Shader::setMat4(te::UniformId id, const glm::mat4& mat) const
 {
 	if (mId != 0)
 	{
-		glUniformMatrix4fv(glGetUniformLocation(mId, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+		glUniformMatrix4fv(GetUniformLocation(id), 1, GL_FALSE, &mat[0][0]);
 	}
 }
\ No newline at end of file
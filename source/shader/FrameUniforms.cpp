@@ -0,0 +1,104 @@
+#include "shader/FrameUniforms.h"
+#include "Camera.h"
+#include "Light.h"
+#include "framework/RenderContext.h"
+#include "framework/FrameScene.h"
+
+namespace te
+{
+    namespace
+    {
+        template <typename T>
+        void Assign(T& target, const T& value, bool& dirty)
+        {
+            if (target != value)
+            {
+                target = value;
+                dirty = true;
+            }
+        }
+    }
+
+    FrameUniformBuffer& FrameUniformBuffer::GetInstance()
+    {
+        static FrameUniformBuffer instance;
+        return instance;
+    }
+
+    void FrameUniformBuffer::SetCamera(const Camera& camera)
+    {
+        Assign(mData.view, camera.GetViewMatrix(), mDirty);
+        Assign(mData.projection, camera.GetProjectionMatrix(), mDirty);
+        Assign(mData.viewPos, glm::vec4(camera.GetEye(), 1.0f), mDirty);
+    }
+
+    void FrameUniformBuffer::SetLight(const Light& light)
+    {
+        Assign(mData.lightPos, glm::vec4(light.GetPosition(), 1.0f), mDirty);
+        Assign(mData.lightColor, glm::vec4(light.GetColor(), 1.0f), mDirty);
+    }
+
+    void FrameUniformBuffer::SetView(const FrameView& view)
+    {
+        Assign(mData.view, view.view, mDirty);
+        Assign(mData.projection, view.projection, mDirty);
+        Assign(mData.viewPos, glm::vec4(view.eye, 1.0f), mDirty);
+    }
+
+    void FrameUniformBuffer::SetLight(const FrameLight& light)
+    {
+        Assign(mData.lightPos, glm::vec4(light.position, 1.0f), mDirty);
+        Assign(mData.lightColor, glm::vec4(light.color, 1.0f), mDirty);
+    }
+
+    void FrameUniformBuffer::SetLightSpaceMatrix(const glm::mat4& lightSpaceMatrix)
+    {
+        Assign(mData.lightSpaceMatrix, lightSpaceMatrix, mDirty);
+    }
+
+    void FrameUniformBuffer::UpdateFromContext(RenderContext& context)
+    {
+        if (const FrameView* pView = context.GetRenderView())
+        {
+            SetView(*pView);
+        }
+        if (const FrameLight* pLight = context.GetRenderLight())
+        {
+            SetLight(*pLight);
+        }
+        Upload();
+    }
+
+    void FrameUniformBuffer::Upload()
+    {
+        if (mBuffer == 0)
+        {
+            glGenBuffers(1, &mBuffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+            mDirty = true;
+        }
+        else
+        {
+            glBindBuffer(GL_UNIFORM_BUFFER, mBuffer);
+        }
+
+        if (mDirty)
+        {
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &mData);
+            mDirty = false;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, mBuffer);
+    }
+
+    void FrameUniformBuffer::Release()
+    {
+        if (mBuffer != 0)
+        {
+            glDeleteBuffers(1, &mBuffer);
+            mBuffer = 0;
+        }
+        mDirty = true;
+    }
+}
@@ -0,0 +1,215 @@
+#include "shader/ProgramBinaryCache.h"
+#include "filesystem.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <cstdio>
+
+namespace te
+{
+    namespace
+    {
+        constexpr uint32_t kMagic = 0x42505445; // "TEPB"
+        constexpr uint32_t kFileVersion = 1;
+
+        struct BinaryHeader
+        {
+            uint32_t magic = kMagic;
+            uint32_t version = kFileVersion;
+            uint64_t driverHash = 0;
+            uint32_t format = 0;
+            uint32_t length = 0;
+        };
+
+        uint64_t Fnv1a64(const void* data, size_t size, uint64_t hash = 1469598103934665603ull)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        uint64_t HashString(const std::string& text, uint64_t hash)
+        {
+            // length first so "ab"+"c" and "a"+"bc" differ
+            const uint64_t length = text.size();
+            hash = Fnv1a64(&length, sizeof(length), hash);
+            return Fnv1a64(text.data(), text.size(), hash);
+        }
+
+        std::string GetGLString(GLenum name)
+        {
+            const GLubyte* value = glGetString(name);
+            return value ? reinterpret_cast<const char*>(value) : "";
+        }
+    }
+
+    ProgramBinaryCache& ProgramBinaryCache::GetInstance()
+    {
+        static ProgramBinaryCache instance;
+        return instance;
+    }
+
+    ProgramBinaryCache::ProgramBinaryCache()
+        : mDirectory(FileSystem::getPath("shader_cache"))
+    {
+    }
+
+    void ProgramBinaryCache::SetDirectory(const std::string& directory)
+    {
+        mDirectory = directory;
+    }
+
+    bool ProgramBinaryCache::IsAvailable() const
+    {
+        if (!mEnabled || !glProgramBinary || !glGetProgramBinary || !glProgramParameteri)
+            return false;
+
+        GLint formatCount = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        return formatCount > 0;
+    }
+
+    uint64_t ProgramBinaryCache::ComputeKey(const std::string& vertexSource, const std::string& fragmentSource,
+        const std::string& macroSignature)
+    {
+        uint64_t hash = Fnv1a64(&kFileVersion, sizeof(kFileVersion));
+        hash = HashString(vertexSource, hash);
+        hash = HashString(fragmentSource, hash);
+        return HashString(macroSignature, hash);
+    }
+
+    uint64_t ProgramBinaryCache::GetDriverHash() const
+    {
+        if (mDriverHash == 0)
+        {
+            uint64_t hash = HashString(GetGLString(GL_VENDOR), 1469598103934665603ull);
+            hash = HashString(GetGLString(GL_RENDERER), hash);
+            mDriverHash = HashString(GetGLString(GL_VERSION), hash);
+        }
+        return mDriverHash;
+    }
+
+    std::string ProgramBinaryCache::GetFilePath(uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return (std::filesystem::path(mDirectory) / name).string();
+    }
+
+    bool ProgramBinaryCache::Load(uint64_t key, GLuint program)
+    {
+        if (program == 0 || !IsAvailable())
+            return false;
+
+        const std::string path = GetFilePath(key);
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open())
+            return false;
+
+        BinaryHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        bool valid = file.good() && header.magic == kMagic && header.version == kFileVersion
+            && header.driverHash == GetDriverHash() && header.length > 0;
+
+        std::vector<char> binary;
+        if (valid)
+        {
+            binary.resize(header.length);
+            file.read(binary.data(), header.length);
+            valid = file.gcount() == std::streamsize(header.length);
+        }
+        file.close();
+
+        if (valid)
+        {
+            glProgramBinary(program, GLenum(header.format), binary.data(), GLsizei(header.length));
+            GLint linked = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            valid = linked == GL_TRUE;
+        }
+
+        if (!valid)
+        {
+            // stale or foreign binary: drop it, the caller compiles from source and stores a fresh one
+            ++mStats.rejected;
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+        return valid;
+    }
+
+    bool ProgramBinaryCache::Store(uint64_t key, GLuint program)
+    {
+        if (program == 0 || !IsAvailable())
+            return false;
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return false;
+
+        std::vector<char> binary(static_cast<size_t>(length));
+        GLsizei written = 0;
+        GLenum format = 0;
+        glGetProgramBinary(program, length, &written, &format, binary.data());
+        if (written <= 0)
+            return false;
+
+        std::error_code ec;
+        std::filesystem::create_directories(mDirectory, ec);
+
+        // write to a temp file and rename, so a crash never leaves a truncated binary behind
+        const std::string path = GetFilePath(key);
+        const std::string tempPath = path + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                std::cout << "WARNING::PROGRAM_CACHE::Cannot write " << tempPath << std::endl;
+                return false;
+            }
+
+            BinaryHeader header;
+            header.driverHash = GetDriverHash();
+            header.format = uint32_t(format);
+            header.length = uint32_t(written);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file.good())
+                return false;
+        }
+        std::filesystem::rename(tempPath, path, ec);
+        return !ec;
+    }
+
+    void ProgramBinaryCache::RecordBuild(bool fromCache, double milliseconds)
+    {
+        if (fromCache)
+        {
+            ++mStats.loaded;
+            mStats.loadMs += milliseconds;
+        }
+        else
+        {
+            ++mStats.compiled;
+            mStats.compileMs += milliseconds;
+        }
+    }
+
+    void ProgramBinaryCache::LogStats(const std::string& label) const
+    {
+        std::cout << "[ProgramBinaryCache] " << label << ": "
+                  << mStats.loaded << " programs from cache (" << mStats.loadMs << " ms), "
+                  << mStats.compiled << " compiled (" << mStats.compileMs << " ms)";
+        if (mStats.rejected > 0)
+        {
+            std::cout << ", " << mStats.rejected << " stale binaries rejected";
+        }
+        std::cout << std::endl;
+    }
+}
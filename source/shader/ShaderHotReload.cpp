@@ -0,0 +1,352 @@
+#include "shader/ShaderHotReload.h"
+#include "shader/ShaderSourceCache.h"
+#include "shader.h"
+#include "filesystem.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <iostream>
+#include <unordered_set>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace te
+{
+    ShaderHotReload& ShaderHotReload::GetInstance()
+    {
+        // never destroyed: shaders owned by other singletons unregister during static destruction
+        static ShaderHotReload* instance = new ShaderHotReload();
+        return *instance;
+    }
+
+    bool ShaderHotReload::Start(GLFWwindow* workerWindow, const std::string& watchDirectory)
+    {
+        if (mRunning || !workerWindow)
+            return false;
+
+        mpWorkerWindow = workerWindow;
+        mWatchDirectory = ShaderSourceCache::NormalizePath(watchDirectory);
+        if (!OpenWatch())
+        {
+            std::cout << "ERROR::SHADER_HOT_RELOAD::Cannot watch " << mWatchDirectory << std::endl;
+            return false;
+        }
+
+        mRunning = true;
+        mWorker = std::thread(&ShaderHotReload::WorkerLoop, this);
+        std::cout << "[ShaderHotReload] watching " << mWatchDirectory << std::endl;
+        return true;
+    }
+
+    void ShaderHotReload::Stop()
+    {
+        if (!mRunning)
+            return;
+
+        mRunning = false;
+        if (mWorker.joinable())
+        {
+            mWorker.join();
+        }
+        CloseWatch();
+
+        // programs that never got swapped in: the caller need not own the render context, so they
+        // are deleted by the next ApplyPendingSwaps() or ReleaseGpuResources()
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDiscarded.insert(mDiscarded.end(), mPending.begin(), mPending.end());
+        mPending.clear();
+    }
+
+    void ShaderHotReload::Register(Shader* shader)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShaders[shader] = mNextSerial++;
+    }
+
+    void ShaderHotReload::Unregister(Shader* shader)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mShaders.erase(shader);
+
+        for (auto it = mPending.begin(); it != mPending.end();)
+        {
+            if (it->shader == shader)
+            {
+                // may be destroyed off the rendering thread; deleted with the next swaps
+                mDiscarded.push_back(*it);
+                it = mPending.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void ShaderHotReload::ApplyPendingSwaps()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        DeleteDiscarded();
+        if (!mRunning)
+            return;
+
+        for (auto it = mPending.begin(); it != mPending.end();)
+        {
+            // zero timeout: a program still being finished by the driver waits for the next frame
+            const GLenum status = glClientWaitSync(it->fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                ++it;
+                continue;
+            }
+
+            glDeleteSync(it->fence);
+            if (status == GL_WAIT_FAILED)
+            {
+                glDeleteProgram(it->program);
+            }
+            else
+            {
+                it->shader->ReplaceProgram(it->program);
+                ++mReloadCount;
+                std::cout << "[ShaderHotReload] reloaded " << it->shader->GetVertexPath() << ", "
+                          << it->shader->GetFragmentPath() << std::endl;
+            }
+            it = mPending.erase(it);
+        }
+    }
+
+    void ShaderHotReload::ReleaseGpuResources()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        DeleteDiscarded();
+    }
+
+    void ShaderHotReload::DeleteDiscarded()
+    {
+        for (const PendingSwap& discarded : mDiscarded)
+        {
+            glDeleteSync(discarded.fence);
+            glDeleteProgram(discarded.program);
+        }
+        mDiscarded.clear();
+    }
+
+    void ShaderHotReload::WorkerLoop()
+    {
+        glfwMakeContextCurrent(mpWorkerWindow);
+
+        while (mRunning)
+        {
+            const std::vector<std::string> changedFiles = WaitForChanges();
+            if (changedFiles.empty())
+                continue;
+
+            // the mtime check would catch most edits, but not two saves within the timestamp resolution
+            for (const std::string& path : changedFiles)
+            {
+                ShaderSourceCache::GetInstance().Invalidate(path);
+            }
+
+            std::vector<Job> jobs = CollectJobs(changedFiles);
+            for (Job& job : jobs)
+            {
+                Build(job);
+            }
+        }
+
+        glfwMakeContextCurrent(nullptr);
+    }
+
+    std::vector<ShaderHotReload::Job> ShaderHotReload::CollectJobs(const std::vector<std::string>& changedFiles)
+    {
+        // the edited stages themselves plus every stage that includes an edited file
+        std::unordered_set<std::string> stages(changedFiles.begin(), changedFiles.end());
+        for (const std::string& path : changedFiles)
+        {
+            for (std::string& dependent : ShaderSourceCache::GetInstance().GetDependents(path))
+            {
+                stages.insert(std::move(dependent));
+            }
+        }
+
+        std::vector<Job> jobs;
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& [shader, serial] : mShaders)
+        {
+            const std::string vertexPath = ShaderSourceCache::NormalizePath(FileSystem::getPath(shader->GetVertexPath()));
+            const std::string fragmentPath = ShaderSourceCache::NormalizePath(FileSystem::getPath(shader->GetFragmentPath()));
+            if (stages.count(vertexPath) || stages.count(fragmentPath))
+            {
+                jobs.push_back({ shader, serial, shader->GetVertexPath(), shader->GetFragmentPath(), shader->GetPreprocessor() });
+            }
+        }
+        return jobs;
+    }
+
+    void ShaderHotReload::Build(Job& job)
+    {
+        const std::string vertexCode = job.preprocessor.ProcessShader(job.vertexPath);
+        const std::string fragmentCode = job.preprocessor.ProcessShader(job.fragmentPath);
+        const GLuint program = (vertexCode.empty() || fragmentCode.empty())
+            ? 0 : Shader::CompileProgram(vertexCode, fragmentCode);
+        if (program == 0)
+        {
+            ++mFailureCount;
+            std::cout << "[ShaderHotReload] build failed, keeping the current program of "
+                      << job.vertexPath << ", " << job.fragmentPath << std::endl;
+            return;
+        }
+
+        // the render context may only use the program once this context's commands completed
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto registered = mShaders.find(job.shader);
+        if (registered == mShaders.end() || registered->second != job.serial)
+        {
+            // the shader was destroyed while we compiled
+            glDeleteSync(fence);
+            glDeleteProgram(program);
+            return;
+        }
+
+        // a newer build supersedes one that was not swapped in yet
+        for (PendingSwap& pending : mPending)
+        {
+            if (pending.shader == job.shader)
+            {
+                glDeleteSync(pending.fence);
+                glDeleteProgram(pending.program);
+                pending.program = program;
+                pending.fence = fence;
+                return;
+            }
+        }
+        mPending.push_back({ job.shader, job.serial, program, fence });
+    }
+
+#if defined(__linux__)
+    bool ShaderHotReload::OpenWatch()
+    {
+        mNotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (mNotifyFd < 0)
+            return false;
+
+        // inotify is not recursive: one watch per directory
+        auto addWatch = [this](const std::string& directory) {
+            const int watch = inotify_add_watch(mNotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (watch >= 0)
+                mWatchDirectories[watch] = directory;
+        };
+
+        std::error_code error;
+        addWatch(mWatchDirectory);
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(mWatchDirectory, error))
+        {
+            if (entry.is_directory())
+                addWatch(ShaderSourceCache::NormalizePath(entry.path().string()));
+        }
+        return !mWatchDirectories.empty();
+    }
+
+    void ShaderHotReload::CloseWatch()
+    {
+        if (mNotifyFd >= 0)
+        {
+            close(mNotifyFd);
+            mNotifyFd = -1;
+        }
+        mWatchDirectories.clear();
+    }
+
+    std::vector<std::string> ShaderHotReload::WaitForChanges()
+    {
+        std::unordered_set<std::string> changed;
+        pollfd descriptor{ mNotifyFd, POLLIN, 0 };
+
+        // wait up to 200 ms for the first event (so Stop() is noticed), then keep draining for
+        // 50 ms to fold an editor's write + rename burst into one rebuild
+        int timeoutMs = 200;
+        while (poll(&descriptor, 1, timeoutMs) > 0)
+        {
+            alignas(inotify_event) char buffer[4096];
+            const ssize_t length = read(mNotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+
+            for (const char* cursor = buffer; cursor < buffer + length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(cursor);
+                cursor += sizeof(inotify_event) + event->len;
+
+                auto directory = mWatchDirectories.find(event->wd);
+                if (event->len == 0 || directory == mWatchDirectories.end())
+                    continue;
+
+                const std::string path = directory->second + "/" + event->name;
+                if (event->mask & IN_ISDIR)
+                {
+                    if (event->mask & IN_CREATE)
+                    {
+                        const int watch = inotify_add_watch(mNotifyFd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+                        if (watch >= 0)
+                            mWatchDirectories[watch] = path;
+                    }
+                }
+                else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                {
+                    changed.insert(path);
+                }
+            }
+            timeoutMs = 50;
+        }
+        return std::vector<std::string>(changed.begin(), changed.end());
+    }
+#else
+    // no inotify: compare modification times of the files under the directory
+    bool ShaderHotReload::OpenWatch()
+    {
+        std::error_code error;
+        mWriteTimes.clear();
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(mWatchDirectory, error))
+        {
+            if (entry.is_regular_file())
+                mWriteTimes[ShaderSourceCache::NormalizePath(entry.path().string())] = entry.last_write_time(error);
+        }
+        return !error;
+    }
+
+    void ShaderHotReload::CloseWatch()
+    {
+        mWriteTimes.clear();
+    }
+
+    std::vector<std::string> ShaderHotReload::WaitForChanges()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+        std::vector<std::string> changed;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(mWatchDirectory, error))
+        {
+            if (!entry.is_regular_file())
+                continue;
+
+            const std::string path = ShaderSourceCache::NormalizePath(entry.path().string());
+            const auto writeTime = entry.last_write_time(error);
+            auto [it, inserted] = mWriteTimes.try_emplace(path, writeTime);
+            if (!inserted && it->second != writeTime)
+            {
+                it->second = writeTime;
+                changed.push_back(path);
+            }
+        }
+        return changed;
+    }
+#endif
+}
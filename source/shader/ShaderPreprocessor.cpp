@@ -1,11 +1,10 @@
 #include "shader/ShaderPreprocessor.h"
+#include "shader/ShaderSourceCache.h"
 #include "shader.h"
 #include "filesystem.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
-#include <regex>
 #include <cstdio>
 
 namespace te
@@ -25,26 +24,49 @@ namespace te
     std::string ShaderPreprocessor::ProcessShader(const std::string& shaderPath)
     {
         std::string fullPath = FileSystem::getPath(shaderPath);
-        std::string content = ReadFile(fullPath);
-        
-        if (content.empty())
+        auto source = ShaderSourceCache::GetInstance().Get(fullPath);
+
+        if (!source || source->text.empty())
         {
             std::cout << "ERROR::SHADER_PREPROCESSOR::Failed to read shader file: " << fullPath << std::endl;
             return "";
         }
 
-        return ProcessShaderContent(content, fullPath);
+        ProcessParsed(*source, fullPath);
+
+        // remember what this shader pulled in so a changed include can find it again
+        if (mConfig.enableIncludeProcessing)
+        {
+            ShaderSourceCache::GetInstance().SetDependencies(fullPath,
+                std::vector<std::string>(mSourceMap.begin() + 1, mSourceMap.end()));
+        }
+        return mLastProcessedContent;
     }
 
     std::string ShaderPreprocessor::ProcessShaderContent(const std::string& content, const std::string& basePath)
+    {
+        ShaderSourceFile source;
+        source.text = content;
+        source.Tokenize();
+        return ProcessParsed(source, basePath);
+    }
+
+    std::string ShaderPreprocessor::ProcessParsed(const ShaderSourceFile& source, const std::string& basePath)
     {
         mProcessedFiles.clear();
-        mLastProcessedContent = content;
+        mSourceMap.assign(1, basePath);
 
         // 1. process include files
-        if (mConfig.enableIncludeProcessing)
+        if (mConfig.enableIncludeProcessing && !source.includes.empty())
+        {
+            std::string expanded;
+            expanded.reserve(source.text.size() * 2);
+            ProcessIncludes(source, 0, 0, mConfig.emitLineDirectives, expanded);
+            mLastProcessedContent = std::move(expanded);
+        }
+        else
         {
-            mLastProcessedContent = ProcessIncludes(mLastProcessedContent, basePath);
+            mLastProcessedContent = source.text;
         }
 
         // 2. process macro definitions
@@ -63,115 +85,123 @@ namespace te
         return mLastProcessedContent;
     }
 
-    std::string ShaderPreprocessor::ProcessIncludes(const std::string& content, const std::string& basePath, int depth)
+    void ShaderPreprocessor::ProcessIncludes(const ShaderSourceFile& source, uint32_t sourceIndex, int depth,
+        bool lineDirectives, std::string& out)
     {
-        if (!IsValidIncludeDepth(depth))
+        size_t cursor = 0;
+        for (const ShaderIncludeDirective& directive : source.includes)
         {
-            std::cout << "WARNING::SHADER_PREPROCESSOR::Maximum include depth reached" << std::endl;
-            return content;
-        }
+            // copy the text up to the directive line, the directive itself is replaced
+            out.append(source.text, cursor, directive.begin - cursor);
+            cursor = directive.end;
 
-        std::string result = content;
-        std::regex includeRegex(R"(#include\s*[<"]([^>"]+)[>"])");
-        std::smatch match;
+            const std::string fullIncludePath =
+                ShaderSourceCache::NormalizePath(ResolveIncludePath(directive.path, mSourceMap[sourceIndex]));
 
-        while (std::regex_search(result, match, includeRegex))
-        {
-            std::string includePath = match[1].str();
-            std::string fullIncludePath = ResolveIncludePath(includePath, basePath);
+            // expanded before in this shader: include-once, which also breaks cycles
+            if (!mProcessedFiles.insert(fullIncludePath).second)
+            {
+                out += "// Circular include: ";
+                out += directive.path;
+                continue;
+            }
 
-            // check if the file has been processed (to prevent circular inclusion)
-            if (mProcessedFiles.find(fullIncludePath) != mProcessedFiles.end())
+            auto include = ShaderSourceCache::GetInstance().Get(fullIncludePath);
+            if (!include)
             {
-                std::cout << "WARNING::SHADER_PREPROCESSOR::Circular include detected: " << includePath << std::endl;
-                result = std::regex_replace(result, includeRegex, "// Circular include: " + includePath, std::regex_constants::format_first_only);
+                std::cout << "ERROR::SHADER_PREPROCESSOR::Failed to read include file: " << fullIncludePath << std::endl;
+                out += "// Failed to include: ";
+                out += directive.path;
                 continue;
             }
 
-            std::string includeContent = ReadFile(fullIncludePath);
-            if (!includeContent.empty())
+            // #line must not precede #version in the root shader
+            const bool emitLines = lineDirectives && (depth > 0 || directive.line > source.versionLine);
+            const uint32_t includeIndex = static_cast<uint32_t>(mSourceMap.size());
+            mSourceMap.push_back(fullIncludePath);
+
+            if (emitLines)
+            {
+                out += "#line 1 ";
+                out += std::to_string(includeIndex);
+                out += '\n';
+            }
+
+            if (IsValidIncludeDepth(depth + 1))
             {
-                mProcessedFiles.insert(fullIncludePath);
-                
-                // recursively process the includes in the included file
-                includeContent = ProcessIncludes(includeContent, fullIncludePath, depth + 1);
-                
-                // replace the include directive
-                result = std::regex_replace(result, includeRegex, includeContent, std::regex_constants::format_first_only);
+                ProcessIncludes(*include, includeIndex, depth + 1, emitLines, out);
             }
             else
             {
-                std::cout << "ERROR::SHADER_PREPROCESSOR::Failed to read include file: " << fullIncludePath << std::endl;
-                result = std::regex_replace(result, includeRegex, "// Failed to include: " + includePath, std::regex_constants::format_first_only);
+                std::cout << "WARNING::SHADER_PREPROCESSOR::Maximum include depth reached" << std::endl;
+                out += include->text;
+            }
+
+            // back in the parent: the line after the directive (GLSL 330+ numbers the next line as <line>)
+            if (emitLines)
+            {
+                if (!out.empty() && out.back() != '\n')
+                    out += '\n';
+                out += "#line ";
+                out += std::to_string(directive.line + 1);
+                out += ' ';
+                out += std::to_string(sourceIndex);
             }
         }
 
-        return result;
+        out.append(source.text, cursor, std::string::npos);
     }
 
     std::string ShaderPreprocessor::ProcessMacros(const std::string& content)
     {
-        //todo
-        std::string result, targetField = "#version";
-
-        size_t pos = content.find(targetField); // find target feid pod
-        if (pos == std::string::npos) 
-            return content;   // not found return
-
-         // line head: search last change-line flag forwardly
-        size_t lineStart = content.rfind('\n', pos) + 1; // +1 skip change-line flag
-        if (lineStart == std::string::npos) lineStart = 0;
+        // the defines go right after #version, nothing may precede it
+        size_t pos = content.find("#version");
+        if (pos == std::string::npos)
+            return content;
 
-        // line tear: search next change-line flag backwardly
         size_t lineEnd = content.find('\n', pos);
-        if (lineEnd == std::string::npos) lineEnd = content.length();
-
-        // get substring by line end  pos
+        if (lineEnd == std::string::npos)
+            lineEnd = content.length();
 
-        result += content.substr(0, lineEnd);
-        std::string subContent1 = content.substr(lineEnd, content.length() - lineEnd);
-        std::string newField = "";
-        for (auto macro: mMacros)
+        std::vector<const ShaderMacro*> macros;
+        macros.reserve(mMacros.size());
+        for (const auto& [name, macro] : mMacros)
         {
-            newField += "\n#define " + macro.second.name + macro.second.value + "\n";
+            macros.push_back(&macro);
         }
-
-        result += newField;
-        result += subContent1;
-
-        return result;
-    }
-
-    std::string ShaderPreprocessor::ProcessLineDirectives(const std::string& content, const std::string& originalPath)
-    {
-        // For now, disable line directives as they often cause issues with OpenGL shader compilation
-        // Many OpenGL drivers don't handle #line directives properly
-        return content;
-        
-        // Alternative implementation (commented out due to compatibility issues):
-        // Convert Windows path separators to forward slashes for GLSL compatibility
-        // std::string normalizedPath = originalPath;
-        // std::replace(normalizedPath.begin(), normalizedPath.end(), '\\', '/');
-        // 
-        // // Use a simpler #line format that's more compatible with OpenGL
-        // std::string result = "#line 1\n" + content;
-        // return result;
-    }
-
-    std::string ShaderPreprocessor::ReadFile(const std::string& filePath)
-    {
-        std::ifstream file(filePath);
-        if (!file.is_open())
+        std::sort(macros.begin(), macros.end(),
+            [](const ShaderMacro* a, const ShaderMacro* b) { return a->name < b->name; });
+
+        std::string result;
+        result.reserve(content.size() + macros.size() * 32);
+        result.append(content, 0, lineEnd);
+        result += '\n';
+        for (const ShaderMacro* macro : macros)
         {
-            std::cout << "ERROR::SHADER_PREPROCESSOR::Cannot open file: " << filePath << std::endl;
-            return "";
+            result += "#define ";
+            result += macro->name;
+            if (!macro->value.empty())
+            {
+                result += ' ';
+                result += macro->value;
+            }
+            result += '\n';
         }
 
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        file.close();
+        // keep the shader's own line numbers after the inserted block
+        if (mConfig.emitLineDirectives)
+        {
+            const size_t versionLine = std::count(content.begin(), content.begin() + pos, '\n') + 1;
+            result += "#line ";
+            result += std::to_string(versionLine + 1);
+            result += " 0";
+        }
 
-        return buffer.str();
+        if (lineEnd < content.length())
+        {
+            result.append(content, lineEnd, std::string::npos);
+        }
+        return result;
     }
 
     std::string ShaderPreprocessor::ResolveIncludePath(const std::string& includePath, const std::string& basePath)
@@ -179,8 +209,15 @@ namespace te
         // if it is a relative path, parse it based on the current file path
         if (includePath[0] != '/' && includePath[0] != '\\')
         {
-            //std::filesystem::path baseDir = std::filesystem::path(basePath).parent_path();
             std::string include_fullPath = FileSystem::getPath(mConfig.shaderDirectory + includePath);
+
+            // not under the shader root: try next to the including file (e.g. vk/gs_common.glsl)
+            if (!basePath.empty() && !std::filesystem::exists(include_fullPath))
+            {
+                std::filesystem::path siblingPath = std::filesystem::path(basePath).parent_path() / includePath;
+                if (std::filesystem::exists(siblingPath))
+                    return siblingPath.string();
+            }
             return include_fullPath;
         }
 
@@ -222,6 +259,28 @@ namespace te
         return mMacros.find(name) != mMacros.end();
     }
 
+    std::string ShaderPreprocessor::GetMacroSignature() const
+    {
+        std::vector<const ShaderMacro*> macros;
+        macros.reserve(mMacros.size());
+        for (const auto& [name, macro] : mMacros)
+        {
+            macros.push_back(&macro);
+        }
+        std::sort(macros.begin(), macros.end(),
+            [](const ShaderMacro* a, const ShaderMacro* b) { return a->name < b->name; });
+
+        std::string signature;
+        for (const ShaderMacro* macro : macros)
+        {
+            signature += macro->name;
+            signature += macro->isFunction ? "()=" : "=";
+            signature += macro->value;
+            signature += ';';
+        }
+        return signature;
+    }
+
     void ShaderPreprocessor::SetConfig(const ShaderPreprocessorConfig& config)
     {
         mConfig = config;
@@ -235,10 +294,8 @@ namespace te
     void ShaderPreprocessor::InitializeBuiltinMacros()
     {
         // add some builtin macro definitions
+        // (PI / TWO_PI / HALF_PI are consts in includes/math_common.glsl, a macro would rewrite those declarations)
         DefineMacro("GLSL_VERSION", "330");
-        DefineMacro("PI", "3.14159265359");
-        DefineMacro("TWO_PI", "6.28318530718");
-        DefineMacro("HALF_PI", "1.57079632679");
     }
 
     // ShaderBuilder Implementation
@@ -253,16 +310,13 @@ namespace te
 
     std::shared_ptr<Shader> ShaderBuilder::BuildShader(const std::string& vertexPath, const std::string& fragmentPath)
     {
-        std::string vertexContent = mPreprocessor.ProcessShader(vertexPath);
-        std::string fragmentContent = mPreprocessor.ProcessShader(fragmentPath);
-
-        if (vertexContent.empty() || fragmentContent.empty())
+        // the shader preprocesses both stages with (a copy of) this builder's preprocessor and macros
+        auto shader = std::make_shared<Shader>(vertexPath.c_str(), fragmentPath.c_str(), mPreprocessor);
+        if (!shader->IsValid())
         {
-            std::cout << "ERROR::SHADER_BUILDER::Failed to process shader files" << std::endl;
-            return nullptr;
+            std::cout << "ERROR::SHADER_BUILDER::Failed to build shader: " << vertexPath << ", " << fragmentPath << std::endl;
         }
-
-        return BuildShaderFromContent(vertexContent, fragmentContent);
+        return shader;
     }
 
     std::shared_ptr<Shader> ShaderBuilder::BuildShaderFromContent(const std::string& vertexContent, const std::string& fragmentContent)
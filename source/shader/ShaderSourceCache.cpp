@@ -0,0 +1,210 @@
+#include "shader/ShaderSourceCache.h"
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+namespace te
+{
+    namespace
+    {
+        size_t SkipBlanks(const std::string& text, size_t pos, size_t end)
+        {
+            while (pos < end && (text[pos] == ' ' || text[pos] == '\t'))
+                ++pos;
+            return pos;
+        }
+
+        bool StartsWithWord(const std::string& text, size_t pos, size_t end, std::string_view word)
+        {
+            if (end - pos < word.size() || text.compare(pos, word.size(), word) != 0)
+                return false;
+            const size_t after = pos + word.size();
+            return after == end || text[after] == ' ' || text[after] == '\t' || text[after] == '<' || text[after] == '"';
+        }
+    }
+
+    void ShaderSourceFile::Tokenize()
+    {
+        includes.clear();
+        versionLine = 0;
+
+        const size_t size = text.size();
+        bool inBlockComment = false;
+        uint32_t line = 1;
+        size_t pos = 0;
+        while (pos < size)
+        {
+            const size_t lineBegin = pos;
+            size_t lineEnd = text.find('\n', pos);
+            if (lineEnd == std::string::npos)
+                lineEnd = size;
+
+            // directives only count at the start of a line that is not inside a /* */ comment
+            size_t cursor = SkipBlanks(text, lineBegin, lineEnd);
+            if (!inBlockComment && cursor < lineEnd && text[cursor] == '#')
+            {
+                cursor = SkipBlanks(text, cursor + 1, lineEnd);
+                if (StartsWithWord(text, cursor, lineEnd, "include"))
+                {
+                    cursor = SkipBlanks(text, cursor + 7, lineEnd);
+                    if (cursor < lineEnd && (text[cursor] == '<' || text[cursor] == '"'))
+                    {
+                        const char close = text[cursor] == '<' ? '>' : '"';
+                        const size_t first = cursor + 1;
+                        const size_t last = text.find(close, first);
+                        if (last != std::string::npos && last < lineEnd && last > first)
+                        {
+                            includes.push_back({ lineBegin, lineEnd, line, text.substr(first, last - first) });
+                        }
+                    }
+                }
+                else if (versionLine == 0 && StartsWithWord(text, cursor, lineEnd, "version"))
+                {
+                    versionLine = line;
+                }
+            }
+
+            // carry the block comment state over to the next line
+            for (size_t i = lineBegin; i + 1 < lineEnd; ++i)
+            {
+                if (inBlockComment)
+                {
+                    if (text[i] == '*' && text[i + 1] == '/')
+                    {
+                        inBlockComment = false;
+                        ++i;
+                    }
+                }
+                else if (text[i] == '/')
+                {
+                    if (text[i + 1] == '/')
+                        break;
+                    if (text[i + 1] == '*')
+                    {
+                        inBlockComment = true;
+                        ++i;
+                    }
+                }
+            }
+
+            pos = lineEnd + 1;
+            ++line;
+        }
+    }
+
+    ShaderSourceCache& ShaderSourceCache::GetInstance()
+    {
+        static ShaderSourceCache instance;
+        return instance;
+    }
+
+    std::string ShaderSourceCache::NormalizePath(const std::string& path)
+    {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+
+    std::shared_ptr<const ShaderSourceFile> ShaderSourceCache::Get(const std::string& path)
+    {
+        const std::string key = NormalizePath(path);
+
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(key, error);
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mFiles.find(key);
+            if (!error && it != mFiles.end() && it->second->writeTime == writeTime)
+            {
+                ++mStats.hits;
+                return it->second;
+            }
+        }
+
+        // read and tokenise outside the lock, readers of the old entry keep their copy
+        std::ifstream file(key, std::ios::binary | std::ios::ate);
+        if (error || !file.is_open())
+        {
+            std::cout << "ERROR::SHADER_SOURCE_CACHE::Cannot open file: " << key << std::endl;
+            return nullptr;
+        }
+
+        auto parsed = std::make_shared<ShaderSourceFile>();
+        parsed->text.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(parsed->text.data(), static_cast<std::streamsize>(parsed->text.size()));
+        parsed->writeTime = writeTime;
+        parsed->Tokenize();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& slot = mFiles[key];
+        slot ? ++mStats.reloads : ++mStats.misses;
+        slot = parsed;
+        return parsed;
+    }
+
+    void ShaderSourceCache::Invalidate(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFiles.erase(NormalizePath(path));
+    }
+
+    void ShaderSourceCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFiles.clear();
+        mDependencies.clear();
+        mDependents.clear();
+    }
+
+    void ShaderSourceCache::SetDependencies(const std::string& shaderPath, const std::vector<std::string>& includes)
+    {
+        const std::string key = NormalizePath(shaderPath);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& dependencies = mDependencies[key];
+        for (const std::string& include : dependencies)
+        {
+            auto it = mDependents.find(include);
+            if (it != mDependents.end())
+            {
+                it->second.erase(key);
+                if (it->second.empty())
+                    mDependents.erase(it);
+            }
+        }
+
+        dependencies.clear();
+        for (const std::string& include : includes)
+        {
+            dependencies.push_back(NormalizePath(include));
+            mDependents[dependencies.back()].insert(key);
+        }
+    }
+
+    std::vector<std::string> ShaderSourceCache::GetDependencies(const std::string& shaderPath) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mDependencies.find(NormalizePath(shaderPath));
+        return it != mDependencies.end() ? it->second : std::vector<std::string>{};
+    }
+
+    std::vector<std::string> ShaderSourceCache::GetDependents(const std::string& path) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mDependents.find(NormalizePath(path));
+        if (it == mDependents.end())
+            return {};
+        return std::vector<std::string>(it->second.begin(), it->second.end());
+    }
+
+    ShaderSourceCacheStats ShaderSourceCache::GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    void ShaderSourceCache::ResetStats()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats = {};
+    }
+}
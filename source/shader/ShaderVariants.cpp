@@ -0,0 +1,189 @@
+#include "shader/ShaderVariants.h"
+#include "shader/ShaderPreprocessor.h"
+#include "shader/ProgramBinaryCache.h"
+#include "shader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace te
+{
+    ShaderVariantCache& ShaderVariantCache::GetInstance()
+    {
+        static ShaderVariantCache instance;
+        return instance;
+    }
+
+    std::string ShaderVariantCache::MakeKey(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::vector<std::string>& defines)
+    {
+        std::string key = vertexPath;
+        key += '\n';
+        key += fragmentPath;
+        for (const std::string& define : defines)
+        {
+            key += '\n';
+            key += define;
+        }
+        return key;
+    }
+
+    std::shared_ptr<Shader> ShaderVariantCache::Get(const std::string& vertexPath, const std::string& fragmentPath,
+        const std::vector<std::string>& features, ShaderVariantMask mask)
+    {
+        std::vector<std::string> defines;
+        for (size_t i = 0; i < features.size() && i < 32; ++i)
+        {
+            if (mask & (ShaderVariantMask(1) << i))
+            {
+                defines.push_back(features[i]);
+            }
+        }
+        return Get(vertexPath, fragmentPath, std::move(defines));
+    }
+
+    std::shared_ptr<Shader> ShaderVariantCache::Get(const std::string& vertexPath, const std::string& fragmentPath,
+        std::vector<std::string> defines)
+    {
+        // order-independent: the same set always maps to the same program
+        std::sort(defines.begin(), defines.end());
+        defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+        const std::string key = MakeKey(vertexPath, fragmentPath, defines);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mVariants.find(key);
+        if (it != mVariants.end())
+        {
+            return it->second.shader;
+        }
+
+        ShaderPreprocessorConfig config;
+        config.enableMacroExpansion = true;
+        ShaderBuilder builder(config);
+        for (const std::string& define : defines)
+        {
+            builder.Define(define, "1");
+        }
+
+        Variant variant{ vertexPath, fragmentPath, defines, builder.BuildShader(vertexPath, fragmentPath) };
+        if (!variant.shader || !variant.shader->IsValid())
+        {
+            std::cout << "ERROR::SHADER_VARIANT::Failed to build " << fragmentPath << " with {";
+            for (const std::string& define : defines)
+            {
+                std::cout << ' ' << define;
+            }
+            std::cout << " }" << std::endl;
+        }
+
+        // failed variants are cached as well so a broken combination is not recompiled every frame
+        auto shader = variant.shader;
+        mVariants.emplace(key, std::move(variant));
+        return shader;
+    }
+
+    size_t ShaderVariantCache::Precompile(const std::string& manifestPath)
+    {
+        std::ifstream file(manifestPath);
+        if (!file.is_open())
+        {
+            return 0;
+        }
+
+        size_t built = 0;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            std::string vertexPath, fragmentPath, defineList;
+            if (!std::getline(fields, vertexPath, '\t') || !std::getline(fields, fragmentPath, '\t'))
+                continue;
+            std::getline(fields, defineList);
+
+            std::vector<std::string> defines;
+            std::istringstream names(defineList);
+            for (std::string name; names >> name;)
+            {
+                defines.push_back(name);
+            }
+
+            const size_t before = GetVariantCount();
+            auto shader = Get(vertexPath, fragmentPath, std::move(defines));
+            if (GetVariantCount() != before && shader && shader->IsValid())
+            {
+                ++built;
+            }
+        }
+
+        std::cout << "[ShaderVariantCache] precompiled " << built << " variants from " << manifestPath << std::endl;
+        return built;
+    }
+
+    bool ShaderVariantCache::SaveManifest(const std::string& manifestPath) const
+    {
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(manifestPath).parent_path(), error);
+
+        std::vector<const Variant*> variants;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto& [key, variant] : mVariants)
+            {
+                if (variant.shader && variant.shader->IsValid())
+                {
+                    variants.push_back(&variant);
+                }
+            }
+        }
+        if (variants.empty())
+        {
+            return false;
+        }
+
+        // stable output so the manifest diffs cleanly between runs
+        std::sort(variants.begin(), variants.end(), [](const Variant* a, const Variant* b) {
+            return MakeKey(a->vertexPath, a->fragmentPath, a->defines) < MakeKey(b->vertexPath, b->fragmentPath, b->defines);
+        });
+
+        std::ofstream file(manifestPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cout << "ERROR::SHADER_VARIANT::Cannot write manifest: " << manifestPath << std::endl;
+            return false;
+        }
+
+        file << "# vertex\tfragment\tdefines (written by ShaderVariantCache::SaveManifest)\n";
+        for (const Variant* variant : variants)
+        {
+            file << variant->vertexPath << '\t' << variant->fragmentPath << '\t';
+            for (size_t i = 0; i < variant->defines.size(); ++i)
+            {
+                file << (i ? " " : "") << variant->defines[i];
+            }
+            file << '\n';
+        }
+        return true;
+    }
+
+    std::string ShaderVariantCache::GetDefaultManifestPath()
+    {
+        return ProgramBinaryCache::GetInstance().GetDirectory() + "/shader_variants.txt";
+    }
+
+    size_t ShaderVariantCache::GetVariantCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mVariants.size();
+    }
+
+    void ShaderVariantCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mVariants.clear();
+    }
+}
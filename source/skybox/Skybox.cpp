@@ -93,15 +93,15 @@ void Skybox::Draw(const glm::mat4& view, const glm::mat4& projection)
 
     // Remove the translation part of the view
     glm::mat4 viewNoTrans = glm::mat4(glm::mat3(view));
-    glUniformMatrix4fv(glGetUniformLocation(mShader->GetID(), "view"), 1, GL_FALSE, glm::value_ptr(viewNoTrans));
-    glUniformMatrix4fv(glGetUniformLocation(mShader->GetID(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    mShader->setMat4("view", viewNoTrans);
+    mShader->setMat4("projection", projection);
 
     glBindVertexArray(mVAO);
     glActiveTexture(GL_TEXTURE7);
     glBindTexture(GL_TEXTURE_CUBE_MAP, mCubemapTexture);
     
     // Set the skybox texture uniform
-    glUniform1i(glGetUniformLocation(mShader->GetID(), "u_skyboxMap"), 7);
+    mShader->setInt("u_skyboxMap", 7);
     
     glDrawArrays(GL_TRIANGLES, 0, 36);
     glBindVertexArray(0);